@@ -94,6 +94,8 @@ class Cube : public BaseCube< eT, Cube<eT> >
   template<typename T1, typename T2>
   inline explicit Cube(const BaseCube<pod_type,T1>& A, const BaseCube<pod_type,T2>& B);
   
+  template<typename T1> inline Cube(const T1& X, const arena_target&);  // only to be used by the unwrap_cube classes
+  
   inline             Cube(const subview_cube<eT>& X);
   inline Cube& operator= (const subview_cube<eT>& X);
   inline Cube& operator+=(const subview_cube<eT>& X);
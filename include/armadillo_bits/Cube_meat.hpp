@@ -230,8 +230,20 @@ Cube<eT>::init_cold()
     {
     arma_extra_debug_print("Cube::init(): acquiring memory");
     
-    access::rw(mem)     = memory::acquire<eT>(n_elem);
-    access::rw(n_alloc) = n_elem;
+    eT* arena_mem = arena_scope::acquire<eT>(this, n_elem);
+    
+    if(arena_mem != nullptr)
+      {
+      // the memory is owned by the arena, hence treat it as auxiliary memory
+      access::rw(mem)       = arena_mem;
+      access::rw(n_alloc)   = 0;
+      access::rw(mem_state) = 1;
+      }
+    else
+      {
+      access::rw(mem)     = memory::acquire<eT>(n_elem);
+      access::rw(n_alloc) = n_elem;
+      }
     }
   
   create_mat();
@@ -298,6 +310,8 @@ Cube<eT>::init_warm(const uword in_n_rows, const uword in_n_cols, const uword in
   
   delete_mat();
   
+  uword new_mem_state = 0;
+  
   if(new_n_elem <= Cube_prealloc::mem_n_elem)
     {
     if(n_alloc > 0)
@@ -322,8 +336,21 @@ Cube<eT>::init_warm(const uword in_n_rows, const uword in_n_cols, const uword in
         }
       
       arma_extra_debug_print("Cube::init(): acquiring memory");
-      access::rw(mem)     = memory::acquire<eT>(new_n_elem);
-      access::rw(n_alloc) = new_n_elem;
+      
+      eT* arena_mem = arena_scope::acquire<eT>(this, new_n_elem);
+      
+      if(arena_mem != nullptr)
+        {
+        access::rw(mem)     = arena_mem;
+        access::rw(n_alloc) = 0;
+        
+        new_mem_state = 1;
+        }
+      else
+        {
+        access::rw(mem)     = memory::acquire<eT>(new_n_elem);
+        access::rw(n_alloc) = new_n_elem;
+        }
       }
     else  // condition: new_n_elem <= n_alloc
       {
@@ -336,7 +363,7 @@ Cube<eT>::init_warm(const uword in_n_rows, const uword in_n_cols, const uword in
   access::rw(n_elem_slice) = in_n_rows*in_n_cols;
   access::rw(n_slices)     = in_n_slices;
   access::rw(n_elem)       = new_n_elem;
-  access::rw(mem_state)    = 0;
+  access::rw(mem_state)    = new_mem_state;
   
   create_mat();
   }
@@ -740,6 +767,19 @@ Cube<eT>::Cube
 
 
 
+//! construct a temporary cube, which may obtain its memory from the current arena_scope;
+//! the arena_target object registers this cube for the duration of the construction
+template<typename eT>
+template<typename T1>
+inline
+Cube<eT>::Cube(const T1& X, const arena_target&)
+  : Cube(X)
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
 //! construct a cube from a subview_cube instance (e.g. construct a cube from a delayed subcube operation)
 template<typename eT>
 inline
@@ -4291,6 +4331,10 @@ Cube<eT>::save(const std::string name, const file_type type, const bool print_st
       save_okay = diskio::save_arma_binary(*this, name);
       break;
     
+    case npy_binary:
+      save_okay = diskio::save_npy_binary(*this, name);
+      break;
+    
     case ppm_binary:
       save_okay = diskio::save_ppm_binary(*this, name);
       break;
@@ -4403,6 +4447,10 @@ Cube<eT>::save(std::ostream& os, const file_type type, const bool print_status)
       save_okay = diskio::save_arma_binary(*this, os);
       break;
     
+    case npy_binary:
+      save_okay = diskio::save_npy_binary(*this, os);
+      break;
+    
     case ppm_binary:
       save_okay = diskio::save_ppm_binary(*this, os);
       break;
@@ -4453,6 +4501,10 @@ Cube<eT>::load(const std::string name, const file_type type, const bool print_st
       load_okay = diskio::load_arma_binary(*this, name, err_msg);
       break;
     
+    case npy_binary:
+      load_okay = diskio::load_npy_binary(*this, name, err_msg);
+      break;
+    
     case ppm_binary:
       load_okay = diskio::load_ppm_binary(*this, name, err_msg);
       break;
@@ -4576,6 +4628,10 @@ Cube<eT>::load(std::istream& is, const file_type type, const bool print_status)
       load_okay = diskio::load_arma_binary(*this, is, err_msg);
       break;
     
+    case npy_binary:
+      load_okay = diskio::load_npy_binary(*this, is, err_msg);
+      break;
+    
     case ppm_binary:
       load_okay = diskio::load_ppm_binary(*this, is, err_msg);
       break;
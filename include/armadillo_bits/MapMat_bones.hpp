@@ -20,6 +20,53 @@
 
 
 // this class is for internal use only; subject to change and/or removal without notice
+//! open-addressing hash table with linear probing, mapping linear indices to element values;
+//! used as the storage for MapMat instead of a tree-based map, so that inserting an element does not allocate memory
+template<typename eT>
+class MapMat_map
+  {
+  public:
+  
+  inline ~MapMat_map();
+  inline  MapMat_map();
+  
+  inline      MapMat_map(const MapMat_map<eT>& x);
+  inline void operator=(const MapMat_map<eT>& x);
+  
+  inline uword size()  const;
+  inline bool  empty() const;
+  
+  inline void clear();
+  inline void reserve(const uword n);
+  
+  arma_inline eT* find(const uword key) const;  //!< nullptr if key is not present
+  
+  arma_inline eT&  get_ref(const uword key);  //!< creates the element with a value of zero if key is not present
+  
+  inline void erase(const uword key);
+  
+  static constexpr uword empty_key = ARMA_MAX_UWORD;  //!< linear indices are always smaller than ARMA_MAX_UWORD
+  
+  
+  private:
+  
+  uword* keys;    //!< key in each slot, or empty_key for unused slots
+  eT*    vals;
+  uword  n_slots; //!< zero or a power of 2
+  uword  n_used;
+  uword  shift;   //!< 64 - log2(n_slots)
+  
+  arma_inline uword home_slot(const uword key) const;
+  
+  inline void rehash(const uword new_n_slots);
+  
+  inline void release();
+  
+  friend class MapMat<eT>;
+  };
+
+
+
 template<typename eT>
 class MapMat
   {
@@ -39,7 +86,7 @@ class MapMat
   
   private:
   
-  typedef typename std::map<uword, eT> map_type;
+  typedef MapMat_map<eT> map_type;
   
   arma_aligned map_type* map_ptr;
   
@@ -105,6 +152,8 @@ class MapMat
   inline uword get_n_nonzero() const;
   inline void  get_locval_format(umat& locs, Col<eT>& vals) const;
   
+  inline void  get_csc(uword* out_col_ptrs, uword* out_row_indices, eT* out_values) const;
+  
   
   private:
   
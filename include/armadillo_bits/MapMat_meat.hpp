@@ -19,13 +19,335 @@
 
 
 
+// MapMat_map
+
+
+
+template<typename eT>
+inline
+MapMat_map<eT>::~MapMat_map()
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  release();
+  }
+
+
+
+template<typename eT>
+inline
+MapMat_map<eT>::MapMat_map()
+  : keys   (nullptr)
+  , vals   (nullptr)
+  , n_slots(0)
+  , n_used (0)
+  , shift  (0)
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+MapMat_map<eT>::MapMat_map(const MapMat_map<eT>& x)
+  : keys   (nullptr)
+  , vals   (nullptr)
+  , n_slots(0)
+  , n_used (0)
+  , shift  (0)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  (*this).operator=(x);
+  }
+
+
+
+template<typename eT>
+inline
+void
+MapMat_map<eT>::operator=(const MapMat_map<eT>& x)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(this == &x)  { return; }
+  
+  if(n_slots != x.n_slots)
+    {
+    release();
+    
+    if(x.n_slots > 0)
+      {
+      keys = memory::acquire<uword>(x.n_slots);
+      vals = memory::acquire<eT>   (x.n_slots);
+      }
+    
+    n_slots = x.n_slots;
+    shift   = x.shift;
+    }
+  
+  n_used = x.n_used;
+  
+  arrayops::copy(keys, x.keys, n_slots);
+  arrayops::copy(vals, x.vals, n_slots);
+  }
+
+
+
+template<typename eT>
+inline
+uword
+MapMat_map<eT>::size() const
+  {
+  return n_used;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+MapMat_map<eT>::empty() const
+  {
+  return (n_used == 0);
+  }
+
+
+
+//! removes all elements; the memory is kept for reuse
+template<typename eT>
+inline
+void
+MapMat_map<eT>::clear()
+  {
+  arma_extra_debug_sigprint();
+  
+  if(n_used == 0)  { return; }
+  
+  for(uword i=0; i < n_slots; ++i)  { keys[i] = empty_key; }
+  
+  n_used = 0;
+  }
+
+
+
+//! ensures that n elements can be stored without rehashing
+template<typename eT>
+inline
+void
+MapMat_map<eT>::reserve(const uword n)
+  {
+  arma_extra_debug_sigprint();
+  
+  // the load factor is kept at or below 1/2, as linear probing degrades quickly at higher loads
+  
+  uword new_n_slots = (n_slots > 0) ? n_slots : uword(16);
+  
+  while( (new_n_slots / 2) < n )  { new_n_slots *= 2; }
+  
+  if(new_n_slots != n_slots)  { rehash(new_n_slots); }
+  }
+
+
+
+template<typename eT>
+arma_inline
+uword
+MapMat_map<eT>::home_slot(const uword key) const
+  {
+  // Fibonacci hashing: the high bits of the product depend on all bits of the key,
+  // so that keys from regular patterns (eg. consecutive rows or columns) are spread out
+  
+  return uword( (u64(key) * u64(0x9E3779B97F4A7C15ULL)) >> shift );
+  }
+
+
+
+template<typename eT>
+arma_inline
+eT*
+MapMat_map<eT>::find(const uword key) const
+  {
+  if(n_used == 0)  { return nullptr; }
+  
+  const uword mask = n_slots - 1;
+  
+  uword i = home_slot(key);
+  
+  while(true)
+    {
+    const uword slot_key = keys[i];
+    
+    if(slot_key == key      )  { return &(vals[i]); }
+    if(slot_key == empty_key)  { return nullptr;    }
+    
+    i = (i + 1) & mask;
+    }
+  }
+
+
+
+template<typename eT>
+arma_inline
+eT&
+MapMat_map<eT>::get_ref(const uword key)
+  {
+  if( (n_used + 1) > (n_slots / 2) )  { reserve(n_used + 1); }
+  
+  const uword mask = n_slots - 1;
+  
+  uword i = home_slot(key);
+  
+  while(true)
+    {
+    const uword slot_key = keys[i];
+    
+    if(slot_key == key)  { return vals[i]; }
+    
+    if(slot_key == empty_key)
+      {
+      keys[i] = key;
+      vals[i] = eT(0);
+      
+      ++n_used;
+      
+      return vals[i];
+      }
+    
+    i = (i + 1) & mask;
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+MapMat_map<eT>::erase(const uword key)
+  {
+  if(n_used == 0)  { return; }
+  
+  const uword mask = n_slots - 1;
+  
+  uword i = home_slot(key);
+  
+  while(true)
+    {
+    const uword slot_key = keys[i];
+    
+    if(slot_key == empty_key)  { return; }
+    if(slot_key == key      )  { break;  }
+    
+    i = (i + 1) & mask;
+    }
+  
+  // backward shift deletion: move later elements of the probe sequence into the hole,
+  // unless their home slot lies cyclically within (hole, current]
+  
+  uword j = i;
+  
+  while(true)
+    {
+    j = (j + 1) & mask;
+    
+    const uword slot_key = keys[j];
+    
+    if(slot_key == empty_key)  { break; }
+    
+    const uword k = home_slot(slot_key);
+    
+    const bool stays = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+    
+    if(stays)  { continue; }
+    
+    keys[i] = slot_key;
+    vals[i] = vals[j];
+    
+    i = j;
+    }
+  
+  keys[i] = empty_key;
+  
+  --n_used;
+  }
+
+
+
+template<typename eT>
+inline
+void
+MapMat_map<eT>::rehash(const uword new_n_slots)
+  {
+  arma_extra_debug_sigprint();
+  
+  uword* old_keys    = keys;
+  eT*    old_vals    = vals;
+  uword  old_n_slots = n_slots;
+  
+  keys = memory::acquire<uword>(new_n_slots);
+  vals = memory::acquire<eT>   (new_n_slots);
+  
+  n_slots = new_n_slots;
+  
+  uword log2_n_slots = 0;
+  
+  while( (uword(1) << log2_n_slots) < new_n_slots )  { ++log2_n_slots; }
+  
+  shift = 64 - log2_n_slots;
+  
+  for(uword i=0; i < n_slots; ++i)  { keys[i] = empty_key; }
+  
+  const uword mask = n_slots - 1;
+  
+  for(uword j=0; j < old_n_slots; ++j)
+    {
+    const uword key = old_keys[j];
+    
+    if(key == empty_key)  { continue; }
+    
+    uword i = home_slot(key);
+    
+    while(keys[i] != empty_key)  { i = (i + 1) & mask; }
+    
+    keys[i] = key;
+    vals[i] = old_vals[j];
+    }
+  
+  memory::release(old_keys);
+  memory::release(old_vals);
+  }
+
+
+
+template<typename eT>
+inline
+void
+MapMat_map<eT>::release()
+  {
+  memory::release(keys);
+  memory::release(vals);
+  
+  keys    = nullptr;
+  vals    = nullptr;
+  n_slots = 0;
+  n_used  = 0;
+  shift   = 0;
+  }
+
+
+
+// MapMat
+
+
+
 template<typename eT>
 inline
 MapMat<eT>::~MapMat()
   {
   arma_extra_debug_sigprint_this(this);
   
-  if(map_ptr)  { (*map_ptr).clear();  delete map_ptr; }
+  if(map_ptr)  { delete map_ptr; }
   
   // try to expose buggy user code that accesses deleted objects
   if(arma_config::debug)  { map_ptr = nullptr; }
@@ -152,6 +474,8 @@ MapMat<eT>::operator=(const SpMat<eT>& x)
   
   map_type& map_ref = (*map_ptr);
   
+  map_ref.reserve(x.n_nonzero);
+  
   for(uword col = 0; col < x_n_cols; ++col)
     {
     const uword start = x_col_ptrs[col    ];
@@ -164,7 +488,7 @@ MapMat<eT>::operator=(const SpMat<eT>& x)
       
       const uword index = (x_n_rows * col) + row;
       
-      map_ref.emplace_hint(map_ref.cend(), index, val);
+      map_ref.get_ref(index) = val;
       }
     }
   }
@@ -344,11 +668,13 @@ MapMat<eT>::eye(const uword in_n_rows, const uword in_n_cols)
   
   map_type& map_ref = (*map_ptr);
   
+  map_ref.reserve(N);
+  
   for(uword i=0; i<N; ++i)
     {
     const uword index = (in_n_rows * i) + i;
     
-    map_ref.emplace_hint(map_ref.cend(), index, eT(1));
+    map_ref.get_ref(index) = eT(1);
     }
   }
 
@@ -419,12 +745,9 @@ arma_warn_unused
 eT
 MapMat<eT>::operator[](const uword index) const
   {
-  map_type& map_ref = (*map_ptr);
-  
-  typename map_type::const_iterator it     = map_ref.find(index);
-  typename map_type::const_iterator it_end = map_ref.end();
+  const eT* val_ptr = (*map_ptr).find(index);
   
-  return (it != it_end) ? eT((*it).second) : eT(0);
+  return (val_ptr != nullptr) ? eT(*val_ptr) : eT(0);
   }
 
 
@@ -450,12 +773,9 @@ MapMat<eT>::operator()(const uword index) const
   {
   arma_debug_check( (index >= n_elem), "MapMat::operator(): index out of bounds" );
   
-  map_type& map_ref = (*map_ptr);
-  
-  typename map_type::const_iterator it     = map_ref.find(index);
-  typename map_type::const_iterator it_end = map_ref.end();
+  const eT* val_ptr = (*map_ptr).find(index);
   
-  return (it != it_end) ? eT((*it).second) : eT(0);
+  return (val_ptr != nullptr) ? eT(*val_ptr) : eT(0);
   }
 
 
@@ -481,12 +801,9 @@ MapMat<eT>::at(const uword in_row, const uword in_col) const
   {
   const uword index = (n_rows * in_col) + in_row;
   
-  map_type& map_ref = (*map_ptr);
-  
-  typename map_type::const_iterator it     = map_ref.find(index);
-  typename map_type::const_iterator it_end = map_ref.end();
+  const eT* val_ptr = (*map_ptr).find(index);
   
-  return (it != it_end) ? eT((*it).second) : eT(0);
+  return (val_ptr != nullptr) ? eT(*val_ptr) : eT(0);
   }
 
 
@@ -516,12 +833,9 @@ MapMat<eT>::operator()(const uword in_row, const uword in_col) const
   
   const uword index = (n_rows * in_col) + in_row;
   
-  map_type& map_ref = (*map_ptr);
-  
-  typename map_type::const_iterator it     = map_ref.find(index);
-  typename map_type::const_iterator it_end = map_ref.end();
+  const eT* val_ptr = (*map_ptr).find(index);
   
-  return (it != it_end) ? eT((*it).second) : eT(0);
+  return (val_ptr != nullptr) ? eT(*val_ptr) : eT(0);
   }
 
 
@@ -602,12 +916,14 @@ MapMat<eT>::sprandu(const uword in_n_rows, const uword in_n_cols, const double d
   
   map_type& map_ref = (*map_ptr);
   
+  map_ref.reserve(N);
+  
   for(uword i=0; i < N; ++i)
     {
     const uword index = indx_mem[i];
     const eT    val   = vals_mem[i];
     
-    map_ref.emplace_hint(map_ref.cend(), index, val);
+    map_ref.get_ref(index) = val;
     }
   }
 
@@ -642,22 +958,17 @@ MapMat<eT>::print(const std::string& extra_text) const
   
   if(n_nonzero > 0)
     {
-    typename map_type::const_iterator it = map_ref.begin();
-
-    for(uword i=0; i < n_nonzero; ++i)
+    podarray<uword> col_ptrs(n_cols + 1);
+    podarray<uword> row_indices(n_nonzero);
+    podarray<eT>    values(n_nonzero);
+    
+    (*this).get_csc(col_ptrs.memptr(), row_indices.memptr(), values.memptr());
+    
+    for(uword col=0; col < n_cols; ++col)
+    for(uword i = col_ptrs[col]; i < col_ptrs[col + 1]; ++i)
       {
-      const std::pair<uword, eT>& entry = (*it);
-      
-      const uword index = entry.first;
-      const eT    val   = entry.second;
-      
-      const uword row = index % n_rows;
-      const uword col = index / n_rows;
-      
-      get_cout_stream() << '(' << row << ", " << col << ") ";
-      get_cout_stream() << val << '\n';
-      
-      ++it;
+      get_cout_stream() << '(' << row_indices[i] << ", " << col << ") ";
+      get_cout_stream() << values[i] << '\n';
       }
     }
   
@@ -685,35 +996,134 @@ MapMat<eT>::get_locval_format(umat& locs, Col<eT>& vals) const
   {
   arma_extra_debug_sigprint();
   
-  map_type& map_ref = (*map_ptr);
-  
-  typename map_type::const_iterator it = map_ref.begin();
-  
-  const uword N = uword(map_ref.size());
+  const uword N = uword((*map_ptr).size());
   
   locs.set_size(2,N);
   vals.set_size(N);
   
-  eT* vals_mem = vals.memptr();
+  podarray<uword> col_ptrs(n_cols + 1);
+  podarray<uword> row_indices(N);
   
-  for(uword i=0; i<N; ++i)
+  (*this).get_csc(col_ptrs.memptr(), row_indices.memptr(), vals.memptr());
+  
+  for(uword col=0; col < n_cols; ++col)
+  for(uword i = col_ptrs[col]; i < col_ptrs[col + 1]; ++i)
+    {
+    uword* locs_colptr = locs.colptr(i);
+    
+    locs_colptr[0] = row_indices[i];
+    locs_colptr[1] = col;
+    }
+  }
+
+
+
+//! converts the elements to compressed sparse column format, with ascending row indices within each column;
+//! out_col_ptrs must have space for n_cols+1 elements, and out_row_indices and out_values for get_n_nonzero() elements
+template<typename eT>
+inline
+void
+MapMat<eT>::get_csc(uword* out_col_ptrs, uword* out_row_indices, eT* out_values) const
+  {
+  arma_extra_debug_sigprint();
+  
+  const map_type& map_ref = (*map_ptr);
+  
+  const uword N = map_ref.n_used;
+  
+  arrayops::fill_zeros(out_col_ptrs, n_cols + 1);
+  
+  if(N == 0)  { return; }
+  
+  const uword* slot_keys = map_ref.keys;
+  const eT*    slot_vals = map_ref.vals;
+  const uword  n_slots   = map_ref.n_slots;
+  
+  // count the elements in each column
+  
+  for(uword j=0; j < n_slots; ++j)
+    {
+    const uword key = slot_keys[j];
+    
+    if(key != map_type::empty_key)  { ++out_col_ptrs[(key / n_rows) + 1]; }
+    }
+  
+  for(uword col=0; col < n_cols; ++col)  { out_col_ptrs[col + 1] += out_col_ptrs[col]; }
+  
+  podarray<uword> col_pos(out_col_ptrs, n_cols);
+  
+  if(n_rows <= (8 * N))
     {
-    const std::pair<uword, eT>& entry = (*it);
+    // LSD radix sort with the row and column as digits:
+    // a counting sort by row, followed by a stable counting sort by column
     
-    const uword index = entry.first;
-    const eT    val   = entry.second;
+    podarray<uword> row_ptrs(n_rows + 1);
     
-    const uword row = index % n_rows;
-    const uword col = index / n_rows;
+    row_ptrs.zeros();
     
-    uword* locs_colptr = locs.colptr(i);
+    for(uword j=0; j < n_slots; ++j)
+      {
+      const uword key = slot_keys[j];
+      
+      if(key != map_type::empty_key)  { ++row_ptrs[(key % n_rows) + 1]; }
+      }
     
-    locs_colptr[0] = row;
-    locs_colptr[1] = col;
+    for(uword row=0; row < n_rows; ++row)  { row_ptrs[row + 1] += row_ptrs[row]; }
     
-    vals_mem[i] = val;
+    podarray<uword> tmp_keys(N);
+    podarray<eT>    tmp_vals(N);
     
-    ++it;
+    for(uword j=0; j < n_slots; ++j)
+      {
+      const uword key = slot_keys[j];
+      
+      if(key == map_type::empty_key)  { continue; }
+      
+      const uword dest = row_ptrs[key % n_rows]++;
+      
+      tmp_keys[dest] = key;
+      tmp_vals[dest] = slot_vals[j];
+      }
+    
+    for(uword i=0; i < N; ++i)
+      {
+      const uword key = tmp_keys[i];
+      const uword col = key / n_rows;
+      
+      const uword dest = col_pos[col]++;
+      
+      out_row_indices[dest] = key - (col * n_rows);
+      out_values     [dest] = tmp_vals[i];
+      }
+    }
+  else
+    {
+    // very tall matrix with few elements: counting sort by column, followed by sorting the rows within each column
+    
+    for(uword j=0; j < n_slots; ++j)
+      {
+      const uword key = slot_keys[j];
+      
+      if(key == map_type::empty_key)  { continue; }
+      
+      const uword col  = key / n_rows;
+      const uword dest = col_pos[col]++;
+      
+      out_row_indices[dest] = key - (col * n_rows);
+      }
+    
+    for(uword col=0; col < n_cols; ++col)
+      {
+      const uword index_start = out_col_ptrs[col    ];
+      const uword index_end   = out_col_ptrs[col + 1];
+      
+      if((index_end - index_start) > 1)  { std::sort(out_row_indices + index_start, out_row_indices + index_end); }
+      
+      for(uword i = index_start; i < index_end; ++i)
+        {
+        out_values[i] = *( map_ref.find((col * n_rows) + out_row_indices[i]) );
+        }
+      }
     }
   }
 
@@ -798,16 +1208,7 @@ MapMat<eT>::set_val(const uword index, const eT& in_val)
   
   if(in_val != eT(0))
     {
-    map_type& map_ref = (*map_ptr);
-    
-    if( (map_ref.empty() == false) && (index > uword(map_ref.crbegin()->first)) )
-      {
-      map_ref.emplace_hint(map_ref.cend(), index, in_val);
-      }
-    else
-      {
-      map_ref.operator[](index) = in_val;
-      }
+    (*map_ptr).get_ref(index) = in_val;
     }
   else
     {
@@ -824,12 +1225,7 @@ MapMat<eT>::erase_val(const uword index)
   {
   arma_extra_debug_sigprint();
   
-  map_type& map_ref = (*map_ptr);
-  
-  typename map_type::iterator it     = map_ref.find(index);
-  typename map_type::iterator it_end = map_ref.end();
-  
-  if(it != it_end)  { map_ref.erase(it); }
+  (*map_ptr).erase(index);
   }
 
 
@@ -934,7 +1330,7 @@ MapMat_val<eT>::operator+=(const eT in_val)
   
   if(in_val != eT(0))
     {
-    eT& val = map_ref.operator[](index);  // creates the element if it doesn't exist
+    eT& val = map_ref.get_ref(index);  // creates the element if it doesn't exist
     
     val += in_val;
     
@@ -955,7 +1351,7 @@ MapMat_val<eT>::operator-=(const eT in_val)
   
   if(in_val != eT(0))
     {
-    eT& val = map_ref.operator[](index);  // creates the element if it doesn't exist
+    eT& val = map_ref.get_ref(index);  // creates the element if it doesn't exist
     
     val -= in_val;
     
@@ -974,22 +1370,21 @@ MapMat_val<eT>::operator*=(const eT in_val)
   
   typename MapMat<eT>::map_type& map_ref = *(parent.map_ptr);
   
-  typename MapMat<eT>::map_type::iterator it     = map_ref.find(index);
-  typename MapMat<eT>::map_type::iterator it_end = map_ref.end();
+  eT* val_ptr = map_ref.find(index);
   
-  if(it != it_end)
+  if(val_ptr != nullptr)
     {
     if(in_val != eT(0))
       {
-      eT& val = (*it).second;
+      eT& val = (*val_ptr);
       
       val *= in_val;
       
-      if(val == eT(0))  { map_ref.erase(it); }
+      if(val == eT(0))  { map_ref.erase(index); }
       }
     else
       {
-      map_ref.erase(it);
+      map_ref.erase(index);
       }
     }
   }
@@ -1005,16 +1400,15 @@ MapMat_val<eT>::operator/=(const eT in_val)
   
   typename MapMat<eT>::map_type& map_ref = *(parent.map_ptr);
   
-  typename MapMat<eT>::map_type::iterator it     = map_ref.find(index);
-  typename MapMat<eT>::map_type::iterator it_end = map_ref.end();
+  eT* val_ptr = map_ref.find(index);
   
-  if(it != it_end)
+  if(val_ptr != nullptr)
     {
-    eT& val = (*it).second;
+    eT& val = (*val_ptr);
     
     val /= in_val;
     
-    if(val == eT(0))  { map_ref.erase(it); }
+    if(val == eT(0))  { map_ref.erase(index); }
     }
   else
     {
@@ -1037,7 +1431,7 @@ MapMat_val<eT>::operator++()
   
   typename MapMat<eT>::map_type& map_ref = *(parent.map_ptr);
   
-  eT& val = map_ref.operator[](index);  // creates the element if it doesn't exist
+  eT& val = map_ref.get_ref(index);  // creates the element if it doesn't exist
   
   val += eT(1);  // can't use ++,  as eT can be std::complex
   
@@ -1067,7 +1461,7 @@ MapMat_val<eT>::operator--()
   
   typename MapMat<eT>::map_type& map_ref = *(parent.map_ptr);
   
-  eT& val = map_ref.operator[](index);  // creates the element if it doesn't exist
+  eT& val = map_ref.get_ref(index);  // creates the element if it doesn't exist
   
   val -= eT(1);  // can't use --,  as eT can be std::complex
   
@@ -1435,7 +1829,7 @@ SpMat_MapMat_val<eT>::add(const eT in_val)
     
     typename MapMat<eT>::map_type& map_ref = *(m_parent.map_ptr);
     
-    eT& val = map_ref.operator[](index);  // creates the element if it doesn't exist
+    eT& val = map_ref.get_ref(index);  // creates the element if it doesn't exist
     
     val += in_val;
     
@@ -1466,7 +1860,7 @@ SpMat_MapMat_val<eT>::sub(const eT in_val)
     
     typename MapMat<eT>::map_type& map_ref = *(m_parent.map_ptr);
     
-    eT& val = map_ref.operator[](index);  // creates the element if it doesn't exist
+    eT& val = map_ref.get_ref(index);  // creates the element if it doesn't exist
     
     val -= in_val;
     
@@ -1497,22 +1891,21 @@ SpMat_MapMat_val<eT>::mul(const eT in_val)
     
     typename MapMat<eT>::map_type& map_ref = *(m_parent.map_ptr);
     
-    typename MapMat<eT>::map_type::iterator it     = map_ref.find(index);
-    typename MapMat<eT>::map_type::iterator it_end = map_ref.end();
+    eT* val_ptr = map_ref.find(index);
     
-    if(it != it_end)
+    if(val_ptr != nullptr)
       {
       if(in_val != eT(0))
         {
-        eT& val = (*it).second;
+        eT& val = (*val_ptr);
         
         val *= in_val;
         
-        if(val == eT(0))  { map_ref.erase(it); }
+        if(val == eT(0))  { map_ref.erase(index); }
         }
       else
         {
-        map_ref.erase(it);
+        map_ref.erase(index);
         }
       
       s_parent.sync_state = 1;
@@ -1558,16 +1951,15 @@ SpMat_MapMat_val<eT>::div(const eT in_val)
     
     typename MapMat<eT>::map_type& map_ref = *(m_parent.map_ptr);
     
-    typename MapMat<eT>::map_type::iterator it     = map_ref.find(index);
-    typename MapMat<eT>::map_type::iterator it_end = map_ref.end();
+    eT* val_ptr = map_ref.find(index);
     
-    if(it != it_end)
+    if(val_ptr != nullptr)
       {
-      eT& val = (*it).second;
+      eT& val = (*val_ptr);
       
       val /= in_val;
       
-      if(val == eT(0))  { map_ref.erase(it); }
+      if(val == eT(0))  { map_ref.erase(index); }
       
       s_parent.sync_state = 1;
       
@@ -112,6 +112,8 @@ class Mat : public Base< eT, Mat<eT> >
   
   inline explicit          Mat(const subview<eT>& X, const bool use_colmem);  // only to be used by the quasi_unwrap class
   
+  template<typename T1> inline Mat(const T1& X, const arena_target&);  // only to be used by the unwrap, partial_unwrap and glue_times classes
+  
   inline             Mat(const subview<eT>& X);
   inline Mat& operator= (const subview<eT>& X);
   inline Mat& operator+=(const subview<eT>& X);
@@ -222,8 +222,20 @@ Mat<eT>::init_cold()
     {
     arma_extra_debug_print("Mat::init(): acquiring memory");
     
-    access::rw(mem)     = memory::acquire<eT>(n_elem);
-    access::rw(n_alloc) = n_elem;
+    eT* arena_mem = arena_scope::acquire<eT>(this, n_elem);
+    
+    if(arena_mem != nullptr)
+      {
+      // the memory is owned by the arena, hence treat it as auxiliary memory
+      access::rw(mem)       = arena_mem;
+      access::rw(n_alloc)   = 0;
+      access::rw(mem_state) = 1;
+      }
+    else
+      {
+      access::rw(mem)     = memory::acquire<eT>(n_elem);
+      access::rw(n_alloc) = n_elem;
+      }
     }
   }
 
@@ -295,6 +307,8 @@ Mat<eT>::init_warm(uword in_n_rows, uword in_n_cols)
   
   arma_debug_check( (t_mem_state == 2), "Mat::init(): mismatch between size of auxiliary memory and requested size" );
   
+  uhword new_mem_state = 0;
+  
   if(new_n_elem <= arma_config::mat_prealloc)
     {
     if(n_alloc > 0)
@@ -319,8 +333,21 @@ Mat<eT>::init_warm(uword in_n_rows, uword in_n_cols)
         }
       
       arma_extra_debug_print("Mat::init(): acquiring memory");
-      access::rw(mem)       = memory::acquire<eT>(new_n_elem);
-      access::rw(n_alloc)   = new_n_elem;
+      
+      eT* arena_mem = arena_scope::acquire<eT>(this, new_n_elem);
+      
+      if(arena_mem != nullptr)
+        {
+        access::rw(mem)     = arena_mem;
+        access::rw(n_alloc) = 0;
+        
+        new_mem_state = 1;
+        }
+      else
+        {
+        access::rw(mem)     = memory::acquire<eT>(new_n_elem);
+        access::rw(n_alloc) = new_n_elem;
+        }
       }
     else // condition: new_n_elem <= n_alloc
       {
@@ -331,7 +358,7 @@ Mat<eT>::init_warm(uword in_n_rows, uword in_n_cols)
   access::rw(n_rows)    = in_n_rows;
   access::rw(n_cols)    = in_n_cols;
   access::rw(n_elem)    = new_n_elem;
-  access::rw(mem_state) = 0;
+  access::rw(mem_state) = new_mem_state;
   }
 
 
@@ -1838,6 +1865,19 @@ Mat<eT>::Mat(const subview<eT>& X, const bool use_colmem)
 
 
 
+//! construct a temporary matrix, which may obtain its memory from the current arena_scope;
+//! the arena_target object registers this matrix for the duration of the construction
+template<typename eT>
+template<typename T1>
+inline
+Mat<eT>::Mat(const T1& X, const arena_target&)
+  : Mat(X)
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
 //! construct a matrix from subview (e.g. construct a matrix from a delayed submatrix operation)
 template<typename eT>
 inline
@@ -7327,6 +7367,10 @@ Mat<eT>::save(const std::string name, const file_type type, const bool print_sta
       save_okay = diskio::save_arma_binary(*this, name);
       break;
     
+    case npy_binary:
+      save_okay = diskio::save_npy_binary(*this, name);
+      break;
+    
     case pgm_binary:
       save_okay = diskio::save_pgm_binary(*this, name);
       break;
@@ -7521,6 +7565,10 @@ Mat<eT>::save(std::ostream& os, const file_type type, const bool print_status) c
       save_okay = diskio::save_arma_binary(*this, os);
       break;
     
+    case npy_binary:
+      save_okay = diskio::save_npy_binary(*this, os);
+      break;
+    
     case pgm_binary:
       save_okay = diskio::save_pgm_binary(*this, os);
       break;
@@ -7575,6 +7623,10 @@ Mat<eT>::load(const std::string name, const file_type type, const bool print_sta
       load_okay = diskio::load_arma_binary(*this, name, err_msg);
       break;
     
+    case npy_binary:
+      load_okay = diskio::load_npy_binary(*this, name, err_msg);
+      break;
+    
     case pgm_binary:
       load_okay = diskio::load_pgm_binary(*this, name, err_msg);
       break;
@@ -7789,6 +7841,10 @@ Mat<eT>::load(std::istream& is, const file_type type, const bool print_status)
       load_okay = diskio::load_arma_binary(*this, is, err_msg);
       break;
     
+    case npy_binary:
+      load_okay = diskio::load_npy_binary(*this, is, err_msg);
+      break;
+    
     case pgm_binary:
       load_okay = diskio::load_pgm_binary(*this, is, err_msg);
       break;
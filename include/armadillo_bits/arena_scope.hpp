@@ -0,0 +1,251 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup arena_scope
+//! @{
+
+
+//! while an arena_scope object exists, the memory for temporary matrices and cubes
+//! created by the unwrap, partial_unwrap and glue_times classes is taken from a per-thread buffer
+//! by incrementing an offset; the buffer is released in one go when the scope ends.
+//! only objects registered via arena_target obtain memory from the arena; such objects use the memory
+//! as auxiliary memory (mem_state = 1), so it is never released individually and never given to user objects.
+//! requests that do not fit into the remaining space of the buffer are served by memory::acquire().
+//! scopes must be nested within one thread; only the innermost scope is used.
+class arena_scope
+  {
+  public:
+  
+  inline explicit arena_scope(const uword n_bytes);
+  inline         ~arena_scope();
+  
+  inline uword n_bytes_used()  const;  //!< number of bytes taken from the buffer so far
+  inline uword n_bytes_total() const;  //!< size of the buffer
+  
+  template<typename eT> inline static eT* acquire(const void* obj, const uword n_elem);
+  
+  static constexpr size_t alignment = (arma_config::mem_align > 32) ? size_t(arma_config::mem_align) : size_t(32);
+  
+  
+  private:
+  
+  unsigned char* buffer;
+  size_t         capacity;
+  size_t         used;
+  
+  arena_scope*        prev_scope;
+  const arena_target* targets;
+  
+  struct spare_type
+    {
+    unsigned char* buffer   = nullptr;
+    size_t         capacity = 0;
+    
+    inline ~spare_type()  { if(buffer != nullptr)  { memory::release(buffer); } }
+    };
+  
+  inline static arena_scope*& get_current();
+  inline static spare_type&   get_spare();
+  
+  arena_scope(const arena_scope&)            = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+  
+  friend class arena_target;
+  };
+
+
+
+//! registers an object (eg. a temporary matrix) that may obtain its memory from the innermost arena_scope;
+//! the registration lasts for the lifetime of the arena_target object
+class arena_target
+  {
+  public:
+  
+  inline explicit arena_target(const void* in_obj);
+  inline         ~arena_target();
+  
+  
+  private:
+  
+  const void*         obj;
+  arena_scope*        scope;
+  const arena_target* prev;
+  
+  arena_target(const arena_target&)            = delete;
+  arena_target& operator=(const arena_target&) = delete;
+  
+  friend class arena_scope;
+  };
+
+
+
+inline
+arena_scope*&
+arena_scope::get_current()
+  {
+  static thread_local arena_scope* current = nullptr;
+  
+  return current;
+  }
+
+
+
+//! the buffer of the most recently ended scope is kept for reuse by the next scope in the same thread
+inline
+arena_scope::spare_type&
+arena_scope::get_spare()
+  {
+  static thread_local spare_type spare;
+  
+  return spare;
+  }
+
+
+
+inline
+arena_scope::arena_scope(const uword n_bytes)
+  : buffer(nullptr)
+  , capacity(0)
+  , used(0)
+  , prev_scope(nullptr)
+  , targets(nullptr)
+  {
+  arma_extra_debug_sigprint();
+  
+  spare_type& spare = get_spare();
+  
+  if( (spare.buffer != nullptr) && (spare.capacity >= size_t(n_bytes)) )
+    {
+    buffer   = spare.buffer;
+    capacity = spare.capacity;
+    
+    spare.buffer   = nullptr;
+    spare.capacity = 0;
+    }
+  else
+  if(n_bytes > 0)
+    {
+    buffer   = memory::acquire<unsigned char>(n_bytes);
+    capacity = size_t(n_bytes);
+    }
+  
+  arena_scope*& current = get_current();
+  
+  prev_scope = current;
+  current    = this;
+  }
+
+
+
+inline
+arena_scope::~arena_scope()
+  {
+  arma_extra_debug_sigprint();
+  
+  get_current() = prev_scope;
+  
+  spare_type& spare = get_spare();
+  
+  if(capacity >= spare.capacity)
+    {
+    memory::release(spare.buffer);
+    
+    spare.buffer   = buffer;
+    spare.capacity = capacity;
+    }
+  else
+    {
+    memory::release(buffer);
+    }
+  }
+
+
+
+inline
+uword
+arena_scope::n_bytes_used() const
+  {
+  return uword(used);
+  }
+
+
+
+inline
+uword
+arena_scope::n_bytes_total() const
+  {
+  return uword(capacity);
+  }
+
+
+
+//! memory for n_elem elements from the innermost scope, if obj has been registered via arena_target;
+//! returns nullptr if there is no scope, obj is not registered, or there is not enough space
+template<typename eT>
+inline
+eT*
+arena_scope::acquire(const void* obj, const uword n_elem)
+  {
+  arena_scope* scope = get_current();
+  
+  if(scope == nullptr)  { return nullptr; }
+  
+  const arena_target* target = scope->targets;
+  
+  while( (target != nullptr) && (target->obj != obj) )  { target = target->prev; }
+  
+  if(target == nullptr)  { return nullptr; }
+  
+  if( size_t(n_elem) > (std::numeric_limits<size_t>::max() / sizeof(eT)) )  { return nullptr; }
+  
+  const size_t n_bytes = sizeof(eT) * size_t(n_elem);
+  
+  const size_t addr  = size_t(scope->buffer) + scope->used;
+  const size_t start = scope->used + ((alignment - (addr % alignment)) % alignment);
+  
+  if( (start > scope->capacity) || (n_bytes > (scope->capacity - start)) )  { return nullptr; }
+  
+  scope->used = start + n_bytes;
+  
+  return (eT*)(scope->buffer + start);
+  }
+
+
+
+inline
+arena_target::arena_target(const void* in_obj)
+  : obj(in_obj)
+  , scope(arena_scope::get_current())
+  , prev(nullptr)
+  {
+  if(scope != nullptr)
+    {
+    prev           = scope->targets;
+    scope->targets = this;
+    }
+  }
+
+
+
+inline
+arena_target::~arena_target()
+  {
+  if(scope != nullptr)  { scope->targets = prev; }
+  }
+
+
+
+//! @}
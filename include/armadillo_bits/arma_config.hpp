@@ -28,6 +28,20 @@ struct arma_config
   #endif
   
   
+  #if defined(ARMA_MEM_ALIGN)
+    static constexpr uword mem_align = ( (sword(ARMA_MEM_ALIGN) >= 16) && (sword(ARMA_MEM_ALIGN) <= 4096) && ((uword(ARMA_MEM_ALIGN) & (uword(ARMA_MEM_ALIGN) - 1)) == 0) ) ? uword(ARMA_MEM_ALIGN) : 32;
+  #else
+    static constexpr uword mem_align = 32;
+  #endif
+  
+  
+  #if defined(ARMA_MEM_ALIGN_PAGE)
+    static constexpr bool mem_align_page = true;
+  #else
+    static constexpr bool mem_align_page = false;
+  #endif
+  
+  
   #if defined(ARMA_OPENMP_THRESHOLD)
     static constexpr uword mp_threshold = (sword(ARMA_OPENMP_THRESHOLD) > 0) ? uword(ARMA_OPENMP_THRESHOLD) : 240;
   #else
@@ -42,6 +56,13 @@ struct arma_config
   #endif
   
   
+  #if defined(ARMA_USE_OPENMP) && defined(ARMA_OPENMP_FIRST_TOUCH)
+    static constexpr bool first_touch = true;
+  #else
+    static constexpr bool first_touch = false;
+  #endif
+  
+  
   #if defined(ARMA_USE_ATLAS)
     static constexpr bool atlas = true;
   #else
@@ -264,6 +264,8 @@ template<typename T1> struct unwrap;
 template<typename T1> struct quasi_unwrap;
 template<typename T1> struct unwrap_cube;
 template<typename T1> struct unwrap_spmat;
+template<typename T1> struct partial_unwrap;
+template<typename T1> struct strip_inv;
 
 
 
@@ -326,6 +328,10 @@ template<typename out_eT, typename T1, typename T2, typename spglue_type> class
 template<typename T1> class SpProxy;
 
 
+class arena_scope;
+class arena_target;
+
+
 
 struct arma_vec_indicator     {};
 struct arma_fixed_indicator   {};
@@ -363,7 +369,8 @@ enum struct file_type : unsigned int
   ppm_binary,         //!< Portable Pixel Map (colour image), used by the field and cube classes
   hdf5_binary,        //!< HDF5: open binary format, not specific to Armadillo, which can store arbitrary data
   hdf5_binary_trans,  //!< [DO NOT USE - deprecated] as per hdf5_binary, but save/load the data with columns transposed to rows
-  coord_ascii         //!< simple co-ordinate format for sparse matrices (indices start at zero)
+  coord_ascii,        //!< simple co-ordinate format for sparse matrices (indices start at zero)
+  npy_binary          //!< NumPy .npy format for matrices and cubes, and .npz format (uncompressed) for fields
   };
 
 
@@ -379,12 +386,25 @@ static constexpr file_type ppm_binary         = file_type::ppm_binary;
 static constexpr file_type hdf5_binary        = file_type::hdf5_binary;
 static constexpr file_type hdf5_binary_trans  = file_type::hdf5_binary_trans;
 static constexpr file_type coord_ascii        = file_type::coord_ascii;
+static constexpr file_type npy_binary         = file_type::npy_binary;
 
 
 struct hdf5_name;
 struct  csv_name;
 
 
+//! access modes of mapped_mat and mapped_cube
+enum struct mmap_mode : unsigned int
+  {
+  read_only,      //!< the memory is read-only and shared with other processes mapping the same file
+  copy_on_write   //!< the memory is writable; modified pages become private copies and the file is not changed
+  };
+
+
+static constexpr mmap_mode mmap_read_only     = mmap_mode::read_only;
+static constexpr mmap_mode mmap_copy_on_write = mmap_mode::copy_on_write;
+
+
 //! @}
 
 
@@ -460,6 +480,22 @@ struct superlu_opts : public spsolve_opts_base
   };
 
 
+struct spchol_opts : public spsolve_opts_base
+  {
+  typedef enum {NATURAL, MIN_DEGREE} permutation_type;
+  
+  bool             allow_ugly;
+  permutation_type permutation;
+  
+  inline spchol_opts()
+    : spsolve_opts_base(2)
+    {
+    allow_ugly  = false;
+    permutation = MIN_DEGREE;
+    }
+  };
+
+
 //! @}
 
 
@@ -483,4 +519,21 @@ struct eigs_opts
   };
 
 
+struct iter_opts
+  {
+  double       tol;         // relative residual tolerance
+  unsigned int max_iter;    // max iterations
+  unsigned int restart;     // gmres(): number of iterations between restarts
+  bool         warm_start;  // use the given x as the initial guess
+  
+  inline iter_opts()
+    {
+    tol        = 1e-6;
+    max_iter   = 1000;
+    restart    = 30;
+    warm_start = false;
+    }
+  };
+
+
 //! @}
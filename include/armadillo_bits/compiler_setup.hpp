@@ -108,6 +108,18 @@
   #define ARMA_HAVE_POSIX_MEMALIGN
 #endif
 
+// mmap() is part of IEEE standard 1003.1; it is used by mapped_mat and mapped_cube
+#if ( defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0) )
+  #undef  ARMA_HAVE_POSIX_MMAP
+  #define ARMA_HAVE_POSIX_MMAP
+#endif
+
+// std::to_chars() for floating point types is part of C++17; it is used by diskio when saving text
+#if ( defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L) )
+  #undef  ARMA_HAVE_TO_CHARS
+  #define ARMA_HAVE_TO_CHARS
+#endif
+
 
 #if defined(__APPLE__) || defined(__apple_build_version__)
   #undef  ARMA_BLAS_SDOT_BUG
@@ -120,6 +132,7 @@
 
 #if defined(__MINGW32__) || defined(__CYGWIN__) || defined(_MSC_VER)
   #undef ARMA_HAVE_POSIX_MEMALIGN
+  #undef ARMA_HAVE_POSIX_MMAP
 #endif
 
 
@@ -409,6 +422,22 @@
 
 
 
+// vector instruction sets used by the micro-kernels of the gemm() emulation (see mul_gemm_kernel.hpp)
+#if !defined(ARMA_DONT_USE_SIMD)
+  #if defined(__AVX512F__)
+    #undef  ARMA_HAVE_AVX512
+    #define ARMA_HAVE_AVX512
+  #elif defined(__AVX2__) && defined(__FMA__)
+    #undef  ARMA_HAVE_AVX2
+    #define ARMA_HAVE_AVX2
+  #elif defined(__aarch64__) && defined(__ARM_NEON)
+    #undef  ARMA_HAVE_NEON
+    #define ARMA_HAVE_NEON
+  #endif
+#endif
+
+
+
 // cleanup
 
 #undef ARMA_DETECTED_FAKE_GCC
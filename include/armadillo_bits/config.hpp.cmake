@@ -87,6 +87,10 @@
 //// For each char argument, the corresponding "hidden" argument specifies the number of characters.
 //// These "hidden" arguments are typically tacked onto the end of function definitions.
 
+// #define ARMA_USE_POOL_ALLOC
+//// Uncomment the above line if you want to use a thread-caching pool of memory blocks instead of standard malloc() and free();
+//// this reduces the cost of repeatedly allocating and freeing temporary matrices
+
 // #define ARMA_USE_TBB_ALLOC
 //// Uncomment the above line if you want to use Intel TBB scalable_malloc() and scalable_free() instead of standard malloc() and free()
 
@@ -153,6 +157,16 @@
 //// If you mainly use lots of very small vectors (eg. <= 4 elements),
 //// change the number to the size of your vectors.
 
+#if !defined(ARMA_MEM_ALIGN)
+  #define ARMA_MEM_ALIGN 32
+#endif
+//// The alignment (in bytes) of memory used by matrices and cubes that occupy at least 1024 bytes;
+//// it must be a power of 2 between 16 and 4096.
+//// Use 64 to align to cache lines (eg. for AVX-512).
+
+// #define ARMA_MEM_ALIGN_PAGE
+//// Uncomment the above line to align memory blocks of at least 256 kB to page boundaries (4096 bytes).
+
 #if !defined(ARMA_OPENMP_THRESHOLD)
   #define ARMA_OPENMP_THRESHOLD 240
 #endif
@@ -165,6 +179,11 @@
 //// The maximum number of threads to use for OpenMP based parallelisation;
 //// it must be an integer that is at least 1.
 
+// #define ARMA_OPENMP_FIRST_TOUCH
+//// Uncomment the above line to have the memory of large matrices and cubes (at least 2 MB)
+//// first touched in parallel by the OpenMP threads, so that on NUMA systems
+//// each page is placed on the node of the thread that later processes it.
+
 // #define ARMA_NO_DEBUG
 //// Uncomment the above line if you want to disable all run-time checks.
 //// This will result in faster code, but you first need to make sure that your code runs correctly!
@@ -251,6 +270,11 @@
   //// Uncomment the above line to disable use of std::mutex
 #endif
 
+#if !defined(ARMA_DONT_USE_SIMD)
+  // #define ARMA_DONT_USE_SIMD
+  //// Uncomment the above line to disable use of AVX2, AVX-512 and NEON intrinsics in the gemm() emulation
+#endif
+
 // for compatibility with earlier versions of Armadillo
 #if defined(ARMA_DONT_USE_CXX11_MUTEX)
   #pragma message ("WARNING: support for ARMA_DONT_USE_CXX11_MUTEX is deprecated and will be removed;")
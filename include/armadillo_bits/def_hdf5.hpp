@@ -38,6 +38,7 @@
   #define arma_H5Sget_simple_extent_dims    H5Sget_simple_extent_dims
   #define arma_H5Sclose                     H5Sclose
   #define arma_H5Screate_simple             H5Screate_simple
+  #define arma_H5Sselect_hyperslab          H5Sselect_hyperslab
 
   #define arma_H5Ovisit     H5Ovisit
 
@@ -94,6 +95,7 @@ extern "C"
   int    arma_H5Sget_simple_extent_dims(hid_t space_id, hsize_t* dims, hsize_t* maxdims);
   herr_t arma_H5Sclose(hid_t space_id);
   hid_t  arma_H5Screate_simple(int rank, const hsize_t* current_dims, const hsize_t* maximum_dims);
+  herr_t arma_H5Sselect_hyperslab(hid_t space_id, H5S_seloper_t op, const hsize_t* start, const hsize_t* stride, const hsize_t* count, const hsize_t* block);
   
   herr_t arma_H5Ovisit(hid_t object_id, H5_index_t index_type, H5_iter_order_t order, H5O_iterate_t op, void* op_data);
   
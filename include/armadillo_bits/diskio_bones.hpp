@@ -33,6 +33,10 @@ class diskio
   template<typename eT> friend class SpMat;
   template<typename oT> friend class field;
   
+  template<typename eT> friend class mapped_mat;
+  template<typename eT> friend class mapped_cube;
+  template<typename eT> friend class mat_reader;
+  
   friend class   Mat_aux;
   friend class  Cube_aux;
   friend class SpMat_aux;
@@ -46,6 +50,10 @@ class diskio
   template<typename eT> inline arma_cold static std::string gen_txt_header(const Cube<eT>&);
   template<typename eT> inline arma_cold static std::string gen_bin_header(const Cube<eT>&);
   
+  static constexpr uword bin_data_align = 64;  //!< alignment of the data in files saved in arma_binary format, relative to the start of the header
+  
+  inline static void save_bin_header(std::ostream& f, const std::string& header, const std::string& dims);
+  
   inline arma_cold static file_type guess_file_type_internal(std::istream& f);
   
   inline arma_cold static std::string gen_tmp_name(const std::string& x);
@@ -53,8 +61,34 @@ class diskio
   inline arma_cold static bool safe_rename(const std::string& old_name, const std::string& new_name);
   
   template<typename eT> inline static bool convert_token(eT&              val, const std::string& token);
+  template<typename eT> inline static bool convert_token(eT&              val, const char* str, const size_t N);
   template<typename  T> inline static bool convert_token(std::complex<T>& val, const std::string& token);
   
+  template<typename eT> inline static bool convert_chars(eT&              val, const char* str, const size_t N);
+  template<typename  T> inline static bool convert_chars(std::complex<T>& val, const char* str, const size_t N);
+  
+  inline static bool convert_wide(double& out, const u64 mant, const int exp10);
+  
+  static constexpr size_t text_mp_threshold = size_t(1) << 20;  //!< minimum number of bytes for parsing text in parallel
+  
+  inline static void read_text(std::vector<char>& buf, std::istream& f);
+  
+  inline static void count_fields(uword& n_min, uword& n_max, const char* mem, const size_t n_bytes, const bool is_csv);
+  
+  template<typename eT> inline static bool parse_lines(Mat<eT>& x, const uword row_start, const char* mem, const size_t n_bytes, const bool is_csv);
+  template<typename eT> inline static bool parse_text (Mat<eT>& x, const char* mem, const size_t n_bytes, const bool is_csv, std::string& err_msg);
+  
+  static constexpr size_t text_elem_chars  = 64;                 //!< upper limit on the number of characters written for one element of text
+  static constexpr size_t text_block_bytes = size_t(1) << 20;    //!< approximate size of the blocks of text formatted before writing
+  
+  inline static char* format_real(char* out, const double val);
+  
+  template<typename eT> inline static char* format_elem(char* out, const eT&              val);
+  template<typename  T> inline static char* format_elem(char* out, const std::complex<T>& val);
+  
+  template<typename eT> inline static char* format_lines(char* out, const eT* mem, const uword n_rows, const uword n_cols, const uword row_start, const uword row_end, const uword col_start, const uword col_end, const bool is_csv);
+  template<typename eT> inline static bool  write_text  (std::ostream& f, const eT* mem, const uword n_rows, const uword n_cols, const bool is_csv);
+  
   template<typename eT> inline static std::streamsize prepare_stream(std::ostream& f);
   
   
@@ -206,8 +240,71 @@ class diskio
   template<typename T1> inline static bool load_ppm_binary(      field<T1>& x, const std::string&  final_name, std::string& err_msg);
   template<typename T1> inline static bool load_ppm_binary(      field<T1>& x,       std::istream& f,          std::string& err_msg);
   
-
-
+  
+  //
+  // handling of NumPy .npy files by matrices and cubes, and .npz archives by fields
+  
+  struct npy_info
+    {
+    std::string        descr;                //!< type code without the byte order character (eg. "f8")
+    bool               native_order  = true;  //!< false if the byte order differs from the byte order of this machine
+    bool               fortran_order = false;
+    std::vector<uword> shape;
+    size_t             offset        = 0;     //!< position of the data, relative to the start of the .npy file
+    };
+  
+  struct npz_entry
+    {
+    std::string name;
+    u32         method  = 0;  //!< compression method; 0 indicates no compression
+    u32         crc     = 0;
+    size_t      offset  = 0;  //!< position of the stored .npy file, relative to the start of the archive
+    size_t      n_bytes = 0;
+    };
+  
+  inline static char npy_byte_order();
+  
+  template<typename eT> inline static std::string gen_npy_descr();
+  
+  template<typename eT> inline static std::string gen_npy_header(const Mat<eT>&  x);
+  template<typename eT> inline static std::string gen_npy_header(const Cube<eT>& x);
+  template<typename eT> inline static std::string gen_npy_header(const uword n_rows, const uword n_cols, const uword n_slices, const uword n_dims);
+  
+  inline static bool parse_npy_header(npy_info& info, const char* mem, const size_t n_bytes);
+  inline static bool read_npy        (std::vector<char>& buf, std::istream& f);
+  inline static bool npy_dims        (uword& n_rows, uword& n_cols, uword& n_slices, const npy_info& info, const uword n_dims_max, const bool is_row);
+  inline static bool npy_is_colmajor (const npy_info& info);
+  
+  template<typename eT> inline static bool convert_npy(eT* out, const std::string& descr, const char* data, const uword n_elem);
+  
+  template<typename eT, typename in_eT> inline static void convert_npy_block(eT* out, const in_eT*              in, const uword n_elem);
+  template<typename eT, typename in_T > inline static void convert_npy_block(eT* out, const std::complex<in_T>* in, const uword n_elem);
+  
+  template<typename eT> inline static bool load_npy_data(eT* out, const npy_info& info, const char* mem, const size_t n_bytes, const uword n_rows, const uword n_cols, const uword n_slices, std::string& err_msg);
+  
+  template<typename eT> inline static bool save_npy_binary(const Mat<eT>&  x, const std::string& final_name);
+  template<typename eT> inline static bool save_npy_binary(const Mat<eT>&  x,       std::ostream& f);
+  template<typename eT> inline static bool save_npy_binary(const Cube<eT>& x, const std::string& final_name);
+  template<typename eT> inline static bool save_npy_binary(const Cube<eT>& x,       std::ostream& f);
+  
+  template<typename eT> inline static bool load_npy_binary(Mat<eT>&  x, const std::string& name, std::string& err_msg);
+  template<typename eT> inline static bool load_npy_binary(Mat<eT>&  x,       std::istream& f,    std::string& err_msg);
+  template<typename eT> inline static bool load_npy_binary(Mat<eT>&  x, const char* mem, const size_t n_bytes, std::string& err_msg);
+  template<typename eT> inline static bool load_npy_binary(Cube<eT>& x, const std::string& name, std::string& err_msg);
+  template<typename eT> inline static bool load_npy_binary(Cube<eT>& x,       std::istream& f,    std::string& err_msg);
+  template<typename eT> inline static bool load_npy_binary(Cube<eT>& x, const char* mem, const size_t n_bytes, std::string& err_msg);
+  
+  inline static u32  zip_crc32(const char* mem, const size_t n_bytes, const u32 crc = 0);
+  inline static void zip_put  (std::string& out, const u64 val, const uword n_bytes);
+  inline static u64  zip_get  (const char* mem, const uword n_bytes);
+  inline static bool parse_npz(std::vector<npz_entry>& entries, const char* mem, const size_t n_bytes);
+  
+  template<typename T1> inline static bool save_npy_binary(const field<T1>& x, const std::string& final_name);
+  template<typename T1> inline static bool save_npy_binary(const field<T1>& x,       std::ostream& f);
+  
+  template<typename T1> inline static bool load_npy_binary(      field<T1>& x, const std::string& name, std::string& err_msg);
+  template<typename T1> inline static bool load_npy_binary(      field<T1>& x,       std::istream& f,    std::string& err_msg);
+  template<typename T1> inline static bool load_npy_binary(      field<T1>& x, const char* mem, const size_t n_bytes, std::string& err_msg);
   };
 
 
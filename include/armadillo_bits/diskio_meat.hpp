@@ -267,6 +267,27 @@ diskio::gen_bin_header(const Cube<eT>&)
 
 
 
+//! write the header and dimensions of the arma_binary format;
+//! the dimensions are preceded by spaces so that the data starts at a multiple of bin_data_align bytes,
+//! which allows mapped_mat and mapped_cube to use the data in place;
+//! the spaces are skipped by readers of the format, including older versions
+inline
+void
+diskio::save_bin_header(std::ostream& f, const std::string& header, const std::string& dims)
+  {
+  arma_extra_debug_sigprint();
+  
+  const std::streamoff start = f.tellp();
+  
+  const uword n_used = uword( (start > 0) ? start : 0 ) + uword(header.length() + 1 + dims.length() + 1);
+  const uword n_pad  = (bin_data_align - (n_used % bin_data_align)) % bin_data_align;
+  
+  f << header << '\n';
+  f << std::string(n_pad, ' ') << dims << '\n';
+  }
+
+
+
 inline
 arma_deprecated
 file_type
@@ -407,12 +428,19 @@ inline
 bool
 diskio::convert_token(eT& val, const std::string& token)
   {
-  const size_t N = size_t(token.length());
-  
+  return diskio::convert_token(val, token.c_str(), size_t(token.length()));
+  }
+
+
+
+//! str must be terminated by a null character
+template<typename eT>
+inline
+bool
+diskio::convert_token(eT& val, const char* str, const size_t N)
+  {
   if(N == 0)  { val = eT(0); return true; }
   
-  const char* str = token.c_str();
-  
   if( (N == 3) || (N == 4) )
     {
     const bool neg = (str[0] == '-');
@@ -544,1252 +572,2820 @@ diskio::convert_token(std::complex<T>& val, const std::string& token)
 
 
 
+//! Convert the characters str[0] to str[N-1] into a number.
+//! Plain decimal numbers with at most 19 significant digits are converted directly when the conversion is exact
+//! (a mantissa below 2^53 and a power of 10 within 1e22, or via convert_wide()),
+//! giving the same result as strtod() and strtoll(); all other tokens are passed to convert_token()
 template<typename eT>
 inline
-std::streamsize
-diskio::prepare_stream(std::ostream& f)
+bool
+diskio::convert_chars(eT& val, const char* str, const size_t N)
   {
-  std::streamsize cell_width = f.width();
+  const char* ptr = str;
+  const char* end = str + N;
   
-  if(is_real<eT>::value)
+  while( (ptr < end) && ((*ptr    == ' ') || (*ptr    == '\t')                     ) )  { ++ptr; }
+  while( (ptr < end) && ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r')) )  { --end; }
+  
+  const bool neg = (ptr < end) && (*ptr == '-');
+  
+  if( (ptr < end) && ((*ptr == '-') || (*ptr == '+')) )  { ++ptr; }
+  
+  u64   mant  = 0;
+  uword n_sig = 0;
+  int   exp10 = 0;
+  
+  bool found = false;
+  bool fast  = true;
+  
+  for(; (ptr < end) && (*ptr >= '0') && (*ptr <= '9'); ++ptr)
     {
-    f.unsetf(ios::fixed);
-    f.setf(ios::scientific);
-    f.fill(' ');
+    found = true;
     
-    f.precision(16);
-    cell_width = 24;
+    if( (mant == 0) && (*ptr == '0') )  { continue; }
     
-    // NOTE: for 'float' the optimum settings are f.precision(8) and cell_width = 15
-    // NOTE: however, to avoid introducing errors in case single precision data is loaded as double precision,
-    // NOTE: the same settings must be used for both 'float' and 'double'
+    if(n_sig >= 19)  { fast = false; break; }
+    
+    mant = mant*10 + u64(*ptr - '0');
+    ++n_sig;
     }
-  else
-  if(is_cx<eT>::value)
+  
+  if(is_real<eT>::value && fast)
     {
-    f.unsetf(ios::fixed);
-    f.setf(ios::scientific);
+    if( (ptr < end) && (*ptr == '.') )
+      {
+      for(++ptr; (ptr < end) && (*ptr >= '0') && (*ptr <= '9'); ++ptr)
+        {
+        found = true;
+        
+        if( (mant == 0) && (*ptr == '0') )  { --exp10; continue; }
+        
+        if(n_sig >= 19)  { fast = false; break; }
+        
+        mant = mant*10 + u64(*ptr - '0');
+        ++n_sig;
+        --exp10;
+        }
+      }
     
-    f.precision(16);
+    if( fast && found && (ptr < end) && ((*ptr == 'e') || (*ptr == 'E')) )
+      {
+      ++ptr;
+      
+      const bool exp_neg = (ptr < end) && (*ptr == '-');
+      
+      if( (ptr < end) && ((*ptr == '-') || (*ptr == '+')) )  { ++ptr; }
+      
+      int   exp_val = 0;
+      uword exp_n   = 0;
+      
+      for(; (ptr < end) && (*ptr >= '0') && (*ptr <= '9'); ++ptr)
+        {
+        if(exp_n >= 4)  { fast = false; break; }
+        
+        exp_val = exp_val*10 + int(*ptr - '0');
+        ++exp_n;
+        }
+      
+      if(exp_n == 0)  { fast = false; }
+      
+      exp10 += (exp_neg) ? -exp_val : exp_val;
+      }
     }
   
-  return cell_width;
-  }
-  
-
-
-
-//! Save a matrix as raw text (no header, human readable).
-//! Matrices can be loaded in Matlab and Octave, as long as they don't have complex elements.
-template<typename eT>
-inline
-bool
-diskio::save_raw_ascii(const Mat<eT>& x, const std::string& final_name)
-  {
-  arma_extra_debug_sigprint();
-  
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::fstream f(tmp_name.c_str(), std::fstream::out);
+  if( fast && found && (ptr == end) )
+    {
+    if(is_real<eT>::value)
+      {
+      static const double pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+      
+      if( (mant <= (u64(1) << 53)) && (exp10 >= -22) && (exp10 <= 22) )
+        {
+        const double tmp = (exp10 < 0) ? (double(mant) / pow10[-exp10]) : (double(mant) * pow10[exp10]);
+        
+        val = eT( (neg) ? -tmp : tmp );
+        
+        return true;
+        }
+      
+      double tmp = 0.0;
+      
+      if(diskio::convert_wide(tmp, mant, exp10))
+        {
+        val = eT( (neg) ? -tmp : tmp );
+        
+        return true;
+        }
+      }
+    else
+    if(n_sig <= 18)
+      {
+      if(neg == false)          { val = eT(mant);          return true; }
+      if(is_signed<eT>::value)  { val = eT( -(s64(mant)) ); return true; }
+      
+      // unsigned integer
+      if(str[0] == '-')         { val = eT(0);             return true; }
+      }
+    }
   
-  bool save_okay = f.is_open();
+  // avoid memory allocation for short tokens
   
-  if(save_okay)
+  if(N < 64)
     {
-    save_okay = diskio::save_raw_ascii(x, f);
+    char buf[64];
     
-    f.flush();
-    f.close();
+    std::memcpy(buf, str, N);
     
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    buf[N] = char(0);
+    
+    return diskio::convert_token(val, buf, N);
     }
   
-  return save_okay;
+  return diskio::convert_token(val, std::string(str, N));
   }
 
 
 
-//! Save a matrix as raw text (no header, human readable).
-//! Matrices can be loaded in Matlab and Octave, as long as they don't have complex elements.
-template<typename eT>
+//! Exact conversion of mant * 10^exp10 into the nearest double, for mantissas with more than 53 bits;
+//! the product or quotient with 5^|exp10| is formed with 128 bit integers and rounded to nearest (ties to even).
+//! returns false if 128 bit integers are not available or |exp10| > 27, as 5^27 is the largest power of 5 below 2^64
 inline
 bool
-diskio::save_raw_ascii(const Mat<eT>& x, std::ostream& f)
+diskio::convert_wide(double& out, const u64 mant, const int exp10)
   {
-  arma_extra_debug_sigprint();
-  
-  const arma_ostream_state stream_state(f);
-  
-  const std::streamsize cell_width = diskio::prepare_stream<eT>(f);
-  
-  for(uword row=0; row < x.n_rows; ++row)
+  #if defined(__SIZEOF_INT128__)
     {
-    for(uword col=0; col < x.n_cols; ++col)
+    __extension__ typedef unsigned __int128 u128;
+    
+    if( (mant == 0) || (exp10 < -27) || (exp10 > 27) )  { return false; }
+    
+    static const u64 pow5_table[] = {                   1ULL,                   5ULL,                  25ULL,                 125ULL,
+                                                      625ULL,                3125ULL,               15625ULL,               78125ULL,
+                                                   390625ULL,             1953125ULL,             9765625ULL,            48828125ULL,
+                                                244140625ULL,          1220703125ULL,          6103515625ULL,         30517578125ULL,
+                                             152587890625ULL,        762939453125ULL,       3814697265625ULL,      19073486328125ULL,
+                                           95367431640625ULL,     476837158203125ULL,    2384185791015625ULL,   11920928955078125ULL,
+                                        59604644775390625ULL,  298023223876953125ULL, 1490116119384765625ULL, 7450580596923828125ULL };
+    
+    const u64 pow5 = pow5_table[ (exp10 < 0) ? -exp10 : exp10 ];
+    
+    u128 q       = 0;
+    bool sticky  = false;
+    int  bin_exp = 0;
+    
+    if(exp10 >= 0)
       {
-      f.put(' ');
+      // mant * 10^exp10 = (mant * 5^exp10) * 2^exp10
       
-      if(is_real<eT>::value)  { f.width(cell_width); }
+      q       = u128(mant) * u128(pow5);
+      bin_exp = exp10;
+      }
+    else
+      {
+      // the mantissa is normalised so that the quotient has at least 64 significant bits
       
-      arma_ostream::raw_print_elem(f, x.at(row,col));
+      const int n_shift = __builtin_clzll(mant);
+      
+      const u128 num = u128(mant << n_shift) << 64;
+      
+      q       = num / u128(pow5);
+      sticky  = ( (num % u128(pow5)) != 0 );
+      bin_exp = exp10 - n_shift - 64;
       }
     
-    f.put('\n');
+    const u64 q_hi = u64(q >> 64);
+    const u64 q_lo = u64(q);
+    
+    const int n_bits = (q_hi != 0) ? (128 - __builtin_clzll(q_hi)) : (64 - __builtin_clzll(q_lo));
+    
+    if(n_bits <= 53)  { out = std::ldexp(double(q_lo), bin_exp); return true; }
+    
+    const int  shift = n_bits - 53;
+    const u128 rem   = q & ((u128(1) << shift) - 1);
+    const u128 half  = u128(1) << (shift - 1);
+    
+    u64 r = u64(q >> shift);
+    
+    if( (rem > half) || ((rem == half) && (sticky || ((r & 1) != 0))) )  { ++r; }
+    
+    out = std::ldexp(double(r), bin_exp + shift);
+    
+    return true;
     }
-  
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
-  }
-
-
-
-//! Save a matrix as raw binary (no header)
-template<typename eT>
-inline
-bool
-diskio::save_raw_binary(const Mat<eT>& x, const std::string& final_name)
-  {
-  arma_extra_debug_sigprint();
-  
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
-  
-  bool save_okay = f.is_open();
-  
-  if(save_okay)
+  #else
     {
-    save_okay = diskio::save_raw_binary(x, f);
-    
-    f.flush();
-    f.close();
+    arma_ignore(out);
+    arma_ignore(mant);
+    arma_ignore(exp10);
     
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    return false;
     }
-  
-  return save_okay;
+  #endif
   }
 
 
 
-template<typename eT>
+template<typename T>
 inline
 bool
-diskio::save_raw_binary(const Mat<eT>& x, std::ostream& f)
+diskio::convert_chars(std::complex<T>& val, const char* str, const size_t N)
   {
-  arma_extra_debug_sigprint();
-  
-  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
-  
-  return f.good();
+  return diskio::convert_token(val, std::string(str, N));
   }
 
 
 
-//! Save a matrix in text format (human readable),
-//! with a header that indicates the matrix type as well as its dimensions
-template<typename eT>
+//! Read all remaining characters from a stream
 inline
-bool
-diskio::save_arma_ascii(const Mat<eT>& x, const std::string& final_name)
+void
+diskio::read_text(std::vector<char>& buf, std::istream& f)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::ofstream f(tmp_name.c_str());
+  buf.clear();
   
-  bool save_okay = f.is_open();
+  const std::streampos pos1 = f.tellg();
   
-  if(save_okay)
+  if(pos1 >= 0)
     {
-    save_okay = diskio::save_arma_ascii(x, f);
+    f.seekg(0, ios::end);
     
-    f.flush();
-    f.close();
+    const std::streampos pos2 = f.tellg();
     
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    if(pos2 > pos1)  { buf.reserve( size_t(pos2 - pos1) ); }
+    
+    f.clear();
+    f.seekg(pos1);
     }
   
-  return save_okay;
+  const size_t n_block = size_t(1) << 20;
+  
+  while(f.good())
+    {
+    const size_t n_old = buf.size();
+    
+    buf.resize(n_old + n_block);
+    
+    f.read( &(buf[n_old]), std::streamsize(n_block) );
+    
+    buf.resize( n_old + size_t(f.gcount()) );
+    }
   }
 
 
 
-//! Save a matrix in text format (human readable),
-//! with a header that indicates the matrix type as well as its dimensions
-template<typename eT>
+//! Find the smallest and largest number of fields in the lines of the given text;
+//! fields are separated by commas (CSV format) or by whitespace (raw_ascii format)
 inline
-bool
-diskio::save_arma_ascii(const Mat<eT>& x, std::ostream& f)
+void
+diskio::count_fields(uword& n_min, uword& n_max, const char* mem, const size_t n_bytes, const bool is_csv)
   {
-  arma_extra_debug_sigprint();
+  n_min = 0;
+  n_max = 0;
   
-  const arma_ostream_state stream_state(f);
-  
-  f << diskio::gen_txt_header(x) << '\n';
-  f << x.n_rows << ' ' << x.n_cols << '\n';
+  const char* ptr = mem;
+  const char* end = mem + n_bytes;
   
-  const std::streamsize cell_width = diskio::prepare_stream<eT>(f);
+  bool first = true;
   
-  for(uword row=0; row < x.n_rows; ++row)
+  while(ptr < end)
     {
-    for(uword col=0; col < x.n_cols; ++col)
+    const char* line_end = (const char*)( std::memchr(ptr, '\n', size_t(end - ptr)) );
+    
+    if(line_end == nullptr)  { line_end = end; }
+    
+    uword n_fields = 0;
+    
+    if(is_csv)
       {
-      f.put(' ');
-      
-      if(is_real<eT>::value)  { f.width(cell_width); }
+      n_fields = 1 + uword( std::count(ptr, line_end, ',') );
+      }
+    else
+      {
+      bool in_token = false;
       
-      arma_ostream::raw_print_elem(f, x.at(row,col));
+      for(const char* p = ptr; p < line_end; ++p)
+        {
+        const char c = *p;
+        
+        const bool is_space = (c == ' ') || (c == '\t') || (c == '\r') || (c == '\v') || (c == '\f');
+        
+        if( (is_space == false) && (in_token == false) )  { ++n_fields; }
+        
+        in_token = (is_space == false);
+        }
       }
     
-    f.put('\n');
+    n_min = (first) ? n_fields : (std::min)(n_min, n_fields);
+    n_max = (first) ? n_fields : (std::max)(n_max, n_fields);
+    
+    first = false;
+    
+    ptr = (line_end < end) ? (line_end + 1) : end;
     }
-  
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
   }
 
 
 
-//! Save a matrix in CSV text format (human readable)
+//! Convert the fields in the lines of the given text, starting at row row_start of x;
+//! returns false if a field in raw_ascii format couldn't be interpreted
 template<typename eT>
 inline
 bool
-diskio::save_csv_ascii(const Mat<eT>& x, const std::string& final_name, const field<std::string>& header, const bool with_header)
+diskio::parse_lines(Mat<eT>& x, const uword row_start, const char* mem, const size_t n_bytes, const bool is_csv)
   {
-  arma_extra_debug_sigprint();
+  bool status = true;
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  const char* ptr = mem;
+  const char* end = mem + n_bytes;
   
-  std::ofstream f(tmp_name.c_str());
+  uword row = row_start;
   
-  bool save_okay = f.is_open();
-  
-  if(save_okay == false)  { return false; }
-  
-  if(with_header)
+  while(ptr < end)
     {
-    arma_extra_debug_print("diskio::save_csv_ascii(): writing header");
+    const char* line_end = (const char*)( std::memchr(ptr, '\n', size_t(end - ptr)) );
     
-    for(uword i=0; i < header.n_elem; ++i)
+    if(line_end == nullptr)  { line_end = end; }
+    
+    uword col = 0;
+    
+    if(is_csv)
       {
-      f << header.at(i);
+      const char* field = ptr;
       
-      if(i != (header.n_elem-1))  { f.put(','); }
+      while(true)
+        {
+        const char* field_end = (const char*)( std::memchr(field, ',', size_t(line_end - field)) );
+        
+        if(field_end == nullptr)  { field_end = line_end; }
+        
+        // as in the conversion of CSV files via streams, fields that can't be interpreted are ignored
+        diskio::convert_chars( x.at(row,col), field, size_t(field_end - field) );
+        
+        ++col;
+        
+        if(field_end == line_end)  { break; }
+        
+        field = field_end + 1;
+        }
+      }
+    else
+      {
+      const char* p = ptr;
+      
+      while(p < line_end)
+        {
+        while( (p < line_end) && ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\v') || (*p == '\f')) )  { ++p; }
+        
+        if(p == line_end)  { break; }
+        
+        const char* token = p;
+        
+        while( (p < line_end) && (*p != ' ') && (*p != '\t') && (*p != '\r') && (*p != '\v') && (*p != '\f') )  { ++p; }
+        
+        if(diskio::convert_chars( x.at(row,col), token, size_t(p - token) ) == false)  { status = false; }
+        
+        ++col;
+        }
       }
     
-    f.put('\n');
+    ++row;
     
-    save_okay = f.good();
+    ptr = (line_end < end) ? (line_end + 1) : end;
     }
   
-  if(save_okay)  { save_okay = diskio::save_csv_ascii(x, f); }
-  
-  f.flush();
-  f.close();
-  
-  if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
-  
-  return save_okay;
+  return status;
   }
 
 
 
-//! Save a matrix in CSV text format (human readable)
+//! Load a matrix from text in CSV or raw_ascii format held in memory.
+//! Lines are used up to the first empty line, as in the conversion of text via streams.
+//! The lines are split into chunks of roughly equal size, which are converted in parallel if OpenMP is enabled;
+//! the elements are written directly into the matrix.
 template<typename eT>
 inline
 bool
-diskio::save_csv_ascii(const Mat<eT>& x, std::ostream& f)
+diskio::parse_text(Mat<eT>& x, const char* mem, const size_t n_bytes, const bool is_csv, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const arma_ostream_state stream_state(f);
+  uword n_chunks = 1;
   
-  diskio::prepare_stream<eT>(f);
+  #if defined(ARMA_USE_OPENMP)
+    {
+    if( (n_bytes >= text_mp_threshold) && (mp_thread_limit::in_parallel() == false) )
+      {
+      n_chunks = uword( (std::max)(int(1), mp_thread_limit::get()) );
+      }
+    }
+  #endif
   
-  uword x_n_rows = x.n_rows;
-  uword x_n_cols = x.n_cols;
+  // find the lines and the start of each chunk;
+  // memchr() is typically implemented with SIMD instructions
   
-  for(uword row=0; row < x_n_rows; ++row)
+  std::vector<size_t> chunk_start(n_chunks+1, size_t(0));
+  std::vector<uword>  chunk_row  (n_chunks+1, uword(0) );
+  
+  const char* ptr = mem;
+  const char* end = mem + n_bytes;
+  
+  uword n_rows  = 0;
+  uword chunk_i = 1;
+  
+  while( (ptr < end) && (*ptr != '\n') )
     {
-    for(uword col=0; col < x_n_cols; ++col)
+    const size_t pos = size_t(ptr - mem);
+    
+    if( (chunk_i < n_chunks) && (pos >= (n_bytes / n_chunks) * chunk_i) )
       {
-      arma_ostream::raw_print_elem(f, x.at(row,col));
+      chunk_start[chunk_i] = pos;
+      chunk_row  [chunk_i] = n_rows;
       
-      if( col < (x_n_cols-1) )  { f.put(','); }
+      ++chunk_i;
       }
     
-    f.put('\n');
+    ++n_rows;
+    
+    const char* line_end = (const char*)( std::memchr(ptr, '\n', size_t(end - ptr)) );
+    
+    ptr = (line_end != nullptr) ? (line_end + 1) : end;
     }
   
-  const bool save_okay = f.good();
+  for(; chunk_i <= n_chunks; ++chunk_i)
+    {
+    chunk_start[chunk_i] = size_t(ptr - mem);
+    chunk_row  [chunk_i] = n_rows;
+    }
   
-  stream_state.restore(f);
+  // work out the size
   
-  return save_okay;
+  std::vector<uword> chunk_min(n_chunks, uword(0));
+  std::vector<uword> chunk_max(n_chunks, uword(0));
+  
+  #if defined(ARMA_USE_OPENMP)
+    {
+    const int n_threads = int(n_chunks);
+    
+    #pragma omp parallel for schedule(static) num_threads(n_threads)
+    for(uword c=0; c < n_chunks; ++c)
+      {
+      diskio::count_fields(chunk_min[c], chunk_max[c], mem + chunk_start[c], chunk_start[c+1] - chunk_start[c], is_csv);
+      }
+    }
+  #else
+    {
+    for(uword c=0; c < n_chunks; ++c)
+      {
+      diskio::count_fields(chunk_min[c], chunk_max[c], mem + chunk_start[c], chunk_start[c+1] - chunk_start[c], is_csv);
+      }
+    }
+  #endif
+  
+  uword n_cols_min = 0;
+  uword n_cols_max = 0;
+  
+  bool first = true;
+  
+  for(uword c=0; c < n_chunks; ++c)
+    {
+    if(chunk_row[c+1] == chunk_row[c])  { continue; }
+    
+    n_cols_min = (first) ? chunk_min[c] : (std::min)(n_cols_min, chunk_min[c]);
+    n_cols_max = (first) ? chunk_max[c] : (std::max)(n_cols_max, chunk_max[c]);
+    
+    first = false;
+    }
+  
+  if(is_csv)
+    {
+    x.zeros(n_rows, n_cols_max);
+    }
+  else
+    {
+    // an empty file indicates an empty matrix
+    if(n_rows == 0)  { x.reset(); return true; }
+    
+    if(n_cols_min != n_cols_max)  { err_msg = "inconsistent number of columns in "; return false; }
+    
+    x.set_size(n_rows, n_cols_max);
+    }
+  
+  // convert the fields
+  
+  std::vector<uword> chunk_status(n_chunks, uword(1));
+  
+  #if defined(ARMA_USE_OPENMP)
+    {
+    const int n_threads = int(n_chunks);
+    
+    #pragma omp parallel for schedule(static) num_threads(n_threads)
+    for(uword c=0; c < n_chunks; ++c)
+      {
+      chunk_status[c] = diskio::parse_lines(x, chunk_row[c], mem + chunk_start[c], chunk_start[c+1] - chunk_start[c], is_csv) ? 1 : 0;
+      }
+    }
+  #else
+    {
+    for(uword c=0; c < n_chunks; ++c)
+      {
+      chunk_status[c] = diskio::parse_lines(x, chunk_row[c], mem + chunk_start[c], chunk_start[c+1] - chunk_start[c], is_csv) ? 1 : 0;
+      }
+    }
+  #endif
+  
+  const bool load_okay = ( std::count(chunk_status.begin(), chunk_status.end(), uword(0)) == 0 );
+  
+  if(load_okay == false)  { err_msg = "couldn't interpret data in "; }
+  
+  return load_okay;
   }
 
 
 
-//! Save a matrix in CSV text format (human readable); complex numbers stored in "a+bi" format
-template<typename T>
+//! Write a number as text, in the same form as stream based output (scientific notation, "inf", "-inf", "nan").
+//! If std::to_chars() is available, the shortest representation that converts back to the same value is used;
+//! otherwise 17 significant digits are used, which is also sufficient for exact conversion back.
+//! The output always uses '.' as the radix character, independent of the current locale.
+//! out must have room for at least 32 characters.
 inline
-bool
-diskio::save_csv_ascii(const Mat< std::complex<T> >& x, std::ostream& f)
+char*
+diskio::format_real(char* out, const double val)
   {
-  arma_extra_debug_sigprint();
-  
-  typedef typename std::complex<T> eT;
-  
-  const arma_ostream_state stream_state(f);
-  
-  diskio::prepare_stream<eT>(f);
-  
-  uword x_n_rows = x.n_rows;
-  uword x_n_cols = x.n_cols;
+  if(arma_isfinite(val) == false)
+    {
+    const char* str = arma_isinf(val) ? ((val <= double(0)) ? "-inf" : "inf") : "nan";
+    
+    const size_t n = std::strlen(str);
+    
+    std::memcpy(out, str, n);
+    
+    return out + n;
+    }
   
-  for(uword row=0; row < x_n_rows; ++row)
+  #if defined(ARMA_HAVE_TO_CHARS)
     {
-    for(uword col=0; col < x_n_cols; ++col)
+    return std::to_chars(out, out + 32, val, std::chars_format::scientific).ptr;
+    }
+  #else
+    {
+    int n = std::snprintf(out, 32, "%.16e", val);
+    
+    if(n <= 0)  { return out; }
+    
+    // snprintf() uses the radix character of the current C locale (eg. ',' instead of '.');
+    // the radix is located after the sign and the first digit, and can be more than one byte long
+    
+    char* radix     = out + ((out[0] == '-') ? 2 : 1);
+    char* radix_end = radix;
+    
+    while( (radix_end < (out + n)) && ((*radix_end < '0') || (*radix_end > '9')) )  { ++radix_end; }
+    
+    const int radix_len = int(radix_end - radix);
+    
+    if( (radix_len > 1) || ((radix_len == 1) && (*radix != '.')) )
       {
-      const eT& val = x.at(row,col);
-      
-      const T    tmp_r     = std::real(val);
-      const T    tmp_i     = std::imag(val);
-      const T    tmp_i_abs = (tmp_i < T(0)) ? T(-tmp_i) : T(tmp_i);
-      const char tmp_sign  = (tmp_i < T(0)) ? char('-') : char('+');
+      (*radix) = '.';
       
-      arma_ostream::raw_print_elem(f, tmp_r    );
-      f.put(tmp_sign);
-      arma_ostream::raw_print_elem(f, tmp_i_abs);
-      f.put('i');
+      std::memmove(radix + 1, radix_end, size_t((out + n) - radix_end));
       
-      if( col < (x_n_cols-1) )  { f.put(','); }
+      n -= (radix_len - 1);
       }
     
-    f.put('\n');
+    return out + n;
     }
-  
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
+  #endif
   }
 
 
 
-//! Save a matrix in binary format,
-//! with a header that stores the matrix type as well as its dimensions
+//! Write an element as text; out must have room for at least text_elem_chars characters.
+//! Elements with type float are written via conversion to double,
+//! so that data saved in single precision can be loaded as double precision without introducing errors.
 template<typename eT>
 inline
-bool
-diskio::save_arma_binary(const Mat<eT>& x, const std::string& final_name)
+char*
+diskio::format_elem(char* out, const eT& val)
   {
-  arma_extra_debug_sigprint();
+  if(is_real<eT>::value)  { return diskio::format_real(out, double(val)); }
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  u64 mag = 0;
   
-  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
+  if(is_signed<eT>::value)
+    {
+    const s64 sval = s64(val);
+    
+    if(sval < 0)  { *out = '-'; ++out; mag = u64(0) - u64(sval); }  else  { mag = u64(sval); }
+    }
+  else
+    {
+    mag = u64(val);
+    }
   
-  bool save_okay = f.is_open();
+  char  tmp[24];
+  char* tmp_end = tmp + 24;
+  char* ptr     = tmp_end;
   
-  if(save_okay)
+  do
     {
-    save_okay = diskio::save_arma_binary(x, f);
+    --ptr;
     
-    f.flush();
-    f.close();
+    (*ptr) = char( '0' + int(mag % 10) );
     
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    mag /= 10;
     }
+  while(mag != 0);
   
-  return save_okay;
+  const size_t n = size_t(tmp_end - ptr);
+  
+  std::memcpy(out, ptr, n);
+  
+  return out + n;
   }
 
 
 
-//! Save a matrix in binary format,
-//! with a header that stores the matrix type as well as its dimensions
-template<typename eT>
+//! Write a complex element as text in "(a,b)" form
+template<typename T>
 inline
-bool
-diskio::save_arma_binary(const Mat<eT>& x, std::ostream& f)
+char*
+diskio::format_elem(char* out, const std::complex<T>& val)
   {
-  arma_extra_debug_sigprint();
+  const double a = double(val.real());
+  const double b = double(val.imag());
   
-  f << diskio::gen_bin_header(x) << '\n';
-  f << x.n_rows << ' ' << x.n_cols << '\n';
+  *out = '('; ++out;
   
-  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
+  if(arma_isinf(a) && (a > double(0)))  { *out = '+'; ++out; }
   
-  return f.good();
+  out = diskio::format_real(out, a);
+  
+  *out = ','; ++out;
+  
+  if(arma_isinf(b) && (b > double(0)))  { *out = '+'; ++out; }
+  
+  out = diskio::format_real(out, b);
+  
+  *out = ')'; ++out;
+  
+  return out;
   }
 
 
 
-//! Save a matrix as a PGM greyscale image
+//! Write the elements in rows [row_start,row_end) and columns [col_start,col_end) of a column-major matrix as lines of text.
+//! The layout is the same as for stream based output:
+//! in raw_ascii format each element is preceded by a space, and real elements are right aligned in cells of 24 characters (see prepare_stream());
+//! in csv_ascii format elements are separated by commas.
+//! Each line is terminated only if col_end is the last column.
 template<typename eT>
 inline
-bool
-diskio::save_pgm_binary(const Mat<eT>& x, const std::string& final_name)
+char*
+diskio::format_lines(char* out, const eT* mem, const uword n_rows, const uword n_cols, const uword row_start, const uword row_end, const uword col_start, const uword col_end, const bool is_csv)
   {
-  arma_extra_debug_sigprint();
-  
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::fstream f(tmp_name.c_str(), std::fstream::out | std::fstream::binary);
+  const bool use_cells = (is_csv == false) && (is_real<eT>::value);
   
-  bool save_okay = f.is_open();
+  const size_t cell_width = 24;
   
-  if(save_okay)
+  for(uword row=row_start; row < row_end; ++row)
     {
-    save_okay = diskio::save_pgm_binary(x, f);
+    const eT* ptr = &(mem[ size_t(col_start)*size_t(n_rows) + size_t(row) ]);
     
-    f.flush();
-    f.close();
+    for(uword col=col_start; col < col_end; ++col)
+      {
+      if(is_csv == false)  { *out = ' '; ++out; }
+      
+      if(use_cells)
+        {
+        char tmp[text_elem_chars];
+        
+        const size_t n = size_t( diskio::format_elem(tmp, *ptr) - tmp );
+        
+        const size_t n_fill = (n < cell_width) ? (cell_width - n) : size_t(0);
+        
+        std::memset(out, ' ', n_fill);
+        std::memcpy(out + n_fill, tmp, n);
+        
+        out += n_fill + n;
+        }
+      else
+        {
+        out = diskio::format_elem(out, *ptr);
+        }
+      
+      if( is_csv && ((col+1) < n_cols) )  { *out = ','; ++out; }
+      
+      ptr += n_rows;
+      }
     
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    if(col_end == n_cols)  { *out = '\n'; ++out; }
     }
   
-  return save_okay;
+  return out;
   }
 
 
 
-//
-// TODO:
-// add functionality to save the image in a normalised format,
-// i.e. scaled so that every value falls in the [0,255] range.
-
-//! Save a matrix as a PGM greyscale image
+//! Save a column-major matrix as text in CSV or raw_ascii format.
+//! The matrix is split into blocks of rows (or parts of rows, for very wide matrices),
+//! which are formatted into separate buffers in parallel if OpenMP is enabled;
+//! the buffers are then written to the stream in order, using one write per block.
 template<typename eT>
 inline
 bool
-diskio::save_pgm_binary(const Mat<eT>& x, std::ostream& f)
+diskio::write_text(std::ostream& f, const eT* mem, const uword n_rows, const uword n_cols, const bool is_csv)
   {
   arma_extra_debug_sigprint();
   
-  f << "P5" << '\n';
-  f << x.n_cols << ' ' << x.n_rows << '\n';
-  f << 255 << '\n';
+  if(n_rows == 0)  { return f.good(); }
   
-  const uword n_elem = x.n_rows * x.n_cols;
-  podarray<u8> tmp(n_elem);
+  const uword block_cols   = uword( (std::max)( size_t(1), (std::min)( size_t(n_cols), text_block_bytes / text_elem_chars ) ) );
+  const uword n_col_pieces = (std::max)( uword(1), (n_cols + block_cols - 1) / block_cols );
+  const uword block_rows   = (n_col_pieces > 1) ? uword(1) : uword( (std::max)( size_t(1), text_block_bytes / (size_t(block_cols)*text_elem_chars + 1) ) );
+  const uword n_row_pieces = (n_rows + block_rows - 1) / block_rows;
+  const uword n_pieces     = n_row_pieces * n_col_pieces;
   
-  uword i = 0;
+  const size_t piece_bytes = size_t( (std::min)(block_rows, n_rows) ) * (size_t(block_cols)*text_elem_chars + 1);
   
-  for(uword row=0; row < x.n_rows; ++row)
-  for(uword col=0; col < x.n_cols; ++col)
+  uword n_buffers = 1;
+  
+  #if defined(ARMA_USE_OPENMP)
     {
-    tmp[i] = u8( x.at(row,col) );  // TODO: add round() ?
-    ++i;
+    if( (n_pieces > 1) && (mp_thread_limit::in_parallel() == false) )
+      {
+      n_buffers = (std::min)( n_pieces, uword( (std::max)(int(1), mp_thread_limit::get()) ) );
+      }
     }
+  #endif
   
-  f.write(reinterpret_cast<const char*>(tmp.mem), std::streamsize(n_elem) );
+  // the buffers are reused for all pieces
   
-  return f.good();
-  }
-
-
+  std::vector< std::vector<char> > buf(n_buffers, std::vector<char>(piece_bytes));
+  std::vector< size_t >            buf_used(n_buffers, size_t(0));
+  
+  for(uword piece_start=0; piece_start < n_pieces; piece_start += n_buffers)
+    {
+    const uword n_now = (std::min)(n_buffers, n_pieces - piece_start);
+    
+    #if defined(ARMA_USE_OPENMP)
+      {
+      const int n_threads = int(n_buffers);
+      
+      #pragma omp parallel for schedule(static) num_threads(n_threads)
+      for(uword b=0; b < n_now; ++b)
+        {
+        const uword piece     = piece_start + b;
+        const uword row_start = (piece / n_col_pieces) * block_rows;
+        const uword col_start = (piece % n_col_pieces) * block_cols;
+        
+        char* out = &(buf[b][0]);
+        
+        buf_used[b] = size_t( diskio::format_lines(out, mem, n_rows, n_cols, row_start, (std::min)(row_start + block_rows, n_rows), col_start, (std::min)(col_start + block_cols, n_cols), is_csv) - out );
+        }
+      }
+    #else
+      {
+      for(uword b=0; b < n_now; ++b)
+        {
+        const uword piece     = piece_start + b;
+        const uword row_start = (piece / n_col_pieces) * block_rows;
+        const uword col_start = (piece % n_col_pieces) * block_cols;
+        
+        char* out = &(buf[b][0]);
+        
+        buf_used[b] = size_t( diskio::format_lines(out, mem, n_rows, n_cols, row_start, (std::min)(row_start + block_rows, n_rows), col_start, (std::min)(col_start + block_cols, n_cols), is_csv) - out );
+        }
+      }
+    #endif
+    
+    for(uword b=0; b < n_now; ++b)  { f.write( &(buf[b][0]), std::streamsize(buf_used[b]) ); }
+    
+    if(f.good() == false)  { return false; }
+    }
+  
+  return true;
+  }
 
-//! Save a matrix as a PGM greyscale image
-template<typename T>
+
+
+template<typename eT>
 inline
-bool
-diskio::save_pgm_binary(const Mat< std::complex<T> >& x, const std::string& final_name)
+std::streamsize
+diskio::prepare_stream(std::ostream& f)
   {
-  arma_extra_debug_sigprint();
+  std::streamsize cell_width = f.width();
   
-  const uchar_mat tmp = conv_to<uchar_mat>::from(x);
+  if(is_real<eT>::value)
+    {
+    f.unsetf(ios::fixed);
+    f.setf(ios::scientific);
+    f.fill(' ');
+    
+    f.precision(16);
+    cell_width = 24;
+    
+    // NOTE: for 'float' the optimum settings are f.precision(8) and cell_width = 15
+    // NOTE: however, to avoid introducing errors in case single precision data is loaded as double precision,
+    // NOTE: the same settings must be used for both 'float' and 'double'
+    }
+  else
+  if(is_cx<eT>::value)
+    {
+    f.unsetf(ios::fixed);
+    f.setf(ios::scientific);
+    
+    f.precision(16);
+    }
   
-  return diskio::save_pgm_binary(tmp, final_name);
+  return cell_width;
   }
+  
 
 
 
-//! Save a matrix as a PGM greyscale image
-template<typename T>
+//! Save a matrix as raw text (no header, human readable).
+//! Matrices can be loaded in Matlab and Octave, as long as they don't have complex elements.
+template<typename eT>
 inline
 bool
-diskio::save_pgm_binary(const Mat< std::complex<T> >& x, std::ostream& f)
+diskio::save_raw_ascii(const Mat<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  const uchar_mat tmp = conv_to<uchar_mat>::from(x);
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  return diskio::save_pgm_binary(tmp, f);
+  std::fstream f(tmp_name.c_str(), std::fstream::out);
+  
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
+    {
+    save_okay = diskio::save_raw_ascii(x, f);
+    
+    f.flush();
+    f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    }
+  
+  return save_okay;
   }
 
 
 
-//! Save a matrix as part of a HDF5 file
+//! Save a matrix as raw text (no header, human readable).
+//! Matrices can be loaded in Matlab and Octave, as long as they don't have complex elements.
 template<typename eT>
-inline 
-bool 
-diskio::save_hdf5_binary(const Mat<eT>& x, const hdf5_name& spec, std::string& err_msg)
+inline
+bool
+diskio::save_raw_ascii(const Mat<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  #if defined(ARMA_USE_HDF5)
-    {
-    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
-    
-    bool save_okay = false;
-    
-    const bool append  = bool(spec.opts.flags & hdf5_opts::flag_append);
-    const bool replace = bool(spec.opts.flags & hdf5_opts::flag_replace);
-    
-    const bool use_existing_file = ((append || replace) && (arma_H5Fis_hdf5(spec.filename.c_str()) > 0));
-    
-    const std::string tmp_name = (use_existing_file) ? std::string() : diskio::gen_tmp_name(spec.filename);
-    
-    // Set up the file according to HDF5's preferences
-    hid_t file = (use_existing_file) ? arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : arma_H5Fcreate(tmp_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-    
-    if(file < 0)  { return false; }
-    
-    // We need to create a dataset, datatype, and dataspace
-    hsize_t dims[2];
-    dims[1] = x.n_rows;
-    dims[0] = x.n_cols;
-    
-    hid_t dataspace = arma_H5Screate_simple(2, dims, NULL);   // treat the matrix as a 2d array dataspace
-    hid_t datatype  = hdf5_misc::get_hdf5_type<eT>();
-    
-    // If this returned something invalid, well, it's time to crash.
-    arma_check(datatype == -1, "Mat::save(): unknown datatype for HDF5");
-    
-    // MATLAB forces the users to specify a name at save time for HDF5;
-    // Octave will use the default of 'dataset' unless otherwise specified.
-    // If the user hasn't specified a dataset name, we will use 'dataset'
-    // We may have to split out the group name from the dataset name.
-    std::vector<hid_t> groups;
-    std::string full_name = spec.dsname;
-    size_t loc;
-    while((loc = full_name.find("/")) != std::string::npos)
-      {
-      // Create another group...
-      if(loc != 0) // Ignore the first /, if there is a leading /.
-        {
-        hid_t gid = arma_H5Gcreate((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-        
-        if((gid < 0) && use_existing_file)
-          {
-          gid = arma_H5Gopen((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT);
-          }
-        
-        groups.push_back(gid);
-        }
-      
-      full_name = full_name.substr(loc + 1);
-      }
-    
-    const std::string dataset_name = full_name.empty() ? std::string("dataset") : full_name;
-    
-    const hid_t last_group = (groups.size() == 0) ? file : groups[groups.size() - 1];
-    
-    if(use_existing_file && replace)
-      {
-      arma_H5Ldelete(last_group, dataset_name.c_str(), H5P_DEFAULT);
-      // NOTE: H5Ldelete() in HDF5 v1.8 doesn't reclaim the deleted space; use h5repack to reclaim space: h5repack oldfile.h5 newfile.h5
-      // NOTE: has this behaviour changed in HDF5 1.10 ?
-      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010482.html
-      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010486.html
-      }
-    
-    hid_t dataset = arma_H5Dcreate(last_group, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-    
-    if(dataset < 0)
-      {
-      save_okay = false;
-      
-      err_msg = "couldn't create dataset in ";
-      }
-    else
-      {
-      save_okay = (arma_H5Dwrite(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, x.mem) >= 0);
-      
-      arma_H5Dclose(dataset);
-      }
-    
-    arma_H5Tclose(datatype);
-    arma_H5Sclose(dataspace);
-    for(size_t i = 0; i < groups.size(); ++i)  { arma_H5Gclose(groups[i]); }
-    arma_H5Fclose(file);
-    
-    if((use_existing_file == false) && (save_okay == true))  { save_okay = diskio::safe_rename(tmp_name, spec.filename); }
-    
-    return save_okay;
-    }
-  #else
-    {
-    arma_ignore(x);
-    arma_ignore(spec);
-    arma_ignore(err_msg);
-    
-    arma_stop_logic_error("Mat::save(): use of HDF5 must be enabled");
-    
-    return false;
-    }
-  #endif
+  return diskio::write_text(f, x.memptr(), x.n_rows, x.n_cols, false);
   }
 
 
 
-//! Load a matrix as raw text (no header, human readable).
-//! Can read matrices saved as text in Matlab and Octave.
-//! NOTE: this is much slower than reading a file with a header.
+//! Save a matrix as raw binary (no header)
 template<typename eT>
 inline
 bool
-diskio::load_raw_ascii(Mat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::save_raw_binary(const Mat<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in);
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  bool load_okay = f.is_open();
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
-  if(load_okay)
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
     {
-    load_okay = diskio::load_raw_ascii(x, f, err_msg);
+    save_okay = diskio::save_raw_binary(x, f);
+    
+    f.flush();
     f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Load a matrix as raw text (no header, human readable).
-//! Can read matrices saved as text in Matlab and Octave.
-//! NOTE: this is much slower than reading a file with a header.
 template<typename eT>
 inline
 bool
-diskio::load_raw_ascii(Mat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::save_raw_binary(const Mat<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  bool load_okay = f.good();
-  
-  f.clear();
-  const std::fstream::pos_type pos1 = f.tellg();
-  
-  //
-  // work out the size
+  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
   
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
+  return f.good();
+  }
+
+
+
+//! Save a matrix in text format (human readable),
+//! with a header that indicates the matrix type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::save_arma_ascii(const Mat<eT>& x, const std::string& final_name)
+  {
+  arma_extra_debug_sigprint();
   
-  bool f_n_cols_found = false;
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::string       line_string;
-  std::stringstream line_stream;
+  std::ofstream f(tmp_name.c_str());
   
-  std::string token;
+  bool save_okay = f.is_open();
   
-  while( f.good() && load_okay )
+  if(save_okay)
     {
-    std::getline(f, line_string);
+    save_okay = diskio::save_arma_ascii(x, f);
     
-    // TODO: does it make sense to stop processing the file if an empty line is found ?
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword line_n_cols = 0;
-    
-    while(line_stream >> token)  { ++line_n_cols; }
-    
-    if(f_n_cols_found == false)
-      {
-      f_n_cols       = line_n_cols;
-      f_n_cols_found = true;
-      }
-    else
-      {
-      if(line_n_cols != f_n_cols)
-        {
-        load_okay = false;
-        err_msg = "inconsistent number of columns in ";
-        }
-      }
-    
-    ++f_n_rows;
-    }
-  
-  
-  if(load_okay)
-    {
-    f.clear();
-    f.seekg(pos1);
-    
-    x.set_size(f_n_rows, f_n_cols);
+    f.flush();
+    f.close();
     
-    for(uword row=0; ((row < x.n_rows) && load_okay); ++row)
-    for(uword col=0; ((col < x.n_cols) && load_okay); ++col)
-      {
-      f >> token;
-      
-      if(diskio::convert_token(x.at(row,col), token) == false)
-        {
-        load_okay = false;
-        err_msg = "couldn't interpret data in ";
-        }
-      }
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  
-  // an empty file indicates an empty matrix
-  if( (f_n_cols_found == false) && (load_okay == true) )  { x.reset(); }
-  
-  
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Load a matrix in binary format (no header);
-//! the matrix is assumed to have one column
+//! Save a matrix in text format (human readable),
+//! with a header that indicates the matrix type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::load_raw_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::save_arma_ascii(const Mat<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f;
-  f.open(name.c_str(), std::fstream::binary);
+  const arma_ostream_state stream_state(f);
   
-  bool load_okay = f.is_open();
+  f << diskio::gen_txt_header(x) << '\n';
+  f << x.n_rows << ' ' << x.n_cols << '\n';
   
-  if(load_okay)
+  const std::streamsize cell_width = diskio::prepare_stream<eT>(f);
+  
+  for(uword row=0; row < x.n_rows; ++row)
     {
-    load_okay = diskio::load_raw_binary(x, f, err_msg);
-    f.close();
+    for(uword col=0; col < x.n_cols; ++col)
+      {
+      f.put(' ');
+      
+      if(is_real<eT>::value)  { f.width(cell_width); }
+      
+      arma_ostream::raw_print_elem(f, x.at(row,col));
+      }
+    
+    f.put('\n');
     }
   
-  return load_okay;
+  const bool save_okay = f.good();
+  
+  stream_state.restore(f);
+  
+  return save_okay;
   }
 
 
 
+//! Save a matrix in CSV text format (human readable)
 template<typename eT>
 inline
 bool
-diskio::load_raw_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::save_csv_ascii(const Mat<eT>& x, const std::string& final_name, const field<std::string>& header, const bool with_header)
   {
   arma_extra_debug_sigprint();
-  arma_ignore(err_msg);
   
-  f.clear();
-  const std::streampos pos1 = f.tellg();
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  f.clear();
-  f.seekg(0, ios::end);
-
-  f.clear();
-  const std::streampos pos2 = f.tellg();
+  std::ofstream f(tmp_name.c_str());
   
-  const uword N = ( (pos1 >= 0) && (pos2 >= 0) ) ? uword(pos2 - pos1) : 0;
+  bool save_okay = f.is_open();
   
-  f.clear();
-  //f.seekg(0, ios::beg);
-  f.seekg(pos1);
+  if(save_okay == false)  { return false; }
   
-  x.set_size(N / uword(sizeof(eT)), 1);
+  if(with_header)
+    {
+    arma_extra_debug_print("diskio::save_csv_ascii(): writing header");
+    
+    for(uword i=0; i < header.n_elem; ++i)
+      {
+      f << header.at(i);
+      
+      if(i != (header.n_elem-1))  { f.put(','); }
+      }
+    
+    f.put('\n');
+    
+    save_okay = f.good();
+    }
   
-  f.clear();
-  f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem * uword(sizeof(eT))) );
+  if(save_okay)  { save_okay = diskio::save_csv_ascii(x, f); }
   
-  return f.good();
+  f.flush();
+  f.close();
+  
+  if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+  
+  return save_okay;
   }
 
 
 
-//! Load a matrix in text format (human readable),
-//! with a header that indicates the matrix type as well as its dimensions
+//! Save a matrix in CSV text format (human readable)
 template<typename eT>
 inline
 bool
-diskio::load_arma_ascii(Mat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::save_csv_ascii(const Mat<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f(name.c_str());
-  
-  bool load_okay = f.is_open();
-  
-  if(load_okay)
-    {
-    load_okay = diskio::load_arma_ascii(x, f, err_msg);
-    f.close();
-    }
-  
-  return load_okay;
+  return diskio::write_text(f, x.memptr(), x.n_rows, x.n_cols, true);
   }
 
 
 
-//! Load a matrix in text format (human readable),
-//! with a header that indicates the matrix type as well as its dimensions
-template<typename eT>
+//! Save a matrix in CSV text format (human readable); complex numbers stored in "a+bi" format
+template<typename T>
 inline
 bool
-diskio::load_arma_ascii(Mat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::save_csv_ascii(const Mat< std::complex<T> >& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  std::streampos pos = f.tellg();
+  typedef typename std::complex<T> eT;
   
-  bool load_okay = true;
+  const arma_ostream_state stream_state(f);
   
-  std::string f_header;
-  uword       f_n_rows;
-  uword       f_n_cols;
+  diskio::prepare_stream<eT>(f);
   
-  f >> f_header;
-  f >> f_n_rows;
-  f >> f_n_cols;
+  uword x_n_rows = x.n_rows;
+  uword x_n_cols = x.n_cols;
   
-  if(f_header == diskio::gen_txt_header(x))
+  for(uword row=0; row < x_n_rows; ++row)
     {
-    x.zeros(f_n_rows, f_n_cols);
-    
-    std::string token;
-    
-    for(uword row=0; row < x.n_rows; ++row)
-    for(uword col=0; col < x.n_cols; ++col)
+    for(uword col=0; col < x_n_cols; ++col)
       {
-      f >> token;
+      const eT& val = x.at(row,col);
       
-      diskio::convert_token( x.at(row,col), token );
+      const T    tmp_r     = std::real(val);
+      const T    tmp_i     = std::imag(val);
+      const T    tmp_i_abs = (tmp_i < T(0)) ? T(-tmp_i) : T(tmp_i);
+      const char tmp_sign  = (tmp_i < T(0)) ? char('-') : char('+');
+      
+      arma_ostream::raw_print_elem(f, tmp_r    );
+      f.put(tmp_sign);
+      arma_ostream::raw_print_elem(f, tmp_i_abs);
+      f.put('i');
+      
+      if( col < (x_n_cols-1) )  { f.put(','); }
       }
     
-    load_okay = f.good();
-    }
-  else
-    {
-    load_okay = false;
-    err_msg = "incorrect header in ";
+    f.put('\n');
     }
   
+  const bool save_okay = f.good();
   
-  // allow automatic conversion of u32/s32 matrices into u64/s64 matrices
-  
-  if(load_okay == false)
-    {
-    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
-      {
-      Mat<u32>    tmp;
-      std::string junk;
-      
-      f.clear();
-      f.seekg(pos);
-      
-      load_okay = diskio::load_arma_ascii(tmp, f, junk);
-      
-      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
-      }
-    else
-    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
-      {
-      Mat<s32>    tmp;
-      std::string junk;
-      
-      f.clear();
-      f.seekg(pos);
-      
-      load_okay = diskio::load_arma_ascii(tmp, f, junk);
-      
-      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
-      }
-    }
+  stream_state.restore(f);
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Load a matrix in CSV text format (human readable)
+//! Save a matrix in binary format,
+//! with a header that stores the matrix type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::load_csv_ascii(Mat<eT>& x, const std::string& name, std::string& err_msg, field<std::string>& header, const bool with_header)
+diskio::save_arma_binary(const Mat<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in);
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  bool load_okay = f.is_open();
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
-  if(load_okay == false)  { return false; }
+  bool save_okay = f.is_open();
   
-  if(with_header)
+  if(save_okay)
     {
-    arma_extra_debug_print("diskio::load_csv_ascii(): reading header");
-    
-    std::string              header_line;
-    std::stringstream        header_stream;
-    std::vector<std::string> header_tokens;
-    
-    std::getline(f, header_line);
+    save_okay = diskio::save_arma_binary(x, f);
     
-    load_okay = f.good();
+    f.flush();
+    f.close();
     
-    if(load_okay)
-      {
-      std::string token;
-      
-      header_stream.clear();
-      header_stream.str(header_line);
-      
-      uword header_n_tokens = 0;
-      
-      while(header_stream.good())
-        {
-        std::getline(header_stream, token, ',');
-        ++header_n_tokens;
-        header_tokens.push_back(token);
-        }
-      
-      if(header_n_tokens == uword(0))
-        {
-        header.reset();
-        }
-      else
-        {
-        header.set_size(1,header_n_tokens);
-        
-        for(uword i=0; i < header_n_tokens; ++i)  { header.at(i) = header_tokens[i]; }
-        }
-      }
-    }
-  
-  if(load_okay)
-    {
-    load_okay = diskio::load_csv_ascii(x, f, err_msg);
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  f.close();
-  
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Load a matrix in CSV text format (human readable)
+//! Save a matrix in binary format,
+//! with a header that stores the matrix type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::load_csv_ascii(Mat<eT>& x, std::istream& f, std::string&)
+diskio::save_arma_binary(const Mat<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  // TODO: replace with more efficient implementation
+  std::ostringstream dims;
   
-  bool load_okay = f.good();
+  dims << x.n_rows << ' ' << x.n_cols;
   
-  f.clear();
-  const std::fstream::pos_type pos1 = f.tellg();
+  diskio::save_bin_header(f, diskio::gen_bin_header(x), dims.str());
   
-  //
-  // work out the size
+  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
   
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
+  return f.good();
+  }
+
+
+
+//! Save a matrix as a PGM greyscale image
+template<typename eT>
+inline
+bool
+diskio::save_pgm_binary(const Mat<eT>& x, const std::string& final_name)
+  {
+  arma_extra_debug_sigprint();
   
-  std::string       line_string;
-  std::stringstream line_stream;
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::string token;
+  std::fstream f(tmp_name.c_str(), std::fstream::out | std::fstream::binary);
   
-  while( f.good() && load_okay )
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
     {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword line_n_cols = 0;
-    
-    while(line_stream.good())
-      {
-      std::getline(line_stream, token, ',');
-      ++line_n_cols;
-      }
+    save_okay = diskio::save_pgm_binary(x, f);
     
-    if(f_n_cols < line_n_cols)  { f_n_cols = line_n_cols; }
+    f.flush();
+    f.close();
     
-    ++f_n_rows;
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  f.clear();
-  f.seekg(pos1);
+  return save_okay;
+  }
+
+
+
+//
+// TODO:
+// add functionality to save the image in a normalised format,
+// i.e. scaled so that every value falls in the [0,255] range.
+
+//! Save a matrix as a PGM greyscale image
+template<typename eT>
+inline
+bool
+diskio::save_pgm_binary(const Mat<eT>& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
   
-  x.zeros(f_n_rows, f_n_cols);
+  f << "P5" << '\n';
+  f << x.n_cols << ' ' << x.n_rows << '\n';
+  f << 255 << '\n';
   
-  uword row = 0;
+  const uword n_elem = x.n_rows * x.n_cols;
+  podarray<u8> tmp(n_elem);
   
-  while(f.good())
+  uword i = 0;
+  
+  for(uword row=0; row < x.n_rows; ++row)
+  for(uword col=0; col < x.n_cols; ++col)
     {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword col = 0;
-    
-    while(line_stream.good())
-      {
-      std::getline(line_stream, token, ',');
-      
-      diskio::convert_token( x.at(row,col), token );
-      
-      ++col;
-      }
-    
-    ++row;
+    tmp[i] = u8( x.at(row,col) );  // TODO: add round() ?
+    ++i;
     }
   
-  return load_okay;
+  f.write(reinterpret_cast<const char*>(tmp.mem), std::streamsize(n_elem) );
+  
+  return f.good();
   }
 
 
 
-//! Load a matrix in CSV text format (human readable); complex numbers stored in "a+bi" format
+//! Save a matrix as a PGM greyscale image
 template<typename T>
 inline
 bool
-diskio::load_csv_ascii(Mat< std::complex<T> >& x, std::istream& f, std::string&)
+diskio::save_pgm_binary(const Mat< std::complex<T> >& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  // TODO: replace with more efficient implementation
-  
-  bool load_okay = f.good();
-  
-  f.clear();
-  const std::fstream::pos_type pos1 = f.tellg();
-  
-  //
-  // work out the size
+  const uchar_mat tmp = conv_to<uchar_mat>::from(x);
   
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
+  return diskio::save_pgm_binary(tmp, final_name);
+  }
+
+
+
+//! Save a matrix as a PGM greyscale image
+template<typename T>
+inline
+bool
+diskio::save_pgm_binary(const Mat< std::complex<T> >& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
   
-  std::string       line_string;
-  std::stringstream line_stream;
+  const uchar_mat tmp = conv_to<uchar_mat>::from(x);
   
-  std::string token;
+  return diskio::save_pgm_binary(tmp, f);
+  }
+
+
+
+//! Save a matrix as part of a HDF5 file
+template<typename eT>
+inline 
+bool 
+diskio::save_hdf5_binary(const Mat<eT>& x, const hdf5_name& spec, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
   
-  while( f.good() && load_okay )
+  #if defined(ARMA_USE_HDF5)
     {
-    std::getline(f, line_string);
+    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
     
-    if(line_string.size() == 0)  { break; }
+    bool save_okay = false;
     
-    line_stream.clear();
-    line_stream.str(line_string);
+    const bool append  = bool(spec.opts.flags & hdf5_opts::flag_append);
+    const bool replace = bool(spec.opts.flags & hdf5_opts::flag_replace);
     
-    uword line_n_cols = 0;
+    const bool use_existing_file = ((append || replace) && (arma_H5Fis_hdf5(spec.filename.c_str()) > 0));
     
-    while(line_stream.good())
-      {
-      std::getline(line_stream, token, ',');
-      ++line_n_cols;
-      }
+    const std::string tmp_name = (use_existing_file) ? std::string() : diskio::gen_tmp_name(spec.filename);
     
-    if(f_n_cols < line_n_cols)  { f_n_cols = line_n_cols; }
+    // Set up the file according to HDF5's preferences
+    hid_t file = (use_existing_file) ? arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : arma_H5Fcreate(tmp_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
     
-    ++f_n_rows;
-    }
-  
-  f.clear();
-  f.seekg(pos1);
-  
-  x.zeros(f_n_rows, f_n_cols);
-  
-  uword row = 0;
-  
-  std::string str_real;
-  std::string str_imag;
-  
-  while(f.good())
-    {
-    std::getline(f, line_string);
+    if(file < 0)  { return false; }
     
-    if(line_string.size() == 0)  { break; }
+    // We need to create a dataset, datatype, and dataspace
+    hsize_t dims[2];
+    dims[1] = x.n_rows;
+    dims[0] = x.n_cols;
     
-    line_stream.clear();
-    line_stream.str(line_string);
+    hid_t dataspace = arma_H5Screate_simple(2, dims, NULL);   // treat the matrix as a 2d array dataspace
+    hid_t datatype  = hdf5_misc::get_hdf5_type<eT>();
     
-    uword col = 0;
+    // If this returned something invalid, well, it's time to crash.
+    arma_check(datatype == -1, "Mat::save(): unknown datatype for HDF5");
     
-    while(line_stream.good())
+    // MATLAB forces the users to specify a name at save time for HDF5;
+    // Octave will use the default of 'dataset' unless otherwise specified.
+    // If the user hasn't specified a dataset name, we will use 'dataset'
+    // We may have to split out the group name from the dataset name.
+    std::vector<hid_t> groups;
+    std::string full_name = spec.dsname;
+    size_t loc;
+    while((loc = full_name.find("/")) != std::string::npos)
       {
-      std::getline(line_stream, token, ',');
-      
-      const size_t token_len = size_t( token.length() );
-      
-      if(token_len == 0)  { col++; continue; }
-      
-      // handle special cases: inf and nan, without the imaginary part
-      if( (token_len == 3) || (token_len == 4) )
+      // Create another group...
+      if(loc != 0) // Ignore the first /, if there is a leading /.
         {
-        const char* str = token.c_str();
+        hid_t gid = arma_H5Gcreate((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
         
-        const bool neg = (str[0] == '-');
-        const bool pos = (str[0] == '+');
-        
-        const size_t offset = ( (neg || pos) && (token_len == 4) ) ? 1 : 0;
-        
-        const char sig_a = str[offset  ];
-        const char sig_b = str[offset+1];
-        const char sig_c = str[offset+2];
-        
-        bool found_val_real = false;
-        T          val_real = T(0);
-        
-        if( ((sig_a == 'i') || (sig_a == 'I')) && ((sig_b == 'n') || (sig_b == 'N')) && ((sig_c == 'f') || (sig_c == 'F')) )
-          {
-          val_real = (neg) ? -(Datum<T>::inf) : Datum<T>::inf;
-          
-          found_val_real = true;
-          }
-        else
-        if( ((sig_a == 'n') || (sig_a == 'N')) && ((sig_b == 'a') || (sig_b == 'A')) && ((sig_c == 'n') || (sig_c == 'N')) )
+        if((gid < 0) && use_existing_file)
           {
-          val_real = Datum<T>::nan;
-          
-          found_val_real = true;
+          gid = arma_H5Gopen((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT);
           }
         
-        if(found_val_real)
-          {
-          x.at(row,col) = std::complex<T>(val_real, T(0));
-          
-          col++; continue;  // get next token
-          }
+        groups.push_back(gid);
         }
       
-      bool found_x = false;
-      std::string::size_type loc_x = 0;  // location of the separator (+ or -) between the real and imaginary part
+      full_name = full_name.substr(loc + 1);
+      }
+    
+    const std::string dataset_name = full_name.empty() ? std::string("dataset") : full_name;
+    
+    const hid_t last_group = (groups.size() == 0) ? file : groups[groups.size() - 1];
+    
+    if(use_existing_file && replace)
+      {
+      arma_H5Ldelete(last_group, dataset_name.c_str(), H5P_DEFAULT);
+      // NOTE: H5Ldelete() in HDF5 v1.8 doesn't reclaim the deleted space; use h5repack to reclaim space: h5repack oldfile.h5 newfile.h5
+      // NOTE: has this behaviour changed in HDF5 1.10 ?
+      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010482.html
+      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010486.html
+      }
+    
+    hid_t dataset = arma_H5Dcreate(last_group, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    
+    if(dataset < 0)
+      {
+      save_okay = false;
       
-      std::string::size_type loc_i = token.find_last_of('i');  // location of the imaginary part indicator
+      err_msg = "couldn't create dataset in ";
+      }
+    else
+      {
+      save_okay = (arma_H5Dwrite(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, x.mem) >= 0);
       
-      if(loc_i == std::string::npos)
-        {
-        str_real = token;
-        str_imag.clear();
-        }
-      else
-        {
-        bool found_plus  = false;
-        bool found_minus = false;
-        
-        std::string::size_type loc_plus = token.find_last_of('+');
-        
-        if(loc_plus != std::string::npos)
-          {
-          if(loc_plus >= 1)
-            {
-            const char prev_char = token.at(loc_plus-1);
-            
-            // make sure we're not looking at the sign of the exponent
-            if( (prev_char != 'e') && (prev_char != 'E') )
-              {
-              found_plus = true;
-              }
-            else
-              {
-              // search again, omitting the exponent
-              loc_plus = token.find_last_of('+', loc_plus-1);
-              
-              if(loc_plus != std::string::npos)  { found_plus = true; }
-              }
-            }
-          else
-            {
-            // loc_plus == 0, meaning we're at the start of the string
-            found_plus = true;
-            }
-          }
-        
-        std::string::size_type loc_minus = token.find_last_of('-');
-        
-        if(loc_minus != std::string::npos)
-          {
-          if(loc_minus >= 1)
-            {
-            const char prev_char = token.at(loc_minus-1);
-            
-            // make sure we're not looking at the sign of the exponent
-            if( (prev_char != 'e') && (prev_char != 'E') )
-              {
-              found_minus = true;
-              }
-            else
-              {
-              // search again, omitting the exponent
-              loc_minus = token.find_last_of('-', loc_minus-1);
-              
-              if(loc_minus != std::string::npos)  { found_minus = true; }
-              }
-            }
-          else
-            {
-            // loc_minus == 0, meaning we're at the start of the string
-            found_minus = true;
-            }
-          }
-        
-        if(found_plus && found_minus)
-          {
-          if( (loc_i > loc_plus) && (loc_i > loc_minus) )
-            {
-            // choose the sign closest to the "i" to be the separator between the real and imaginary part
-            loc_x = ( (loc_i - loc_plus) < (loc_i - loc_minus) ) ? loc_plus : loc_minus;
-            found_x = true;
-            }
-          }
-        else if(found_plus )  { loc_x = loc_plus;  found_x = true; }
-        else if(found_minus)  { loc_x = loc_minus; found_x = true; }
+      arma_H5Dclose(dataset);
+      }
+    
+    arma_H5Tclose(datatype);
+    arma_H5Sclose(dataspace);
+    for(size_t i = 0; i < groups.size(); ++i)  { arma_H5Gclose(groups[i]); }
+    arma_H5Fclose(file);
+    
+    if((use_existing_file == false) && (save_okay == true))  { save_okay = diskio::safe_rename(tmp_name, spec.filename); }
+    
+    return save_okay;
+    }
+  #else
+    {
+    arma_ignore(x);
+    arma_ignore(spec);
+    arma_ignore(err_msg);
+    
+    arma_stop_logic_error("Mat::save(): use of HDF5 must be enabled");
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+//! Load a matrix as raw text (no header, human readable).
+//! Can read matrices saved as text in Matlab and Octave.
+//! NOTE: this is much slower than reading a file with a header.
+template<typename eT>
+inline
+bool
+diskio::load_raw_ascii(Mat<eT>& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  mmap_region region;
+  
+  if(region.map(name, mmap_read_only))
+    {
+    return diskio::parse_text(x, (const char*)(region.memptr()), region.n_bytes(), false, err_msg);
+    }
+  
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_raw_ascii(x, f, err_msg);
+    f.close();
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Load a matrix as raw text (no header, human readable).
+//! Can read matrices saved as text in Matlab and Octave.
+//! NOTE: this is much slower than reading a file with a header.
+template<typename eT>
+inline
+bool
+diskio::load_raw_ascii(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(f.good() == false)  { return false; }
+  
+  std::vector<char> buf;
+  
+  diskio::read_text(buf, f);
+  
+  return diskio::parse_text(x, (buf.empty() ? nullptr : &(buf[0])), buf.size(), false, err_msg);
+  }
+
+
+
+//! Load a matrix in binary format (no header);
+//! the matrix is assumed to have one column
+template<typename eT>
+inline
+bool
+diskio::load_raw_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_raw_binary(x, f, err_msg);
+    f.close();
+    }
+  
+  return load_okay;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+diskio::load_raw_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(err_msg);
+  
+  f.clear();
+  const std::streampos pos1 = f.tellg();
+  
+  f.clear();
+  f.seekg(0, ios::end);
+
+  f.clear();
+  const std::streampos pos2 = f.tellg();
+  
+  const uword N = ( (pos1 >= 0) && (pos2 >= 0) ) ? uword(pos2 - pos1) : 0;
+  
+  f.clear();
+  //f.seekg(0, ios::beg);
+  f.seekg(pos1);
+  
+  x.set_size(N / uword(sizeof(eT)), 1);
+  
+  f.clear();
+  f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem * uword(sizeof(eT))) );
+  
+  return f.good();
+  }
+
+
+
+//! Load a matrix in text format (human readable),
+//! with a header that indicates the matrix type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::load_arma_ascii(Mat<eT>& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::ifstream f(name.c_str());
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_arma_ascii(x, f, err_msg);
+    f.close();
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Load a matrix in text format (human readable),
+//! with a header that indicates the matrix type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::load_arma_ascii(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::streampos pos = f.tellg();
+  
+  bool load_okay = true;
+  
+  std::string f_header;
+  uword       f_n_rows;
+  uword       f_n_cols;
+  
+  f >> f_header;
+  f >> f_n_rows;
+  f >> f_n_cols;
+  
+  if(f_header == diskio::gen_txt_header(x))
+    {
+    x.zeros(f_n_rows, f_n_cols);
+    
+    std::string token;
+    
+    for(uword row=0; row < x.n_rows; ++row)
+    for(uword col=0; col < x.n_cols; ++col)
+      {
+      f >> token;
+      
+      diskio::convert_token( x.at(row,col), token );
+      }
+    
+    load_okay = f.good();
+    }
+  else
+    {
+    load_okay = false;
+    err_msg = "incorrect header in ";
+    }
+  
+  
+  // allow automatic conversion of u32/s32 matrices into u64/s64 matrices
+  
+  if(load_okay == false)
+    {
+    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
+      {
+      Mat<u32>    tmp;
+      std::string junk;
+      
+      f.clear();
+      f.seekg(pos);
+      
+      load_okay = diskio::load_arma_ascii(tmp, f, junk);
+      
+      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
+      }
+    else
+    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
+      {
+      Mat<s32>    tmp;
+      std::string junk;
+      
+      f.clear();
+      f.seekg(pos);
+      
+      load_okay = diskio::load_arma_ascii(tmp, f, junk);
+      
+      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
+      }
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Load a matrix in CSV text format (human readable)
+template<typename eT>
+inline
+bool
+diskio::load_csv_ascii(Mat<eT>& x, const std::string& name, std::string& err_msg, field<std::string>& header, const bool with_header)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay == false)  { return false; }
+  
+  if(with_header)
+    {
+    arma_extra_debug_print("diskio::load_csv_ascii(): reading header");
+    
+    std::string              header_line;
+    std::stringstream        header_stream;
+    std::vector<std::string> header_tokens;
+    
+    std::getline(f, header_line);
+    
+    load_okay = f.good();
+    
+    if(load_okay)
+      {
+      std::string token;
+      
+      header_stream.clear();
+      header_stream.str(header_line);
+      
+      uword header_n_tokens = 0;
+      
+      while(header_stream.good())
+        {
+        std::getline(header_stream, token, ',');
+        ++header_n_tokens;
+        header_tokens.push_back(token);
+        }
+      
+      if(header_n_tokens == uword(0))
+        {
+        header.reset();
+        }
+      else
+        {
+        header.set_size(1,header_n_tokens);
+        
+        for(uword i=0; i < header_n_tokens; ++i)  { header.at(i) = header_tokens[i]; }
+        }
+      }
+    }
+  
+  if(load_okay)
+    {
+    // complex numbers are converted via streams, as they may be stored in "a+bi" format
+    
+    const std::streamoff offset = (with_header) ? std::streamoff(f.tellg()) : std::streamoff(0);
+    
+    mmap_region region;
+    
+    if( is_cx<eT>::no && (offset >= 0) && region.map(name, mmap_read_only) && (size_t(offset) <= region.n_bytes()) )
+      {
+      const char* mem = (const char*)(region.memptr()) + offset;
+      
+      diskio::parse_text(x, mem, region.n_bytes() - size_t(offset), true, err_msg);
+      }
+    else
+      {
+      load_okay = diskio::load_csv_ascii(x, f, err_msg);
+      }
+    }
+  
+  f.close();
+  
+  return load_okay;
+  }
+
+
+
+//! Load a matrix in CSV text format (human readable)
+template<typename eT>
+inline
+bool
+diskio::load_csv_ascii(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  const bool load_okay = f.good();
+  
+  std::vector<char> buf;
+  
+  diskio::read_text(buf, f);
+  
+  diskio::parse_text(x, (buf.empty() ? nullptr : &(buf[0])), buf.size(), true, err_msg);
+  
+  return load_okay;
+  }
+
+
+
+//! Load a matrix in CSV text format (human readable); complex numbers stored in "a+bi" format
+template<typename T>
+inline
+bool
+diskio::load_csv_ascii(Mat< std::complex<T> >& x, std::istream& f, std::string&)
+  {
+  arma_extra_debug_sigprint();
+  
+  // TODO: replace with more efficient implementation
+  
+  bool load_okay = f.good();
+  
+  f.clear();
+  const std::fstream::pos_type pos1 = f.tellg();
+  
+  //
+  // work out the size
+  
+  uword f_n_rows = 0;
+  uword f_n_cols = 0;
+  
+  std::string       line_string;
+  std::stringstream line_stream;
+  
+  std::string token;
+  
+  while( f.good() && load_okay )
+    {
+    std::getline(f, line_string);
+    
+    if(line_string.size() == 0)  { break; }
+    
+    line_stream.clear();
+    line_stream.str(line_string);
+    
+    uword line_n_cols = 0;
+    
+    while(line_stream.good())
+      {
+      std::getline(line_stream, token, ',');
+      ++line_n_cols;
+      }
+    
+    if(f_n_cols < line_n_cols)  { f_n_cols = line_n_cols; }
+    
+    ++f_n_rows;
+    }
+  
+  f.clear();
+  f.seekg(pos1);
+  
+  x.zeros(f_n_rows, f_n_cols);
+  
+  uword row = 0;
+  
+  std::string str_real;
+  std::string str_imag;
+  
+  while(f.good())
+    {
+    std::getline(f, line_string);
+    
+    if(line_string.size() == 0)  { break; }
+    
+    line_stream.clear();
+    line_stream.str(line_string);
+    
+    uword col = 0;
+    
+    while(line_stream.good())
+      {
+      std::getline(line_stream, token, ',');
+      
+      const size_t token_len = size_t( token.length() );
+      
+      if(token_len == 0)  { col++; continue; }
+      
+      // handle special cases: inf and nan, without the imaginary part
+      if( (token_len == 3) || (token_len == 4) )
+        {
+        const char* str = token.c_str();
+        
+        const bool neg = (str[0] == '-');
+        const bool pos = (str[0] == '+');
+        
+        const size_t offset = ( (neg || pos) && (token_len == 4) ) ? 1 : 0;
+        
+        const char sig_a = str[offset  ];
+        const char sig_b = str[offset+1];
+        const char sig_c = str[offset+2];
+        
+        bool found_val_real = false;
+        T          val_real = T(0);
+        
+        if( ((sig_a == 'i') || (sig_a == 'I')) && ((sig_b == 'n') || (sig_b == 'N')) && ((sig_c == 'f') || (sig_c == 'F')) )
+          {
+          val_real = (neg) ? -(Datum<T>::inf) : Datum<T>::inf;
+          
+          found_val_real = true;
+          }
+        else
+        if( ((sig_a == 'n') || (sig_a == 'N')) && ((sig_b == 'a') || (sig_b == 'A')) && ((sig_c == 'n') || (sig_c == 'N')) )
+          {
+          val_real = Datum<T>::nan;
+          
+          found_val_real = true;
+          }
+        
+        if(found_val_real)
+          {
+          x.at(row,col) = std::complex<T>(val_real, T(0));
+          
+          col++; continue;  // get next token
+          }
+        }
+      
+      bool found_x = false;
+      std::string::size_type loc_x = 0;  // location of the separator (+ or -) between the real and imaginary part
+      
+      std::string::size_type loc_i = token.find_last_of('i');  // location of the imaginary part indicator
+      
+      if(loc_i == std::string::npos)
+        {
+        str_real = token;
+        str_imag.clear();
+        }
+      else
+        {
+        bool found_plus  = false;
+        bool found_minus = false;
+        
+        std::string::size_type loc_plus = token.find_last_of('+');
+        
+        if(loc_plus != std::string::npos)
+          {
+          if(loc_plus >= 1)
+            {
+            const char prev_char = token.at(loc_plus-1);
+            
+            // make sure we're not looking at the sign of the exponent
+            if( (prev_char != 'e') && (prev_char != 'E') )
+              {
+              found_plus = true;
+              }
+            else
+              {
+              // search again, omitting the exponent
+              loc_plus = token.find_last_of('+', loc_plus-1);
+              
+              if(loc_plus != std::string::npos)  { found_plus = true; }
+              }
+            }
+          else
+            {
+            // loc_plus == 0, meaning we're at the start of the string
+            found_plus = true;
+            }
+          }
+        
+        std::string::size_type loc_minus = token.find_last_of('-');
+        
+        if(loc_minus != std::string::npos)
+          {
+          if(loc_minus >= 1)
+            {
+            const char prev_char = token.at(loc_minus-1);
+            
+            // make sure we're not looking at the sign of the exponent
+            if( (prev_char != 'e') && (prev_char != 'E') )
+              {
+              found_minus = true;
+              }
+            else
+              {
+              // search again, omitting the exponent
+              loc_minus = token.find_last_of('-', loc_minus-1);
+              
+              if(loc_minus != std::string::npos)  { found_minus = true; }
+              }
+            }
+          else
+            {
+            // loc_minus == 0, meaning we're at the start of the string
+            found_minus = true;
+            }
+          }
+        
+        if(found_plus && found_minus)
+          {
+          if( (loc_i > loc_plus) && (loc_i > loc_minus) )
+            {
+            // choose the sign closest to the "i" to be the separator between the real and imaginary part
+            loc_x = ( (loc_i - loc_plus) < (loc_i - loc_minus) ) ? loc_plus : loc_minus;
+            found_x = true;
+            }
+          }
+        else if(found_plus )  { loc_x = loc_plus;  found_x = true; }
+        else if(found_minus)  { loc_x = loc_minus; found_x = true; }
+        
+        if(found_x)
+          {
+          if( loc_x    > 0           ) { str_real = token.substr(0,loc_x);                     } else { str_real.clear(); }
+          if((loc_x+1) < token.size()) { str_imag = token.substr(loc_x, token.size()-loc_x-1); } else { str_imag.clear(); }
+          }
+        else
+          {
+          str_real.clear();
+          str_imag.clear();
+          }
+        }
+      
+      T val_real = T(0);
+      T val_imag = T(0);
+      
+      diskio::convert_token(val_real, str_real);
+      diskio::convert_token(val_imag, str_imag);
+      
+      x.at(row,col) = std::complex<T>(val_real, val_imag);
+      
+      ++col;
+      }
+    
+    ++row;
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Load a matrix in binary format,
+//! with a header that indicates the matrix type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::load_arma_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_arma_binary(x, f, err_msg);
+    f.close();
+    }
+  
+  return load_okay;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+diskio::load_arma_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::streampos pos = f.tellg();
+  
+  bool load_okay = true;
+  
+  std::string f_header;
+  uword       f_n_rows;
+  uword       f_n_cols;
+  
+  f >> f_header;
+  f >> f_n_rows;
+  f >> f_n_cols;
+  
+  if(f_header == diskio::gen_bin_header(x))
+    {
+    //f.seekg(1, ios::cur);  // NOTE: this may not be portable, as on a Windows machine a newline could be two characters
+    f.get();
+    
+    x.set_size(f_n_rows,f_n_cols);
+    f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem*sizeof(eT)) );
+    
+    load_okay = f.good();
+    }
+  else
+    {
+    load_okay = false;
+    err_msg = "incorrect header in ";
+    }
+  
+  
+  // allow automatic conversion of u32/s32 matrices into u64/s64 matrices
+  
+  if(load_okay == false)
+    {
+    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
+      {
+      Mat<u32>    tmp;
+      std::string junk;
+      
+      f.clear();
+      f.seekg(pos);
+      
+      load_okay = diskio::load_arma_binary(tmp, f, junk);
+      
+      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
+      }
+    else
+    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
+      {
+      Mat<s32>    tmp;
+      std::string junk;
+      
+      f.clear();
+      f.seekg(pos);
+      
+      load_okay = diskio::load_arma_binary(tmp, f, junk);
+      
+      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
+      }
+    }
+  
+  return load_okay;
+  }
+
+
+
+inline
+void
+diskio::pnm_skip_comments(std::istream& f)
+  {
+  while( isspace(f.peek()) )
+    {
+    while( isspace(f.peek()) )  { f.get(); }
+    
+    if(f.peek() == '#')
+      {
+      while( (f.peek() != '\r') && (f.peek() != '\n') )  { f.get(); }
+      }
+    }
+  }
+
+
+
+//! Load a PGM greyscale image as a matrix
+template<typename eT>
+inline
+bool
+diskio::load_pgm_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_pgm_binary(x, f, err_msg);
+    f.close();
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Load a PGM greyscale image as a matrix
+template<typename eT>
+inline
+bool
+diskio::load_pgm_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  bool load_okay = true;
+  
+  std::string f_header;
+  
+  f >> f_header;
+  
+  if(f_header == "P5")
+    {
+    uword f_n_rows = 0;
+    uword f_n_cols = 0;
+    int f_maxval = 0;
+    
+    diskio::pnm_skip_comments(f);
+    
+    f >> f_n_cols;
+    diskio::pnm_skip_comments(f);
+    
+    f >> f_n_rows;
+    diskio::pnm_skip_comments(f);
+    
+    f >> f_maxval;
+    f.get();
+    
+    if( (f_maxval > 0) && (f_maxval <= 65535) )
+      {
+      x.set_size(f_n_rows,f_n_cols);
+      
+      if(f_maxval <= 255)
+        {
+        const uword n_elem = f_n_cols*f_n_rows;
+        podarray<u8> tmp(n_elem);
+        
+        f.read( reinterpret_cast<char*>(tmp.memptr()), std::streamsize(n_elem) );
+        
+        uword i = 0;
+        
+        //cout << "f_n_cols = " << f_n_cols << endl;
+        //cout << "f_n_rows = " << f_n_rows << endl;
+        
+        for(uword row=0; row < f_n_rows; ++row)
+        for(uword col=0; col < f_n_cols; ++col)
+          {
+          x.at(row,col) = eT(tmp[i]);
+          ++i;
+          }
+        }
+      else
+        {
+        const uword n_elem = f_n_cols*f_n_rows;
+        podarray<u16> tmp(n_elem);
+        
+        f.read( reinterpret_cast<char *>(tmp.memptr()), std::streamsize(n_elem*2) );
+        
+        uword i = 0;
+        
+        for(uword row=0; row < f_n_rows; ++row)
+        for(uword col=0; col < f_n_cols; ++col)
+          {
+          x.at(row,col) = eT(tmp[i]);
+          ++i;
+          }
+        }
+      }
+    else
+      {
+      load_okay = false;
+      err_msg = "functionality unimplemented to handle loading ";
+      }
+    
+    if(f.good() == false)  { load_okay = false; }
+    }
+  else
+    {
+    load_okay = false;
+    err_msg = "unsupported header in ";
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Load a PGM greyscale image as a matrix
+template<typename T>
+inline
+bool
+diskio::load_pgm_binary(Mat< std::complex<T> >& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  uchar_mat tmp;
+  const bool load_okay = diskio::load_pgm_binary(tmp, name, err_msg);
+  
+  x = conv_to< Mat< std::complex<T> > >::from(tmp);
+  
+  return load_okay;
+  }
+
+
+
+//! Load a PGM greyscale image as a matrix
+template<typename T>
+inline
+bool
+diskio::load_pgm_binary(Mat< std::complex<T> >& x, std::istream& is, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  uchar_mat tmp;
+  const bool load_okay = diskio::load_pgm_binary(tmp, is, err_msg);
+  
+  x = conv_to< Mat< std::complex<T> > >::from(tmp);
+  
+  return load_okay;
+  }
+
+
+
+//! Load a HDF5 file as a matrix
+template<typename eT>
+inline
+bool
+diskio::load_hdf5_binary(Mat<eT>& x, const hdf5_name& spec, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_HDF5)
+    {
+    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
+    
+    bool load_okay = false;
+    
+    hid_t fid = arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    
+    if(fid >= 0)
+      {
+      // MATLAB HDF5 dataset names are user-specified;
+      // Octave tends to store the datasets in a group, with the actual dataset being referred to as "value".
+      // If the user hasn't specified a dataset, we will search for "dataset" and "value",
+      // and if those are not found we will take the first dataset we do find.
+      
+      std::vector<std::string> searchNames;
+      
+      const bool exact = (spec.dsname.empty() == false);
+      
+      if(exact)
+        {
+        searchNames.push_back(spec.dsname);
+        }
+      else
+        {
+        searchNames.push_back("dataset");
+        searchNames.push_back("value"  );
+        }
+      
+      hid_t dataset = hdf5_misc::search_hdf5_file(searchNames, fid, 2, exact);
+      
+      if(dataset >= 0)
+        {
+        hid_t filespace = arma_H5Dget_space(dataset);
+        
+        // This must be <= 2 due to our search rules.
+        const int ndims = arma_H5Sget_simple_extent_ndims(filespace);
+        
+        hsize_t dims[2];
+        const herr_t query_status = arma_H5Sget_simple_extent_dims(filespace, dims, NULL);
+        
+        // arma_check(query_status < 0, "Mat::load(): cannot get size of HDF5 dataset");
+        if(query_status < 0)
+          {
+          err_msg = "cannot get size of HDF5 dataset in ";
+          
+          arma_H5Sclose(filespace);
+          arma_H5Dclose(dataset);
+          arma_H5Fclose(fid);
+          
+          return false;
+          }
+        
+        if(ndims == 1) { dims[1] = 1; }  // Vector case; fake second dimension (one column).
+        
+        x.set_size(dims[1], dims[0]);
+        
+        // Now we have to see what type is stored to figure out how to load it.
+        hid_t datatype = arma_H5Dget_type(dataset);
+        hid_t mat_type = hdf5_misc::get_hdf5_type<eT>();
+        
+        // If these are the same type, it is simple.
+        if(arma_H5Tequal(datatype, mat_type) > 0)
+          {
+          // Load directly; H5S_ALL used so that we load the entire dataset.
+          hid_t read_status = arma_H5Dread(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, void_ptr(x.memptr()));
+          
+          if(read_status >= 0) { load_okay = true; }
+          }
+        else
+          {
+          // Load into another array and convert its type accordingly.
+          hid_t read_status = hdf5_misc::load_and_convert_hdf5(x.memptr(), dataset, datatype, x.n_elem);
+          
+          if(read_status >= 0) { load_okay = true; }
+          }
+        
+        // Now clean up.
+        arma_H5Tclose(datatype);
+        arma_H5Tclose(mat_type);
+        arma_H5Sclose(filespace);
+        }
+      
+      arma_H5Dclose(dataset);
+      
+      arma_H5Fclose(fid);
+      
+      if(load_okay == false)
+        {
+        err_msg = "unsupported or missing HDF5 data in ";
+        }
+      }
+    else
+      {
+      err_msg = "cannot open file ";
+      }
+    
+    return load_okay;
+    }
+  #else
+    {
+    arma_ignore(x);
+    arma_ignore(spec);
+    arma_ignore(err_msg);
+    
+    arma_stop_logic_error("Mat::load(): use of HDF5 must be enabled");
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+//! Try to load a matrix by automatically determining its type
+template<typename eT>
+inline
+bool
+diskio::load_auto_detect(Mat<eT>& x, const std::string& name, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_HDF5)
+    // We're currently using the C bindings for the HDF5 library, which don't support C++ streams
+    if( arma_H5Fis_hdf5(name.c_str()) ) { return load_hdf5_binary(x, name, err_msg); }
+  #endif
+  
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_auto_detect(x, f, err_msg);
+    f.close();
+    }
+  
+  return load_okay;
+  }
+
+
+
+//! Try to load a matrix by automatically determining its type
+template<typename eT>
+inline
+bool
+diskio::load_auto_detect(Mat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  const char* ARMA_MAT_TXT_str = "ARMA_MAT_TXT";
+  const char* ARMA_MAT_BIN_str = "ARMA_MAT_BIN";
+  const char*           P5_str = "P5";
+  const char*          NPY_str = "\x93NUMPY";
+  
+  const uword ARMA_MAT_TXT_len = uword(12);
+  const uword ARMA_MAT_BIN_len = uword(12);
+  const uword           P5_len = uword(2);
+  const uword          NPY_len = uword(6);
+  
+  podarray<char> header(ARMA_MAT_TXT_len + 1);
+  
+  char* header_mem = header.memptr();
+  
+  std::streampos pos = f.tellg();
+    
+  f.read( header_mem, std::streamsize(ARMA_MAT_TXT_len) );
+  f.clear();
+  f.seekg(pos);
+  
+  header_mem[ARMA_MAT_TXT_len] = '\0';
+  
+  if( std::strncmp(ARMA_MAT_TXT_str, header_mem, size_t(ARMA_MAT_TXT_len)) == 0 )
+    {
+    return load_arma_ascii(x, f, err_msg);
+    }
+  else
+  if( std::strncmp(ARMA_MAT_BIN_str, header_mem, size_t(ARMA_MAT_BIN_len)) == 0 )
+    {
+    return load_arma_binary(x, f, err_msg);
+    }
+  else
+  if( std::strncmp(P5_str, header_mem, size_t(P5_len)) == 0 )
+    {
+    return load_pgm_binary(x, f, err_msg);
+    }
+  else
+  if( std::strncmp(NPY_str, header_mem, size_t(NPY_len)) == 0 )
+    {
+    return load_npy_binary(x, f, err_msg);
+    }
+  else
+    {
+    const file_type ft = guess_file_type_internal(f);
+    
+    switch(ft)
+      {
+      case csv_ascii:
+        return load_csv_ascii(x, f, err_msg);
+        break;
+      
+      case raw_binary:
+        return load_raw_binary(x, f, err_msg);
+        break;
+        
+      case raw_ascii:
+        return load_raw_ascii(x, f, err_msg);
+        break;
+      
+      default:
+        err_msg = "unknown data in ";
+        return false;
+      }
+    }
+  
+  return false;
+  }
+
+
+
+//
+// sparse matrices
+//
+
+
+
+//! Save a sparse matrix in CSV format
+template<typename eT>
+inline
+bool
+diskio::save_csv_ascii(const SpMat<eT>& x, const std::string& final_name, const field<std::string>& header, const bool with_header)
+  {
+  arma_extra_debug_sigprint();
+  
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  
+  std::ofstream f(tmp_name.c_str());
+  
+  bool save_okay = f.is_open();
+  
+  if(save_okay == false)  { return false; }
+  
+  if(with_header)
+    {
+    arma_extra_debug_print("diskio::save_csv_ascii(): writing header");
+    
+    for(uword i=0; i < header.n_elem; ++i)
+      {
+      f << header(i);
+      
+      if(i != (header.n_elem-1))  { f.put(','); }
+      }
+    
+    f.put('\n');
+    
+    save_okay = f.good();
+    }
+  
+  if(save_okay)  { save_okay = diskio::save_csv_ascii(x, f); }
+  
+  f.flush();
+  f.close();
+  
+  if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+  
+  return save_okay;
+  }
+
+
+
+//! Save a sparse matrix in CSV format
+template<typename eT>
+inline
+bool
+diskio::save_csv_ascii(const SpMat<eT>& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
+  
+  const arma_ostream_state stream_state(f);
+  
+  diskio::prepare_stream<eT>(f);
+  
+  x.sync();
+  
+  uword x_n_rows = x.n_rows;
+  uword x_n_cols = x.n_cols;
+  
+  for(uword row=0; row < x_n_rows; ++row)
+    {
+    for(uword col=0; col < x_n_cols; ++col)
+      {
+      const eT val = x.at(row,col);
+      
+      if(val != eT(0))  { arma_ostream::raw_print_elem(f, val); }
+      
+      if( col < (x_n_cols-1) )  { f.put(','); }
+      }
+    
+    f.put('\n');
+    }
+  
+  const bool save_okay = f.good();
+  
+  stream_state.restore(f);
+  
+  return save_okay;
+  }
+
+
+
+//! Save a sparse matrix in CSV format (complex numbers)
+template<typename T>
+inline
+bool
+diskio::save_csv_ascii(const SpMat< std::complex<T> >& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_ignore(x);
+  arma_ignore(f);
+  
+  arma_warn("saving complex sparse matrices as csv_ascii not yet implemented");
+  
+  return false;
+  }
+
+
+
+//! Save a matrix in ASCII coord format
+template<typename eT>
+inline
+bool
+diskio::save_coord_ascii(const SpMat<eT>& x, const std::string& final_name)
+  {
+  arma_extra_debug_sigprint();
+  
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  
+  std::ofstream f(tmp_name.c_str());
+  
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
+    {
+    save_okay = diskio::save_coord_ascii(x, f);
+    
+    f.flush();
+    f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    }
+  
+  return save_okay;
+  }
+
+
+
+//! Save a matrix in ASCII coord format
+template<typename eT>
+inline
+bool
+diskio::save_coord_ascii(const SpMat<eT>& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
+  
+  const arma_ostream_state stream_state(f);
+  
+  diskio::prepare_stream<eT>(f);
+  
+  typename SpMat<eT>::const_iterator iter     = x.begin();
+  typename SpMat<eT>::const_iterator iter_end = x.end();
+  
+  for(; iter != iter_end; ++iter)
+    {
+    const eT val = (*iter);
+    
+    f << iter.row() << ' ' << iter.col() << ' ' << val << '\n';
+    }
+  
+  
+  // make sure it's possible to figure out the matrix size later
+  if( (x.n_rows > 0) && (x.n_cols > 0) )
+    {
+    const uword max_row = (x.n_rows > 0) ? x.n_rows-1 : 0;
+    const uword max_col = (x.n_cols > 0) ? x.n_cols-1 : 0;
+    
+    if( x.at(max_row, max_col) == eT(0) )
+      {
+      f << max_row << ' ' << max_col << " 0\n";
+      }
+    }
+  
+  const bool save_okay = f.good();
+  
+  stream_state.restore(f);
+  
+  return save_okay;
+  }
+
+
+
+//! Save a matrix in ASCII coord format (complex numbers)
+template<typename T>
+inline
+bool
+diskio::save_coord_ascii(const SpMat< std::complex<T> >& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename std::complex<T> eT;
+  
+  const arma_ostream_state stream_state(f);
+  
+  diskio::prepare_stream<eT>(f);
+  
+  typename SpMat<eT>::const_iterator iter     = x.begin();
+  typename SpMat<eT>::const_iterator iter_end = x.end();
+  
+  for(; iter != iter_end; ++iter)
+    {
+    const eT val = (*iter);
+    
+    f << iter.row() << ' ' << iter.col() << ' ' << val.real() << ' ' << val.imag() << '\n';
+    }
+  
+  // make sure it's possible to figure out the matrix size later
+  if( (x.n_rows > 0) && (x.n_cols > 0) )
+    {
+    const uword max_row = (x.n_rows > 0) ? x.n_rows-1 : 0;
+    const uword max_col = (x.n_cols > 0) ? x.n_cols-1 : 0;
+    
+    if( x.at(max_row, max_col) == eT(0) )
+      {
+      f << max_row << ' ' << max_col << " 0 0\n";
+      }
+    }
+  
+  const bool save_okay = f.good();
+  
+  stream_state.restore(f);
+  
+  return save_okay;
+  }
+
+
+
+//! Save a matrix in binary format,
+//! with a header that stores the matrix type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::save_arma_binary(const SpMat<eT>& x, const std::string& final_name)
+  {
+  arma_extra_debug_sigprint();
+  
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
+  
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
+    {
+    save_okay = diskio::save_arma_binary(x, f);
+    
+    f.flush();
+    f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
+    }
+  
+  return save_okay;
+  }
+
+
+
+//! Save a matrix in binary format,
+//! with a header that stores the matrix type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::save_arma_binary(const SpMat<eT>& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
+  
+  f << diskio::gen_bin_header(x) << '\n';
+  f << x.n_rows << ' ' << x.n_cols << ' ' << x.n_nonzero << '\n';
+  
+  f.write( reinterpret_cast<const char*>(x.values),      std::streamsize(x.n_nonzero*sizeof(eT))     );
+  f.write( reinterpret_cast<const char*>(x.row_indices), std::streamsize(x.n_nonzero*sizeof(uword))  );
+  f.write( reinterpret_cast<const char*>(x.col_ptrs),    std::streamsize((x.n_cols+1)*sizeof(uword)) );
+  
+  return f.good();
+  }
+
+
+
+template<typename eT>
+inline
+bool
+diskio::load_csv_ascii(SpMat<eT>& x, const std::string& name, std::string& err_msg, field<std::string>& header, const bool with_header)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in);
+  
+  bool load_okay = f.is_open();
+  
+  if(load_okay == false)  { return false; }
+  
+  if(with_header)
+    {
+    arma_extra_debug_print("diskio::load_csv_ascii(): reading header");
+    
+    std::string              header_line;
+    std::stringstream        header_stream;
+    std::vector<std::string> header_tokens;
+    
+    std::getline(f, header_line);
+    
+    load_okay = f.good();
+    
+    if(load_okay)
+      {
+      std::string token;
+      
+      header_stream.clear();
+      header_stream.str(header_line);
+      
+      uword header_n_tokens = 0;
+      
+      while(header_stream.good())
+        {
+        std::getline(header_stream, token, ',');
+        ++header_n_tokens;
+        header_tokens.push_back(token);
+        }
+      
+      if(header_n_tokens == uword(0))
+        {
+        header.reset();
+        }
+      else
+        {
+        header.set_size(1,header_n_tokens);
         
-        if(found_x)
-          {
-          if( loc_x    > 0           ) { str_real = token.substr(0,loc_x);                     } else { str_real.clear(); }
-          if((loc_x+1) < token.size()) { str_imag = token.substr(loc_x, token.size()-loc_x-1); } else { str_imag.clear(); }
-          }
-        else
-          {
-          str_real.clear();
-          str_imag.clear();
-          }
+        for(uword i=0; i < header_n_tokens; ++i)  { header.at(i) = header_tokens[i]; }
         }
+      }
+    }
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_csv_ascii(x, f, err_msg);
+    }
+  
+  f.close();
+  
+  return load_okay;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+diskio::load_csv_ascii(SpMat<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(err_msg);
+  
+  // TODO: replace with more efficient implementation
+  
+  bool load_okay = f.good();
+  
+  f.clear();
+  const std::fstream::pos_type pos1 = f.tellg();
+  
+  //
+  // work out the size
+  
+  uword f_n_rows = 0;
+  uword f_n_cols = 0;
+  
+  std::string       line_string;
+  std::stringstream line_stream;
+  
+  std::string token;
+  
+  while( f.good() && load_okay )
+    {
+    std::getline(f, line_string);
+    
+    if(line_string.size() == 0)  { break; }
+    
+    line_stream.clear();
+    line_stream.str(line_string);
+    
+    uword line_n_cols = 0;
+    
+    while(line_stream.good())
+      {
+      std::getline(line_stream, token, ',');
+      ++line_n_cols;
+      }
+    
+    if(f_n_cols < line_n_cols)  { f_n_cols = line_n_cols; }
+    
+    ++f_n_rows;
+    }
+  
+  f.clear();
+  f.seekg(pos1);
+  
+  x.zeros(f_n_rows, f_n_cols);
+  
+  uword row = 0;
+  
+  while(f.good())
+    {
+    std::getline(f, line_string);
+    
+    if(line_string.size() == 0)  { break; }
+    
+    line_stream.clear();
+    line_stream.str(line_string);
+    
+    uword col = 0;
+    
+    while(line_stream.good())
+      {
+      std::getline(line_stream, token, ',');
       
-      T val_real = T(0);
-      T val_imag = T(0);
+      eT val = eT(0);
       
-      diskio::convert_token(val_real, str_real);
-      diskio::convert_token(val_imag, str_imag);
+      diskio::convert_token( val, token );
       
-      x.at(row,col) = std::complex<T>(val_real, val_imag);
+      if(val != eT(0))  { x(row,col) = val; }
       
       ++col;
       }
@@ -1802,23 +3398,39 @@ diskio::load_csv_ascii(Mat< std::complex<T> >& x, std::istream& f, std::string&)
 
 
 
-//! Load a matrix in binary format,
-//! with a header that indicates the matrix type as well as its dimensions
+template<typename T>
+inline
+bool
+diskio::load_csv_ascii(SpMat< std::complex<T> >& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_ignore(x);
+  arma_ignore(f);
+  arma_ignore(err_msg);
+  
+  arma_warn("loading complex sparse matrices as csv_ascii not yet implemented");
+  
+  return false;
+  }
+
+
+
 template<typename eT>
 inline
 bool
-diskio::load_arma_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::load_coord_ascii(SpMat<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f;
-  f.open(name.c_str(), std::fstream::binary);
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
   
   bool load_okay = f.is_open();
   
   if(load_okay)
     {
-    load_okay = diskio::load_arma_binary(x, f, err_msg);
+    load_okay = diskio::load_coord_ascii(x, f, err_msg);
     f.close();
     }
   
@@ -1830,68 +3442,94 @@ diskio::load_arma_binary(Mat<eT>& x, const std::string& name, std::string& err_m
 template<typename eT>
 inline
 bool
-diskio::load_arma_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::load_coord_ascii(SpMat<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
+  arma_ignore(err_msg);
   
-  std::streampos pos = f.tellg();
+  bool load_okay = f.good();
   
-  bool load_okay = true;
+  f.clear();
+  const std::fstream::pos_type pos1 = f.tellg();
   
-  std::string f_header;
-  uword       f_n_rows;
-  uword       f_n_cols;
+  // work out the size
   
-  f >> f_header;
-  f >> f_n_rows;
-  f >> f_n_cols;
+  uword f_n_rows = 0;
+  uword f_n_cols = 0;
   
-  if(f_header == diskio::gen_bin_header(x))
+  bool size_found = false;
+  
+  std::string       line_string;
+  std::stringstream line_stream;
+  
+  std::string token;
+  
+  while( f.good() && load_okay )
     {
-    //f.seekg(1, ios::cur);  // NOTE: this may not be portable, as on a Windows machine a newline could be two characters
-    f.get();
+    std::getline(f, line_string);
     
-    x.set_size(f_n_rows,f_n_cols);
-    f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem*sizeof(eT)) );
+    if(line_string.size() == 0)  { break; }
     
-    load_okay = f.good();
-    }
-  else
-    {
-    load_okay = false;
-    err_msg = "incorrect header in ";
+    line_stream.clear();
+    line_stream.str(line_string);
+    
+    uword line_row = 0;
+    uword line_col = 0;
+    
+    // a valid line in co-ord format has at least 2 entries
+    
+    line_stream >> line_row;
+    
+    if(line_stream.good() == false)  { load_okay = false; break; }
+    
+    line_stream >> line_col;
+    
+    size_found = true;
+    
+    if(f_n_rows < line_row)  { f_n_rows = line_row; }
+    if(f_n_cols < line_col)  { f_n_cols = line_col; }
     }
   
   
-  // allow automatic conversion of u32/s32 matrices into u64/s64 matrices
+  // take into account that indices start at 0
+  if(size_found)  { ++f_n_rows;  ++f_n_cols; }
   
-  if(load_okay == false)
+  
+  if(load_okay)
     {
-    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
+    f.clear();
+    f.seekg(pos1);
+    
+    MapMat<eT> tmp(f_n_rows, f_n_cols);
+    
+    while(f.good())
       {
-      Mat<u32>    tmp;
-      std::string junk;
+      std::getline(f, line_string);
       
-      f.clear();
-      f.seekg(pos);
+      if(line_string.size() == 0)  { break; }
       
-      load_okay = diskio::load_arma_binary(tmp, f, junk);
+      line_stream.clear();
+      line_stream.str(line_string);
       
-      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
-      }
-    else
-    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
-      {
-      Mat<s32>    tmp;
-      std::string junk;
+      uword line_row = 0;
+      uword line_col = 0;
       
-      f.clear();
-      f.seekg(pos);
+      line_stream >> line_row;
+      line_stream >> line_col;
       
-      load_okay = diskio::load_arma_binary(tmp, f, junk);
+      eT val = eT(0);
       
-      if(load_okay)  { x = conv_to< Mat<eT> >::from(tmp); }
+      line_stream >> token;
+      
+      if(line_stream.fail() == false)
+        {
+        diskio::convert_token( val, token );
+        }
+      
+      if(val != eT(0))  { tmp(line_row,line_col) = val; }
       }
+    
+    x = tmp;
     }
   
   return load_okay;
@@ -1899,128 +3537,108 @@ diskio::load_arma_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
 
 
 
-inline
-void
-diskio::pnm_skip_comments(std::istream& f)
-  {
-  while( isspace(f.peek()) )
-    {
-    while( isspace(f.peek()) )  { f.get(); }
-    
-    if(f.peek() == '#')
-      {
-      while( (f.peek() != '\r') && (f.peek() != '\n') )  { f.get(); }
-      }
-    }
-  }
-
-
-
-//! Load a PGM greyscale image as a matrix
-template<typename eT>
+template<typename T>
 inline
 bool
-diskio::load_pgm_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::load_coord_ascii(SpMat< std::complex<T> >& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
+  arma_ignore(err_msg);
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
+  bool load_okay = f.good();
   
-  bool load_okay = f.is_open();
+  f.clear();
+  const std::fstream::pos_type pos1 = f.tellg();
   
-  if(load_okay)
-    {
-    load_okay = diskio::load_pgm_binary(x, f, err_msg);
-    f.close();
-    }
+  // work out the size
   
-  return load_okay;
-  }
-
-
-
-//! Load a PGM greyscale image as a matrix
-template<typename eT>
-inline
-bool
-diskio::load_pgm_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
-  {
-  bool load_okay = true;
+  uword f_n_rows = 0;
+  uword f_n_cols = 0;
   
-  std::string f_header;
+  bool size_found = false;
   
-  f >> f_header;
+  std::string       line_string;
+  std::stringstream line_stream;
   
-  if(f_header == "P5")
+  std::string token_real;
+  std::string token_imag;
+  
+  while( f.good() && load_okay )
     {
-    uword f_n_rows = 0;
-    uword f_n_cols = 0;
-    int f_maxval = 0;
+    std::getline(f, line_string);
     
-    diskio::pnm_skip_comments(f);
+    if(line_string.size() == 0)  { break; }
     
-    f >> f_n_cols;
-    diskio::pnm_skip_comments(f);
+    line_stream.clear();
+    line_stream.str(line_string);
     
-    f >> f_n_rows;
-    diskio::pnm_skip_comments(f);
+    uword line_row = 0;
+    uword line_col = 0;
     
-    f >> f_maxval;
-    f.get();
+    // a valid line in co-ord format has at least 2 entries
     
-    if( (f_maxval > 0) && (f_maxval <= 65535) )
+    line_stream >> line_row;
+    
+    if(line_stream.good() == false)  { load_okay = false; break; }
+    
+    line_stream >> line_col;
+    
+    size_found = true;
+    
+    if(f_n_rows < line_row)  f_n_rows = line_row;
+    if(f_n_cols < line_col)  f_n_cols = line_col;
+    }
+  
+  // take into account that indices start at 0
+  if(size_found)  { ++f_n_rows;  ++f_n_cols; }
+  
+  if(load_okay)
+    {
+    f.clear();
+    f.seekg(pos1);
+    
+    MapMat< std::complex<T> > tmp(f_n_rows, f_n_cols);
+    
+    while(f.good())
       {
-      x.set_size(f_n_rows,f_n_cols);
+      std::getline(f, line_string);
       
-      if(f_maxval <= 255)
+      if(line_string.size() == 0)  { break; }
+      
+      line_stream.clear();
+      line_stream.str(line_string);
+      
+      uword line_row = 0;
+      uword line_col = 0;
+      
+      line_stream >> line_row;
+      line_stream >> line_col;
+      
+      T val_real = T(0);
+      T val_imag = T(0);
+      
+      line_stream >> token_real;
+      
+      if(line_stream.fail() == false)
         {
-        const uword n_elem = f_n_cols*f_n_rows;
-        podarray<u8> tmp(n_elem);
-        
-        f.read( reinterpret_cast<char*>(tmp.memptr()), std::streamsize(n_elem) );
-        
-        uword i = 0;
-        
-        //cout << "f_n_cols = " << f_n_cols << endl;
-        //cout << "f_n_rows = " << f_n_rows << endl;
-        
-        for(uword row=0; row < f_n_rows; ++row)
-        for(uword col=0; col < f_n_cols; ++col)
-          {
-          x.at(row,col) = eT(tmp[i]);
-          ++i;
-          }
+        diskio::convert_token( val_real, token_real );
         }
-      else
+      
+      
+      line_stream >> token_imag;
+      
+      if(line_stream.fail() == false)
         {
-        const uword n_elem = f_n_cols*f_n_rows;
-        podarray<u16> tmp(n_elem);
-        
-        f.read( reinterpret_cast<char *>(tmp.memptr()), std::streamsize(n_elem*2) );
-        
-        uword i = 0;
-        
-        for(uword row=0; row < f_n_rows; ++row)
-        for(uword col=0; col < f_n_cols; ++col)
-          {
-          x.at(row,col) = eT(tmp[i]);
-          ++i;
-          }
+        diskio::convert_token( val_imag, token_imag );
+        }
+      
+      if( (val_real != T(0)) || (val_imag != T(0)) )
+        {
+        tmp(line_row,line_col) = std::complex<T>(val_real, val_imag);
         }
-      }
-    else
-      {
-      load_okay = false;
-      err_msg = "functionality unimplemented to handle loading ";
       }
     
-    if(f.good() == false)  { load_okay = false; }
-    }
-  else
-    {
-    load_okay = false;
-    err_msg = "unsupported header in ";
+    x = tmp;
     }
   
   return load_okay;
@@ -2028,275 +3646,230 @@ diskio::load_pgm_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
 
 
 
-//! Load a PGM greyscale image as a matrix
-template<typename T>
+//! Load a matrix in binary format,
+//! with a header that indicates the matrix type as well as its dimensions
+template<typename eT>
 inline
 bool
-diskio::load_pgm_binary(Mat< std::complex<T> >& x, const std::string& name, std::string& err_msg)
+diskio::load_arma_binary(SpMat<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  uchar_mat tmp;
-  const bool load_okay = diskio::load_pgm_binary(tmp, name, err_msg);
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
   
-  x = conv_to< Mat< std::complex<T> > >::from(tmp);
+  bool load_okay = f.is_open();
+  
+  if(load_okay)
+    {
+    load_okay = diskio::load_arma_binary(x, f, err_msg);
+    f.close();
+    }
   
   return load_okay;
   }
 
 
 
-//! Load a PGM greyscale image as a matrix
-template<typename T>
+template<typename eT>
 inline
 bool
-diskio::load_pgm_binary(Mat< std::complex<T> >& x, std::istream& is, std::string& err_msg)
+diskio::load_arma_binary(SpMat<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  uchar_mat tmp;
-  const bool load_okay = diskio::load_pgm_binary(tmp, is, err_msg);
+  bool load_okay = true;
   
-  x = conv_to< Mat< std::complex<T> > >::from(tmp);
+  std::string f_header;
   
-  return load_okay;
-  }
-
-
-
-//! Load a HDF5 file as a matrix
-template<typename eT>
-inline
-bool
-diskio::load_hdf5_binary(Mat<eT>& x, const hdf5_name& spec, std::string& err_msg)
-  {
-  arma_extra_debug_sigprint();
+  f >> f_header;
   
-  #if defined(ARMA_USE_HDF5)
+  if(f_header == diskio::gen_bin_header(x))
     {
-    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
-    
-    bool load_okay = false;
+    uword f_n_rows;
+    uword f_n_cols;
+    uword f_n_nz;
     
-    hid_t fid = arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    f >> f_n_rows;
+    f >> f_n_cols;
+    f >> f_n_nz;
     
-    if(fid >= 0)
-      {
-      // MATLAB HDF5 dataset names are user-specified;
-      // Octave tends to store the datasets in a group, with the actual dataset being referred to as "value".
-      // If the user hasn't specified a dataset, we will search for "dataset" and "value",
-      // and if those are not found we will take the first dataset we do find.
-      
-      std::vector<std::string> searchNames;
-      
-      const bool exact = (spec.dsname.empty() == false);
-      
-      if(exact)
-        {
-        searchNames.push_back(spec.dsname);
-        }
-      else
-        {
-        searchNames.push_back("dataset");
-        searchNames.push_back("value"  );
-        }
-      
-      hid_t dataset = hdf5_misc::search_hdf5_file(searchNames, fid, 2, exact);
-      
-      if(dataset >= 0)
+    //f.seekg(1, ios::cur);  // NOTE: this may not be portable, as on a Windows machine a newline could be two characters
+    f.get();
+    
+    x.reserve(f_n_rows, f_n_cols, f_n_nz);
+    
+    f.read( reinterpret_cast<char*>(access::rwp(x.values)),      std::streamsize(x.n_nonzero*sizeof(eT))     );
+    
+    std::streampos pos = f.tellg();
+    
+    f.read( reinterpret_cast<char*>(access::rwp(x.row_indices)), std::streamsize(x.n_nonzero*sizeof(uword))  );
+    f.read( reinterpret_cast<char*>(access::rwp(x.col_ptrs)),    std::streamsize((x.n_cols+1)*sizeof(uword)) );
+    
+    bool check1 = true;  for(uword i=0; i < x.n_nonzero; ++i)  { if(x.values[i] == eT(0))  { check1 = false; break; } }
+    bool check2 = true;  for(uword i=0; i < x.n_cols;    ++i)  { if(x.col_ptrs[i+1] < x.col_ptrs[i])  { check2 = false; break; } }
+    bool check3 = (x.col_ptrs[x.n_cols] == x.n_nonzero);
+    
+    if((check1 == true) && ((check2 == false) || (check3 == false)))
+      {
+      if(sizeof(uword) == 8)
         {
-        hid_t filespace = arma_H5Dget_space(dataset);
+        arma_extra_debug_print("detected inconsistent data while loading; re-reading integer parts as u32");
         
-        // This must be <= 2 due to our search rules.
-        const int ndims = arma_H5Sget_simple_extent_ndims(filespace);
+        // inconstency could be due to a different uword size used during saving,
+        // so try loading the row_indices and col_ptrs under the assumption of 32 bit unsigned integers
         
-        hsize_t dims[2];
-        const herr_t query_status = arma_H5Sget_simple_extent_dims(filespace, dims, NULL);
+        f.clear();
+        f.seekg(pos);
         
-        // arma_check(query_status < 0, "Mat::load(): cannot get size of HDF5 dataset");
-        if(query_status < 0)
-          {
-          err_msg = "cannot get size of HDF5 dataset in ";
-          
-          arma_H5Sclose(filespace);
-          arma_H5Dclose(dataset);
-          arma_H5Fclose(fid);
-          
-          return false;
-          }
+        podarray<u32> tmp_a(x.n_nonzero );  tmp_a.zeros();
+        podarray<u32> tmp_b(x.n_cols + 1);  tmp_b.zeros();
         
-        if(ndims == 1) { dims[1] = 1; }  // Vector case; fake second dimension (one column).
+        f.read( reinterpret_cast<char*>(tmp_a.memptr()), std::streamsize( x.n_nonzero   * sizeof(u32)) );
+        f.read( reinterpret_cast<char*>(tmp_b.memptr()), std::streamsize((x.n_cols + 1) * sizeof(u32)) );
         
-        x.set_size(dims[1], dims[0]);
+        check2 = true;  for(uword i=0; i < x.n_cols; ++i)  { if(tmp_b[i+1] < tmp_b[i])  { check2 = false; break; } }
+        check3 = (tmp_b[x.n_cols] == x.n_nonzero);
         
-        // Now we have to see what type is stored to figure out how to load it.
-        hid_t datatype = arma_H5Dget_type(dataset);
-        hid_t mat_type = hdf5_misc::get_hdf5_type<eT>();
+        load_okay = f.good();
         
-        // If these are the same type, it is simple.
-        if(arma_H5Tequal(datatype, mat_type) > 0)
+        if( load_okay && (check2 == true) && (check3 == true) )
           {
-          // Load directly; H5S_ALL used so that we load the entire dataset.
-          hid_t read_status = arma_H5Dread(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, void_ptr(x.memptr()));
+          arma_extra_debug_print("reading integer parts as u32 succeeded");
           
-          if(read_status >= 0) { load_okay = true; }
+          arrayops::convert(access::rwp(x.row_indices), tmp_a.memptr(), x.n_nonzero );
+          arrayops::convert(access::rwp(x.col_ptrs),    tmp_b.memptr(), x.n_cols + 1);
           }
         else
           {
-          // Load into another array and convert its type accordingly.
-          hid_t read_status = hdf5_misc::load_and_convert_hdf5(x.memptr(), dataset, datatype, x.n_elem);
-          
-          if(read_status >= 0) { load_okay = true; }
+          arma_extra_debug_print("reading integer parts as u32 failed");
           }
-        
-        // Now clean up.
-        arma_H5Tclose(datatype);
-        arma_H5Tclose(mat_type);
-        arma_H5Sclose(filespace);
-        }
-      
-      arma_H5Dclose(dataset);
-      
-      arma_H5Fclose(fid);
-      
-      if(load_okay == false)
-        {
-        err_msg = "unsupported or missing HDF5 data in ";
         }
       }
+    
+    if((check1 == false) || (check2 == false) || (check3 == false))
+      {
+      load_okay = false;
+      err_msg = "inconsistent data in ";
+      }
     else
       {
-      err_msg = "cannot open file ";
+      load_okay = f.good();
       }
-    
-    return load_okay;
     }
-  #else
+  else
     {
-    arma_ignore(x);
-    arma_ignore(spec);
-    arma_ignore(err_msg);
-    
-    arma_stop_logic_error("Mat::load(): use of HDF5 must be enabled");
-    
-    return false;
+    load_okay = false;
+    err_msg = "incorrect header in ";
     }
-  #endif
+  
+  return load_okay;
   }
 
 
 
-//! Try to load a matrix by automatically determining its type
+// cubes
+
+
+
+//! Save a cube as raw text (no header, human readable).
 template<typename eT>
 inline
 bool
-diskio::load_auto_detect(Mat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::save_raw_ascii(const Cube<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  #if defined(ARMA_USE_HDF5)
-    // We're currently using the C bindings for the HDF5 library, which don't support C++ streams
-    if( arma_H5Fis_hdf5(name.c_str()) ) { return load_hdf5_binary(x, name, err_msg); }
-  #endif
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
+  std::fstream f(tmp_name.c_str(), std::fstream::out);
   
-  bool load_okay = f.is_open();
+  bool save_okay = f.is_open();
   
-  if(load_okay)
+  if(save_okay)
     {
-    load_okay = diskio::load_auto_detect(x, f, err_msg);
+    save_okay = save_raw_ascii(x, f);
+    
+    f.flush();
     f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Try to load a matrix by automatically determining its type
+//! Save a cube as raw text (no header, human readable).
 template<typename eT>
 inline
 bool
-diskio::load_auto_detect(Mat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::save_raw_ascii(const Cube<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  const char* ARMA_MAT_TXT_str = "ARMA_MAT_TXT";
-  const char* ARMA_MAT_BIN_str = "ARMA_MAT_BIN";
-  const char*           P5_str = "P5";
+  bool save_okay = f.good();
   
-  const uword ARMA_MAT_TXT_len = uword(12);
-  const uword ARMA_MAT_BIN_len = uword(12);
-  const uword           P5_len = uword(2);
+  for(uword slice=0; (slice < x.n_slices) && save_okay; ++slice)
+    {
+    save_okay = diskio::write_text(f, x.slice_memptr(slice), x.n_rows, x.n_cols, false);
+    }
   
-  podarray<char> header(ARMA_MAT_TXT_len + 1);
+  return save_okay;
+  }
+
+
+
+//! Save a cube as raw binary (no header)
+template<typename eT>
+inline
+bool
+diskio::save_raw_binary(const Cube<eT>& x, const std::string& final_name)
+  {
+  arma_extra_debug_sigprint();
   
-  char* header_mem = header.memptr();
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::streampos pos = f.tellg();
-    
-  f.read( header_mem, std::streamsize(ARMA_MAT_TXT_len) );
-  f.clear();
-  f.seekg(pos);
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
-  header_mem[ARMA_MAT_TXT_len] = '\0';
+  bool save_okay = f.is_open();
   
-  if( std::strncmp(ARMA_MAT_TXT_str, header_mem, size_t(ARMA_MAT_TXT_len)) == 0 )
-    {
-    return load_arma_ascii(x, f, err_msg);
-    }
-  else
-  if( std::strncmp(ARMA_MAT_BIN_str, header_mem, size_t(ARMA_MAT_BIN_len)) == 0 )
-    {
-    return load_arma_binary(x, f, err_msg);
-    }
-  else
-  if( std::strncmp(P5_str, header_mem, size_t(P5_len)) == 0 )
-    {
-    return load_pgm_binary(x, f, err_msg);
-    }
-  else
+  if(save_okay)
     {
-    const file_type ft = guess_file_type_internal(f);
+    save_okay = diskio::save_raw_binary(x, f);
     
-    switch(ft)
-      {
-      case csv_ascii:
-        return load_csv_ascii(x, f, err_msg);
-        break;
-      
-      case raw_binary:
-        return load_raw_binary(x, f, err_msg);
-        break;
-        
-      case raw_ascii:
-        return load_raw_ascii(x, f, err_msg);
-        break;
-      
-      default:
-        err_msg = "unknown data in ";
-        return false;
-      }
+    f.flush();
+    f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return false;
+  return save_okay;
   }
 
 
 
-//
-// sparse matrices
-//
+template<typename eT>
+inline
+bool
+diskio::save_raw_binary(const Cube<eT>& x, std::ostream& f)
+  {
+  arma_extra_debug_sigprint();
+  
+  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
+  
+  return f.good();
+  }
 
 
 
-//! Save a sparse matrix in CSV format
+//! Save a cube in text format (human readable),
+//! with a header that indicates the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::save_csv_ascii(const SpMat<eT>& x, const std::string& final_name, const field<std::string>& header, const bool with_header)
+diskio::save_arma_ascii(const Cube<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
@@ -2306,65 +3879,52 @@ diskio::save_csv_ascii(const SpMat<eT>& x, const std::string& final_name, const
   
   bool save_okay = f.is_open();
   
-  if(save_okay == false)  { return false; }
-  
-  if(with_header)
+  if(save_okay)
     {
-    arma_extra_debug_print("diskio::save_csv_ascii(): writing header");
-    
-    for(uword i=0; i < header.n_elem; ++i)
-      {
-      f << header(i);
-      
-      if(i != (header.n_elem-1))  { f.put(','); }
-      }
+    save_okay = diskio::save_arma_ascii(x, f);
     
-    f.put('\n');
+    f.flush();
+    f.close();
     
-    save_okay = f.good();
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  if(save_okay)  { save_okay = diskio::save_csv_ascii(x, f); }
-  
-  f.flush();
-  f.close();
-  
-  if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
-  
   return save_okay;
   }
 
 
 
-//! Save a sparse matrix in CSV format
+//! Save a cube in text format (human readable),
+//! with a header that indicates the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::save_csv_ascii(const SpMat<eT>& x, std::ostream& f)
+diskio::save_arma_ascii(const Cube<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
   const arma_ostream_state stream_state(f);
   
-  diskio::prepare_stream<eT>(f);
-  
-  x.sync();
+  f << diskio::gen_txt_header(x) << '\n';
+  f << x.n_rows << ' ' << x.n_cols << ' ' << x.n_slices << '\n';
   
-  uword x_n_rows = x.n_rows;
-  uword x_n_cols = x.n_cols;
+  const std::streamsize cell_width = diskio::prepare_stream<eT>(f);
   
-  for(uword row=0; row < x_n_rows; ++row)
+  for(uword slice=0; slice < x.n_slices; ++slice)
     {
-    for(uword col=0; col < x_n_cols; ++col)
+    for(uword row=0; row < x.n_rows; ++row)
       {
-      const eT val = x.at(row,col);
-      
-      if(val != eT(0))  { arma_ostream::raw_print_elem(f, val); }
+      for(uword col=0; col < x.n_cols; ++col)
+        {
+        f.put(' ');
+        
+        if(is_real<eT>::value)  { f.width(cell_width); }
+        
+        arma_ostream::raw_print_elem(f, x.at(row,col,slice));
+        }
       
-      if( col < (x_n_cols-1) )  { f.put(','); }
+      f.put('\n');
       }
-    
-    f.put('\n');
     }
   
   const bool save_okay = f.good();
@@ -2376,41 +3936,24 @@ diskio::save_csv_ascii(const SpMat<eT>& x, std::ostream& f)
 
 
 
-//! Save a sparse matrix in CSV format (complex numbers)
-template<typename T>
-inline
-bool
-diskio::save_csv_ascii(const SpMat< std::complex<T> >& x, std::ostream& f)
-  {
-  arma_extra_debug_sigprint();
-  
-  arma_ignore(x);
-  arma_ignore(f);
-  
-  arma_warn("saving complex sparse matrices as csv_ascii not yet implemented");
-  
-  return false;
-  }
-
-
-
-//! Save a matrix in ASCII coord format
+//! Save a cube in binary format,
+//! with a header that stores the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::save_coord_ascii(const SpMat<eT>& x, const std::string& final_name)
+diskio::save_arma_binary(const Cube<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
   const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::ofstream f(tmp_name.c_str());
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
   bool save_okay = f.is_open();
   
   if(save_okay)
     {
-    save_okay = diskio::save_coord_ascii(x, f);
+    save_okay = diskio::save_arma_binary(x, f);
     
     f.flush();
     f.close();
@@ -2423,293 +3966,458 @@ diskio::save_coord_ascii(const SpMat<eT>& x, const std::string& final_name)
 
 
 
-//! Save a matrix in ASCII coord format
+//! Save a cube in binary format,
+//! with a header that stores the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::save_coord_ascii(const SpMat<eT>& x, std::ostream& f)
+diskio::save_arma_binary(const Cube<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  const arma_ostream_state stream_state(f);
+  std::ostringstream dims;
   
-  diskio::prepare_stream<eT>(f);
+  dims << x.n_rows << ' ' << x.n_cols << ' ' << x.n_slices;
   
-  typename SpMat<eT>::const_iterator iter     = x.begin();
-  typename SpMat<eT>::const_iterator iter_end = x.end();
+  diskio::save_bin_header(f, diskio::gen_bin_header(x), dims.str());
   
-  for(; iter != iter_end; ++iter)
-    {
-    const eT val = (*iter);
-    
-    f << iter.row() << ' ' << iter.col() << ' ' << val << '\n';
-    }
+  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
   
+  return f.good();
+  }
+
+
+
+//! Save a cube as part of a HDF5 file
+template<typename eT>
+inline
+bool
+diskio::save_hdf5_binary(const Cube<eT>& x, const hdf5_name& spec, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
   
-  // make sure it's possible to figure out the matrix size later
-  if( (x.n_rows > 0) && (x.n_cols > 0) )
+  #if defined(ARMA_USE_HDF5)
     {
-    const uword max_row = (x.n_rows > 0) ? x.n_rows-1 : 0;
-    const uword max_col = (x.n_cols > 0) ? x.n_cols-1 : 0;
+    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
     
-    if( x.at(max_row, max_col) == eT(0) )
+    bool save_okay = false;
+    
+    const bool append  = bool(spec.opts.flags & hdf5_opts::flag_append);
+    const bool replace = bool(spec.opts.flags & hdf5_opts::flag_replace);
+    
+    const bool use_existing_file = ((append || replace) && (arma_H5Fis_hdf5(spec.filename.c_str()) > 0));
+    
+    const std::string tmp_name = (use_existing_file) ? std::string() : diskio::gen_tmp_name(spec.filename);
+    
+    // Set up the file according to HDF5's preferences
+    hid_t file = (use_existing_file) ? arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : arma_H5Fcreate(tmp_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    
+    if(file < 0)  { return false; }
+    
+    // We need to create a dataset, datatype, and dataspace
+    hsize_t dims[3];
+    dims[2] = x.n_rows;
+    dims[1] = x.n_cols;
+    dims[0] = x.n_slices;
+    
+    hid_t dataspace = arma_H5Screate_simple(3, dims, NULL);   // treat the cube as a 3d array dataspace
+    hid_t datatype  = hdf5_misc::get_hdf5_type<eT>();
+    
+    // If this returned something invalid, well, it's time to crash.
+    arma_check(datatype == -1, "Cube::save(): unknown datatype for HDF5");
+    
+    // MATLAB forces the users to specify a name at save time for HDF5;
+    // Octave will use the default of 'dataset' unless otherwise specified.
+    // If the user hasn't specified a dataset name, we will use 'dataset'
+    // We may have to split out the group name from the dataset name.
+    std::vector<hid_t> groups;
+    std::string full_name = spec.dsname;
+    size_t loc;
+    while((loc = full_name.find("/")) != std::string::npos)
       {
-      f << max_row << ' ' << max_col << " 0\n";
+      // Create another group...
+      if(loc != 0) // Ignore the first /, if there is a leading /.
+        {
+        hid_t gid = arma_H5Gcreate((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        
+        if((gid < 0) && use_existing_file)
+          {
+          gid = arma_H5Gopen((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT);
+          }
+        
+        groups.push_back(gid);
+        }
+      
+      full_name = full_name.substr(loc + 1);
+      }
+    
+    const std::string dataset_name = full_name.empty() ? std::string("dataset") : full_name;
+    
+    const hid_t last_group = (groups.size() == 0) ? file : groups[groups.size() - 1];
+    
+    if(use_existing_file && replace)
+      {
+      arma_H5Ldelete(last_group, dataset_name.c_str(), H5P_DEFAULT);
+      // NOTE: H5Ldelete() in HDF5 v1.8 doesn't reclaim the deleted space; use h5repack to reclaim space: h5repack oldfile.h5 newfile.h5
+      // NOTE: has this behaviour changed in HDF5 1.10 ?
+      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010482.html
+      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010486.html
+      }
+    
+    hid_t dataset = arma_H5Dcreate(last_group, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    
+    if(dataset < 0)
+      {
+      save_okay = false;
+      
+      err_msg = "couldn't create dataset in ";
       }
+    else
+      {
+      save_okay = (arma_H5Dwrite(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, x.mem) >= 0);
+      
+      arma_H5Dclose(dataset);
+      }
+    
+    arma_H5Tclose(datatype);
+    arma_H5Sclose(dataspace);
+    for(size_t i = 0; i < groups.size(); ++i)  { arma_H5Gclose(groups[i]); }
+    arma_H5Fclose(file);
+    
+    if((use_existing_file == false) && (save_okay == true))  { save_okay = diskio::safe_rename(tmp_name, spec.filename); }
+    
+    return save_okay;
     }
-  
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
+  #else
+    {
+    arma_ignore(x);
+    arma_ignore(spec);
+    arma_ignore(err_msg);
+    
+    arma_stop_logic_error("Cube::save(): use of HDF5 must be enabled");
+    
+    return false;
+    }
+  #endif
   }
 
 
 
-//! Save a matrix in ASCII coord format (complex numbers)
-template<typename T>
+//! Load a cube as raw text (no header, human readable).
+//! NOTE: this is much slower than reading a file with a header.
+template<typename eT>
 inline
 bool
-diskio::save_coord_ascii(const SpMat< std::complex<T> >& x, std::ostream& f)
+diskio::load_raw_ascii(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  typedef typename std::complex<T> eT;
-  
-  const arma_ostream_state stream_state(f);
-  
-  diskio::prepare_stream<eT>(f);
-  
-  typename SpMat<eT>::const_iterator iter     = x.begin();
-  typename SpMat<eT>::const_iterator iter_end = x.end();
+  Mat<eT> tmp;
+  const bool load_okay = diskio::load_raw_ascii(tmp, name, err_msg);
   
-  for(; iter != iter_end; ++iter)
+  if(load_okay)
     {
-    const eT val = (*iter);
-    
-    f << iter.row() << ' ' << iter.col() << ' ' << val.real() << ' ' << val.imag() << '\n';
+    if(tmp.is_empty() == false)
+      {
+      x.set_size(tmp.n_rows, tmp.n_cols, 1);
+      
+      x.slice(0) = tmp;
+      }
+    else
+      {
+      x.reset();
+      }
     }
   
-  // make sure it's possible to figure out the matrix size later
-  if( (x.n_rows > 0) && (x.n_cols > 0) )
+  return load_okay;
+  }
+
+
+
+//! Load a cube as raw text (no header, human readable).
+//! NOTE: this is much slower than reading a file with a header.
+template<typename eT>
+inline
+bool
+diskio::load_raw_ascii(Cube<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  Mat<eT> tmp;
+  const bool load_okay = diskio::load_raw_ascii(tmp, f, err_msg);
+  
+  if(load_okay)
     {
-    const uword max_row = (x.n_rows > 0) ? x.n_rows-1 : 0;
-    const uword max_col = (x.n_cols > 0) ? x.n_cols-1 : 0;
-    
-    if( x.at(max_row, max_col) == eT(0) )
+    if(tmp.is_empty() == false)
       {
-      f << max_row << ' ' << max_col << " 0 0\n";
+      x.set_size(tmp.n_rows, tmp.n_cols, 1);
+      
+      x.slice(0) = tmp;
+      }
+    else
+      {
+      x.reset();
       }
     }
   
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
+  return load_okay;
   }
 
 
 
-//! Save a matrix in binary format,
-//! with a header that stores the matrix type as well as its dimensions
+//! Load a cube in binary format (no header);
+//! the cube is assumed to have one slice with one column
 template<typename eT>
 inline
 bool
-diskio::save_arma_binary(const SpMat<eT>& x, const std::string& final_name)
+diskio::load_raw_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
   
-  bool save_okay = f.is_open();
+  bool load_okay = f.is_open();
   
-  if(save_okay)
+  if(load_okay)
     {
-    save_okay = diskio::save_arma_binary(x, f);
-    
-    f.flush();
+    load_okay = diskio::load_raw_binary(x, f, err_msg);
     f.close();
-    
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return save_okay;
+  return load_okay;
   }
 
 
 
-//! Save a matrix in binary format,
-//! with a header that stores the matrix type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::save_arma_binary(const SpMat<eT>& x, std::ostream& f)
+diskio::load_raw_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
+  arma_ignore(err_msg);
   
-  f << diskio::gen_bin_header(x) << '\n';
-  f << x.n_rows << ' ' << x.n_cols << ' ' << x.n_nonzero << '\n';
+  f.clear();
+  const std::streampos pos1 = f.tellg();
   
-  f.write( reinterpret_cast<const char*>(x.values),      std::streamsize(x.n_nonzero*sizeof(eT))     );
-  f.write( reinterpret_cast<const char*>(x.row_indices), std::streamsize(x.n_nonzero*sizeof(uword))  );
-  f.write( reinterpret_cast<const char*>(x.col_ptrs),    std::streamsize((x.n_cols+1)*sizeof(uword)) );
+  f.clear();
+  f.seekg(0, ios::end);
+  
+  f.clear();
+  const std::streampos pos2 = f.tellg();
+  
+  const uword N = ( (pos1 >= 0) && (pos2 >= 0) ) ? uword(pos2 - pos1) : 0;
+  
+  f.clear();
+  //f.seekg(0, ios::beg);
+  f.seekg(pos1);
+  
+  x.set_size(N / uword(sizeof(eT)), 1, 1);
+  
+  f.clear();
+  f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem * uword(sizeof(eT))) );
   
   return f.good();
   }
 
 
 
+//! Load a cube in text format (human readable),
+//! with a header that indicates the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::load_csv_ascii(SpMat<eT>& x, const std::string& name, std::string& err_msg, field<std::string>& header, const bool with_header)
+diskio::load_arma_ascii(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in);
+  std::ifstream f(name.c_str());
   
   bool load_okay = f.is_open();
   
-  if(load_okay == false)  { return false; }
+  if(load_okay)
+    {
+    load_okay = diskio::load_arma_ascii(x, f, err_msg);
+    f.close();
+    }
   
-  if(with_header)
+  return load_okay;
+  }
+  
+
+
+//! Load a cube in text format (human readable),
+//! with a header that indicates the cube type as well as its dimensions
+template<typename eT>
+inline
+bool
+diskio::load_arma_ascii(Cube<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
+  
+  std::streampos pos = f.tellg();
+  
+  bool load_okay = true;
+  
+  std::string f_header;
+  uword       f_n_rows;
+  uword       f_n_cols;
+  uword       f_n_slices;
+  
+  f >> f_header;
+  f >> f_n_rows;
+  f >> f_n_cols;
+  f >> f_n_slices;
+  
+  if(f_header == diskio::gen_txt_header(x))
     {
-    arma_extra_debug_print("diskio::load_csv_ascii(): reading header");
-    
-    std::string              header_line;
-    std::stringstream        header_stream;
-    std::vector<std::string> header_tokens;
-    
-    std::getline(f, header_line);
+    x.set_size(f_n_rows, f_n_cols, f_n_slices);
+
+    for(uword slice = 0; slice < x.n_slices; ++slice)
+    for(uword   row = 0;   row < x.n_rows;   ++row  )
+    for(uword   col = 0;   col < x.n_cols;   ++col  )
+      {
+      f >> x.at(row,col,slice);
+      }
     
     load_okay = f.good();
-    
-    if(load_okay)
+    }
+  else
+    {
+    load_okay = false;
+    err_msg = "incorrect header in ";
+    }
+  
+  
+  // allow automatic conversion of u32/s32 cubes into u64/s64 cubes
+  
+  if(load_okay == false)
+    {
+    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
       {
-      std::string token;
+      Cube<u32>   tmp;
+      std::string junk;
       
-      header_stream.clear();
-      header_stream.str(header_line);
+      f.clear();
+      f.seekg(pos);
       
-      uword header_n_tokens = 0;
+      load_okay = diskio::load_arma_ascii(tmp, f, junk);
       
-      while(header_stream.good())
-        {
-        std::getline(header_stream, token, ',');
-        ++header_n_tokens;
-        header_tokens.push_back(token);
-        }
+      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
+      }
+    else
+    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
+      {
+      Cube<s32>   tmp;
+      std::string junk;
       
-      if(header_n_tokens == uword(0))
-        {
-        header.reset();
-        }
-      else
-        {
-        header.set_size(1,header_n_tokens);
-        
-        for(uword i=0; i < header_n_tokens; ++i)  { header.at(i) = header_tokens[i]; }
-        }
+      f.clear();
+      f.seekg(pos);
+      
+      load_okay = diskio::load_arma_ascii(tmp, f, junk);
+      
+      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
       }
     }
   
-  if(load_okay)
-    {
-    load_okay = diskio::load_csv_ascii(x, f, err_msg);
-    }
-  
-  f.close();
-  
   return load_okay;
   }
 
 
 
+//! Load a cube in binary format,
+//! with a header that indicates the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::load_csv_ascii(SpMat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::load_arma_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
-  arma_ignore(err_msg);
   
-  // TODO: replace with more efficient implementation
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
   
-  bool load_okay = f.good();
+  bool load_okay = f.is_open();
   
-  f.clear();
-  const std::fstream::pos_type pos1 = f.tellg();
+  if(load_okay)
+    {
+    load_okay = diskio::load_arma_binary(x, f, err_msg);
+    f.close();
+    }
   
-  //
-  // work out the size
+  return load_okay;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+diskio::load_arma_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
+  {
+  arma_extra_debug_sigprint();
   
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
+  std::streampos pos = f.tellg();
+    
+  bool load_okay = true;
   
-  std::string       line_string;
-  std::stringstream line_stream;
+  std::string f_header;
+  uword       f_n_rows;
+  uword       f_n_cols;
+  uword       f_n_slices;
   
-  std::string token;
+  f >> f_header;
+  f >> f_n_rows;
+  f >> f_n_cols;
+  f >> f_n_slices;
   
-  while( f.good() && load_okay )
+  if(f_header == diskio::gen_bin_header(x))
     {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword line_n_cols = 0;
-    
-    while(line_stream.good())
-      {
-      std::getline(line_stream, token, ',');
-      ++line_n_cols;
-      }
+    //f.seekg(1, ios::cur);  // NOTE: this may not be portable, as on a Windows machine a newline could be two characters
+    f.get();
     
-    if(f_n_cols < line_n_cols)  { f_n_cols = line_n_cols; }
+    x.set_size(f_n_rows, f_n_cols, f_n_slices);
+    f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem*sizeof(eT)) );
     
-    ++f_n_rows;
+    load_okay = f.good();
+    }
+  else
+    {
+    load_okay = false;
+    err_msg = "incorrect header in ";
     }
   
-  f.clear();
-  f.seekg(pos1);
-  
-  x.zeros(f_n_rows, f_n_cols);
   
-  uword row = 0;
+  // allow automatic conversion of u32/s32 cubes into u64/s64 cubes
   
-  while(f.good())
+  if(load_okay == false)
     {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword col = 0;
-    
-    while(line_stream.good())
+    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
       {
-      std::getline(line_stream, token, ',');
+      Cube<u32>   tmp;
+      std::string junk;
       
-      eT val = eT(0);
+      f.clear();
+      f.seekg(pos);
       
-      diskio::convert_token( val, token );
+      load_okay = diskio::load_arma_binary(tmp, f, junk);
       
-      if(val != eT(0))  { x(row,col) = val; }
+      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
+      }
+    else
+    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
+      {
+      Cube<s32>   tmp;
+      std::string junk;
       
-      ++col;
+      f.clear();
+      f.seekg(pos);
+      
+      load_okay = diskio::load_arma_binary(tmp, f, junk);
+      
+      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
       }
-    
-    ++row;
     }
   
   return load_okay;
@@ -2717,31 +4425,142 @@ diskio::load_csv_ascii(SpMat<eT>& x, std::istream& f, std::string& err_msg)
 
 
 
-template<typename T>
+//! Load a HDF5 file as a cube
+template<typename eT>
 inline
 bool
-diskio::load_csv_ascii(SpMat< std::complex<T> >& x, std::istream& f, std::string& err_msg)
+diskio::load_hdf5_binary(Cube<eT>& x, const hdf5_name& spec, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  arma_ignore(x);
-  arma_ignore(f);
-  arma_ignore(err_msg);
-  
-  arma_warn("loading complex sparse matrices as csv_ascii not yet implemented");
-  
-  return false;
+  #if defined(ARMA_USE_HDF5)
+    {
+    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
+    
+    bool load_okay = false;
+    
+    hid_t fid = arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    
+    if(fid >= 0)
+      {
+      // MATLAB HDF5 dataset names are user-specified;
+      // Octave tends to store the datasets in a group, with the actual dataset being referred to as "value".
+      // If the user hasn't specified a dataset, we will search for "dataset" and "value",
+      // and if those are not found we will take the first dataset we do find.
+      
+      std::vector<std::string> searchNames;
+      
+      const bool exact = (spec.dsname.empty() == false);
+      
+      if(exact)
+        {
+        searchNames.push_back(spec.dsname);
+        }
+      else
+        {
+        searchNames.push_back("dataset");
+        searchNames.push_back("value"  );
+        }
+      
+      hid_t dataset = hdf5_misc::search_hdf5_file(searchNames, fid, 3, exact);
+      
+      if(dataset >= 0)
+        {
+        hid_t filespace = arma_H5Dget_space(dataset);
+        
+        // This must be <= 3 due to our search rules.
+        const int ndims = arma_H5Sget_simple_extent_ndims(filespace);
+        
+        hsize_t dims[3];
+        const herr_t query_status = arma_H5Sget_simple_extent_dims(filespace, dims, NULL);
+        
+        // arma_check(query_status < 0, "Cube::load(): cannot get size of HDF5 dataset");
+        if(query_status < 0)
+          {
+          err_msg = "cannot get size of HDF5 dataset in ";
+          
+          arma_H5Sclose(filespace);
+          arma_H5Dclose(dataset);
+          arma_H5Fclose(fid);
+          
+          return false;
+          }
+        
+        if(ndims == 1) { dims[1] = 1; dims[2] = 1; }  // Vector case; one row/colum, several slices
+        if(ndims == 2) {              dims[2] = 1; }  // Matrix case; one column, several rows/slices
+        
+        x.set_size(dims[2], dims[1], dims[0]);
+        
+        // Now we have to see what type is stored to figure out how to load it.
+        hid_t datatype = arma_H5Dget_type(dataset);
+        hid_t mat_type = hdf5_misc::get_hdf5_type<eT>();
+        
+        // If these are the same type, it is simple.
+        if(arma_H5Tequal(datatype, mat_type) > 0)
+          {
+          // Load directly; H5S_ALL used so that we load the entire dataset.
+          hid_t read_status = arma_H5Dread(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, void_ptr(x.memptr()));
+          
+          if(read_status >= 0) { load_okay = true; }
+          }
+        else
+          {
+          // Load into another array and convert its type accordingly.
+          hid_t read_status = hdf5_misc::load_and_convert_hdf5(x.memptr(), dataset, datatype, x.n_elem);
+          
+          if(read_status >= 0) { load_okay = true; }
+          }
+        
+        // Now clean up.
+        arma_H5Tclose(datatype);
+        arma_H5Tclose(mat_type);
+        arma_H5Sclose(filespace);
+        }
+      
+      arma_H5Dclose(dataset);
+      
+      arma_H5Fclose(fid);
+      
+      if(load_okay == false)
+        {
+        err_msg = "unsupported or missing HDF5 data in ";
+        }
+      }
+    else
+      {
+      err_msg = "cannot open file ";
+      }
+    
+    return load_okay;
+    }
+  #else
+    {
+    arma_ignore(x);
+    arma_ignore(spec);
+    arma_ignore(err_msg);
+    
+    arma_stop_logic_error("Cube::load(): use of HDF5 must be enabled");
+    
+    return false;
+    }
+  #endif
   }
 
 
 
+//! Try to load a cube by automatically determining its type
 template<typename eT>
 inline
 bool
-diskio::load_coord_ascii(SpMat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::load_auto_detect(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
+  #if defined(ARMA_USE_HDF5)
+    // We're currently using the C bindings for the HDF5 library, which don't support C++ streams
+    if( arma_H5Fis_hdf5(name.c_str()) ) { return load_hdf5_binary(x, name, err_msg); }
+  #endif
+  
   std::fstream f;
   f.open(name.c_str(), std::fstream::in | std::fstream::binary);
   
@@ -2749,7 +4568,7 @@ diskio::load_coord_ascii(SpMat<eT>& x, const std::string& name, std::string& err
   
   if(load_okay)
     {
-    load_okay = diskio::load_coord_ascii(x, f, err_msg);
+    load_okay = diskio::load_auto_detect(x, f, err_msg);
     f.close();
     }
   
@@ -2758,224 +4577,163 @@ diskio::load_coord_ascii(SpMat<eT>& x, const std::string& name, std::string& err
 
 
 
+//! Try to load a cube by automatically determining its type
 template<typename eT>
 inline
 bool
-diskio::load_coord_ascii(SpMat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::load_auto_detect(Cube<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
-  arma_ignore(err_msg);
   
-  bool load_okay = f.good();
+  const char* ARMA_CUB_TXT_str = "ARMA_CUB_TXT";
+  const char* ARMA_CUB_BIN_str = "ARMA_CUB_BIN";
+  const char*           P6_str = "P6";
+  const char*          NPY_str = "\x93NUMPY";
   
-  f.clear();
-  const std::fstream::pos_type pos1 = f.tellg();
+  const uword ARMA_CUB_TXT_len = uword(12);
+  const uword ARMA_CUB_BIN_len = uword(12);
+  const uword           P6_len = uword(2);
+  const uword          NPY_len = uword(6);
   
-  // work out the size
+  podarray<char> header(ARMA_CUB_TXT_len + 1);
   
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
+  char* header_mem = header.memptr();
   
-  bool size_found = false;
+  std::streampos pos = f.tellg();
   
-  std::string       line_string;
-  std::stringstream line_stream;
+  f.read( header_mem, std::streamsize(ARMA_CUB_TXT_len) );
+  f.clear();
+  f.seekg(pos);
   
-  std::string token;
+  header_mem[ARMA_CUB_TXT_len] = '\0';
   
-  while( f.good() && load_okay )
+  if( std::strncmp(ARMA_CUB_TXT_str, header_mem, size_t(ARMA_CUB_TXT_len)) == 0 )
     {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword line_row = 0;
-    uword line_col = 0;
-    
-    // a valid line in co-ord format has at least 2 entries
-    
-    line_stream >> line_row;
-    
-    if(line_stream.good() == false)  { load_okay = false; break; }
-    
-    line_stream >> line_col;
-    
-    size_found = true;
+    return load_arma_ascii(x, f, err_msg);
+    }
+  else
+  if( std::strncmp(ARMA_CUB_BIN_str, header_mem, size_t(ARMA_CUB_BIN_len)) == 0 )
+    {
+    return load_arma_binary(x, f, err_msg);
+    }
+  else
+  if( std::strncmp(P6_str, header_mem, size_t(P6_len)) == 0 )
+    {
+    return load_ppm_binary(x, f, err_msg);
+    }
+  else
+  if( std::strncmp(NPY_str, header_mem, size_t(NPY_len)) == 0 )
+    {
+    return load_npy_binary(x, f, err_msg);
+    }
+  else
+    {
+    const file_type ft = guess_file_type_internal(f);
     
-    if(f_n_rows < line_row)  { f_n_rows = line_row; }
-    if(f_n_cols < line_col)  { f_n_cols = line_col; }
+    switch(ft)
+      {
+      // case csv_ascii:
+      //   return load_csv_ascii(x, f, err_msg);
+      //   break;
+      
+      case raw_binary:
+        return load_raw_binary(x, f, err_msg);
+        break;
+        
+      case raw_ascii:
+        return load_raw_ascii(x, f, err_msg);
+        break;
+        
+      default:
+        err_msg = "unknown data in ";
+        return false;
+      }
     }
   
+  return false;
+  }
+
+
+
+
+
+// fields
+
+
+
+template<typename T1>
+inline
+bool
+diskio::save_arma_binary(const field<T1>& x, const std::string& final_name)
+  {
+  arma_extra_debug_sigprint();
+  
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  // take into account that indices start at 0
-  if(size_found)  { ++f_n_rows;  ++f_n_cols; }
+  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
   
+  bool save_okay = f.is_open();
   
-  if(load_okay)
+  if(save_okay)
     {
-    f.clear();
-    f.seekg(pos1);
-    
-    MapMat<eT> tmp(f_n_rows, f_n_cols);
+    save_okay = diskio::save_arma_binary(x, f);
     
-    while(f.good())
-      {
-      std::getline(f, line_string);
-      
-      if(line_string.size() == 0)  { break; }
-      
-      line_stream.clear();
-      line_stream.str(line_string);
-      
-      uword line_row = 0;
-      uword line_col = 0;
-      
-      line_stream >> line_row;
-      line_stream >> line_col;
-      
-      eT val = eT(0);
-      
-      line_stream >> token;
-      
-      if(line_stream.fail() == false)
-        {
-        diskio::convert_token( val, token );
-        }
-      
-      if(val != eT(0))  { tmp(line_row,line_col) = val; }
-      }
+    f.flush();
+    f.close();
     
-    x = tmp;
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-template<typename T>
+template<typename T1>
 inline
 bool
-diskio::load_coord_ascii(SpMat< std::complex<T> >& x, std::istream& f, std::string& err_msg)
+diskio::save_arma_binary(const field<T1>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
-  arma_ignore(err_msg);
-  
-  bool load_okay = f.good();
-  
-  f.clear();
-  const std::fstream::pos_type pos1 = f.tellg();
-  
-  // work out the size
-  
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
-  
-  bool size_found = false;
   
-  std::string       line_string;
-  std::stringstream line_stream;
-  
-  std::string token_real;
-  std::string token_imag;
+  arma_type_check(( (is_Mat<T1>::value == false) && (is_Cube<T1>::value == false) ));
   
-  while( f.good() && load_okay )
+  if(x.n_slices <= 1)
     {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    line_stream.clear();
-    line_stream.str(line_string);
-    
-    uword line_row = 0;
-    uword line_col = 0;
-    
-    // a valid line in co-ord format has at least 2 entries
-    
-    line_stream >> line_row;
-    
-    if(line_stream.good() == false)  { load_okay = false; break; }
-    
-    line_stream >> line_col;
-    
-    size_found = true;
-    
-    if(f_n_rows < line_row)  f_n_rows = line_row;
-    if(f_n_cols < line_col)  f_n_cols = line_col;
+    f << "ARMA_FLD_BIN" << '\n';
+    f << x.n_rows       << '\n';
+    f << x.n_cols       << '\n';
+    }
+  else
+    {
+    f << "ARMA_FL3_BIN" << '\n';
+    f << x.n_rows       << '\n';
+    f << x.n_cols       << '\n';
+    f << x.n_slices     << '\n';
     }
   
-  // take into account that indices start at 0
-  if(size_found)  { ++f_n_rows;  ++f_n_cols; }
+  bool save_okay = true;
   
-  if(load_okay)
+  for(uword i=0; i<x.n_elem; ++i)
     {
-    f.clear();
-    f.seekg(pos1);
-    
-    MapMat< std::complex<T> > tmp(f_n_rows, f_n_cols);
-    
-    while(f.good())
-      {
-      std::getline(f, line_string);
-      
-      if(line_string.size() == 0)  { break; }
-      
-      line_stream.clear();
-      line_stream.str(line_string);
-      
-      uword line_row = 0;
-      uword line_col = 0;
-      
-      line_stream >> line_row;
-      line_stream >> line_col;
-      
-      T val_real = T(0);
-      T val_imag = T(0);
-      
-      line_stream >> token_real;
-      
-      if(line_stream.fail() == false)
-        {
-        diskio::convert_token( val_real, token_real );
-        }
-      
-      
-      line_stream >> token_imag;
-      
-      if(line_stream.fail() == false)
-        {
-        diskio::convert_token( val_imag, token_imag );
-        }
-      
-      if( (val_real != T(0)) || (val_imag != T(0)) )
-        {
-        tmp(line_row,line_col) = std::complex<T>(val_real, val_imag);
-        }
-      }
+    save_okay = diskio::save_arma_binary(x[i], f);
     
-    x = tmp;
+    if(save_okay == false)  { break; }
     }
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Load a matrix in binary format,
-//! with a header that indicates the matrix type as well as its dimensions
-template<typename eT>
+template<typename T1>
 inline
 bool
-diskio::load_arma_binary(SpMat<eT>& x, const std::string& name, std::string& err_msg)
+diskio::load_arma_binary(field<T1>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f;
-  f.open(name.c_str(), std::fstream::binary);
+  std::ifstream f( name.c_str(), std::fstream::binary );
   
   bool load_okay = f.is_open();
   
@@ -2990,96 +4748,65 @@ diskio::load_arma_binary(SpMat<eT>& x, const std::string& name, std::string& err
 
 
 
-template<typename eT>
+template<typename T1>
 inline
 bool
-diskio::load_arma_binary(SpMat<eT>& x, std::istream& f, std::string& err_msg)
+diskio::load_arma_binary(field<T1>& x, std::istream& f, std::string& err_msg)
   {
-  arma_extra_debug_sigprint();
-  
-  bool load_okay = true;
-  
-  std::string f_header;
-  
-  f >> f_header;
-  
-  if(f_header == diskio::gen_bin_header(x))
-    {
-    uword f_n_rows;
-    uword f_n_cols;
-    uword f_n_nz;
-    
-    f >> f_n_rows;
-    f >> f_n_cols;
-    f >> f_n_nz;
-    
-    //f.seekg(1, ios::cur);  // NOTE: this may not be portable, as on a Windows machine a newline could be two characters
-    f.get();
-    
-    x.reserve(f_n_rows, f_n_cols, f_n_nz);
-    
-    f.read( reinterpret_cast<char*>(access::rwp(x.values)),      std::streamsize(x.n_nonzero*sizeof(eT))     );
-    
-    std::streampos pos = f.tellg();
-    
-    f.read( reinterpret_cast<char*>(access::rwp(x.row_indices)), std::streamsize(x.n_nonzero*sizeof(uword))  );
-    f.read( reinterpret_cast<char*>(access::rwp(x.col_ptrs)),    std::streamsize((x.n_cols+1)*sizeof(uword)) );
-    
-    bool check1 = true;  for(uword i=0; i < x.n_nonzero; ++i)  { if(x.values[i] == eT(0))  { check1 = false; break; } }
-    bool check2 = true;  for(uword i=0; i < x.n_cols;    ++i)  { if(x.col_ptrs[i+1] < x.col_ptrs[i])  { check2 = false; break; } }
-    bool check3 = (x.col_ptrs[x.n_cols] == x.n_nonzero);
-    
-    if((check1 == true) && ((check2 == false) || (check3 == false)))
-      {
-      if(sizeof(uword) == 8)
-        {
-        arma_extra_debug_print("detected inconsistent data while loading; re-reading integer parts as u32");
-        
-        // inconstency could be due to a different uword size used during saving,
-        // so try loading the row_indices and col_ptrs under the assumption of 32 bit unsigned integers
-        
-        f.clear();
-        f.seekg(pos);
-        
-        podarray<u32> tmp_a(x.n_nonzero );  tmp_a.zeros();
-        podarray<u32> tmp_b(x.n_cols + 1);  tmp_b.zeros();
-        
-        f.read( reinterpret_cast<char*>(tmp_a.memptr()), std::streamsize( x.n_nonzero   * sizeof(u32)) );
-        f.read( reinterpret_cast<char*>(tmp_b.memptr()), std::streamsize((x.n_cols + 1) * sizeof(u32)) );
-        
-        check2 = true;  for(uword i=0; i < x.n_cols; ++i)  { if(tmp_b[i+1] < tmp_b[i])  { check2 = false; break; } }
-        check3 = (tmp_b[x.n_cols] == x.n_nonzero);
-        
-        load_okay = f.good();
-        
-        if( load_okay && (check2 == true) && (check3 == true) )
-          {
-          arma_extra_debug_print("reading integer parts as u32 succeeded");
-          
-          arrayops::convert(access::rwp(x.row_indices), tmp_a.memptr(), x.n_nonzero );
-          arrayops::convert(access::rwp(x.col_ptrs),    tmp_b.memptr(), x.n_cols + 1);
-          }
-        else
-          {
-          arma_extra_debug_print("reading integer parts as u32 failed");
-          }
-        }
-      }
+  arma_extra_debug_sigprint();
+  
+  arma_type_check(( (is_Mat<T1>::value == false) && (is_Cube<T1>::value == false) ));
+  
+  bool load_okay = true;
+  
+  std::string f_type;
+  f >> f_type;
+  
+  if(f_type == "ARMA_FLD_BIN")
+    {
+    uword f_n_rows;
+    uword f_n_cols;
     
-    if((check1 == false) || (check2 == false) || (check3 == false))
+    f >> f_n_rows;
+    f >> f_n_cols;
+    
+    x.set_size(f_n_rows, f_n_cols);
+    
+    f.get();
+    
+    for(uword i=0; i<x.n_elem; ++i)
       {
-      load_okay = false;
-      err_msg = "inconsistent data in ";
+      load_okay = diskio::load_arma_binary(x[i], f, err_msg);
+      
+      if(load_okay == false)  { break; }
       }
-    else
+    }
+  else
+  if(f_type == "ARMA_FL3_BIN")
+    {
+    uword f_n_rows;
+    uword f_n_cols;
+    uword f_n_slices;
+    
+    f >> f_n_rows;
+    f >> f_n_cols;
+    f >> f_n_slices;
+    
+    x.set_size(f_n_rows, f_n_cols, f_n_slices);
+    
+    f.get();
+    
+    for(uword i=0; i<x.n_elem; ++i)
       {
-      load_okay = f.good();
+      load_okay = diskio::load_arma_binary(x[i], f, err_msg);
+      
+      if(load_okay == false)  { break; }
       }
     }
   else
     {
     load_okay = false;
-    err_msg = "incorrect header in ";
+    err_msg = "unsupported field type in ";
     }
   
   return load_okay;
@@ -3087,27 +4814,21 @@ diskio::load_arma_binary(SpMat<eT>& x, std::istream& f, std::string& err_msg)
 
 
 
-// cubes
-
-
-
-//! Save a cube as raw text (no header, human readable).
-template<typename eT>
 inline
 bool
-diskio::save_raw_ascii(const Cube<eT>& x, const std::string& final_name)
+diskio::save_std_string(const field<std::string>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
   const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::fstream f(tmp_name.c_str(), std::fstream::out);
+  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
   
   bool save_okay = f.is_open();
   
   if(save_okay)
     {
-    save_okay = save_raw_ascii(x, f);
+    save_okay = diskio::save_std_string(x, f);
     
     f.flush();
     f.close();
@@ -3120,402 +4841,408 @@ diskio::save_raw_ascii(const Cube<eT>& x, const std::string& final_name)
 
 
 
-//! Save a cube as raw text (no header, human readable).
-template<typename eT>
 inline
 bool
-diskio::save_raw_ascii(const Cube<eT>& x, std::ostream& f)
+diskio::save_std_string(const field<std::string>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  const arma_ostream_state stream_state(f);
-  
-  const std::streamsize cell_width = diskio::prepare_stream<eT>(f);
-  
-  for(uword slice=0; slice < x.n_slices; ++slice)
+  for(uword row=0; row<x.n_rows; ++row)
+  for(uword col=0; col<x.n_cols; ++col)
     {
-    for(uword row=0; row < x.n_rows; ++row)
+    f << x.at(row,col);
+    
+    if(col < x.n_cols-1)
       {
-      for(uword col=0; col < x.n_cols; ++col)
-        {
-        f.put(' ');
-        
-        if(is_real<eT>::value)  { f.width(cell_width); }
-        
-        arma_ostream::raw_print_elem(f, x.at(row,col,slice));
-        }
-        
-      f.put('\n');
+      f << ' ';
+      }
+    else
+      {
+      f << '\n';
       }
     }
   
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
+  return f.good();
   }
 
 
 
-//! Save a cube as raw binary (no header)
-template<typename eT>
 inline
 bool
-diskio::save_raw_binary(const Cube<eT>& x, const std::string& final_name)
+diskio::load_std_string(field<std::string>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
+  std::ifstream f( name.c_str() );
   
-  bool save_okay = f.is_open();
+  bool load_okay = f.is_open();
   
-  if(save_okay)
+  if(load_okay)
     {
-    save_okay = diskio::save_raw_binary(x, f);
-    
-    f.flush();
+    load_okay = diskio::load_std_string(x, f, err_msg);
     f.close();
-    
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return save_okay;
+  return load_okay;
   }
 
 
 
-template<typename eT>
 inline
 bool
-diskio::save_raw_binary(const Cube<eT>& x, std::ostream& f)
+diskio::load_std_string(field<std::string>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
+  bool load_okay = true;
   
-  return f.good();
+  //
+  // work out the size
+  
+  uword f_n_rows = 0;
+  uword f_n_cols = 0;
+  
+  bool f_n_cols_found = false;
+  
+  std::string line_string;
+  std::string token;
+  
+  while( f.good() && load_okay )
+    {
+    std::getline(f, line_string);
+    
+    if(line_string.size() == 0)  { break; }
+    
+    std::stringstream line_stream(line_string);
+    
+    uword line_n_cols = 0;
+    
+    while(line_stream >> token)  { line_n_cols++; }
+    
+    if(f_n_cols_found == false)
+      {
+      f_n_cols = line_n_cols;
+      f_n_cols_found = true;
+      }
+    else
+      {
+      if(line_n_cols != f_n_cols)
+        {
+        load_okay = false;
+        err_msg = "inconsistent number of columns in ";
+        }
+      }
+    
+    ++f_n_rows;
+    }
+    
+  if(load_okay)
+    {
+    f.clear();
+    f.seekg(0, ios::beg);
+    //f.seekg(start);
+    
+    x.set_size(f_n_rows, f_n_cols);
+    
+    for(uword row=0; row < x.n_rows; ++row)
+    for(uword col=0; col < x.n_cols; ++col)
+      {
+      f >> x.at(row,col);
+      }
+    }
+  
+  if(f.good() == false)  { load_okay = false; }
+  
+  return load_okay;
   }
 
 
 
-//! Save a cube in text format (human readable),
-//! with a header that indicates the cube type as well as its dimensions
-template<typename eT>
+//! Try to load a field by automatically determining its type
+template<typename T1>
 inline
 bool
-diskio::save_arma_ascii(const Cube<eT>& x, const std::string& final_name)
+diskio::load_auto_detect(field<T1>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::ofstream f(tmp_name.c_str());
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
   
-  bool save_okay = f.is_open();
+  bool load_okay = f.is_open();
   
-  if(save_okay)
+  if(load_okay)
     {
-    save_okay = diskio::save_arma_ascii(x, f);
-    
-    f.flush();
+    load_okay = diskio::load_auto_detect(x, f, err_msg);
     f.close();
-    
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return save_okay;
+  return load_okay;
   }
 
 
 
-//! Save a cube in text format (human readable),
-//! with a header that indicates the cube type as well as its dimensions
-template<typename eT>
+//! Try to load a field by automatically determining its type
+template<typename T1>
 inline
 bool
-diskio::save_arma_ascii(const Cube<eT>& x, std::ostream& f)
+diskio::load_auto_detect(field<T1>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const arma_ostream_state stream_state(f);
+  arma_type_check(( is_Mat<T1>::value == false ));
   
-  f << diskio::gen_txt_header(x) << '\n';
-  f << x.n_rows << ' ' << x.n_cols << ' ' << x.n_slices << '\n';
+  static const std::string ARMA_FLD_BIN = "ARMA_FLD_BIN";
+  static const std::string ARMA_FL3_BIN = "ARMA_FL3_BIN";
+  static const std::string           P6 = "P6";
+  static const std::string          NPZ = std::string("PK\x03\x04", 4);
   
-  const std::streamsize cell_width = diskio::prepare_stream<eT>(f);
+  podarray<char> raw_header(uword(ARMA_FLD_BIN.length()) + 1);
   
-  for(uword slice=0; slice < x.n_slices; ++slice)
+  std::streampos pos = f.tellg();
+  
+  f.read( raw_header.memptr(), std::streamsize(ARMA_FLD_BIN.length()) );
+  
+  f.clear();
+  f.seekg(pos);
+  
+  raw_header[uword(ARMA_FLD_BIN.length())] = '\0';
+  
+  const std::string header = raw_header.mem;
+  
+  if(ARMA_FLD_BIN == header.substr(0, ARMA_FLD_BIN.length()))
     {
-    for(uword row=0; row < x.n_rows; ++row)
-      {
-      for(uword col=0; col < x.n_cols; ++col)
-        {
-        f.put(' ');
-        
-        if(is_real<eT>::value)  { f.width(cell_width); }
-        
-        arma_ostream::raw_print_elem(f, x.at(row,col,slice));
-        }
-      
-      f.put('\n');
-      }
+    return load_arma_binary(x, f, err_msg);
+    }
+  else
+  if(ARMA_FL3_BIN == header.substr(0, ARMA_FL3_BIN.length()))
+    {
+    return load_arma_binary(x, f, err_msg);
+    }
+  else
+  if(P6 == header.substr(0, P6.length()))
+    {
+    return load_ppm_binary(x, f, err_msg);
+    }
+  else
+  if(NPZ == header.substr(0, NPZ.length()))
+    {
+    return load_npy_binary(x, f, err_msg);
+    }
+  else
+    {
+    err_msg = "unsupported header in ";
+    return false;
     }
-  
-  const bool save_okay = f.good();
-  
-  stream_state.restore(f);
-  
-  return save_okay;
   }
 
 
 
-//! Save a cube in binary format,
-//! with a header that stores the cube type as well as its dimensions
+//
+// handling of PPM images by cubes
+
+
 template<typename eT>
 inline
 bool
-diskio::save_arma_binary(const Cube<eT>& x, const std::string& final_name)
+diskio::load_ppm_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  
-  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
   
-  bool save_okay = f.is_open();
+  bool load_okay = f.is_open();
   
-  if(save_okay)
+  if(load_okay)
     {
-    save_okay = diskio::save_arma_binary(x, f);
-    
-    f.flush();
+    load_okay = diskio::load_ppm_binary(x, f, err_msg);
     f.close();
-    
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return save_okay;
+  return load_okay;
   }
 
 
 
-//! Save a cube in binary format,
-//! with a header that stores the cube type as well as its dimensions
 template<typename eT>
 inline
 bool
-diskio::save_arma_binary(const Cube<eT>& x, std::ostream& f)
+diskio::load_ppm_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  f << diskio::gen_bin_header(x) << '\n';
-  f << x.n_rows << ' ' << x.n_cols << ' ' << x.n_slices << '\n';
+  bool load_okay = true;
   
-  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
+  std::string f_header;
   
-  return f.good();
-  }
-
-
-
-//! Save a cube as part of a HDF5 file
-template<typename eT>
-inline
-bool
-diskio::save_hdf5_binary(const Cube<eT>& x, const hdf5_name& spec, std::string& err_msg)
-  {
-  arma_extra_debug_sigprint();
+  f >> f_header;
   
-  #if defined(ARMA_USE_HDF5)
+  if(f_header == "P6")
     {
-    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
-    
-    bool save_okay = false;
-    
-    const bool append  = bool(spec.opts.flags & hdf5_opts::flag_append);
-    const bool replace = bool(spec.opts.flags & hdf5_opts::flag_replace);
-    
-    const bool use_existing_file = ((append || replace) && (arma_H5Fis_hdf5(spec.filename.c_str()) > 0));
-    
-    const std::string tmp_name = (use_existing_file) ? std::string() : diskio::gen_tmp_name(spec.filename);
-    
-    // Set up the file according to HDF5's preferences
-    hid_t file = (use_existing_file) ? arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : arma_H5Fcreate(tmp_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    uword f_n_rows = 0;
+    uword f_n_cols = 0;
+    int f_maxval = 0;
     
-    if(file < 0)  { return false; }
+    diskio::pnm_skip_comments(f);
     
-    // We need to create a dataset, datatype, and dataspace
-    hsize_t dims[3];
-    dims[2] = x.n_rows;
-    dims[1] = x.n_cols;
-    dims[0] = x.n_slices;
+    f >> f_n_cols;
+    diskio::pnm_skip_comments(f);
     
-    hid_t dataspace = arma_H5Screate_simple(3, dims, NULL);   // treat the cube as a 3d array dataspace
-    hid_t datatype  = hdf5_misc::get_hdf5_type<eT>();
+    f >> f_n_rows;
+    diskio::pnm_skip_comments(f);
     
-    // If this returned something invalid, well, it's time to crash.
-    arma_check(datatype == -1, "Cube::save(): unknown datatype for HDF5");
+    f >> f_maxval;
+    f.get();
     
-    // MATLAB forces the users to specify a name at save time for HDF5;
-    // Octave will use the default of 'dataset' unless otherwise specified.
-    // If the user hasn't specified a dataset name, we will use 'dataset'
-    // We may have to split out the group name from the dataset name.
-    std::vector<hid_t> groups;
-    std::string full_name = spec.dsname;
-    size_t loc;
-    while((loc = full_name.find("/")) != std::string::npos)
+    if( (f_maxval > 0) && (f_maxval <= 65535) )
       {
-      // Create another group...
-      if(loc != 0) // Ignore the first /, if there is a leading /.
+      x.set_size(f_n_rows, f_n_cols, 3);
+      
+      if(f_maxval <= 255)
         {
-        hid_t gid = arma_H5Gcreate((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        const uword n_elem = 3*f_n_cols*f_n_rows;
+        podarray<u8> tmp(n_elem);
         
-        if((gid < 0) && use_existing_file)
+        f.read( reinterpret_cast<char*>(tmp.memptr()), std::streamsize(n_elem) );
+        
+        uword i = 0;
+        
+        //cout << "f_n_cols = " << f_n_cols << endl;
+        //cout << "f_n_rows = " << f_n_rows << endl;
+        
+        for(uword row=0; row < f_n_rows; ++row)
+        for(uword col=0; col < f_n_cols; ++col)
           {
-          gid = arma_H5Gopen((groups.size() == 0) ? file : groups[groups.size() - 1], full_name.substr(0, loc).c_str(), H5P_DEFAULT);
+          x.at(row,col,0) = eT(tmp[i+0]);
+          x.at(row,col,1) = eT(tmp[i+1]);
+          x.at(row,col,2) = eT(tmp[i+2]);
+          i+=3;
           }
+        }
+      else
+        {
+        const uword n_elem = 3*f_n_cols*f_n_rows;
+        podarray<u16> tmp(n_elem);
         
-        groups.push_back(gid);
+        f.read( reinterpret_cast<char *>(tmp.memptr()), std::streamsize(2*n_elem) );
+        
+        uword i = 0;
+        
+        for(uword row=0; row < f_n_rows; ++row)
+        for(uword col=0; col < f_n_cols; ++col)
+          {
+          x.at(row,col,0) = eT(tmp[i+0]);
+          x.at(row,col,1) = eT(tmp[i+1]);
+          x.at(row,col,2) = eT(tmp[i+2]);
+          i+=3;
+          }
         }
-      
-      full_name = full_name.substr(loc + 1);
-      }
-    
-    const std::string dataset_name = full_name.empty() ? std::string("dataset") : full_name;
-    
-    const hid_t last_group = (groups.size() == 0) ? file : groups[groups.size() - 1];
-    
-    if(use_existing_file && replace)
-      {
-      arma_H5Ldelete(last_group, dataset_name.c_str(), H5P_DEFAULT);
-      // NOTE: H5Ldelete() in HDF5 v1.8 doesn't reclaim the deleted space; use h5repack to reclaim space: h5repack oldfile.h5 newfile.h5
-      // NOTE: has this behaviour changed in HDF5 1.10 ?
-      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010482.html
-      // NOTE: https://lists.hdfgroup.org/pipermail/hdf-forum_lists.hdfgroup.org/2017-August/010486.html
-      }
-    
-    hid_t dataset = arma_H5Dcreate(last_group, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-    
-    if(dataset < 0)
-      {
-      save_okay = false;
-      
-      err_msg = "couldn't create dataset in ";
       }
     else
       {
-      save_okay = (arma_H5Dwrite(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, x.mem) >= 0);
-      
-      arma_H5Dclose(dataset);
+      load_okay = false;
+      err_msg = "currently no code available to handle loading ";
       }
     
-    arma_H5Tclose(datatype);
-    arma_H5Sclose(dataspace);
-    for(size_t i = 0; i < groups.size(); ++i)  { arma_H5Gclose(groups[i]); }
-    arma_H5Fclose(file);
-    
-    if((use_existing_file == false) && (save_okay == true))  { save_okay = diskio::safe_rename(tmp_name, spec.filename); }
-    
-    return save_okay;
+    if(f.good() == false)  { load_okay = false; }
     }
-  #else
+  else
     {
-    arma_ignore(x);
-    arma_ignore(spec);
-    arma_ignore(err_msg);
-    
-    arma_stop_logic_error("Cube::save(): use of HDF5 must be enabled");
-    
-    return false;
+    load_okay = false;
+    err_msg = "unsupported header in ";
     }
-  #endif
+  
+  return load_okay;
   }
 
 
 
-//! Load a cube as raw text (no header, human readable).
-//! NOTE: this is much slower than reading a file with a header.
 template<typename eT>
 inline
 bool
-diskio::load_raw_ascii(Cube<eT>& x, const std::string& name, std::string& err_msg)
+diskio::save_ppm_binary(const Cube<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  Mat<eT> tmp;
-  const bool load_okay = diskio::load_raw_ascii(tmp, name, err_msg);
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  if(load_okay)
+  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
+  
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
     {
-    if(tmp.is_empty() == false)
-      {
-      x.set_size(tmp.n_rows, tmp.n_cols, 1);
-      
-      x.slice(0) = tmp;
-      }
-    else
-      {
-      x.reset();
-      }
+    save_okay = diskio::save_ppm_binary(x, f);
+    
+    f.flush();
+    f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-//! Load a cube as raw text (no header, human readable).
-//! NOTE: this is much slower than reading a file with a header.
 template<typename eT>
 inline
 bool
-diskio::load_raw_ascii(Cube<eT>& x, std::istream& f, std::string& err_msg)
+diskio::save_ppm_binary(const Cube<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  Mat<eT> tmp;
-  const bool load_okay = diskio::load_raw_ascii(tmp, f, err_msg);
+  arma_debug_check( (x.n_slices != 3), "diskio::save_ppm_binary(): given cube must have exactly 3 slices" );
   
-  if(load_okay)
+  const uword n_elem = 3 * x.n_rows * x.n_cols;
+  podarray<u8> tmp(n_elem);
+  
+  uword i = 0;
+  for(uword row=0; row < x.n_rows; ++row)
     {
-    if(tmp.is_empty() == false)
-      {
-      x.set_size(tmp.n_rows, tmp.n_cols, 1);
-      
-      x.slice(0) = tmp;
-      }
-    else
+    for(uword col=0; col < x.n_cols; ++col)
       {
-      x.reset();
+      tmp[i+0] = u8( access::tmp_real( x.at(row,col,0) ) );
+      tmp[i+1] = u8( access::tmp_real( x.at(row,col,1) ) );
+      tmp[i+2] = u8( access::tmp_real( x.at(row,col,2) ) );
+      
+      i+=3;
       }
     }
   
-  return load_okay;
+  f << "P6" << '\n';
+  f << x.n_cols << '\n';
+  f << x.n_rows << '\n';
+  f << 255 << '\n';
+  
+  f.write( reinterpret_cast<const char*>(tmp.mem), std::streamsize(n_elem) );
+  
+  return f.good();
   }
 
 
 
-//! Load a cube in binary format (no header);
-//! the cube is assumed to have one slice with one column
-template<typename eT>
+//
+// handling of PPM images by fields
+
+
+
+template<typename T1>
 inline
 bool
-diskio::load_raw_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
+diskio::load_ppm_binary(field<T1>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f;
-  f.open(name.c_str(), std::fstream::binary);
+  std::fstream f;
+  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
   
   bool load_okay = f.is_open();
   
   if(load_okay)
     {
-    load_okay = diskio::load_raw_binary(x, f, err_msg);
+    load_okay = diskio::load_ppm_binary(x, f, err_msg);
     f.close();
     }
   
@@ -3524,486 +5251,664 @@ diskio::load_raw_binary(Cube<eT>& x, const std::string& name, std::string& err_m
 
 
 
-template<typename eT>
+template<typename T1>
 inline
 bool
-diskio::load_raw_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
+diskio::load_ppm_binary(field<T1>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
-  arma_ignore(err_msg);
-  
-  f.clear();
-  const std::streampos pos1 = f.tellg();
-  
-  f.clear();
-  f.seekg(0, ios::end);
   
-  f.clear();
-  const std::streampos pos2 = f.tellg();
+  arma_type_check(( is_Mat<T1>::value == false ));
+  typedef typename T1::elem_type eT;
   
-  const uword N = ( (pos1 >= 0) && (pos2 >= 0) ) ? uword(pos2 - pos1) : 0;
+  bool load_okay = true;
   
-  f.clear();
-  //f.seekg(0, ios::beg);
-  f.seekg(pos1);
+  std::string f_header;
   
-  x.set_size(N / uword(sizeof(eT)), 1, 1);
+  f >> f_header;
   
-  f.clear();
-  f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem * uword(sizeof(eT))) );
+  if(f_header == "P6")
+    {
+    uword f_n_rows = 0;
+    uword f_n_cols = 0;
+    int f_maxval = 0;
+    
+    diskio::pnm_skip_comments(f);
+    
+    f >> f_n_cols;
+    diskio::pnm_skip_comments(f);
+    
+    f >> f_n_rows;
+    diskio::pnm_skip_comments(f);
+    
+    f >> f_maxval;
+    f.get();
+    
+    if( (f_maxval > 0) && (f_maxval <= 65535) )
+      {
+      x.set_size(3);
+      Mat<eT>& R = x(0);
+      Mat<eT>& G = x(1);
+      Mat<eT>& B = x(2);
+      
+      R.set_size(f_n_rows,f_n_cols);
+      G.set_size(f_n_rows,f_n_cols);
+      B.set_size(f_n_rows,f_n_cols);
+      
+      if(f_maxval <= 255)
+        {
+        const uword n_elem = 3*f_n_cols*f_n_rows;
+        podarray<u8> tmp(n_elem);
+        
+        f.read( reinterpret_cast<char*>(tmp.memptr()), std::streamsize(n_elem) );
+        
+        uword i = 0;
+        
+        //cout << "f_n_cols = " << f_n_cols << endl;
+        //cout << "f_n_rows = " << f_n_rows << endl;
+        
+        
+        for(uword row=0; row < f_n_rows; ++row)
+          {
+          for(uword col=0; col < f_n_cols; ++col)
+            {
+            R.at(row,col) = eT(tmp[i+0]);
+            G.at(row,col) = eT(tmp[i+1]);
+            B.at(row,col) = eT(tmp[i+2]);
+            i+=3;
+            }
+          
+          }
+        }
+      else
+        {
+        const uword n_elem = 3*f_n_cols*f_n_rows;
+        podarray<u16> tmp(n_elem);
+        
+        f.read( reinterpret_cast<char *>(tmp.memptr()), std::streamsize(2*n_elem) );
+        
+        uword i = 0;
+        
+        for(uword row=0; row < f_n_rows; ++row)
+        for(uword col=0; col < f_n_cols; ++col)
+          {
+          R.at(row,col) = eT(tmp[i+0]);
+          G.at(row,col) = eT(tmp[i+1]);
+          B.at(row,col) = eT(tmp[i+2]);
+          i+=3;
+          }
+        }
+      }
+    else
+      {
+      load_okay = false;
+      err_msg = "currently no code available to handle loading ";
+      }
+    
+    if(f.good() == false)  { load_okay = false; }
+    }
+  else
+    {
+    load_okay = false;
+    err_msg = "unsupported header in ";
+    }
   
-  return f.good();
+  return load_okay;
   }
 
 
 
-//! Load a cube in text format (human readable),
-//! with a header that indicates the cube type as well as its dimensions
-template<typename eT>
+template<typename T1>
 inline
 bool
-diskio::load_arma_ascii(Cube<eT>& x, const std::string& name, std::string& err_msg)
+diskio::save_ppm_binary(const field<T1>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f(name.c_str());
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
   
-  bool load_okay = f.is_open();
+  bool save_okay = f.is_open();
   
-  if(load_okay)
+  if(save_okay)
     {
-    load_okay = diskio::load_arma_ascii(x, f, err_msg);
+    save_okay = diskio::save_ppm_binary(x, f);
+    
+    f.flush();
     f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return load_okay;
+  return save_okay;
   }
-  
 
 
-//! Load a cube in text format (human readable),
-//! with a header that indicates the cube type as well as its dimensions
-template<typename eT>
+
+template<typename T1>
 inline
 bool
-diskio::load_arma_ascii(Cube<eT>& x, std::istream& f, std::string& err_msg)
+diskio::save_ppm_binary(const field<T1>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  std::streampos pos = f.tellg();
-  
-  bool load_okay = true;
+  arma_type_check(( is_Mat<T1>::value == false ));
   
-  std::string f_header;
-  uword       f_n_rows;
-  uword       f_n_cols;
-  uword       f_n_slices;
+  typedef typename T1::elem_type eT;
   
-  f >> f_header;
-  f >> f_n_rows;
-  f >> f_n_cols;
-  f >> f_n_slices;
+  arma_debug_check( (x.n_elem != 3), "diskio::save_ppm_binary(): given field must have exactly 3 matrices of equal size" );
   
-  if(f_header == diskio::gen_txt_header(x))
+  bool same_size = true;
+  for(uword i=1; i<3; ++i)
     {
-    x.set_size(f_n_rows, f_n_cols, f_n_slices);
-
-    for(uword slice = 0; slice < x.n_slices; ++slice)
-    for(uword   row = 0;   row < x.n_rows;   ++row  )
-    for(uword   col = 0;   col < x.n_cols;   ++col  )
+    if( (x(0).n_rows != x(i).n_rows) || (x(0).n_cols != x(i).n_cols) )
       {
-      f >> x.at(row,col,slice);
+      same_size = false;
+      break;
       }
-    
-    load_okay = f.good();
-    }
-  else
-    {
-    load_okay = false;
-    err_msg = "incorrect header in ";
     }
   
+  arma_debug_check( (same_size != true), "diskio::save_ppm_binary(): given field must have exactly 3 matrices of equal size" );
   
-  // allow automatic conversion of u32/s32 cubes into u64/s64 cubes
+  const Mat<eT>& R = x(0);
+  const Mat<eT>& G = x(1);
+  const Mat<eT>& B = x(2);
   
-  if(load_okay == false)
+  f << "P6" << '\n';
+  f << R.n_cols << '\n';
+  f << R.n_rows << '\n';
+  f << 255 << '\n';
+
+  const uword n_elem = 3 * R.n_rows * R.n_cols;
+  podarray<u8> tmp(n_elem);
+
+  uword i = 0;
+  for(uword row=0; row < R.n_rows; ++row)
+  for(uword col=0; col < R.n_cols; ++col)
     {
-    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
-      {
-      Cube<u32>   tmp;
-      std::string junk;
-      
-      f.clear();
-      f.seekg(pos);
-      
-      load_okay = diskio::load_arma_ascii(tmp, f, junk);
-      
-      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
-      }
-    else
-    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
-      {
-      Cube<s32>   tmp;
-      std::string junk;
-      
-      f.clear();
-      f.seekg(pos);
-      
-      load_okay = diskio::load_arma_ascii(tmp, f, junk);
-      
-      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
-      }
+    tmp[i+0] = u8( access::tmp_real( R.at(row,col) ) );
+    tmp[i+1] = u8( access::tmp_real( G.at(row,col) ) );
+    tmp[i+2] = u8( access::tmp_real( B.at(row,col) ) );
+    
+    i+=3;
     }
   
-  return load_okay;
+  f.write( reinterpret_cast<const char*>(tmp.mem), std::streamsize(n_elem) );
+  
+  return f.good();
+  }
+
+
+
+//
+// handling of NumPy .npy files by matrices and cubes, and .npz archives by fields
+//
+// .npy files start with a short header, which is a Python dictionary stating the element type,
+// the storage order (C or Fortran) and the shape of the array; the elements follow the header.
+// .npz files are zip archives holding one .npy file per array.
+
+
+
+//! '<' on little endian machines, '>' on big endian machines
+inline
+char
+diskio::npy_byte_order()
+  {
+  const u16 val = 1;
+  
+  unsigned char first_byte = 0;
+  
+  std::memcpy(&first_byte, &val, 1);
+  
+  return (first_byte == 1) ? '<' : '>';
   }
 
 
 
-//! Load a cube in binary format,
-//! with a header that indicates the cube type as well as its dimensions
+//! type code used by NumPy for the given element type (eg. "f8" for double)
 template<typename eT>
 inline
-bool
-diskio::load_arma_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
+std::string
+diskio::gen_npy_descr()
   {
-  arma_extra_debug_sigprint();
-  
-  std::ifstream f;
-  f.open(name.c_str(), std::fstream::binary);
+  const char kind = (is_cx<eT>::yes) ? 'c' : ( (is_real<eT>::value) ? 'f' : ( (is_signed<eT>::value) ? 'i' : 'u' ) );
   
-  bool load_okay = f.is_open();
+  std::ostringstream ss;
   
-  if(load_okay)
-    {
-    load_okay = diskio::load_arma_binary(x, f, err_msg);
-    f.close();
-    }
+  ss << kind << sizeof(eT);
   
-  return load_okay;
+  return ss.str();
+  }
+
+
+
+template<typename eT>
+inline
+std::string
+diskio::gen_npy_header(const Mat<eT>& x)
+  {
+  return diskio::gen_npy_header<eT>(x.n_rows, x.n_cols, 1, 2);
+  }
+
+
+
+template<typename eT>
+inline
+std::string
+diskio::gen_npy_header(const Cube<eT>& x)
+  {
+  return diskio::gen_npy_header<eT>(x.n_rows, x.n_cols, x.n_slices, 3);
   }
 
 
 
+//! header of a .npy file (format version 1.0) for data stored in Fortran order;
+//! the header is padded so that the data starts at a multiple of 64 bytes
 template<typename eT>
 inline
+std::string
+diskio::gen_npy_header(const uword n_rows, const uword n_cols, const uword n_slices, const uword n_dims)
+  {
+  std::ostringstream ss;
+  
+  ss << "{'descr': '" << ((sizeof(eT) == 1) ? '|' : diskio::npy_byte_order()) << diskio::gen_npy_descr<eT>() << "', ";
+  ss << "'fortran_order': True, ";
+  ss << "'shape': (" << n_rows << ", " << n_cols;
+  
+  if(n_dims == 3)  { ss << ", " << n_slices; }
+  
+  ss << "), }";
+  
+  std::string dict = ss.str();
+  
+  const size_t n_used = 10 + dict.length() + 1;
+  
+  dict.append( (64 - (n_used % 64)) % 64, ' ' );
+  dict.push_back('\n');
+  
+  std::string out("\x93NUMPY\x01\x00", 8);
+  
+  diskio::zip_put(out, u64(dict.length()), 2);
+  
+  out += dict;
+  
+  return out;
+  }
+
+
+
+//! interpret the header of a .npy file held in memory; n_bytes only needs to cover the header
+inline
 bool
-diskio::load_arma_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
+diskio::parse_npy_header(npy_info& info, const char* mem, const size_t n_bytes)
   {
   arma_extra_debug_sigprint();
   
-  std::streampos pos = f.tellg();
-    
-  bool load_okay = true;
+  if( (n_bytes < 10) || (std::memcmp(mem, "\x93NUMPY", 6) != 0) )  { return false; }
   
-  std::string f_header;
-  uword       f_n_rows;
-  uword       f_n_cols;
-  uword       f_n_slices;
+  const unsigned char major = (unsigned char)(mem[6]);
   
-  f >> f_header;
-  f >> f_n_rows;
-  f >> f_n_cols;
-  f >> f_n_slices;
+  size_t start = 0;
+  size_t len   = 0;
   
-  if(f_header == diskio::gen_bin_header(x))
+  if(major == 1)
     {
-    //f.seekg(1, ios::cur);  // NOTE: this may not be portable, as on a Windows machine a newline could be two characters
-    f.get();
-    
-    x.set_size(f_n_rows, f_n_cols, f_n_slices);
-    f.read( reinterpret_cast<char *>(x.memptr()), std::streamsize(x.n_elem*sizeof(eT)) );
-    
-    load_okay = f.good();
+    start = 10;
+    len   = size_t( diskio::zip_get(mem + 8, 2) );
     }
   else
+  if( ((major == 2) || (major == 3)) && (n_bytes >= 12) )
     {
-    load_okay = false;
-    err_msg = "incorrect header in ";
+    start = 12;
+    len   = size_t( diskio::zip_get(mem + 8, 4) );
+    }
+  else
+    {
+    return false;
     }
   
+  if( len > (n_bytes - start) )  { return false; }
   
-  // allow automatic conversion of u32/s32 cubes into u64/s64 cubes
+  info.offset = start + len;
   
-  if(load_okay == false)
+  // the data is aligned to at least 16 bytes
+  if( (info.offset % 16) != 0 )  { return false; }
+  
+  const std::string dict(mem + start, len);
+  
+  // element type
+  
+  size_t pos = dict.find("'descr'");
+  
+  if(pos == std::string::npos)  { return false; }
+  
+  pos = dict.find_first_not_of(" :", pos + 7);
+  
+  if( (pos == std::string::npos) || (dict[pos] != '\'') )  { return false; }
+  
+  const size_t descr_end = dict.find('\'', pos + 1);
+  
+  if( (descr_end == std::string::npos) || (descr_end < (pos + 3)) )  { return false; }
+  
+  const char order = dict[pos + 1];
+  
+  if( (order != '<') && (order != '>') && (order != '|') && (order != '=') )  { return false; }
+  
+  info.native_order = (order == '|') || (order == '=') || (order == diskio::npy_byte_order());
+  info.descr        = dict.substr(pos + 2, descr_end - (pos + 2));
+  
+  // storage order
+  
+  pos = dict.find("'fortran_order'");
+  
+  if(pos == std::string::npos)  { return false; }
+  
+  pos = dict.find_first_not_of(" :", pos + 15);
+  
+  if(pos == std::string::npos)  { return false; }
+  
+       if(dict.compare(pos, 4, "True" ) == 0)  { info.fortran_order = true;  }
+  else if(dict.compare(pos, 5, "False") == 0)  { info.fortran_order = false; }
+  else                                         { return false;               }
+  
+  // shape
+  
+  pos = dict.find("'shape'");
+  
+  if(pos == std::string::npos)  { return false; }
+  
+  pos = dict.find_first_not_of(" :", pos + 7);
+  
+  if( (pos == std::string::npos) || (dict[pos] != '(') )  { return false; }
+  
+  info.shape.clear();
+  
+  ++pos;
+  
+  while(pos < dict.length())
     {
-    if( (sizeof(eT) == 8) && is_same_type<uword,eT>::yes )
-      {
-      Cube<u32>   tmp;
-      std::string junk;
-      
-      f.clear();
-      f.seekg(pos);
-      
-      load_okay = diskio::load_arma_binary(tmp, f, junk);
-      
-      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
-      }
-    else
-    if( (sizeof(eT) == 8) && is_same_type<sword,eT>::yes )
+    const char c = dict[pos];
+    
+    if(c == ')')  { return true; }
+    
+    if( (c == ' ') || (c == ',') || (c == 'L') )  { ++pos; continue; }
+    
+    if( (c < '0') || (c > '9') )  { return false; }
+    
+    u64 val = 0;
+    
+    while( (pos < dict.length()) && (dict[pos] >= '0') && (dict[pos] <= '9') )
       {
-      Cube<s32>   tmp;
-      std::string junk;
-      
-      f.clear();
-      f.seekg(pos);
+      if( val > (u64(ARMA_MAX_UWORD) / 10) )  { return false; }
       
-      load_okay = diskio::load_arma_binary(tmp, f, junk);
+      val = val*10 + u64(dict[pos] - '0');
       
-      if(load_okay)  { x = conv_to< Cube<eT> >::from(tmp); }
+      ++pos;
       }
+    
+    if( val > u64(ARMA_MAX_UWORD) )  { return false; }
+    
+    info.shape.push_back( uword(val) );
     }
   
-  return load_okay;
+  return false;
   }
 
 
 
-//! Load a HDF5 file as a cube
-template<typename eT>
+//! read a .npy file from a stream into buf, which afterwards holds the header followed by the data
 inline
 bool
-diskio::load_hdf5_binary(Cube<eT>& x, const hdf5_name& spec, std::string& err_msg)
+diskio::read_npy(std::vector<char>& buf, std::istream& f)
   {
   arma_extra_debug_sigprint();
   
-  #if defined(ARMA_USE_HDF5)
+  buf.resize(12);
+  
+  f.read( &(buf[0]), std::streamsize(10) );
+  
+  if( (f.good() == false) || (std::memcmp(&(buf[0]), "\x93NUMPY", 6) != 0) )  { return false; }
+  
+  size_t start = 10;
+  size_t len   = size_t( diskio::zip_get(&(buf[8]), 2) );
+  
+  if(buf[6] != char(1))
     {
-    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
-    
-    bool load_okay = false;
-    
-    hid_t fid = arma_H5Fopen(spec.filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-    
-    if(fid >= 0)
-      {
-      // MATLAB HDF5 dataset names are user-specified;
-      // Octave tends to store the datasets in a group, with the actual dataset being referred to as "value".
-      // If the user hasn't specified a dataset, we will search for "dataset" and "value",
-      // and if those are not found we will take the first dataset we do find.
-      
-      std::vector<std::string> searchNames;
-      
-      const bool exact = (spec.dsname.empty() == false);
-      
-      if(exact)
-        {
-        searchNames.push_back(spec.dsname);
-        }
-      else
-        {
-        searchNames.push_back("dataset");
-        searchNames.push_back("value"  );
-        }
-      
-      hid_t dataset = hdf5_misc::search_hdf5_file(searchNames, fid, 3, exact);
-      
-      if(dataset >= 0)
-        {
-        hid_t filespace = arma_H5Dget_space(dataset);
-        
-        // This must be <= 3 due to our search rules.
-        const int ndims = arma_H5Sget_simple_extent_ndims(filespace);
-        
-        hsize_t dims[3];
-        const herr_t query_status = arma_H5Sget_simple_extent_dims(filespace, dims, NULL);
-        
-        // arma_check(query_status < 0, "Cube::load(): cannot get size of HDF5 dataset");
-        if(query_status < 0)
-          {
-          err_msg = "cannot get size of HDF5 dataset in ";
-          
-          arma_H5Sclose(filespace);
-          arma_H5Dclose(dataset);
-          arma_H5Fclose(fid);
-          
-          return false;
-          }
-        
-        if(ndims == 1) { dims[1] = 1; dims[2] = 1; }  // Vector case; one row/colum, several slices
-        if(ndims == 2) {              dims[2] = 1; }  // Matrix case; one column, several rows/slices
-        
-        x.set_size(dims[2], dims[1], dims[0]);
-        
-        // Now we have to see what type is stored to figure out how to load it.
-        hid_t datatype = arma_H5Dget_type(dataset);
-        hid_t mat_type = hdf5_misc::get_hdf5_type<eT>();
-        
-        // If these are the same type, it is simple.
-        if(arma_H5Tequal(datatype, mat_type) > 0)
-          {
-          // Load directly; H5S_ALL used so that we load the entire dataset.
-          hid_t read_status = arma_H5Dread(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, void_ptr(x.memptr()));
-          
-          if(read_status >= 0) { load_okay = true; }
-          }
-        else
-          {
-          // Load into another array and convert its type accordingly.
-          hid_t read_status = hdf5_misc::load_and_convert_hdf5(x.memptr(), dataset, datatype, x.n_elem);
-          
-          if(read_status >= 0) { load_okay = true; }
-          }
-        
-        // Now clean up.
-        arma_H5Tclose(datatype);
-        arma_H5Tclose(mat_type);
-        arma_H5Sclose(filespace);
-        }
-      
-      arma_H5Dclose(dataset);
-      
-      arma_H5Fclose(fid);
-      
-      if(load_okay == false)
-        {
-        err_msg = "unsupported or missing HDF5 data in ";
-        }
-      }
-    else
-      {
-      err_msg = "cannot open file ";
-      }
+    f.read( &(buf[10]), std::streamsize(2) );
     
-    return load_okay;
+    start = 12;
+    len   = size_t( diskio::zip_get(&(buf[8]), 4) );
     }
-  #else
+  
+  buf.resize(start + len);
+  
+  f.read( &(buf[start]), std::streamsize(len) );
+  
+  npy_info info;
+  
+  if( (f.good() == false) || (diskio::parse_npy_header(info, &(buf[0]), buf.size()) == false) )  { return false; }
+  
+  u64 n_bytes = (info.descr.length() > 1) ? u64( std::strtoul(info.descr.c_str() + 1, nullptr, 10) ) : u64(0);
+  
+  for(uword i=0; i < info.shape.size(); ++i)
     {
-    arma_ignore(x);
-    arma_ignore(spec);
-    arma_ignore(err_msg);
-    
-    arma_stop_logic_error("Cube::load(): use of HDF5 must be enabled");
+    if( (info.shape[i] > 0) && (n_bytes > (u64(ARMA_MAX_UWORD) / u64(info.shape[i]))) )  { return false; }
     
-    return false;
+    n_bytes *= u64(info.shape[i]);
     }
-  #endif
+  
+  buf.resize(buf.size() + size_t(n_bytes));
+  
+  if(n_bytes > 0)  { f.read( &(buf[info.offset]), std::streamsize(n_bytes) ); }
+  
+  return f.good();
   }
 
 
 
-//! Try to load a cube by automatically determining its type
+//! size of a matrix (n_dims_max = 2) or cube (n_dims_max = 3) to hold the array described by a .npy header;
+//! one dimensional arrays are stored as column vectors, or row vectors if is_row is true
+inline
+bool
+diskio::npy_dims(uword& n_rows, uword& n_cols, uword& n_slices, const npy_info& info, const uword n_dims_max, const bool is_row)
+  {
+  const uword n_dims = uword(info.shape.size());
+  
+  if(n_dims > n_dims_max)  { return false; }
+  
+  n_rows   = (n_dims >= 1) ? info.shape[0] : uword(1);
+  n_cols   = (n_dims >= 2) ? info.shape[1] : uword(1);
+  n_slices = (n_dims >= 3) ? info.shape[2] : uword(1);
+  
+  if( (n_dims == 1) && is_row )  { std::swap(n_rows, n_cols); }
+  
+  // check for overflow of the number of elements
+  
+  const double n_elem = double(n_rows) * double(n_cols) * double(n_slices);
+  
+  return ( n_elem <= double(ARMA_MAX_UWORD) );
+  }
+
+
+
+//! true if the elements of the array are stored in the same order as in Armadillo (column-major)
+inline
+bool
+diskio::npy_is_colmajor(const npy_info& info)
+  {
+  if(info.fortran_order)  { return true; }
+  
+  // in C order, arrays with at most one dimension larger than 1 are also stored in column-major order
+  
+  uword n_large = 0;
+  
+  for(uword i=0; i < info.shape.size(); ++i)  { if(info.shape[i] > 1)  { ++n_large; } }
+  
+  return (n_large <= 1);
+  }
+
+
+
+template<typename eT, typename in_eT>
+inline
+void
+diskio::convert_npy_block(eT* out, const in_eT* in, const uword n_elem)
+  {
+  arrayops::convert(out, in, n_elem);
+  }
+
+
+
+template<typename eT, typename in_T>
+inline
+void
+diskio::convert_npy_block(eT* out, const std::complex<in_T>* in, const uword n_elem)
+  {
+  arrayops::convert_cx(out, in, n_elem);
+  }
+
+
+
+//! convert n_elem elements with the NumPy type code descr into elements of type eT;
+//! the data does not need to be aligned, as it is copied in blocks to a suitably aligned buffer
 template<typename eT>
 inline
 bool
-diskio::load_auto_detect(Cube<eT>& x, const std::string& name, std::string& err_msg)
+diskio::convert_npy(eT* out, const std::string& descr, const char* data, const uword n_elem)
   {
   arma_extra_debug_sigprint();
   
-  #if defined(ARMA_USE_HDF5)
-    // We're currently using the C bindings for the HDF5 library, which don't support C++ streams
-    if( arma_H5Fis_hdf5(name.c_str()) ) { return load_hdf5_binary(x, name, err_msg); }
-  #endif
+  const uword block_size = 512;
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
+  cx_double buf_mem[block_size];
   
-  bool load_okay = f.is_open();
+  void* buf = (void*)(&buf_mem[0]);
   
-  if(load_okay)
+  for(uword i=0; i < n_elem; i += block_size)
     {
-    load_okay = diskio::load_auto_detect(x, f, err_msg);
-    f.close();
+    const uword n = (std::min)(block_size, n_elem - i);
+    
+         if( descr == "f4"  )  { std::memcpy(buf, data + i*4,  n*4 ); diskio::convert_npy_block(out + i, (const float*    )(buf), n); }
+    else if( descr == "f8"  )  { std::memcpy(buf, data + i*8,  n*8 ); diskio::convert_npy_block(out + i, (const double*   )(buf), n); }
+    else if( descr == "c8"  )  { std::memcpy(buf, data + i*8,  n*8 ); diskio::convert_npy_block(out + i, (const cx_float* )(buf), n); }
+    else if( descr == "c16" )  { std::memcpy(buf, data + i*16, n*16); diskio::convert_npy_block(out + i, (const cx_double*)(buf), n); }
+    else if( descr == "i1"  )  { std::memcpy(buf, data + i*1,  n*1 ); diskio::convert_npy_block(out + i, (const s8*       )(buf), n); }
+    else if( descr == "i2"  )  { std::memcpy(buf, data + i*2,  n*2 ); diskio::convert_npy_block(out + i, (const s16*      )(buf), n); }
+    else if( descr == "i4"  )  { std::memcpy(buf, data + i*4,  n*4 ); diskio::convert_npy_block(out + i, (const s32*      )(buf), n); }
+    else if( descr == "i8"  )  { std::memcpy(buf, data + i*8,  n*8 ); diskio::convert_npy_block(out + i, (const s64*      )(buf), n); }
+    else if( descr == "u1"  )  { std::memcpy(buf, data + i*1,  n*1 ); diskio::convert_npy_block(out + i, (const u8*       )(buf), n); }
+    else if( descr == "u2"  )  { std::memcpy(buf, data + i*2,  n*2 ); diskio::convert_npy_block(out + i, (const u16*      )(buf), n); }
+    else if( descr == "u4"  )  { std::memcpy(buf, data + i*4,  n*4 ); diskio::convert_npy_block(out + i, (const u32*      )(buf), n); }
+    else if( descr == "u8"  )  { std::memcpy(buf, data + i*8,  n*8 ); diskio::convert_npy_block(out + i, (const u64*      )(buf), n); }
+    else if( descr == "b1"  )  { std::memcpy(buf, data + i*1,  n*1 ); diskio::convert_npy_block(out + i, (const u8*       )(buf), n); }
+    else                       { return false; }
     }
   
-  return load_okay;
+  return true;
   }
 
 
 
-//! Try to load a cube by automatically determining its type
+//! Load the array of a .npy file held in memory into n_rows x n_cols x n_slices elements, stored in column-major order.
+//! Data with the same element type and storage order is copied directly;
+//! data stored in C order is rearranged via blocked transposes (op_strans);
+//! data with other element types is converted first.
 template<typename eT>
 inline
 bool
-diskio::load_auto_detect(Cube<eT>& x, std::istream& f, std::string& err_msg)
+diskio::load_npy_data(eT* out, const npy_info& info, const char* mem, const size_t n_bytes, const uword n_rows, const uword n_cols, const uword n_slices, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const char* ARMA_CUB_TXT_str = "ARMA_CUB_TXT";
-  const char* ARMA_CUB_BIN_str = "ARMA_CUB_BIN";
-  const char*           P6_str = "P6";
+  if(info.native_order == false)  { err_msg = "unsupported byte order in "; return false; }
   
-  const uword ARMA_CUB_TXT_len = uword(12);
-  const uword ARMA_CUB_BIN_len = uword(12);
-  const uword           P6_len = uword(2);
+  if( (is_cx<eT>::no) && (info.descr.length() > 0) && (info.descr[0] == 'c') )  { err_msg = "complex data in "; return false; }
   
-  podarray<char> header(ARMA_CUB_TXT_len + 1);
+  const uword  n_elem    = n_rows * n_cols * n_slices;
+  const size_t elem_size = (info.descr.length() > 1) ? size_t( std::strtoul(info.descr.c_str() + 1, nullptr, 10) ) : size_t(0);
   
-  char* header_mem = header.memptr();
+  if( (elem_size == 0) || (size_t(n_elem) > ((n_bytes - info.offset) / elem_size)) )
+    {
+    err_msg = (elem_size == 0) ? "unsupported element type in " : "not enough data in ";
+    return false;
+    }
   
-  std::streampos pos = f.tellg();
+  if(n_elem == 0)  { return true; }
   
-  f.read( header_mem, std::streamsize(ARMA_CUB_TXT_len) );
-  f.clear();
-  f.seekg(pos);
+  const char* data = mem + info.offset;
   
-  header_mem[ARMA_CUB_TXT_len] = '\0';
+  const bool same_type = (info.descr == diskio::gen_npy_descr<eT>()) && ((size_t(data) % alignof(eT)) == 0);
   
-  if( std::strncmp(ARMA_CUB_TXT_str, header_mem, size_t(ARMA_CUB_TXT_len)) == 0 )
-    {
-    return load_arma_ascii(x, f, err_msg);
-    }
-  else
-  if( std::strncmp(ARMA_CUB_BIN_str, header_mem, size_t(ARMA_CUB_BIN_len)) == 0 )
+  const bool is_colmajor = diskio::npy_is_colmajor(info);
+  
+  // elements in the order of the file
+  
+  Mat<eT> tmp;
+  
+  const eT* src = (same_type) ? (const eT*)(data) : nullptr;
+  
+  if(same_type == false)
     {
-    return load_arma_binary(x, f, err_msg);
+    eT* dest = out;
+    
+    if(is_colmajor == false)  { tmp.set_size(n_elem, 1); dest = tmp.memptr(); }
+    
+    if(diskio::convert_npy(dest, info.descr, data, n_elem) == false)  { err_msg = "unsupported element type in "; return false; }
+    
+    if(is_colmajor)  { return true; }
+    
+    src = tmp.memptr();
     }
-  else
-  if( std::strncmp(P6_str, header_mem, size_t(P6_len)) == 0 )
+  
+  if(is_colmajor)  { arrayops::copy(out, src, n_elem); return true; }
+  
+  // in C order, the element at (row,col,slice) is stored at (row*n_cols + col)*n_slices + slice;
+  // ie. the data is a Fortran order array of size n_slices x n_cols x n_rows
+  
+  Mat<eT> tmp2;
+  
+  if(n_slices > 1)
     {
-    return load_ppm_binary(x, f, err_msg);
+    const Mat<eT> A(const_cast<eT*>(src), n_slices, n_cols*n_rows, false, true);
+    
+    op_strans::apply_mat_noalias(tmp2, A);
+    
+    src = tmp2.memptr();
     }
-  else
+  
+  const uword n_elem_slice = n_rows * n_cols;
+  
+  for(uword slice=0; slice < n_slices; ++slice)
     {
-    const file_type ft = guess_file_type_internal(f);
+    const Mat<eT> A(const_cast<eT*>(src) + slice*n_elem_slice, n_cols, n_rows, false, true);
     
-    switch(ft)
-      {
-      // case csv_ascii:
-      //   return load_csv_ascii(x, f, err_msg);
-      //   break;
-      
-      case raw_binary:
-        return load_raw_binary(x, f, err_msg);
-        break;
-        
-      case raw_ascii:
-        return load_raw_ascii(x, f, err_msg);
-        break;
-        
-      default:
-        err_msg = "unknown data in ";
-        return false;
-      }
+    Mat<eT> B(out + slice*n_elem_slice, n_rows, n_cols, false, true);
+    
+    op_strans::apply_mat_noalias(B, A);
     }
   
-  return false;
+  return true;
   }
 
 
 
-
-
-// fields
-
-
-
-template<typename T1>
+//! Save a matrix as a NumPy .npy file (Fortran order, which is the same as the column-major order of Armadillo)
+template<typename eT>
 inline
 bool
-diskio::save_arma_binary(const field<T1>& x, const std::string& final_name)
+diskio::save_npy_binary(const Mat<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
   const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
   bool save_okay = f.is_open();
   
   if(save_okay)
     {
-    save_okay = diskio::save_arma_binary(x, f);
+    save_okay = diskio::save_npy_binary(x, f);
     
     f.flush();
     f.close();
@@ -4016,485 +5921,403 @@ diskio::save_arma_binary(const field<T1>& x, const std::string& final_name)
 
 
 
-template<typename T1>
+template<typename eT>
 inline
 bool
-diskio::save_arma_binary(const field<T1>& x, std::ostream& f)
+diskio::save_npy_binary(const Mat<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  arma_type_check(( (is_Mat<T1>::value == false) && (is_Cube<T1>::value == false) ));
-  
-  if(x.n_slices <= 1)
-    {
-    f << "ARMA_FLD_BIN" << '\n';
-    f << x.n_rows       << '\n';
-    f << x.n_cols       << '\n';
-    }
-  else
-    {
-    f << "ARMA_FL3_BIN" << '\n';
-    f << x.n_rows       << '\n';
-    f << x.n_cols       << '\n';
-    f << x.n_slices     << '\n';
-    }
+  const std::string header = diskio::gen_npy_header(x);
   
-  bool save_okay = true;
+  f.write( header.c_str(), std::streamsize(header.length()) );
   
-  for(uword i=0; i<x.n_elem; ++i)
-    {
-    save_okay = diskio::save_arma_binary(x[i], f);
-    
-    if(save_okay == false)  { break; }
-    }
+  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
   
-  return save_okay;
+  return f.good();
   }
 
 
 
-template<typename T1>
+//! Save a cube as a NumPy .npy file (Fortran order, with shape (n_rows, n_cols, n_slices))
+template<typename eT>
 inline
 bool
-diskio::load_arma_binary(field<T1>& x, const std::string& name, std::string& err_msg)
+diskio::save_npy_binary(const Cube<eT>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f( name.c_str(), std::fstream::binary );
+  const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  bool load_okay = f.is_open();
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
-  if(load_okay)
+  bool save_okay = f.is_open();
+  
+  if(save_okay)
     {
-    load_okay = diskio::load_arma_binary(x, f, err_msg);
+    save_okay = diskio::save_npy_binary(x, f);
+    
+    f.flush();
     f.close();
+    
+    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return load_okay;
+  return save_okay;
   }
 
 
 
-template<typename T1>
+template<typename eT>
 inline
 bool
-diskio::load_arma_binary(field<T1>& x, std::istream& f, std::string& err_msg)
+diskio::save_npy_binary(const Cube<eT>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  arma_type_check(( (is_Mat<T1>::value == false) && (is_Cube<T1>::value == false) ));
-  
-  bool load_okay = true;
+  const std::string header = diskio::gen_npy_header(x);
   
-  std::string f_type;
-  f >> f_type;
+  f.write( header.c_str(), std::streamsize(header.length()) );
   
-  if(f_type == "ARMA_FLD_BIN")
-    {
-    uword f_n_rows;
-    uword f_n_cols;
-    
-    f >> f_n_rows;
-    f >> f_n_cols;
-    
-    x.set_size(f_n_rows, f_n_cols);
-    
-    f.get();
-    
-    for(uword i=0; i<x.n_elem; ++i)
-      {
-      load_okay = diskio::load_arma_binary(x[i], f, err_msg);
-      
-      if(load_okay == false)  { break; }
-      }
-    }
-  else
-  if(f_type == "ARMA_FL3_BIN")
-    {
-    uword f_n_rows;
-    uword f_n_cols;
-    uword f_n_slices;
-    
-    f >> f_n_rows;
-    f >> f_n_cols;
-    f >> f_n_slices;
-    
-    x.set_size(f_n_rows, f_n_cols, f_n_slices);
-    
-    f.get();
-    
-    for(uword i=0; i<x.n_elem; ++i)
-      {
-      load_okay = diskio::load_arma_binary(x[i], f, err_msg);
-      
-      if(load_okay == false)  { break; }
-      }
-    }
-  else
-    {
-    load_okay = false;
-    err_msg = "unsupported field type in ";
-    }
+  f.write( reinterpret_cast<const char*>(x.mem), std::streamsize(x.n_elem*sizeof(eT)) );
   
-  return load_okay;
+  return f.good();
   }
 
 
 
+//! Load a matrix from a NumPy .npy file; the file is mapped into memory via mmap() if possible
+template<typename eT>
 inline
 bool
-diskio::save_std_string(const field<std::string>& x, const std::string& final_name)
+diskio::load_npy_binary(Mat<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
+  mmap_region region;
   
-  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
+  if(region.map(name, mmap_read_only))
+    {
+    return diskio::load_npy_binary(x, (const char*)(region.memptr()), region.n_bytes(), err_msg);
+    }
+  
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
   
-  bool save_okay = f.is_open();
+  bool load_okay = f.is_open();
   
-  if(save_okay)
+  if(load_okay)
     {
-    save_okay = diskio::save_std_string(x, f);
-    
-    f.flush();
+    load_okay = diskio::load_npy_binary(x, f, err_msg);
     f.close();
-    
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
     }
   
-  return save_okay;
+  return load_okay;
   }
 
 
 
+template<typename eT>
 inline
 bool
-diskio::save_std_string(const field<std::string>& x, std::ostream& f)
+diskio::load_npy_binary(Mat<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  for(uword row=0; row<x.n_rows; ++row)
-  for(uword col=0; col<x.n_cols; ++col)
-    {
-    f << x.at(row,col);
-    
-    if(col < x.n_cols-1)
-      {
-      f << ' ';
-      }
-    else
-      {
-      f << '\n';
-      }
-    }
+  std::vector<char> buf;
   
-  return f.good();
+  if(diskio::read_npy(buf, f) == false)  { err_msg = "incorrect header in "; return false; }
+  
+  return diskio::load_npy_binary(x, &(buf[0]), buf.size(), err_msg);
   }
 
 
 
+template<typename eT>
 inline
 bool
-diskio::load_std_string(field<std::string>& x, const std::string& name, std::string& err_msg)
+diskio::load_npy_binary(Mat<eT>& x, const char* mem, const size_t n_bytes, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  std::ifstream f( name.c_str() );
+  npy_info info;
   
-  bool load_okay = f.is_open();
+  uword f_n_rows   = 0;
+  uword f_n_cols   = 0;
+  uword f_n_slices = 0;
   
-  if(load_okay)
+  if( (diskio::parse_npy_header(info, mem, n_bytes) == false) || (diskio::npy_dims(f_n_rows, f_n_cols, f_n_slices, info, 2, (x.vec_state == 2)) == false) )
     {
-    load_okay = diskio::load_std_string(x, f, err_msg);
-    f.close();
+    err_msg = "incorrect header in ";
+    return false;
     }
   
-  return load_okay;
+  x.set_size(f_n_rows, f_n_cols);
+  
+  return diskio::load_npy_data(x.memptr(), info, mem, n_bytes, f_n_rows, f_n_cols, 1, err_msg);
   }
 
 
 
+//! Load a cube from a NumPy .npy file; the file is mapped into memory via mmap() if possible
+template<typename eT>
 inline
 bool
-diskio::load_std_string(field<std::string>& x, std::istream& f, std::string& err_msg)
+diskio::load_npy_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  bool load_okay = true;
-  
-  //
-  // work out the size
+  mmap_region region;
   
-  uword f_n_rows = 0;
-  uword f_n_cols = 0;
+  if(region.map(name, mmap_read_only))
+    {
+    return diskio::load_npy_binary(x, (const char*)(region.memptr()), region.n_bytes(), err_msg);
+    }
   
-  bool f_n_cols_found = false;
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
   
-  std::string line_string;
-  std::string token;
+  bool load_okay = f.is_open();
   
-  while( f.good() && load_okay )
-    {
-    std::getline(f, line_string);
-    
-    if(line_string.size() == 0)  { break; }
-    
-    std::stringstream line_stream(line_string);
-    
-    uword line_n_cols = 0;
-    
-    while(line_stream >> token)  { line_n_cols++; }
-    
-    if(f_n_cols_found == false)
-      {
-      f_n_cols = line_n_cols;
-      f_n_cols_found = true;
-      }
-    else
-      {
-      if(line_n_cols != f_n_cols)
-        {
-        load_okay = false;
-        err_msg = "inconsistent number of columns in ";
-        }
-      }
-    
-    ++f_n_rows;
-    }
-    
   if(load_okay)
     {
-    f.clear();
-    f.seekg(0, ios::beg);
-    //f.seekg(start);
-    
-    x.set_size(f_n_rows, f_n_cols);
-    
-    for(uword row=0; row < x.n_rows; ++row)
-    for(uword col=0; col < x.n_cols; ++col)
-      {
-      f >> x.at(row,col);
-      }
+    load_okay = diskio::load_npy_binary(x, f, err_msg);
+    f.close();
     }
   
-  if(f.good() == false)  { load_okay = false; }
-  
   return load_okay;
   }
 
 
 
-//! Try to load a field by automatically determining its type
-template<typename T1>
+template<typename eT>
 inline
 bool
-diskio::load_auto_detect(field<T1>& x, const std::string& name, std::string& err_msg)
+diskio::load_npy_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
-  
-  bool load_okay = f.is_open();
+  std::vector<char> buf;
   
-  if(load_okay)
-    {
-    load_okay = diskio::load_auto_detect(x, f, err_msg);
-    f.close();
-    }
+  if(diskio::read_npy(buf, f) == false)  { err_msg = "incorrect header in "; return false; }
   
-  return load_okay;
+  return diskio::load_npy_binary(x, &(buf[0]), buf.size(), err_msg);
   }
 
 
 
-//! Try to load a field by automatically determining its type
-template<typename T1>
+template<typename eT>
 inline
 bool
-diskio::load_auto_detect(field<T1>& x, std::istream& f, std::string& err_msg)
+diskio::load_npy_binary(Cube<eT>& x, const char* mem, const size_t n_bytes, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  arma_type_check(( is_Mat<T1>::value == false ));
+  npy_info info;
   
-  static const std::string ARMA_FLD_BIN = "ARMA_FLD_BIN";
-  static const std::string ARMA_FL3_BIN = "ARMA_FL3_BIN";
-  static const std::string           P6 = "P6";
+  uword f_n_rows   = 0;
+  uword f_n_cols   = 0;
+  uword f_n_slices = 0;
   
-  podarray<char> raw_header(uword(ARMA_FLD_BIN.length()) + 1);
+  if( (diskio::parse_npy_header(info, mem, n_bytes) == false) || (diskio::npy_dims(f_n_rows, f_n_cols, f_n_slices, info, 3, false) == false) )
+    {
+    err_msg = "incorrect header in ";
+    return false;
+    }
   
-  std::streampos pos = f.tellg();
+  x.set_size(f_n_rows, f_n_cols, f_n_slices);
   
-  f.read( raw_header.memptr(), std::streamsize(ARMA_FLD_BIN.length()) );
+  return diskio::load_npy_data(x.memptr(), info, mem, n_bytes, f_n_rows, f_n_cols, f_n_slices, err_msg);
+  }
+
+
+
+//! CRC-32 checksum as used by zip archives; crc is the checksum of any preceding data
+inline
+u32
+diskio::zip_crc32(const char* mem, const size_t n_bytes, const u32 crc)
+  {
+  struct table_type
+    {
+    u32 val[256];
+    
+    inline table_type()
+      {
+      for(u32 i=0; i < 256; ++i)
+        {
+        u32 c = i;
+        
+        for(uword k=0; k < 8; ++k)  { c = (c & 1) ? (u32(0xEDB88320) ^ (c >> 1)) : (c >> 1); }
+        
+        val[i] = c;
+        }
+      }
+    };
   
-  f.clear();
-  f.seekg(pos);
+  static const table_type table;
   
-  raw_header[uword(ARMA_FLD_BIN.length())] = '\0';
+  u32 c = ~crc;
   
-  const std::string header = raw_header.mem;
+  for(size_t i=0; i < n_bytes; ++i)  { c = table.val[ (c ^ u32((unsigned char)(mem[i]))) & 0xFF ] ^ (c >> 8); }
   
-  if(ARMA_FLD_BIN == header.substr(0, ARMA_FLD_BIN.length()))
-    {
-    return load_arma_binary(x, f, err_msg);
-    }
-  else
-  if(ARMA_FL3_BIN == header.substr(0, ARMA_FL3_BIN.length()))
-    {
-    return load_arma_binary(x, f, err_msg);
-    }
-  else
-  if(P6 == header.substr(0, P6.length()))
-    {
-    return load_ppm_binary(x, f, err_msg);
-    }
-  else
-    {
-    err_msg = "unsupported header in ";
-    return false;
-    }
+  return ~c;
   }
 
 
 
-//
-// handling of PPM images by cubes
+//! append an unsigned integer in little endian byte order
+inline
+void
+diskio::zip_put(std::string& out, const u64 val, const uword n_bytes)
+  {
+  for(uword i=0; i < n_bytes; ++i)  { out.push_back( char( (val >> (8*i)) & 0xFF ) ); }
+  }
 
 
-template<typename eT>
+
+//! read an unsigned integer stored in little endian byte order
 inline
-bool
-diskio::load_ppm_binary(Cube<eT>& x, const std::string& name, std::string& err_msg)
+u64
+diskio::zip_get(const char* mem, const uword n_bytes)
   {
-  arma_extra_debug_sigprint();
-  
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
-  
-  bool load_okay = f.is_open();
+  u64 val = 0;
   
-  if(load_okay)
-    {
-    load_okay = diskio::load_ppm_binary(x, f, err_msg);
-    f.close();
-    }
+  for(uword i=0; i < n_bytes; ++i)  { val |= u64((unsigned char)(mem[i])) << (8*i); }
   
-  return load_okay;
+  return val;
   }
 
 
 
-template<typename eT>
+//! find the files stored in a zip archive held in memory, using the central directory at the end of the archive;
+//! zip64 extensions (used by NumPy for all arrays) are supported
 inline
 bool
-diskio::load_ppm_binary(Cube<eT>& x, std::istream& f, std::string& err_msg)
+diskio::parse_npz(std::vector<npz_entry>& entries, const char* mem, const size_t n_bytes)
   {
   arma_extra_debug_sigprint();
   
-  bool load_okay = true;
+  entries.clear();
   
-  std::string f_header;
+  if(n_bytes < 22)  { return false; }
   
-  f >> f_header;
+  // end of central directory record; it is followed by a comment of at most 65535 bytes
   
-  if(f_header == "P6")
+  size_t eocd = n_bytes - 22;
+  
+  const size_t eocd_min = (n_bytes > (22 + 65535)) ? (n_bytes - 22 - 65535) : size_t(0);
+  
+  while( diskio::zip_get(mem + eocd, 4) != u64(0x06054b50) )
     {
-    uword f_n_rows = 0;
-    uword f_n_cols = 0;
-    int f_maxval = 0;
+    if(eocd == eocd_min)  { return false; }
     
-    diskio::pnm_skip_comments(f);
+    --eocd;
+    }
+  
+  u64 n_entries = diskio::zip_get(mem + eocd + 10, 2);
+  u64 cd_offset = diskio::zip_get(mem + eocd + 16, 4);
+  
+  if( (n_entries == 0xFFFF) || (cd_offset == 0xFFFFFFFF) )
+    {
+    // zip64 end of central directory locator, followed by the zip64 end of central directory record
     
-    f >> f_n_cols;
-    diskio::pnm_skip_comments(f);
+    if( (eocd < 20) || (diskio::zip_get(mem + eocd - 20, 4) != u64(0x07064b50)) )  { return false; }
     
-    f >> f_n_rows;
-    diskio::pnm_skip_comments(f);
+    const u64 eocd64 = diskio::zip_get(mem + eocd - 20 + 8, 8);
     
-    f >> f_maxval;
-    f.get();
+    if( (eocd64 > u64(n_bytes - 56)) || (diskio::zip_get(mem + eocd64, 4) != u64(0x06064b50)) )  { return false; }
     
-    if( (f_maxval > 0) && (f_maxval <= 65535) )
+    n_entries = diskio::zip_get(mem + eocd64 + 32, 8);
+    cd_offset = diskio::zip_get(mem + eocd64 + 48, 8);
+    }
+  
+  size_t pos = size_t(cd_offset);
+  
+  for(u64 i=0; i < n_entries; ++i)
+    {
+    if( (pos > (n_bytes - 46)) || (diskio::zip_get(mem + pos, 4) != u64(0x02014b50)) )  { return false; }
+    
+    npz_entry entry;
+    
+    entry.method = u32( diskio::zip_get(mem + pos + 10, 2) );
+    entry.crc    = u32( diskio::zip_get(mem + pos + 16, 4) );
+    
+    u64 n_comp  = diskio::zip_get(mem + pos + 20, 4);
+    u64 n_orig  = diskio::zip_get(mem + pos + 24, 4);
+    u64 local   = diskio::zip_get(mem + pos + 42, 4);
+    
+    const size_t name_len    = size_t( diskio::zip_get(mem + pos + 28, 2) );
+    const size_t extra_len   = size_t( diskio::zip_get(mem + pos + 30, 2) );
+    const size_t comment_len = size_t( diskio::zip_get(mem + pos + 32, 2) );
+    
+    if( (name_len + extra_len) > (n_bytes - pos - 46) )  { return false; }
+    
+    entry.name.assign(mem + pos + 46, name_len);
+    
+    // zip64 extended information: the values which don't fit into 32 bits, in a fixed order
+    
+    const char* extra     = mem + pos + 46 + name_len;
+    const char* extra_end = extra + extra_len;
+    
+    while( (extra + 4) <= extra_end )
       {
-      x.set_size(f_n_rows, f_n_cols, 3);
+      const u64    id  = diskio::zip_get(extra,     2);
+      const size_t len = size_t( diskio::zip_get(extra + 2, 2) );
       
-      if(f_maxval <= 255)
-        {
-        const uword n_elem = 3*f_n_cols*f_n_rows;
-        podarray<u8> tmp(n_elem);
-        
-        f.read( reinterpret_cast<char*>(tmp.memptr()), std::streamsize(n_elem) );
-        
-        uword i = 0;
-        
-        //cout << "f_n_cols = " << f_n_cols << endl;
-        //cout << "f_n_rows = " << f_n_rows << endl;
-        
-        for(uword row=0; row < f_n_rows; ++row)
-        for(uword col=0; col < f_n_cols; ++col)
-          {
-          x.at(row,col,0) = eT(tmp[i+0]);
-          x.at(row,col,1) = eT(tmp[i+1]);
-          x.at(row,col,2) = eT(tmp[i+2]);
-          i+=3;
-          }
-        }
-      else
-        {
-        const uword n_elem = 3*f_n_cols*f_n_rows;
-        podarray<u16> tmp(n_elem);
-        
-        f.read( reinterpret_cast<char *>(tmp.memptr()), std::streamsize(2*n_elem) );
-        
-        uword i = 0;
+      if( (extra + 4 + len) > extra_end )  { break; }
+      
+      if(id == 0x0001)
+        {
+        const char* field_ptr = extra + 4;
+        const char* field_end = extra + 4 + len;
         
-        for(uword row=0; row < f_n_rows; ++row)
-        for(uword col=0; col < f_n_cols; ++col)
-          {
-          x.at(row,col,0) = eT(tmp[i+0]);
-          x.at(row,col,1) = eT(tmp[i+1]);
-          x.at(row,col,2) = eT(tmp[i+2]);
-          i+=3;
-          }
+        if( (n_orig == 0xFFFFFFFF) && ((field_ptr + 8) <= field_end) )  { n_orig = diskio::zip_get(field_ptr, 8); field_ptr += 8; }
+        if( (n_comp == 0xFFFFFFFF) && ((field_ptr + 8) <= field_end) )  { n_comp = diskio::zip_get(field_ptr, 8); field_ptr += 8; }
+        if( (local  == 0xFFFFFFFF) && ((field_ptr + 8) <= field_end) )  { local  = diskio::zip_get(field_ptr, 8); field_ptr += 8; }
         }
-      }
-    else
-      {
-      load_okay = false;
-      err_msg = "currently no code available to handle loading ";
+      
+      extra += 4 + len;
       }
     
-    if(f.good() == false)  { load_okay = false; }
-    }
-  else
-    {
-    load_okay = false;
-    err_msg = "unsupported header in ";
+    // the local header has its own name and extra fields, which precede the data
+    
+    if( (local > u64(n_bytes - 30)) || (diskio::zip_get(mem + local, 4) != u64(0x04034b50)) )  { return false; }
+    
+    const u64 data_start = local + 30 + diskio::zip_get(mem + local + 26, 2) + diskio::zip_get(mem + local + 28, 2);
+    
+    if( (data_start > u64(n_bytes)) || (n_comp > (u64(n_bytes) - data_start)) )  { return false; }
+    
+    entry.offset  = size_t(data_start);
+    entry.n_bytes = size_t(n_comp);
+    
+    entries.push_back(entry);
+    
+    pos += 46 + name_len + extra_len + comment_len;
     }
   
-  return load_okay;
+  return true;
   }
 
 
 
-template<typename eT>
+//! Save a field of matrices or cubes as a NumPy .npz archive (uncompressed),
+//! holding the elements (in column-major order) as arr_0.npy, arr_1.npy, etc
+template<typename T1>
 inline
 bool
-diskio::save_ppm_binary(const Cube<eT>& x, const std::string& final_name)
+diskio::save_npy_binary(const field<T1>& x, const std::string& final_name)
   {
   arma_extra_debug_sigprint();
   
   const std::string tmp_name = diskio::gen_tmp_name(final_name);
   
-  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
+  std::ofstream f(tmp_name.c_str(), std::fstream::binary);
   
   bool save_okay = f.is_open();
   
   if(save_okay)
     {
-    save_okay = diskio::save_ppm_binary(x, f);
+    save_okay = diskio::save_npy_binary(x, f);
     
     f.flush();
     f.close();
@@ -4507,171 +6330,182 @@ diskio::save_ppm_binary(const Cube<eT>& x, const std::string& final_name)
 
 
 
-template<typename eT>
+template<typename T1>
 inline
 bool
-diskio::save_ppm_binary(const Cube<eT>& x, std::ostream& f)
+diskio::save_npy_binary(const field<T1>& x, std::ostream& f)
   {
   arma_extra_debug_sigprint();
   
-  arma_debug_check( (x.n_slices != 3), "diskio::save_ppm_binary(): given cube must have exactly 3 slices" );
+  arma_type_check(( (is_Mat<T1>::value == false) && (is_Cube<T1>::value == false) ));
   
-  const uword n_elem = 3 * x.n_rows * x.n_cols;
-  podarray<u8> tmp(n_elem);
+  typedef typename T1::elem_type eT;
   
-  uword i = 0;
-  for(uword row=0; row < x.n_rows; ++row)
+  const u64 limit = 0xFFFFFFFF;
+  
+  std::string cdir;  // central directory
+  
+  u64 pos = 0;
+  
+  for(uword i=0; i < x.n_elem; ++i)
     {
-    for(uword col=0; col < x.n_cols; ++col)
+    const T1& obj = x[i];
+    
+    std::ostringstream ss;
+    
+    ss << "arr_" << i << ".npy";
+    
+    const std::string name   = ss.str();
+    const std::string header = diskio::gen_npy_header(obj);
+    
+    const char* data = reinterpret_cast<const char*>(obj.mem);
+    
+    const u64 n_data  = u64(obj.n_elem) * u64(sizeof(eT));
+    const u64 n_total = u64(header.length()) + n_data;
+    
+    const u32 crc = diskio::zip_crc32(data, size_t(n_data), diskio::zip_crc32(header.c_str(), header.length()));
+    
+    const bool large_size   = (n_total >= limit);
+    const bool large_offset = (pos     >= limit);
+    
+    // local header
+    
+    std::string local;
+    
+    diskio::zip_put(local, 0x04034b50, 4);
+    diskio::zip_put(local, (large_size ? 45 : 20), 2);  // version needed to extract
+    diskio::zip_put(local, 0, 2);                       // flags
+    diskio::zip_put(local, 0, 2);                       // compression method: none
+    diskio::zip_put(local, 0, 2);                       // time
+    diskio::zip_put(local, 0x21, 2);                    // date: 1980-01-01
+    diskio::zip_put(local, crc, 4);
+    diskio::zip_put(local, (large_size ? limit : n_total), 4);
+    diskio::zip_put(local, (large_size ? limit : n_total), 4);
+    diskio::zip_put(local, name.length(), 2);
+    diskio::zip_put(local, (large_size ? 20 : 0), 2);
+    
+    local += name;
+    
+    if(large_size)
       {
-      tmp[i+0] = u8( access::tmp_real( x.at(row,col,0) ) );
-      tmp[i+1] = u8( access::tmp_real( x.at(row,col,1) ) );
-      tmp[i+2] = u8( access::tmp_real( x.at(row,col,2) ) );
+      diskio::zip_put(local, 0x0001, 2);
+      diskio::zip_put(local, 16, 2);
+      diskio::zip_put(local, n_total, 8);
+      diskio::zip_put(local, n_total, 8);
+      }
+    
+    // central directory entry
+    
+    const u64 n_extra = (large_size ? 16 : 0) + (large_offset ? 8 : 0);
+    
+    diskio::zip_put(cdir, 0x02014b50, 4);
+    diskio::zip_put(cdir, 45, 2);                       // version made by
+    diskio::zip_put(cdir, ((large_size || large_offset) ? 45 : 20), 2);
+    diskio::zip_put(cdir, 0, 2);
+    diskio::zip_put(cdir, 0, 2);
+    diskio::zip_put(cdir, 0, 2);
+    diskio::zip_put(cdir, 0x21, 2);
+    diskio::zip_put(cdir, crc, 4);
+    diskio::zip_put(cdir, (large_size ? limit : n_total), 4);
+    diskio::zip_put(cdir, (large_size ? limit : n_total), 4);
+    diskio::zip_put(cdir, name.length(), 2);
+    diskio::zip_put(cdir, ((n_extra > 0) ? (n_extra + 4) : 0), 2);
+    diskio::zip_put(cdir, 0, 2);                        // comment length
+    diskio::zip_put(cdir, 0, 2);                        // disk number
+    diskio::zip_put(cdir, 0, 2);                        // internal attributes
+    diskio::zip_put(cdir, 0, 4);                        // external attributes
+    diskio::zip_put(cdir, (large_offset ? limit : pos), 4);
+    
+    cdir += name;
+    
+    if(n_extra > 0)
+      {
+      diskio::zip_put(cdir, 0x0001, 2);
+      diskio::zip_put(cdir, n_extra, 2);
       
-      i+=3;
+      if(large_size)    { diskio::zip_put(cdir, n_total, 8); diskio::zip_put(cdir, n_total, 8); }
+      if(large_offset)  { diskio::zip_put(cdir, pos,     8);                                    }
       }
+    
+    f.write( local.c_str(),  std::streamsize(local.length())  );
+    f.write( header.c_str(), std::streamsize(header.length()) );
+    f.write( data,           std::streamsize(n_data)          );
+    
+    if(f.good() == false)  { return false; }
+    
+    pos += u64(local.length()) + n_total;
     }
   
-  f << "P6" << '\n';
-  f << x.n_cols << '\n';
-  f << x.n_rows << '\n';
-  f << 255 << '\n';
-  
-  f.write( reinterpret_cast<const char*>(tmp.mem), std::streamsize(n_elem) );
-  
-  return f.good();
-  }
-
-
-
-//
-// handling of PPM images by fields
-
-
-
-template<typename T1>
-inline
-bool
-diskio::load_ppm_binary(field<T1>& x, const std::string& name, std::string& err_msg)
-  {
-  arma_extra_debug_sigprint();
+  // end of central directory
   
-  std::fstream f;
-  f.open(name.c_str(), std::fstream::in | std::fstream::binary);
+  const u64 n_entries = u64(x.n_elem);
+  const u64 cd_size   = u64(cdir.length());
   
-  bool load_okay = f.is_open();
+  std::string tail;
   
-  if(load_okay)
+  if( (n_entries >= 0xFFFF) || (pos >= limit) || (cd_size >= limit) )
     {
-    load_okay = diskio::load_ppm_binary(x, f, err_msg);
-    f.close();
+    const u64 eocd64 = pos + cd_size;
+    
+    diskio::zip_put(tail, 0x06064b50, 4);
+    diskio::zip_put(tail, 44, 8);                       // size of the remainder of the record
+    diskio::zip_put(tail, 45, 2);
+    diskio::zip_put(tail, 45, 2);
+    diskio::zip_put(tail, 0, 4);
+    diskio::zip_put(tail, 0, 4);
+    diskio::zip_put(tail, n_entries, 8);
+    diskio::zip_put(tail, n_entries, 8);
+    diskio::zip_put(tail, cd_size, 8);
+    diskio::zip_put(tail, pos, 8);
+    
+    diskio::zip_put(tail, 0x07064b50, 4);
+    diskio::zip_put(tail, 0, 4);
+    diskio::zip_put(tail, eocd64, 8);
+    diskio::zip_put(tail, 1, 4);
     }
   
-  return load_okay;
+  diskio::zip_put(tail, 0x06054b50, 4);
+  diskio::zip_put(tail, 0, 2);
+  diskio::zip_put(tail, 0, 2);
+  diskio::zip_put(tail, (std::min)(n_entries, u64(0xFFFF)), 2);
+  diskio::zip_put(tail, (std::min)(n_entries, u64(0xFFFF)), 2);
+  diskio::zip_put(tail, (std::min)(cd_size, limit), 4);
+  diskio::zip_put(tail, (std::min)(pos, limit), 4);
+  diskio::zip_put(tail, 0, 2);
+  
+  f.write( cdir.c_str(), std::streamsize(cdir.length()) );
+  f.write( tail.c_str(), std::streamsize(tail.length()) );
+  
+  return f.good();
   }
 
 
 
+//! Load a field of matrices or cubes from a NumPy .npz archive; the arrays are stored in a field with one column.
+//! Only uncompressed archives are supported (eg. as saved by numpy.savez(), but not numpy.savez_compressed()).
 template<typename T1>
 inline
 bool
-diskio::load_ppm_binary(field<T1>& x, std::istream& f, std::string& err_msg)
+diskio::load_npy_binary(field<T1>& x, const std::string& name, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  arma_type_check(( is_Mat<T1>::value == false ));
-  typedef typename T1::elem_type eT;
+  mmap_region region;
   
-  bool load_okay = true;
+  if(region.map(name, mmap_read_only))
+    {
+    return diskio::load_npy_binary(x, (const char*)(region.memptr()), region.n_bytes(), err_msg);
+    }
   
-  std::string f_header;
+  std::ifstream f;
+  f.open(name.c_str(), std::fstream::binary);
   
-  f >> f_header;
+  bool load_okay = f.is_open();
   
-  if(f_header == "P6")
-    {
-    uword f_n_rows = 0;
-    uword f_n_cols = 0;
-    int f_maxval = 0;
-    
-    diskio::pnm_skip_comments(f);
-    
-    f >> f_n_cols;
-    diskio::pnm_skip_comments(f);
-    
-    f >> f_n_rows;
-    diskio::pnm_skip_comments(f);
-    
-    f >> f_maxval;
-    f.get();
-    
-    if( (f_maxval > 0) && (f_maxval <= 65535) )
-      {
-      x.set_size(3);
-      Mat<eT>& R = x(0);
-      Mat<eT>& G = x(1);
-      Mat<eT>& B = x(2);
-      
-      R.set_size(f_n_rows,f_n_cols);
-      G.set_size(f_n_rows,f_n_cols);
-      B.set_size(f_n_rows,f_n_cols);
-      
-      if(f_maxval <= 255)
-        {
-        const uword n_elem = 3*f_n_cols*f_n_rows;
-        podarray<u8> tmp(n_elem);
-        
-        f.read( reinterpret_cast<char*>(tmp.memptr()), std::streamsize(n_elem) );
-        
-        uword i = 0;
-        
-        //cout << "f_n_cols = " << f_n_cols << endl;
-        //cout << "f_n_rows = " << f_n_rows << endl;
-        
-        
-        for(uword row=0; row < f_n_rows; ++row)
-          {
-          for(uword col=0; col < f_n_cols; ++col)
-            {
-            R.at(row,col) = eT(tmp[i+0]);
-            G.at(row,col) = eT(tmp[i+1]);
-            B.at(row,col) = eT(tmp[i+2]);
-            i+=3;
-            }
-          
-          }
-        }
-      else
-        {
-        const uword n_elem = 3*f_n_cols*f_n_rows;
-        podarray<u16> tmp(n_elem);
-        
-        f.read( reinterpret_cast<char *>(tmp.memptr()), std::streamsize(2*n_elem) );
-        
-        uword i = 0;
-        
-        for(uword row=0; row < f_n_rows; ++row)
-        for(uword col=0; col < f_n_cols; ++col)
-          {
-          R.at(row,col) = eT(tmp[i+0]);
-          G.at(row,col) = eT(tmp[i+1]);
-          B.at(row,col) = eT(tmp[i+2]);
-          i+=3;
-          }
-        }
-      }
-    else
-      {
-      load_okay = false;
-      err_msg = "currently no code available to handle loading ";
-      }
-    
-    if(f.good() == false)  { load_okay = false; }
-    }
-  else
+  if(load_okay)
     {
-    load_okay = false;
-    err_msg = "unsupported header in ";
+    load_okay = diskio::load_npy_binary(x, f, err_msg);
+    f.close();
     }
   
   return load_okay;
@@ -4682,26 +6516,17 @@ diskio::load_ppm_binary(field<T1>& x, std::istream& f, std::string& err_msg)
 template<typename T1>
 inline
 bool
-diskio::save_ppm_binary(const field<T1>& x, const std::string& final_name)
+diskio::load_npy_binary(field<T1>& x, std::istream& f, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  const std::string tmp_name = diskio::gen_tmp_name(final_name);
-  std::ofstream f( tmp_name.c_str(), std::fstream::binary );
+  std::vector<char> buf;
   
-  bool save_okay = f.is_open();
+  diskio::read_text(buf, f);
   
-  if(save_okay)
-    {
-    save_okay = diskio::save_ppm_binary(x, f);
-    
-    f.flush();
-    f.close();
-    
-    if(save_okay)  { save_okay = diskio::safe_rename(tmp_name, final_name); }
-    }
+  if(buf.empty())  { err_msg = "incorrect header in "; return false; }
   
-  return save_okay;
+  return diskio::load_npy_binary(x, &(buf[0]), buf.size(), err_msg);
   }
 
 
@@ -4709,54 +6534,32 @@ diskio::save_ppm_binary(const field<T1>& x, const std::string& final_name)
 template<typename T1>
 inline
 bool
-diskio::save_ppm_binary(const field<T1>& x, std::ostream& f)
+diskio::load_npy_binary(field<T1>& x, const char* mem, const size_t n_bytes, std::string& err_msg)
   {
   arma_extra_debug_sigprint();
   
-  arma_type_check(( is_Mat<T1>::value == false ));
-  
-  typedef typename T1::elem_type eT;
-  
-  arma_debug_check( (x.n_elem != 3), "diskio::save_ppm_binary(): given field must have exactly 3 matrices of equal size" );
+  arma_type_check(( (is_Mat<T1>::value == false) && (is_Cube<T1>::value == false) ));
   
-  bool same_size = true;
-  for(uword i=1; i<3; ++i)
-    {
-    if( (x(0).n_rows != x(i).n_rows) || (x(0).n_cols != x(i).n_cols) )
-      {
-      same_size = false;
-      break;
-      }
-    }
+  std::vector<npz_entry> entries;
   
-  arma_debug_check( (same_size != true), "diskio::save_ppm_binary(): given field must have exactly 3 matrices of equal size" );
+  if(diskio::parse_npz(entries, mem, n_bytes) == false)  { err_msg = "incorrect header in "; return false; }
   
-  const Mat<eT>& R = x(0);
-  const Mat<eT>& G = x(1);
-  const Mat<eT>& B = x(2);
+  x.set_size( uword(entries.size()) );
   
-  f << "P6" << '\n';
-  f << R.n_cols << '\n';
-  f << R.n_rows << '\n';
-  f << 255 << '\n';
-
-  const uword n_elem = 3 * R.n_rows * R.n_cols;
-  podarray<u8> tmp(n_elem);
-
-  uword i = 0;
-  for(uword row=0; row < R.n_rows; ++row)
-  for(uword col=0; col < R.n_cols; ++col)
+  for(uword i=0; i < x.n_elem; ++i)
     {
-    tmp[i+0] = u8( access::tmp_real( R.at(row,col) ) );
-    tmp[i+1] = u8( access::tmp_real( G.at(row,col) ) );
-    tmp[i+2] = u8( access::tmp_real( B.at(row,col) ) );
+    const npz_entry& entry = entries[i];
     
-    i+=3;
+    if(entry.method != 0)  { err_msg = "unsupported compression in "; return false; }
+    
+    const char* entry_mem = mem + entry.offset;
+    
+    if(diskio::zip_crc32(entry_mem, entry.n_bytes) != entry.crc)  { err_msg = "incorrect checksum in "; return false; }
+    
+    if(diskio::load_npy_binary(x[i], entry_mem, entry.n_bytes, err_msg) == false)  { return false; }
     }
   
-  f.write( reinterpret_cast<const char*>(tmp.mem), std::streamsize(n_elem) );
-  
-  return f.good();
+  return true;
   }
 
 
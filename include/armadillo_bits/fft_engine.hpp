@@ -54,6 +54,37 @@
 //! @{
 
 
+template<typename engine_type> struct fft_cache;
+
+
+
+struct fft_helper
+  {
+  //! smallest length >= N that has only 2, 3 and 5 as factors, which are handled efficiently by fft_engine
+  inline
+  static
+  uword
+  good_size(const uword N)
+    {
+    uword best = 1;
+    
+    while(best < N)  { best *= 2; }
+    
+    for(uword p5 = 1; p5 < best; p5 *= 5)
+    for(uword p3 = p5; p3 < best; p3 *= 3)
+      {
+      uword n = p3;
+      
+      while(n < N)  { n *= 2; }
+      
+      if(n < best)  { best = n; }
+      }
+    
+    return best;
+    }
+  };
+
+
 template<typename cx_type, uword fixed_N, bool> struct fft_store {};
 
 template<typename cx_type, uword fixed_N>
@@ -101,7 +132,15 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   podarray<uword>   residue;
   podarray<uword>   radix;
   
-  podarray<cx_type> tmp_array;
+  uword max_radix_N;  //!< largest radix handled by the generic butterfly; zero if not used
+  
+  uword bluestein_N;  //!< length of the padded transforms used by the Bluestein algorithm; zero if not used
+  
+  podarray<cx_type> chirp;      //!< exp(-+ i*pi*n^2/N) for n = 0, ..., N-1
+  podarray<cx_type> chirp_fft;  //!< transform of the conjugated and padded chirp, scaled by 1/bluestein_N
+  
+  std::shared_ptr< const fft_engine<cx_type,false> > bluestein_fwd;
+  std::shared_ptr< const fft_engine<cx_type,true > > bluestein_inv;
   
   
   template<bool fill>
@@ -142,6 +181,8 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   inline
   fft_engine(const uword in_N)
     : fft_store< cx_type, fixed_N, (fixed_N > 0) >(in_N)
+    , max_radix_N(0)
+    , bluestein_N(0)
     {
     arma_extra_debug_sigprint();
     
@@ -152,6 +193,18 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
     
     calc_radix<true>();
     
+    for(uword i=0; i < len; ++i)
+      {
+      if(radix[i] > 5)  { max_radix_N = (std::max)(max_radix_N, radix[i]); }
+      }
+    
+    if( (fixed_N == 0) && (max_radix_N > 5) )
+      {
+      const uword L = fft_helper::good_size(2*N - 1);
+      
+      if( calc_bluestein_cost(L) < calc_generic_cost() )  { init_bluestein(L); return; }
+      }
+    
     
     // calculate the constant coefficients
     
@@ -164,10 +217,123 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   
   
   
+  //! approximate number of complex multiply-adds performed by the butterflies
+  inline
+  double
+  calc_generic_cost() const
+    {
+    double cost = 0;
+    
+    for(uword i=0; i < radix.n_elem; ++i)  { cost += double(N) * double(radix[i]); }
+    
+    return cost;
+    }
+  
+  
+  
+  //! approximate cost of the Bluestein algorithm, in the same units as calc_generic_cost();
+  //! dominated by two transforms of length L
+  inline
+  double
+  calc_bluestein_cost(const uword L) const
+    {
+    return double(2) * double(L) * std::log2(double(L)) + double(4) * double(N);
+    }
+  
+  
+  
+  //! Bluestein's algorithm expresses a transform of arbitrary length N as a convolution,
+  //! using n*k = (n^2 + k^2 - (k-n)^2)/2;
+  //! the convolution is evaluated via transforms of length L >= 2N-1 that have only small factors
+  inline
+  void
+  init_bluestein(const uword L)
+    {
+    arma_extra_debug_sigprint();
+    
+    bluestein_N = L;
+    max_radix_N = 0;
+    
+    bluestein_fwd = fft_cache< fft_engine<cx_type,false> >::get(L);
+    bluestein_inv = fft_cache< fft_engine<cx_type,true > >::get(L);
+    
+    chirp.set_size(N);
+    
+    cx_type* chirp_mem = chirp.memptr();
+    
+    const T pi = std::acos( T(-1) );
+    
+    // n^2 is reduced modulo 2N to retain precision for large n
+    for(uword n=0; n < N; ++n)
+      {
+      const uword n2 = uword( (u64(n) * u64(n)) % u64(2*N) );
+      
+      const T phase = pi * T(n2) / T(N);
+      
+      chirp_mem[n] = std::exp( cx_type(T(0), (inverse) ? phase : -phase) );
+      }
+    
+    podarray<cx_type> tmp(L);
+    
+    cx_type* tmp_mem = tmp.memptr();
+    
+    arrayops::fill_zeros(tmp_mem, L);
+    
+    const T scale = T(1) / T(L);
+    
+    tmp_mem[0] = scale * std::conj(chirp_mem[0]);
+    
+    for(uword n=1; n < N; ++n)
+      {
+      const cx_type val = scale * std::conj(chirp_mem[n]);
+      
+      tmp_mem[n    ] = val;
+      tmp_mem[L - n] = val;
+      }
+    
+    chirp_fft.set_size(L);
+    
+    (*bluestein_fwd).run(chirp_fft.memptr(), tmp_mem);
+    }
+  
+  
+  
+  inline
+  void
+  run_bluestein(cx_type* Y, const cx_type* X) const
+    {
+    arma_extra_debug_sigprint();
+    
+    const uword L = bluestein_N;
+    
+    podarray<cx_type> buf_a(L);
+    podarray<cx_type> buf_b(L);
+    
+    cx_type* A = buf_a.memptr();
+    cx_type* B = buf_b.memptr();
+    
+    const cx_type* chirp_mem     = chirp.memptr();
+    const cx_type* chirp_fft_mem = chirp_fft.memptr();
+    
+    for(uword n=0; n < N; ++n)  { A[n] = X[n] * chirp_mem[n]; }
+    
+    arrayops::fill_zeros(&A[N], L-N);
+    
+    (*bluestein_fwd).run(B, A);
+    
+    for(uword k=0; k < L; ++k)  { B[k] *= chirp_fft_mem[k]; }
+    
+    (*bluestein_inv).run(A, B);
+    
+    for(uword k=0; k < N; ++k)  { Y[k] = A[k] * chirp_mem[k]; }
+    }
+  
+  
+  
   arma_hot
   inline
   void
-  butterfly_2(cx_type* Y, const uword stride, const uword m)
+  butterfly_2(cx_type* Y, const uword stride, const uword m) const
     {
     arma_extra_debug_sigprint();
     
@@ -187,14 +353,14 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   arma_hot
   inline
   void
-  butterfly_3(cx_type* Y, const uword stride, const uword m)
+  butterfly_3(cx_type* Y, const uword stride, const uword m) const
     {
     arma_extra_debug_sigprint();
     
     arma_aligned cx_type tmp[5];
     
-    cx_type* coeffs1 = coeffs_ptr();
-    cx_type* coeffs2 = coeffs1;
+    const cx_type* coeffs1 = coeffs_ptr();
+    const cx_type* coeffs2 = coeffs1;
     
     const T coeff_sm_imag = coeffs1[stride*m].imag();
     
@@ -233,7 +399,7 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   arma_hot
   inline
   void
-  butterfly_4(cx_type* Y, const uword stride, const uword m)
+  butterfly_4(cx_type* Y, const uword stride, const uword m) const
     {
     arma_extra_debug_sigprint();
     
@@ -276,7 +442,7 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   inline
   arma_hot
   void
-  butterfly_5(cx_type* Y, const uword stride, const uword m)
+  butterfly_5(cx_type* Y, const uword stride, const uword m) const
     {
     arma_extra_debug_sigprint();
     
@@ -340,15 +506,12 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   arma_hot
   inline
   void
-  butterfly_N(cx_type* Y, const uword stride, const uword m, const uword r)
+  butterfly_N(cx_type* Y, const uword stride, const uword m, const uword r, cx_type* tmp) const
     {
     arma_extra_debug_sigprint();
     
     const cx_type* coeffs = coeffs_ptr();
     
-    tmp_array.set_min_size(r);
-    cx_type* tmp = tmp_array.memptr();
-    
     for(uword u=0; u < m; ++u)
       {
       uword k = u;
@@ -385,7 +548,7 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
   
   inline
   void
-  run(cx_type* Y, const cx_type* X, const uword stage = 0, const uword stride = 1)
+  run_stage(cx_type* Y, const cx_type* X, cx_type* tmp, const uword stage, const uword stride) const
     {
     arma_extra_debug_sigprint();
     
@@ -403,21 +566,379 @@ class fft_engine : public fft_store<cx_type, fixed_N, (fixed_N > 0)>
       const uword next_stage  = stage + 1;
       const uword next_stride = stride * r;
       
-      for(cx_type* Yi = Y; Yi != Y_end; Yi += m, X += stride)  { run(Yi, X, next_stage, next_stride); }
+      for(cx_type* Yi = Y; Yi != Y_end; Yi += m, X += stride)  { run_stage(Yi, X, tmp, next_stage, next_stride); }
       }
     
     switch(r)
       {
-      case 2:  butterfly_2(Y, stride, m   );  break;
-      case 3:  butterfly_3(Y, stride, m   );  break;
-      case 4:  butterfly_4(Y, stride, m   );  break;
-      case 5:  butterfly_5(Y, stride, m   );  break;
-      default: butterfly_N(Y, stride, m, r);  break;
+      case 2:  butterfly_2(Y, stride, m        );  break;
+      case 3:  butterfly_3(Y, stride, m        );  break;
+      case 4:  butterfly_4(Y, stride, m        );  break;
+      case 5:  butterfly_5(Y, stride, m        );  break;
+      default: butterfly_N(Y, stride, m, r, tmp);  break;
+      }
+    }
+  
+  
+  
+  //! unscaled transform of X into Y; X and Y must not overlap;
+  //! the engine is not modified, so one instance can be shared between threads
+  inline
+  void
+  run(cx_type* Y, const cx_type* X) const
+    {
+    arma_extra_debug_sigprint();
+    
+    if(bluestein_N > 0)  { run_bluestein(Y, X); return; }
+    
+    podarray<cx_type> tmp(max_radix_N);
+    
+    run_stage(Y, X, tmp.memptr(), 0, 1);
+    }
+  
+  
+  };
+
+
+
+//! cache of FFT engines, shared between all threads;
+//! an engine stores the radix factorisation and twiddle factors for one transform length
+template<typename engine_type>
+struct fft_cache
+  {
+  typedef std::shared_ptr<const engine_type> ptr_type;
+  
+  //! upper limit on the sum of transform lengths held by the cache
+  static constexpr uword max_n_coeffs = uword(1) << 20;
+  
+  inline static ptr_type get(const uword N);
+  
+  inline static void clear();
+  
+  
+  private:
+  
+  struct state_type
+    {
+    std::map<uword, ptr_type> engines;
+    uword                     n_coeffs = 0;
+    
+    #if (!defined(ARMA_USE_OPENMP) && !defined(ARMA_DONT_USE_STD_MUTEX))
+    std::mutex mutex;
+    #endif
+    };
+  
+  inline static state_type& get_state();
+  
+  inline static ptr_type get_locked(const uword N, const ptr_type& candidate);
+  inline static ptr_type get_simple(const uword N, const ptr_type& candidate);
+  inline static void   clear_simple();
+  };
+
+
+
+template<typename engine_type>
+inline
+typename fft_cache<engine_type>::state_type&
+fft_cache<engine_type>::get_state()
+  {
+  static state_type state;
+  
+  return state;
+  }
+
+
+
+template<typename engine_type>
+inline
+typename fft_cache<engine_type>::ptr_type
+fft_cache<engine_type>::get(const uword N)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(N > max_n_coeffs)  { return ptr_type( new engine_type(N) ); }
+  
+  ptr_type out = get_locked(N, ptr_type());
+  
+  if(out)  { return out; }
+  
+  // the engine is constructed outside of the lock,
+  // as constructing an engine may require engines of other lengths from the cache
+  const ptr_type candidate( new engine_type(N) );
+  
+  return get_locked(N, candidate);
+  }
+
+
+
+template<typename engine_type>
+inline
+typename fft_cache<engine_type>::ptr_type
+fft_cache<engine_type>::get_locked(const uword N, const ptr_type& candidate)
+  {
+  arma_extra_debug_sigprint();
+  
+  ptr_type out;
+  
+  #if defined(ARMA_USE_OPENMP)
+    {
+    #pragma omp critical (arma_fft_cache)
+      {
+      out = get_simple(N, candidate);
+      }
+    }
+  #elif (!defined(ARMA_DONT_USE_STD_MUTEX))
+    {
+    std::lock_guard<std::mutex> lock( get_state().mutex );
+    
+    out = get_simple(N, candidate);
+    }
+  #else
+    {
+    out = (candidate) ? candidate : ptr_type( new engine_type(N) );
+    }
+  #endif
+  
+  return out;
+  }
+
+
+
+template<typename engine_type>
+inline
+void
+fft_cache<engine_type>::clear()
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_OPENMP)
+    {
+    #pragma omp critical (arma_fft_cache)
+      {
+      clear_simple();
       }
     }
+  #elif (!defined(ARMA_DONT_USE_STD_MUTEX))
+    {
+    std::lock_guard<std::mutex> lock( get_state().mutex );
+    
+    clear_simple();
+    }
+  #endif
+  }
+
 
 
+//! returns the cached engine for length N;
+//! if there is no such engine, candidate is stored in the cache and returned (which may be empty)
+template<typename engine_type>
+inline
+typename fft_cache<engine_type>::ptr_type
+fft_cache<engine_type>::get_simple(const uword N, const ptr_type& candidate)
+  {
+  arma_extra_debug_sigprint();
+  
+  state_type& state = get_state();
+  
+  typename std::map<uword, ptr_type>::const_iterator it = state.engines.find(N);
+  
+  if(it != state.engines.end())  { return it->second; }
+  
+  if(!candidate)  { return candidate; }
+  
+  // engines already handed out remain valid after the cache is cleared
+  if( (state.n_coeffs + N) > max_n_coeffs )  { clear_simple(); }
+  
+  state.engines[N] = candidate;
+  state.n_coeffs  += N;
+  
+  return candidate;
+  }
+
+
+
+template<typename engine_type>
+inline
+void
+fft_cache<engine_type>::clear_simple()
+  {
+  state_type& state = get_state();
+  
+  state.engines.clear();
+  state.n_coeffs = 0;
+  }
+
+
+
+//! transforms of real sequences of length N, exploiting Hermitian symmetry;
+//! only the N/2+1 non-redundant frequency bins are stored.
+//! for even N, the sequence is packed into a complex sequence of length N/2,
+//! which is transformed and then split into the spectrum of the real sequence
+template<typename cx_type>
+class fft_engine_real
+  {
+  public:
+  
+  typedef typename get_pod_type<cx_type>::result T;
+  
+  const uword N;
+  const uword M;  //!< length of the underlying complex transforms
+  
+  typename fft_cache< fft_engine<cx_type,false> >::ptr_type worker_fwd;
+  typename fft_cache< fft_engine<cx_type,true > >::ptr_type worker_inv;
+  
+  podarray<cx_type> twiddles;  //!< exp(-2*pi*i*k/N) for k = 0, ..., M-1; used only for even N
+  
+  
+  static
+  inline
+  uword
+  calc_M(const uword in_N)
+    {
+    return ( ((in_N % 2) == 0) && (in_N >= 4) ) ? (in_N / 2) : in_N;
+    }
+  
+  
+  
+  inline
+  explicit
+  fft_engine_real(const uword in_N)
+    : N(in_N)
+    , M(calc_M(in_N))
+    {
+    arma_extra_debug_sigprint();
+    
+    if(M >= 2)
+      {
+      worker_fwd = fft_cache< fft_engine<cx_type,false> >::get(M);
+      worker_inv = fft_cache< fft_engine<cx_type,true > >::get(M);
+      }
+    
+    if(M < N)
+      {
+      twiddles.set_size(M);
+      
+      cx_type* twiddles_mem = twiddles.memptr();
+      
+      const T k = T(-2) * std::acos( T(-1) ) / T(N);
+      
+      for(uword i=0; i < M; ++i)  { twiddles_mem[i] = std::exp( cx_type(T(0), i*k) ); }
+      }
+    }
+  
+  
+  
+  //! unscaled transform of N real values in X into N/2+1 complex values in Y
+  inline
+  void
+  r2c(cx_type* Y, const T* X) const
+    {
+    arma_extra_debug_sigprint();
+    
+    if(N <= 1)  { if(N == 1) { Y[0] = cx_type(X[0]); }  return; }
+    
+    podarray<cx_type> buf_a(M);
+    podarray<cx_type> buf_b(M);
+    
+    cx_type* A = buf_a.memptr();
+    cx_type* B = buf_b.memptr();
+    
+    if(M == N)
+      {
+      for(uword i=0; i < N; ++i)  { A[i] = cx_type(X[i]); }
+      
+      (*worker_fwd).run(B, A);
+      
+      arrayops::copy(Y, B, (N/2 + 1));
+      
+      return;
+      }
+    
+    for(uword i=0; i < M; ++i)  { A[i] = cx_type( X[2*i], X[2*i + 1] ); }
+    
+    (*worker_fwd).run(B, A);
+    
+    const cx_type* W = twiddles.memptr();
+    
+    for(uword k=0; k < M; ++k)
+      {
+      const cx_type Zk  = B[k];
+      const cx_type Zmk = std::conj( B[(k == 0) ? 0 : (M - k)] );
+      
+      const cx_type E = T(0.5) * (Zk + Zmk);
+      const cx_type D = T(0.5) * (Zk - Zmk);
+      const cx_type O = cx_type( D.imag(), -D.real() );  // D / i
+      
+      Y[k] = E + W[k] * O;
+      
+      if(k == 0)  { Y[M] = E - O; }
+      }
+    }
+  
+  
+  
+  //! inverse transform of N/2+1 complex values in X into N real values in Y, including the 1/N scaling;
+  //! the imaginary parts of the first and (for even N) last bins are ignored
+  inline
+  void
+  c2r(T* Y, const cx_type* X) const
+    {
+    arma_extra_debug_sigprint();
+    
+    if(N <= 1)  { if(N == 1) { Y[0] = X[0].real(); }  return; }
+    
+    podarray<cx_type> buf_a(M);
+    podarray<cx_type> buf_b(M);
+    
+    cx_type* A = buf_a.memptr();
+    cx_type* B = buf_b.memptr();
+    
+    if(M == N)
+      {
+      const uword n_bins = N/2 + 1;
+      
+      arrayops::copy(A, X, n_bins);
+      
+      A[0] = cx_type(X[0].real());
+      
+      if((N % 2) == 0)  { A[N/2] = cx_type(X[N/2].real()); }
+      
+      for(uword k=n_bins; k < N; ++k)  { A[k] = std::conj(X[N - k]); }
+      
+      (*worker_inv).run(B, A);
+      
+      const T scale = T(1) / T(N);
+      
+      for(uword i=0; i < N; ++i)  { Y[i] = B[i].real() * scale; }
+      
+      return;
+      }
+    
+    const cx_type* W = twiddles.memptr();
+    
+    for(uword k=0; k < M; ++k)
+      {
+      const cx_type Xk  = (k == 0) ? cx_type(X[0].real()) : X[k];
+      const cx_type Xmk = (k == 0) ? cx_type(X[M].real()) : std::conj(X[M - k]);
+      
+      const cx_type E = T(0.5) * (Xk + Xmk);
+      const cx_type O = T(0.5) * (Xk - Xmk) * std::conj(W[k]);
+      
+      A[k] = E + cx_type( -O.imag(), O.real() );  // E + i*O
+      }
+    
+    (*worker_inv).run(B, A);
+    
+    const T scale = T(1) / T(M);
+    
+    for(uword i=0; i < M; ++i)
+      {
+      Y[2*i    ] = B[i].real() * scale;
+      Y[2*i + 1] = B[i].imag() * scale;
+      }
+    }
   };
 
 
+
 //! @}
@@ -0,0 +1,56 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+//! \addtogroup fft_plan
+//! @{
+
+
+
+//! FFT of a fixed length, with the radix factorisation and twiddle factors computed once;
+//! the underlying engines are shared with fft() and ifft() via fft_cache
+template<typename cx_type>
+class fft_plan
+  {
+  public:
+  
+  typedef cx_type                                 elem_type;
+  typedef typename get_pod_type<cx_type>::result pod_type;
+  
+  const uword N;  //!< transform length
+  
+  inline explicit fft_plan(const uword in_N);
+  
+  template<typename eT, typename T1> inline void  fft(Mat<cx_type>& out, const Base<eT,T1>& X) const;
+  template<typename eT, typename T1> inline void ifft(Mat<cx_type>& out, const Base<eT,T1>& X) const;
+  
+  template<typename eT, typename T1> arma_warn_unused inline Mat<cx_type>  fft(const Base<eT,T1>& X) const;
+  template<typename eT, typename T1> arma_warn_unused inline Mat<cx_type> ifft(const Base<eT,T1>& X) const;
+  
+  
+  private:
+  
+  const typename fft_cache< fft_engine<cx_type,false> >::ptr_type worker_fwd;
+  const typename fft_cache< fft_engine<cx_type,true > >::ptr_type worker_inv;
+  
+  template<bool inverse, typename eT, typename T1> inline void apply(Mat<cx_type>& out, const Base<eT,T1>& X, const fft_engine<cx_type,inverse>& worker) const;
+  
+  template<bool inverse, typename eT> inline void apply_noalias(Mat<cx_type>& out, const Mat<eT>& A, const fft_engine<cx_type,inverse>& worker) const;
+  };
+
+
+
+//! @}
@@ -0,0 +1,191 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+//! \addtogroup fft_plan
+//! @{
+
+
+
+template<typename cx_type>
+inline
+fft_plan<cx_type>::fft_plan(const uword in_N)
+  : N         (in_N)
+  , worker_fwd( fft_cache< fft_engine<cx_type,false> >::get(in_N) )
+  , worker_inv( fft_cache< fft_engine<cx_type,true > >::get(in_N) )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_type_check(( (is_cx_float<cx_type>::no) && (is_cx_double<cx_type>::no) ));
+  }
+
+
+
+template<typename cx_type>
+template<typename eT, typename T1>
+inline
+void
+fft_plan<cx_type>::fft(Mat<cx_type>& out, const Base<eT,T1>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  (*this).template apply<false>(out, X, *worker_fwd);
+  }
+
+
+
+template<typename cx_type>
+template<typename eT, typename T1>
+inline
+void
+fft_plan<cx_type>::ifft(Mat<cx_type>& out, const Base<eT,T1>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  (*this).template apply<true>(out, X, *worker_inv);
+  }
+
+
+
+template<typename cx_type>
+template<typename eT, typename T1>
+inline
+Mat<cx_type>
+fft_plan<cx_type>::fft(const Base<eT,T1>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  Mat<cx_type> out;
+  
+  (*this).fft(out, X);
+  
+  return out;
+  }
+
+
+
+template<typename cx_type>
+template<typename eT, typename T1>
+inline
+Mat<cx_type>
+fft_plan<cx_type>::ifft(const Base<eT,T1>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  Mat<cx_type> out;
+  
+  (*this).ifft(out, X);
+  
+  return out;
+  }
+
+
+
+template<typename cx_type>
+template<bool inverse, typename eT, typename T1>
+inline
+void
+fft_plan<cx_type>::apply(Mat<cx_type>& out, const Base<eT,T1>& X, const fft_engine<cx_type,inverse>& worker) const
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_type_check(( (is_same_type<eT, cx_type>::no) && (is_same_type<eT, pod_type>::no) ));
+  
+  const quasi_unwrap<T1> U(X.get_ref());
+  
+  if(U.is_alias(out))
+    {
+    Mat<cx_type> tmp;
+    
+    (*this).apply_noalias(tmp, U.M, worker);
+    
+    out.steal_mem(tmp);
+    }
+  else
+    {
+    (*this).apply_noalias(out, U.M, worker);
+    }
+  }
+
+
+
+//! same conventions as fft(X,N) and ifft(X,N): vectors are transformed as a whole,
+//! while each column of a matrix is transformed separately;
+//! the input is zero padded or truncated to the plan length
+template<typename cx_type>
+template<bool inverse, typename eT>
+inline
+void
+fft_plan<cx_type>::apply_noalias(Mat<cx_type>& out, const Mat<eT>& A, const fft_engine<cx_type,inverse>& worker) const
+  {
+  arma_extra_debug_sigprint();
+  
+  const bool is_vec = ( (A.n_rows == 1) || (A.n_cols == 1) );
+  
+  const uword N_orig = (is_vec) ? A.n_elem : A.n_rows;
+  const uword n_vecs = (is_vec) ? uword(1) : A.n_cols;
+  
+  if(is_vec)
+    {
+    (A.n_cols == 1) ? out.set_size(N, 1) : out.set_size(1, N);
+    }
+  else
+    {
+    out.set_size(N, A.n_cols);
+    }
+  
+  if( (out.n_elem == 0) || (N_orig == 0) )  { out.zeros(); return; }
+  
+  const uword N_copy = (std::min)(N, N_orig);
+  
+  podarray<cx_type> data(N);
+  
+  cx_type* data_mem = data.memptr();
+  
+  if(N > N_orig)  { arrayops::fill_zeros( &data_mem[N_orig], (N - N_orig) ); }
+  
+  for(uword vec_id=0; vec_id < n_vecs; ++vec_id)
+    {
+    const eT*      A_ptr = (is_vec) ? A.memptr()   : A.colptr(vec_id);
+          cx_type* out_ptr = (is_vec) ? out.memptr() : out.colptr(vec_id);
+    
+    for(uword i=0; i < N_copy; ++i)  { data_mem[i] = cx_type(A_ptr[i]); }
+    
+    if(N == 1)
+      {
+      out_ptr[0] = data_mem[0];
+      }
+    else
+      {
+      worker.run(out_ptr, data_mem);
+      }
+    }
+  
+  if(inverse)
+    {
+    const pod_type k = pod_type(1) / pod_type(N);
+    
+    cx_type* out_mem = out.memptr();
+    
+    const uword out_n_elem = out.n_elem;
+    
+    for(uword i=0; i < out_n_elem; ++i)  { out_mem[i] *= k; }
+    }
+  }
+
+
+
+//! @}
@@ -2453,6 +2453,10 @@ field_aux::save(const field< Mat<eT> >& x, const std::string& name, const file_t
       return diskio::save_arma_binary(x, name);
       break;
       
+    case npy_binary:
+      return diskio::save_npy_binary(x, name);
+      break;
+      
     case ppm_binary:
       return diskio::save_ppm_binary(x, name);
       break;
@@ -2478,6 +2482,10 @@ field_aux::save(const field< Mat<eT> >& x, std::ostream& os, const file_type typ
       return diskio::save_arma_binary(x, os);
       break;
       
+    case npy_binary:
+      return diskio::save_npy_binary(x, os);
+      break;
+      
     case ppm_binary:
       return diskio::save_ppm_binary(x, os);
       break;
@@ -2507,6 +2515,10 @@ field_aux::load(field< Mat<eT> >& x, const std::string& name, const file_type ty
       return diskio::load_arma_binary(x, name, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, name, err_msg);
+      break;
+      
     case ppm_binary:
       return diskio::load_ppm_binary(x, name, err_msg);
       break;
@@ -2536,6 +2548,10 @@ field_aux::load(field< Mat<eT> >& x, std::istream& is, const file_type type, std
       return diskio::load_arma_binary(x, is, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, is, err_msg);
+      break;
+      
     case ppm_binary:
       return diskio::load_ppm_binary(x, is, err_msg);
       break;
@@ -2561,6 +2577,10 @@ field_aux::save(const field< Col<eT> >& x, const std::string& name, const file_t
       return diskio::save_arma_binary(x, name);
       break;
       
+    case npy_binary:
+      return diskio::save_npy_binary(x, name);
+      break;
+      
     case ppm_binary:
       return diskio::save_ppm_binary(x, name);
       break;
@@ -2586,6 +2606,10 @@ field_aux::save(const field< Col<eT> >& x, std::ostream& os, const file_type typ
       return diskio::save_arma_binary(x, os);
       break;
       
+    case npy_binary:
+      return diskio::save_npy_binary(x, os);
+      break;
+      
     case ppm_binary:
       return diskio::save_ppm_binary(x, os);
       break;
@@ -2615,6 +2639,10 @@ field_aux::load(field< Col<eT> >& x, const std::string& name, const file_type ty
       return diskio::load_arma_binary(x, name, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, name, err_msg);
+      break;
+      
     case ppm_binary:
       return diskio::load_ppm_binary(x, name, err_msg);
       break;
@@ -2644,6 +2672,10 @@ field_aux::load(field< Col<eT> >& x, std::istream& is, const file_type type, std
       return diskio::load_arma_binary(x, is, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, is, err_msg);
+      break;
+      
     case ppm_binary:
       return diskio::load_ppm_binary(x, is, err_msg);
       break;
@@ -2669,6 +2701,10 @@ field_aux::save(const field< Row<eT> >& x, const std::string& name, const file_t
       return diskio::save_arma_binary(x, name);
       break;
       
+    case npy_binary:
+      return diskio::save_npy_binary(x, name);
+      break;
+      
     case ppm_binary:
       return diskio::save_ppm_binary(x, name);
       break;
@@ -2694,6 +2730,10 @@ field_aux::save(const field< Row<eT> >& x, std::ostream& os, const file_type typ
       return diskio::save_arma_binary(x, os);
       break;
       
+    case npy_binary:
+      return diskio::save_npy_binary(x, os);
+      break;
+      
     case ppm_binary:
       return diskio::save_ppm_binary(x, os);
       break;
@@ -2723,6 +2763,10 @@ field_aux::load(field< Row<eT> >& x, const std::string& name, const file_type ty
       return diskio::load_arma_binary(x, name, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, name, err_msg);
+      break;
+      
     case ppm_binary:
       return diskio::load_ppm_binary(x, name, err_msg);
       break;
@@ -2752,6 +2796,10 @@ field_aux::load(field< Row<eT> >& x, std::istream& is, const file_type type, std
       return diskio::load_arma_binary(x, is, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, is, err_msg);
+      break;
+      
     case ppm_binary:
       return diskio::load_ppm_binary(x, is, err_msg);
       break;
@@ -2777,6 +2825,10 @@ field_aux::save(const field< Cube<eT> >& x, const std::string& name, const file_
       return diskio::save_arma_binary(x, name);
       break;
     
+    case npy_binary:
+      return diskio::save_npy_binary(x, name);
+      break;
+    
     default:
       err_msg = " [unsupported type] filename = ";
       return false;
@@ -2798,6 +2850,10 @@ field_aux::save(const field< Cube<eT> >& x, std::ostream& os, const file_type ty
       return diskio::save_arma_binary(x, os);
       break;
     
+    case npy_binary:
+      return diskio::save_npy_binary(x, os);
+      break;
+    
     default:
       err_msg = " [unsupported type] filename = ";
       return false;
@@ -2820,6 +2876,10 @@ field_aux::load(field< Cube<eT> >& x, const std::string& name, const file_type t
       return diskio::load_arma_binary(x, name, err_msg);
       break;
     
+    case npy_binary:
+      return diskio::load_npy_binary(x, name, err_msg);
+      break;
+    
     default:
       err_msg = " [unsupported type] filename = ";
       return false;
@@ -2842,6 +2902,10 @@ field_aux::load(field< Cube<eT> >& x, std::istream& is, const file_type type, st
       return diskio::load_arma_binary(x, is, err_msg);
       break;
       
+    case npy_binary:
+      return diskio::load_npy_binary(x, is, err_msg);
+      break;
+      
     default:
       err_msg = " [unsupported type] filename = ";
       return false;
@@ -0,0 +1,70 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup fn_batch_mul
+//! @{
+
+
+
+//! C.slice(i) = A.slice(i) * B.slice(i);
+//! trans_spec is "nn", "nt", "tn" or "tt", where 't' indicates that the slices of the corresponding cube are (hermitian) transposed;
+//! a cube with one slice is multiplied with each slice of the other cube
+template<typename T1, typename T2>
+inline
+void
+batch_mul
+  (
+        Cube<typename T1::elem_type>&        C,
+  const BaseCube<typename T1::elem_type,T1>& A_expr,
+  const BaseCube<typename T1::elem_type,T2>& B_expr,
+  const char*                                trans_spec = "nn"
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename T1::elem_type eT;
+  
+  const char sig_A = (trans_spec != nullptr) ? trans_spec[0] : char(0);
+  const char sig_B = (sig_A      != char(0)) ? trans_spec[1] : char(0);
+  
+  arma_debug_check
+    (
+    ( ((sig_A != 'n') && (sig_A != 't')) || ((sig_B != 'n') && (sig_B != 't')) ),
+    "batch_mul(): unknown trans_spec"
+    );
+  
+  const unwrap_cube<T1> UA(A_expr.get_ref());
+  const unwrap_cube<T2> UB(B_expr.get_ref());
+  
+  const Cube<eT>& A = UA.M;
+  const Cube<eT>& B = UB.M;
+  
+  const bool is_alias = ( (&A == &C) || (&B == &C) );
+  
+  Cube<eT>  tmp;
+  Cube<eT>& out = (is_alias) ? tmp : C;
+  
+       if( (sig_A == 'n') && (sig_B == 'n') )  { glue_batch_mul::apply_noalias<eT, false, false>(out, A, B); }
+  else if( (sig_A == 'n') && (sig_B == 't') )  { glue_batch_mul::apply_noalias<eT, false, true >(out, A, B); }
+  else if( (sig_A == 't') && (sig_B == 'n') )  { glue_batch_mul::apply_noalias<eT, true,  false>(out, A, B); }
+  else                                         { glue_batch_mul::apply_noalias<eT, true,  true >(out, A, B); }
+  
+  if(is_alias)  { C.steal_mem(tmp); }
+  }
+
+
+
+//! @}
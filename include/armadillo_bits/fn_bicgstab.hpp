@@ -0,0 +1,69 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup fn_bicgstab
+//! @{
+
+
+//! solve A*x = b via the stabilised bi-conjugate gradient method
+//! A is a sparse matrix, a dense matrix, or a function which takes a Col<eT> and returns A*Col<eT>;
+//! precond is one of "none", "jacobi", "ilu0" or "ic0", and is applicable only to sparse matrices
+template<typename T1, typename T2>
+inline
+bool
+bicgstab
+  (
+         Col<typename T2::elem_type>&     x,
+  const  T1&                              A,
+  const Base<typename T2::elem_type, T2>& b,
+  const char*                             precond = "none",
+  const iter_opts&                        opts    = iter_opts(),
+  const typename arma_blas_type_only<typename T2::elem_type>::result* junk = nullptr
+  )
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  iter_info info;
+  
+  return sp_iter::apply(sp_iter::solver_bicgstab, x, info, A, b, precond, opts, "bicgstab()");
+  }
+
+
+
+template<typename T1, typename T2>
+inline
+bool
+bicgstab
+  (
+         Col<typename T2::elem_type>&     x,
+         iter_info&                       info,
+  const  T1&                              A,
+  const Base<typename T2::elem_type, T2>& b,
+  const char*                             precond = "none",
+  const iter_opts&                        opts    = iter_opts(),
+  const typename arma_blas_type_only<typename T2::elem_type>::result* junk = nullptr
+  )
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  return sp_iter::apply(sp_iter::solver_bicgstab, x, info, A, b, precond, opts, "bicgstab()");
+  }
+
+
+
+//! @}
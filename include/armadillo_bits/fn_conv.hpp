@@ -30,7 +30,7 @@ enable_if2
   (is_arma_type<T1>::value && is_arma_type<T2>::value && is_same_type<typename T1::elem_type, typename T2::elem_type>::value),
   const Glue<T1, T2, glue_conv>
   >::result
-conv(const T1& A, const T2& B, const char* shape = "full")
+conv(const T1& A, const T2& B, const char* shape = "full", const char* method = "auto")
   {
   arma_extra_debug_sigprint();
   
@@ -38,9 +38,15 @@ conv(const T1& A, const T2& B, const char* shape = "full")
   
   arma_debug_check( ((sig != 'f') && (sig != 's')), "conv(): unsupported value of 'shape' parameter" );
   
+  const char method_sig = (method != nullptr) ? method[0] : char(0);
+  
+  arma_debug_check( ((method_sig != 'a') && (method_sig != 'd') && (method_sig != 'f')), "conv(): unknown method specified" );
+  
   const uword mode = (sig == 's') ? uword(1) : uword(0);
   
-  return Glue<T1, T2, glue_conv>(A, B, mode);
+  const uword method_id = (method_sig == 'd') ? uword(glue_conv::method_direct) : ( (method_sig == 'f') ? uword(glue_conv::method_fft) : uword(glue_conv::method_auto) );
+  
+  return Glue<T1, T2, glue_conv>(A, B, (mode | (method_id << 1)));
   }
 
 
@@ -54,7 +60,7 @@ enable_if2
   (is_arma_type<T1>::value && is_arma_type<T2>::value && is_same_type<typename T1::elem_type, typename T2::elem_type>::value),
   const Glue<T1, T2, glue_conv2>
   >::result
-conv2(const T1& A, const T2& B, const char* shape = "full")
+conv2(const T1& A, const T2& B, const char* shape = "full", const char* method = "auto")
   {
   arma_extra_debug_sigprint();
   
@@ -62,9 +68,15 @@ conv2(const T1& A, const T2& B, const char* shape = "full")
   
   arma_debug_check( ((sig != 'f') && (sig != 's')), "conv2(): unsupported value of 'shape' parameter" );
   
+  const char method_sig = (method != nullptr) ? method[0] : char(0);
+  
+  arma_debug_check( ((method_sig != 'a') && (method_sig != 'd') && (method_sig != 'f')), "conv2(): unknown method specified" );
+  
   const uword mode = (sig == 's') ? uword(1) : uword(0);
   
-  return Glue<T1, T2, glue_conv2>(A, B, mode);
+  const uword method_id = (method_sig == 'd') ? uword(glue_conv::method_direct) : ( (method_sig == 'f') ? uword(glue_conv::method_fft) : uword(glue_conv::method_auto) );
+  
+  return Glue<T1, T2, glue_conv2>(A, B, (mode | (method_id << 1)));
   }
 
 
@@ -420,4 +420,72 @@ eigs_gen
 
 
 
+//! eigenvalues of general real operator given as function object func, where func(x) returns A*x for a column vector x with n_rows elements
+template<typename T, typename func_type>
+inline
+typename enable_if2< is_real<T>::value && (is_arma_type<func_type>::value == false) && (is_arma_sparse_type<func_type>::value == false), bool >::result
+eigs_gen
+  (
+         Col< std::complex<T> >& eigval,
+  const func_type&               func,
+  const uword                    n_rows,
+  const uword                    n_eigvals,
+  const char*                    form = "lm",
+  const eigs_opts                opts = eigs_opts()
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  Mat< std::complex<T> > eigvec;
+  
+  sp_auxlib::form_type form_val = sp_auxlib::interpret_form_str(form);
+  
+  const bool status = sp_auxlib::eigs_gen_func(eigval, eigvec, func, n_rows, n_eigvals, form_val, opts);
+  
+  if(status == false)
+    {
+    eigval.soft_reset();
+    arma_debug_warn("eigs_gen(): decomposition failed");
+    }
+  
+  return status;
+  }
+
+
+
+//! eigenvalues and eigenvectors of general real operator given as function object func, where func(x) returns A*x for a column vector x with n_rows elements
+template<typename T, typename func_type>
+inline
+typename enable_if2< is_real<T>::value && (is_arma_type<func_type>::value == false) && (is_arma_sparse_type<func_type>::value == false), bool >::result
+eigs_gen
+  (
+         Col< std::complex<T> >& eigval,
+         Mat< std::complex<T> >& eigvec,
+  const func_type&               func,
+  const uword                    n_rows,
+  const uword                    n_eigvals,
+  const char*                    form = "lm",
+  const eigs_opts                opts = eigs_opts()
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( void_ptr(&eigval) == void_ptr(&eigvec), "eigs_gen(): parameter 'eigval' is an alias of parameter 'eigvec'" );
+  
+  sp_auxlib::form_type form_val = sp_auxlib::interpret_form_str(form);
+  
+  const bool status = sp_auxlib::eigs_gen_func(eigval, eigvec, func, n_rows, n_eigvals, form_val, opts);
+  
+  if(status == false)
+    {
+    eigval.soft_reset();
+    eigvec.soft_reset();
+    arma_debug_warn("eigs_gen(): decomposition failed");
+    }
+  
+  return status;
+  }
+
+
+
 //! @}
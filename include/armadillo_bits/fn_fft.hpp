@@ -131,4 +131,81 @@ ifft(const T1& A, const uword N)
 
 
 
+// real-to-complex and complex-to-real transforms,
+// which store only the N/2+1 non-redundant frequency bins of a real sequence of length N
+
+
+
+template<typename T1>
+arma_warn_unused
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && is_real<typename T1::elem_type>::value),
+  const mtOp<std::complex<typename T1::pod_type>, T1, op_fft_r2c>
+  >::result
+fft_r2c(const T1& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  return mtOp<std::complex<typename T1::pod_type>, T1, op_fft_r2c>(A, uword(0), uword(1));
+  }
+
+
+
+template<typename T1>
+arma_warn_unused
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && is_real<typename T1::elem_type>::value),
+  const mtOp<std::complex<typename T1::pod_type>, T1, op_fft_r2c>
+  >::result
+fft_r2c(const T1& A, const uword N)
+  {
+  arma_extra_debug_sigprint();
+  
+  return mtOp<std::complex<typename T1::pod_type>, T1, op_fft_r2c>(A, N, uword(0));
+  }
+
+
+
+template<typename T1>
+arma_warn_unused
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && (is_cx_float<typename T1::elem_type>::yes || is_cx_double<typename T1::elem_type>::yes)),
+  const mtOp<typename T1::pod_type, T1, op_ifft_c2r>
+  >::result
+ifft_c2r(const T1& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  return mtOp<typename T1::pod_type, T1, op_ifft_c2r>(A, uword(0), uword(1));
+  }
+
+
+
+template<typename T1>
+arma_warn_unused
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && (is_cx_float<typename T1::elem_type>::yes || is_cx_double<typename T1::elem_type>::yes)),
+  const mtOp<typename T1::pod_type, T1, op_ifft_c2r>
+  >::result
+ifft_c2r(const T1& A, const uword N)
+  {
+  arma_extra_debug_sigprint();
+  
+  return mtOp<typename T1::pod_type, T1, op_ifft_c2r>(A, N, uword(0));
+  }
+
+
+
 //! @}
@@ -29,7 +29,41 @@ inline
 typename
 enable_if2
   <
-  is_arma_type<T1>::value,
+  (is_arma_type<T1>::value && is_real<typename T1::elem_type>::value),
+  Mat< std::complex<typename T1::pod_type> >
+  >::result
+fft2(const T1& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename T1::elem_type eT;
+  
+  const quasi_unwrap<T1> tmp(A);
+  
+  // vectors retain the behaviour of the complex version, where fft() is applied twice
+  if(tmp.M.is_vec())
+    {
+    Mat< std::complex<eT> > B = strans( fft(tmp.M) );
+    
+    return strans( fft(B) );
+    }
+  
+  Mat< std::complex<eT> > out;
+  
+  op_fft2_real::apply(out, tmp.M);
+  
+  return out;
+  }
+
+
+
+template<typename T1>
+arma_warn_unused
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && (is_cx_float<typename T1::elem_type>::yes || is_cx_double<typename T1::elem_type>::yes)),
   Mat< std::complex<typename T1::pod_type> >
   >::result
 fft2(const T1& A)
@@ -0,0 +1,124 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup fn_lobpcg
+//! @{
+
+
+//! find k eigenvalues and eigenvectors of symmetric real matrix A via the LOBPCG method;
+//! A is a sparse or dense matrix; form is "sa" (smallest algebraic) or "la" (largest algebraic);
+//! precond is one of "none", "jacobi", "ilu0" or "ic0", and is applicable only to sparse matrices with form "sa"
+template<typename eT, typename T1>
+inline
+typename enable_if2< is_real<eT>::value && (is_arma_type<T1>::value || is_arma_sparse_type<T1>::value) && is_same_type<eT, typename T1::elem_type>::value, bool >::result
+lobpcg
+  (
+         Col<eT>&   eigval,
+         Mat<eT>&   eigvec,
+  const  T1&        A,
+  const  uword      k,
+  const  char*      form    = "sa",
+  const  char*      precond = "none",
+  const  iter_opts& opts    = iter_opts()
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( void_ptr(&eigval) == void_ptr(&eigvec), "lobpcg(): parameter 'eigval' is an alias of parameter 'eigvec'" );
+  
+  iter_info info;
+  
+  return sp_lobpcg::apply(eigval, eigvec, info, A, uword(0), k, form, precond, opts);
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< is_real<eT>::value && (is_arma_type<T1>::value || is_arma_sparse_type<T1>::value) && is_same_type<eT, typename T1::elem_type>::value, bool >::result
+lobpcg
+  (
+         Col<eT>&   eigval,
+         Mat<eT>&   eigvec,
+         iter_info& info,
+  const  T1&        A,
+  const  uword      k,
+  const  char*      form    = "sa",
+  const  char*      precond = "none",
+  const  iter_opts& opts    = iter_opts()
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( void_ptr(&eigval) == void_ptr(&eigvec), "lobpcg(): parameter 'eigval' is an alias of parameter 'eigvec'" );
+  
+  return sp_lobpcg::apply(eigval, eigvec, info, A, uword(0), k, form, precond, opts);
+  }
+
+
+
+//! find k eigenvalues and eigenvectors of a symmetric real operator with n rows, given as function object func;
+//! func takes a Mat<eT> with n rows and returns the product of the operator with all columns, eg. Mat<eT> func(const Mat<eT>& X)
+template<typename eT, typename func_type>
+inline
+typename enable_if2< is_real<eT>::value && (is_arma_type<func_type>::value == false) && (is_arma_sparse_type<func_type>::value == false), bool >::result
+lobpcg
+  (
+         Col<eT>&   eigval,
+         Mat<eT>&   eigvec,
+  const  func_type& func,
+  const  uword      n,
+  const  uword      k,
+  const  char*      form = "sa",
+  const  iter_opts& opts = iter_opts()
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( void_ptr(&eigval) == void_ptr(&eigvec), "lobpcg(): parameter 'eigval' is an alias of parameter 'eigvec'" );
+  
+  iter_info info;
+  
+  return sp_lobpcg::apply(eigval, eigvec, info, func, n, k, form, "none", opts);
+  }
+
+
+
+template<typename eT, typename func_type>
+inline
+typename enable_if2< is_real<eT>::value && (is_arma_type<func_type>::value == false) && (is_arma_sparse_type<func_type>::value == false), bool >::result
+lobpcg
+  (
+         Col<eT>&   eigval,
+         Mat<eT>&   eigvec,
+         iter_info& info,
+  const  func_type& func,
+  const  uword      n,
+  const  uword      k,
+  const  char*      form = "sa",
+  const  iter_opts& opts = iter_opts()
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( void_ptr(&eigval) == void_ptr(&eigvec), "lobpcg(): parameter 'eigval' is an alias of parameter 'eigvec'" );
+  
+  return sp_lobpcg::apply(eigval, eigvec, info, func, n, k, form, "none", opts);
+  }
+
+
+
+//! @}
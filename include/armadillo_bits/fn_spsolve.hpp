@@ -41,7 +41,7 @@ spsolve_helper
   
   const char sig = (solver != nullptr) ? solver[0] : char(0);
   
-  arma_debug_check( ((sig != 'l') && (sig != 's')), "spsolve(): unknown solver" );
+  arma_debug_check( ((sig != 'l') && (sig != 's') && (sig != 'c')), "spsolve(): unknown solver" );
   
   T rcond = T(0);
   
@@ -68,6 +68,60 @@ spsolve_helper
       }
     }
   else
+  if(sig == 'c')  // built-in sparse Cholesky solver (LDL' form)
+    {
+    spchol_opts spchol_opts_default;
+    
+    const spchol_opts& chol_opts = (settings.id == 2) ? static_cast<const spchol_opts&>(settings) : spchol_opts_default;
+    
+    if(settings.id == 1)
+      {
+      arma_debug_warn("spsolve(): ignoring settings not applicable to Cholesky based solver");
+      }
+    
+    const unwrap_spmat<T1> U(A.get_ref());
+    const SpMat<eT>& AA  = U.M;
+    
+    arma_debug_check( (AA.n_rows != AA.n_cols), "spsolve(): matrix A must be square sized" );
+    
+    out = B.get_ref();
+    
+    arma_debug_check( (AA.n_rows != out.n_rows), "spsolve(): number of rows in the given objects must be the same" );
+    
+    if(AA.is_empty())
+      {
+      status = true;
+      }
+    else
+    if(AA.is_hermitian( T(100) * std::numeric_limits<T>::epsilon() ) == false)
+      {
+      if(is_cx<eT>::no )  { arma_debug_warn("spsolve(): given matrix is not symmetric"); }
+      if(is_cx<eT>::yes)  { arma_debug_warn("spsolve(): given matrix is not hermitian"); }
+      
+      status = false;
+      }
+    else
+      {
+      sp_ldl<eT> ldl;
+      
+      status = ldl.factorise(AA, (chol_opts.permutation == spchol_opts::MIN_DEGREE));
+      
+      if(status)
+        {
+        rcond = ldl.rcond();
+        
+        if( (rcond < auxlib::epsilon_lapack(out)) && (chol_opts.allow_ugly == false) )
+          {
+          status = false;
+          }
+        else
+          {
+          ldl.solve(out);
+          }
+        }
+      }
+    }
+  else
   if(sig == 'l')  // brutal LAPACK solver
     {
     if( (settings.id != 0) && ((opts.symmetric) || (opts.pivot_thresh != double(1))) )
@@ -283,7 +283,7 @@ svds
   const bool status = svds_helper(U, S, V, X.get_ref(), k, tol, true);
   
   if(status == false)  { arma_debug_warn("svds(): decomposition failed"); }
-
+  
   return status;
   }
 
@@ -334,7 +334,7 @@ svds
   arma_ignore(junk);
   
   Col<typename T1::pod_type>  S;
-
+  
   Mat<typename T1::elem_type> U;
   Mat<typename T1::elem_type> V;
   
@@ -347,4 +347,154 @@ svds
 
 
 
+//! singular value decomposition of real operator A with n_rows x n_cols elements, given as function objects
+//! func and func_t, where func(x) returns A*x and func_t(x) returns A.t()*x
+template<typename eT, typename func_type, typename func_t_type>
+inline
+bool
+svds_func_helper
+  (
+         Mat<eT>&      U,
+         Col<eT>&      S,
+         Mat<eT>&      V,
+  const func_type&     func,
+  const func_t_type&   func_t,
+  const uword          n_rows,
+  const uword          n_cols,
+  const uword          k,
+  const eT             tol,
+  const bool           calc_UV
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check
+    (
+    ( ((void*)(&U) == (void*)(&S)) || (&U == &V) || ((void*)(&S) == (void*)(&V)) ),
+    "svds(): two or more output objects are the same object"
+    );
+  
+  arma_debug_check( (tol < eT(0)), "svds(): tol must be >= 0" );
+  
+  const uword kk = (std::min)( (std::min)(n_rows, n_cols), k );
+  
+  if(kk == 0)
+    {
+    U.set_size(n_rows, 0);
+    S.set_size(0);
+    V.set_size(n_cols, 0);
+    
+    return true;
+    }
+  
+  #if defined(ARMA_USE_NEWARP)
+    {
+    const newarp::FuncAugMatProd<eT,func_type,func_t_type> op(func, func_t, n_rows, n_cols);
+    
+    Col<eT> eigval;
+    Mat<eT> eigvec;
+    
+    eigs_opts opts;
+    opts.tol = (tol / Datum<eT>::sqrt2);
+    
+    const bool status = sp_auxlib::eigs_sym_newarp_op(eigval, eigvec, op, kk, sp_auxlib::form_la, opts);
+    
+    if(status == false)
+      {
+      U.soft_reset();
+      S.soft_reset();
+      V.soft_reset();
+      
+      return false;
+      }
+    
+    const uvec sorted_indices = sort_index(eigval, "descend");
+    
+    S = eigval.elem(sorted_indices);
+    
+    if(calc_UV)
+      {
+      const Mat<eT> eigvec_sorted = eigvec.cols(sorted_indices);
+      
+      U = Datum<eT>::sqrt2 * eigvec_sorted.rows(0,      n_rows-1         );
+      V = Datum<eT>::sqrt2 * eigvec_sorted.rows(n_rows, n_rows + n_cols - 1);
+      }
+    }
+  #else
+    {
+    arma_ignore(func);
+    arma_ignore(func_t);
+    arma_ignore(calc_UV);
+    
+    arma_stop_logic_error("svds(): use of NEWARP must be enabled for operators given as function objects");
+    return false;
+    }
+  #endif
+  
+  if(S.n_elem < k)  { arma_debug_warn("svds(): found fewer singular values than specified"); }
+  
+  return true;
+  }
+
+
+
+//! find the k largest singular values and corresponding singular vectors of real operator A with n_rows x n_cols elements,
+//! given as function objects func and func_t, where func(x) returns A*x and func_t(x) returns A.t()*x
+template<typename eT, typename func_type, typename func_t_type>
+inline
+typename enable_if2< is_real<eT>::value && (is_arma_type<func_type>::value == false) && (is_arma_sparse_type<func_type>::value == false), bool >::result
+svds
+  (
+         Mat<eT>&      U,
+         Col<eT>&      S,
+         Mat<eT>&      V,
+  const func_type&     func,
+  const func_t_type&   func_t,
+  const uword          n_rows,
+  const uword          n_cols,
+  const uword          k,
+  const eT             tol = eT(0)
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  const bool status = svds_func_helper(U, S, V, func, func_t, n_rows, n_cols, k, tol, true);
+  
+  if(status == false)  { arma_debug_warn("svds(): decomposition failed"); }
+  
+  return status;
+  }
+
+
+
+//! find the k largest singular values of real operator A with n_rows x n_cols elements,
+//! given as function objects func and func_t, where func(x) returns A*x and func_t(x) returns A.t()*x
+template<typename eT, typename func_type, typename func_t_type>
+inline
+typename enable_if2< is_real<eT>::value && (is_arma_type<func_type>::value == false) && (is_arma_sparse_type<func_type>::value == false), bool >::result
+svds
+  (
+         Col<eT>&      S,
+  const func_type&     func,
+  const func_t_type&   func_t,
+  const uword          n_rows,
+  const uword          n_cols,
+  const uword          k,
+  const eT             tol = eT(0)
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  Mat<eT> U;
+  Mat<eT> V;
+  
+  const bool status = svds_func_helper(U, S, V, func, func_t, n_rows, n_cols, k, tol, false);
+  
+  if(status == false)  { arma_debug_warn("svds(): decomposition failed"); }
+  
+  return status;
+  }
+
+
+
 //! @}
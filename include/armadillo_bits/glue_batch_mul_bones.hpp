@@ -0,0 +1,47 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup glue_batch_mul
+//! @{
+
+
+
+//! multiplication of corresponding slices of two cubes: C.slice(i) = A.slice(i) * B.slice(i).
+//! small products use register-blocked kernels (with compile-time sizes for common square sizes),
+//! and are spread across OpenMP threads; larger products use gemm() for each slice
+class glue_batch_mul
+  {
+  public:
+  
+  static constexpr uword max_kernel_size = 32;     //!< largest dimension handled by the built-in kernels
+  static constexpr uword mp_threshold    = 65536;  //!< minimum number of multiply-adds for spreading slices across OpenMP threads
+  
+  template<typename eT, const bool do_trans_A, const bool do_trans_B>
+  inline static void apply_noalias(Cube<eT>& C, const Cube<eT>& A, const Cube<eT>& B);
+  
+  template<typename eT, const bool do_trans_B, const uword fixed_size>
+  arma_hot inline static void kernel(eT* C, const eT* A, const eT* B, const uword in_M, const uword in_K, const uword in_N);
+  
+  template<typename eT, const bool do_trans_A, const bool do_trans_B>
+  arma_hot inline static void apply_slice_small(eT* C, const eT* A, const eT* B, const uword M, const uword K, const uword N);
+  
+  template<typename eT, const bool do_trans_A, const bool do_trans_B>
+  inline static void apply_slice_large(eT* C, const eT* A, const eT* B, const uword M, const uword K, const uword N);
+  };
+
+
+
+//! @}
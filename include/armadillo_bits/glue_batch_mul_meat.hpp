@@ -0,0 +1,238 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup glue_batch_mul
+//! @{
+
+
+
+template<typename eT, const bool do_trans_A, const bool do_trans_B>
+inline
+void
+glue_batch_mul::apply_noalias(Cube<eT>& C, const Cube<eT>& A, const Cube<eT>& B)
+  {
+  arma_extra_debug_sigprint();
+  
+  const uword M = (do_trans_A) ? A.n_cols : A.n_rows;
+  const uword K = (do_trans_A) ? A.n_rows : A.n_cols;
+  const uword N = (do_trans_B) ? B.n_rows : B.n_cols;
+  
+  const uword B_K = (do_trans_B) ? B.n_cols : B.n_rows;
+  
+  arma_debug_assert_mul_size(M, K, B_K, N, "batch_mul()");
+  
+  arma_debug_check
+    (
+    ( (A.n_slices != B.n_slices) && (A.n_slices != 1) && (B.n_slices != 1) ),
+    "batch_mul(): number of slices must be equal, or one of the cubes must have one slice"
+    );
+  
+  // a cube with no slices gives no slices, even if the other cube has one slice
+  const uword n_slices = ( (A.n_slices == 0) || (B.n_slices == 0) ) ? uword(0) : (std::max)(A.n_slices, B.n_slices);
+  
+  C.set_size(M, N, n_slices);
+  
+  if(C.n_elem == 0)  { return; }
+  
+  if(K == 0)  { C.zeros(); return; }
+  
+  // a cube with one slice is used for all slices of the other cube
+  const uword A_slice_step = (A.n_slices == 1) ? uword(0) : A.n_elem_slice;
+  const uword B_slice_step = (B.n_slices == 1) ? uword(0) : B.n_elem_slice;
+  
+  const eT* A_mem = A.memptr();
+  const eT* B_mem = B.memptr();
+        eT* C_mem = C.memptr();
+  
+  const uword C_n_elem_slice = C.n_elem_slice;
+  
+  const bool use_kernel = (M <= max_kernel_size) && (K <= max_kernel_size) && (N <= max_kernel_size);
+  
+  if(use_kernel)
+    {
+    #if defined(ARMA_USE_OPENMP)
+      {
+      const bool use_mp = (n_slices > 1) && ( (C.n_elem * K) >= mp_threshold ) && (mp_thread_limit::in_parallel() == false);
+      
+      if(use_mp)
+        {
+        const int n_threads = mp_thread_limit::get();
+        
+        #pragma omp parallel for schedule(static) num_threads(n_threads)
+        for(uword s=0; s < n_slices; ++s)
+          {
+          glue_batch_mul::apply_slice_small<eT, do_trans_A, do_trans_B>(&(C_mem[s*C_n_elem_slice]), &(A_mem[s*A_slice_step]), &(B_mem[s*B_slice_step]), M, K, N);
+          }
+        
+        return;
+        }
+      }
+    #endif
+    
+    for(uword s=0; s < n_slices; ++s)
+      {
+      glue_batch_mul::apply_slice_small<eT, do_trans_A, do_trans_B>(&(C_mem[s*C_n_elem_slice]), &(A_mem[s*A_slice_step]), &(B_mem[s*B_slice_step]), M, K, N);
+      }
+    }
+  else
+    {
+    // gemm() may use several threads for each slice
+    
+    for(uword s=0; s < n_slices; ++s)
+      {
+      glue_batch_mul::apply_slice_large<eT, do_trans_A, do_trans_B>(&(C_mem[s*C_n_elem_slice]), &(A_mem[s*A_slice_step]), &(B_mem[s*B_slice_step]), M, K, N);
+      }
+    }
+  }
+
+
+
+//! C = A*B, where A is M x K, B is K x N (or N x K if do_trans_B is true) and C is M x N;
+//! blocks of 4 columns of C are accumulated together, so that each column of A is loaded once per block;
+//! if fixed_size is non-zero, it is used as the value of M, K and N, so that all loop bounds are known at compile time
+template<typename eT, const bool do_trans_B, const uword fixed_size>
+arma_hot
+inline
+void
+glue_batch_mul::kernel(eT* C, const eT* A, const eT* B, const uword in_M, const uword in_K, const uword in_N)
+  {
+  const uword M = (fixed_size > 0) ? fixed_size : in_M;
+  const uword K = (fixed_size > 0) ? fixed_size : in_K;
+  const uword N = (fixed_size > 0) ? fixed_size : in_N;
+  
+  const uword B_n_rows = (do_trans_B) ? N : K;
+  
+  arma_aligned eT acc0[max_kernel_size];
+  arma_aligned eT acc1[max_kernel_size];
+  arma_aligned eT acc2[max_kernel_size];
+  arma_aligned eT acc3[max_kernel_size];
+  
+  uword j = 0;
+  
+  for(; (j+4) <= N; j += 4)
+    {
+    for(uword i=0; i < M; ++i)  { acc0[i] = eT(0); acc1[i] = eT(0); acc2[i] = eT(0); acc3[i] = eT(0); }
+    
+    for(uword k=0; k < K; ++k)
+      {
+      const eT* A_col = &(A[k*M]);
+      
+      const eT b0 = (do_trans_B) ? access::alt_conj(B[(j+0) + k*B_n_rows]) : B[k + (j+0)*B_n_rows];
+      const eT b1 = (do_trans_B) ? access::alt_conj(B[(j+1) + k*B_n_rows]) : B[k + (j+1)*B_n_rows];
+      const eT b2 = (do_trans_B) ? access::alt_conj(B[(j+2) + k*B_n_rows]) : B[k + (j+2)*B_n_rows];
+      const eT b3 = (do_trans_B) ? access::alt_conj(B[(j+3) + k*B_n_rows]) : B[k + (j+3)*B_n_rows];
+      
+      for(uword i=0; i < M; ++i)
+        {
+        const eT a = A_col[i];
+        
+        acc0[i] += a * b0;
+        acc1[i] += a * b1;
+        acc2[i] += a * b2;
+        acc3[i] += a * b3;
+        }
+      }
+    
+    eT* C_col0 = &(C[(j+0)*M]);
+    eT* C_col1 = &(C[(j+1)*M]);
+    eT* C_col2 = &(C[(j+2)*M]);
+    eT* C_col3 = &(C[(j+3)*M]);
+    
+    for(uword i=0; i < M; ++i)  { C_col0[i] = acc0[i]; C_col1[i] = acc1[i]; C_col2[i] = acc2[i]; C_col3[i] = acc3[i]; }
+    }
+  
+  if( (fixed_size > 0) && ((fixed_size % 4) == 0) )  { return; }
+  
+  for(; j < N; ++j)
+    {
+    for(uword i=0; i < M; ++i)  { acc0[i] = eT(0); }
+    
+    for(uword k=0; k < K; ++k)
+      {
+      const eT* A_col = &(A[k*M]);
+      
+      const eT b0 = (do_trans_B) ? access::alt_conj(B[j + k*B_n_rows]) : B[k + j*B_n_rows];
+      
+      for(uword i=0; i < M; ++i)  { acc0[i] += A_col[i] * b0; }
+      }
+    
+    eT* C_col = &(C[j*M]);
+    
+    for(uword i=0; i < M; ++i)  { C_col[i] = acc0[i]; }
+    }
+  }
+
+
+
+template<typename eT, const bool do_trans_A, const bool do_trans_B>
+arma_hot
+inline
+void
+glue_batch_mul::apply_slice_small(eT* C, const eT* A, const eT* B, const uword M, const uword K, const uword N)
+  {
+  // the kernel requires A in non-transposed form; A^T is K x M
+  
+  arma_aligned eT A_tmp[ (do_trans_A) ? (max_kernel_size*max_kernel_size) : 1 ];
+  
+  if(do_trans_A)
+    {
+    for(uword k=0; k < K; ++k)
+    for(uword i=0; i < M; ++i)
+      {
+      A_tmp[i + k*M] = access::alt_conj(A[k + i*K]);
+      }
+    }
+  
+  const eT* AA = (do_trans_A) ? A_tmp : A;
+  
+  if( (M == K) && (K == N) )
+    {
+    switch(M)
+      {
+      case  2:  glue_batch_mul::kernel<eT, do_trans_B,  2>(C, AA, B, M, K, N);  return;
+      case  3:  glue_batch_mul::kernel<eT, do_trans_B,  3>(C, AA, B, M, K, N);  return;
+      case  4:  glue_batch_mul::kernel<eT, do_trans_B,  4>(C, AA, B, M, K, N);  return;
+      case  6:  glue_batch_mul::kernel<eT, do_trans_B,  6>(C, AA, B, M, K, N);  return;
+      case  8:  glue_batch_mul::kernel<eT, do_trans_B,  8>(C, AA, B, M, K, N);  return;
+      case 12:  glue_batch_mul::kernel<eT, do_trans_B, 12>(C, AA, B, M, K, N);  return;
+      case 16:  glue_batch_mul::kernel<eT, do_trans_B, 16>(C, AA, B, M, K, N);  return;
+      case 24:  glue_batch_mul::kernel<eT, do_trans_B, 24>(C, AA, B, M, K, N);  return;
+      case 32:  glue_batch_mul::kernel<eT, do_trans_B, 32>(C, AA, B, M, K, N);  return;
+      default:  ;
+      }
+    }
+  
+  glue_batch_mul::kernel<eT, do_trans_B, 0>(C, AA, B, M, K, N);
+  }
+
+
+
+template<typename eT, const bool do_trans_A, const bool do_trans_B>
+inline
+void
+glue_batch_mul::apply_slice_large(eT* C, const eT* A, const eT* B, const uword M, const uword K, const uword N)
+  {
+  const Mat<eT> AA(const_cast<eT*>(A), ((do_trans_A) ? K : M), ((do_trans_A) ? M : K), false, true);
+  const Mat<eT> BB(const_cast<eT*>(B), ((do_trans_B) ? N : K), ((do_trans_B) ? K : N), false, true);
+  
+        Mat<eT> CC(C, M, N, false, true);
+  
+  glue_times::apply<eT, do_trans_A, do_trans_B, false>(CC, AA, BB, eT(0));
+  }
+
+
+
+//! @}
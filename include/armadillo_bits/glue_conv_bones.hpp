@@ -32,7 +32,27 @@ class glue_conv
     static constexpr bool is_xvec = T1::is_xvec;
     };
   
-  template<typename eT> inline static void apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const bool A_is_col);
+  // aux_uword in Glue<T1,T2,glue_conv> holds the shape in bit 0 and the method in bits 1 and 2
+  
+  static constexpr uword method_auto   = 0;
+  static constexpr uword method_direct = 1;
+  static constexpr uword method_fft    = 2;
+  
+  // minimum filter length for automatically considering the FFT based implementation
+  static constexpr uword fft_threshold = 64;
+  
+  template<typename eT> inline static void apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const bool A_is_col, const uword method = method_auto);
+  
+  template<typename eT> inline static void apply_direct(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col);
+  
+  template<typename eT> inline static void apply_fft(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col, const uword nfft, typename     arma_real_only<eT>::result* junk = nullptr);
+  template<typename eT> inline static void apply_fft(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col, const uword nfft, typename       arma_cx_only<eT>::result* junk = nullptr);
+  template<typename eT> inline static void apply_fft(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col, const uword nfft, typename arma_integral_only<eT>::result* junk = nullptr);
+  
+  template<typename eT> inline static uword choose_nfft(const uword h_n_elem, const uword x_n_elem, const uword method);
+  
+  inline static double fft_cost(const double N);
+  inline static uword  fft_size(const uword  N);
   
   template<typename T1, typename T2> inline static void apply(Mat<typename T1::elem_type>& out, const Glue<T1,T2,glue_conv>& X);
   };
@@ -44,7 +64,15 @@ class glue_conv2
   {
   public:
   
-  template<typename eT> inline static void apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B);
+  template<typename eT> inline static void apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const uword method = glue_conv::method_auto);
+  
+  template<typename eT> inline static void apply_direct(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W);
+  
+  template<typename eT> inline static void apply_fft(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W, typename     arma_real_only<eT>::result* junk = nullptr);
+  template<typename eT> inline static void apply_fft(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W, typename       arma_cx_only<eT>::result* junk = nullptr);
+  template<typename eT> inline static void apply_fft(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W, typename arma_integral_only<eT>::result* junk = nullptr);
+  
+  template<typename cx_type, bool inverse> inline static void fft_cols_rows(cx_type* mem, const uword P, const uword Q, const uword n_active_cols);
   
   template<typename T1, typename T2> inline static void apply(Mat<typename T1::elem_type>& out, const Glue<T1,T2,glue_conv2>& expr);
   };
@@ -19,17 +19,39 @@
 
 
 
-// TODO: this implementation of conv() is rudimentary; replace with faster version
 template<typename eT>
 inline
 void
-glue_conv::apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const bool A_is_col)
+glue_conv::apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const bool A_is_col, const uword method)
   {
   arma_extra_debug_sigprint();
   
   const Mat<eT>& h = (A.n_elem <= B.n_elem) ? A : B;
   const Mat<eT>& x = (A.n_elem <= B.n_elem) ? B : A;
   
+  if( (h.n_elem == 0) || (x.n_elem == 0) )  { out.zeros(); return; }
+  
+  const uword nfft = glue_conv::choose_nfft<eT>(h.n_elem, x.n_elem, method);
+  
+  if(nfft == 0)
+    {
+    glue_conv::apply_direct(out, h, x, A_is_col);
+    }
+  else
+    {
+    glue_conv::apply_fft(out, h, x, A_is_col, nfft);
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+glue_conv::apply_direct(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col)
+  {
+  arma_extra_debug_sigprint();
+  
   const uword   h_n_elem    = h.n_elem;
   const uword   h_n_elem_m1 = h_n_elem - 1;
   const uword   x_n_elem    = x.n_elem;
@@ -71,6 +93,240 @@ glue_conv::apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const bool A_
 
 
 
+//! overlap-add convolution using FFTs of length nfft;
+//! when nfft covers the entire output, only one block is processed.
+//! for real data only the non-redundant half of each spectrum is computed
+template<typename eT>
+inline
+void
+glue_conv::apply_fft(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col, const uword nfft, typename arma_real_only<eT>::result* junk)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  typedef std::complex<eT> cx_type;
+  
+  const uword   h_n_elem = h.n_elem;
+  const uword   x_n_elem = x.n_elem;
+  const uword out_n_elem = h_n_elem + x_n_elem - 1;
+  
+  const uword block_len = (std::min)( (nfft - h_n_elem + 1), x_n_elem );
+  const uword n_bins    = nfft/2 + 1;
+  
+  const typename fft_cache< fft_engine_real<cx_type> >::ptr_type worker_ptr = fft_cache< fft_engine_real<cx_type> >::get(nfft);
+  
+  const fft_engine_real<cx_type>& worker = *worker_ptr;
+  
+  podarray<eT>      buf(nfft);
+  podarray<cx_type>   H(n_bins);
+  podarray<cx_type>   Y(n_bins);
+  
+       eT* buf_mem = buf.memptr();
+  cx_type*   H_mem =   H.memptr();
+  cx_type*   Y_mem =   Y.memptr();
+  
+  const eT* h_mem = h.memptr();
+  const eT* x_mem = x.memptr();
+  
+  arrayops::copy( buf_mem, h_mem, h_n_elem );
+  
+  arrayops::fill_zeros( &(buf_mem[h_n_elem]), (nfft - h_n_elem) );
+  
+  worker.r2c(H_mem, buf_mem);
+  
+  (A_is_col) ? out.zeros(out_n_elem, 1) : out.zeros(1, out_n_elem);
+  
+  eT* out_mem = out.memptr();
+  
+  for(uword start=0; start < x_n_elem; start += block_len)
+    {
+    const uword len     = (std::min)(block_len, (x_n_elem - start));
+    const uword n_valid = len + h_n_elem - 1;
+    
+    arrayops::copy( buf_mem, &(x_mem[start]), len );
+    
+    arrayops::fill_zeros( &(buf_mem[len]), (nfft - len) );
+    
+    worker.r2c(Y_mem, buf_mem);
+    
+    for(uword i=0; i < n_bins; ++i)  { Y_mem[i] *= H_mem[i]; }
+    
+    worker.c2r(buf_mem, Y_mem);
+    
+    arrayops::inplace_plus( &(out_mem[start]), buf_mem, n_valid );
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+glue_conv::apply_fft(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col, const uword nfft, typename arma_cx_only<eT>::result* junk)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  typedef typename get_pod_type<eT>::result T;
+  typedef std::complex<T>             cx_type;
+  
+  const uword   h_n_elem = h.n_elem;
+  const uword   x_n_elem = x.n_elem;
+  const uword out_n_elem = h_n_elem + x_n_elem - 1;
+  
+  const uword block_len = (std::min)( (nfft - h_n_elem + 1), x_n_elem );
+  
+  const typename fft_cache< fft_engine<cx_type,false> >::ptr_type worker_fwd_ptr = fft_cache< fft_engine<cx_type,false> >::get(nfft);
+  const typename fft_cache< fft_engine<cx_type,true > >::ptr_type worker_inv_ptr = fft_cache< fft_engine<cx_type,true > >::get(nfft);
+  
+  const fft_engine<cx_type,false>& worker_fwd = *worker_fwd_ptr;
+  const fft_engine<cx_type,true >& worker_inv = *worker_inv_ptr;
+  
+  podarray<cx_type>   H(nfft);
+  podarray<cx_type> buf(nfft);
+  podarray<cx_type>   Y(nfft);
+  
+  cx_type*   H_mem =   H.memptr();
+  cx_type* buf_mem = buf.memptr();
+  cx_type*   Y_mem =   Y.memptr();
+  
+  const eT* h_mem = h.memptr();
+  const eT* x_mem = x.memptr();
+  
+  for(uword i=0; i < h_n_elem; ++i)  { buf_mem[i] = cx_type(h_mem[i]); }
+  
+  arrayops::fill_zeros( &(buf_mem[h_n_elem]), (nfft - h_n_elem) );
+  
+  worker_fwd.run(H_mem, buf_mem);
+  
+  (A_is_col) ? out.zeros(out_n_elem, 1) : out.zeros(1, out_n_elem);
+  
+  eT* out_mem = out.memptr();
+  
+  const T k = T(1) / T(nfft);
+  
+  for(uword start=0; start < x_n_elem; start += block_len)
+    {
+    const uword len     = (std::min)(block_len, (x_n_elem - start));
+    const uword n_valid = len + h_n_elem - 1;
+    
+    for(uword i=0; i < len; ++i)  { buf_mem[i] = cx_type(x_mem[start + i]); }
+    
+    arrayops::fill_zeros( &(buf_mem[len]), (nfft - len) );
+    
+    worker_fwd.run(Y_mem, buf_mem);
+    
+    for(uword i=0; i < nfft; ++i)  { buf_mem[i] = Y_mem[i] * H_mem[i]; }
+    
+    worker_inv.run(Y_mem, buf_mem);
+    
+    eT* out_ptr = &(out_mem[start]);
+    
+    for(uword i=0; i < n_valid; ++i)
+      {
+      eT val;
+      
+      arrayops::convert_cx_scalar(val, (Y_mem[i] * k));
+      
+      out_ptr[i] += val;
+      }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+glue_conv::apply_fft(Mat<eT>& out, const Mat<eT>& h, const Mat<eT>& x, const bool A_is_col, const uword nfft, typename arma_integral_only<eT>::result* junk)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(nfft);
+  arma_ignore(junk);
+  
+  // FFT based convolution is not applicable to integer element types
+  
+  glue_conv::apply_direct(out, h, x, A_is_col);
+  }
+
+
+
+//! returns the FFT length to use for overlap-add convolution, or zero if direct convolution is preferable
+template<typename eT>
+inline
+uword
+glue_conv::choose_nfft(const uword h_n_elem, const uword x_n_elem, const uword method)
+  {
+  arma_extra_debug_sigprint();
+  
+  if( (is_real<eT>::value == false) && (is_cx<eT>::value == false) )  { return uword(0); }
+  
+  if(method == glue_conv::method_direct)  { return uword(0); }
+  
+  if( (method == glue_conv::method_auto) && (h_n_elem < glue_conv::fft_threshold) )  { return uword(0); }
+  
+  const uword out_n_elem = h_n_elem + x_n_elem - 1;
+  
+  if(out_n_elem < 2)  { return uword(0); }
+  
+  // transforms of real data cost about half as much, but need an even length
+  
+  const double cost_scale = (is_real<eT>::value) ? double(0.5) : double(1);
+  
+  // start with a single transform covering the entire output
+  
+  uword  best_nfft = (is_real<eT>::value) ? (2 * glue_conv::fft_size((out_n_elem + 1) / 2)) : glue_conv::fft_size(out_n_elem);
+  double best_cost = double(3) * cost_scale * glue_conv::fft_cost(double(best_nfft)) + double(best_nfft);
+  
+  // try overlap-add with shorter transforms
+  
+  uword nfft = 2;
+  
+  while(nfft < 2*h_n_elem)  { nfft *= 2; }
+  
+  for(; nfft < best_nfft; nfft *= 2)
+    {
+    const uword block_len = nfft - h_n_elem + 1;
+    const uword n_blocks  = (x_n_elem + block_len - 1) / block_len;
+    
+    const double cost = double(2*n_blocks + 1) * cost_scale * glue_conv::fft_cost(double(nfft)) + double(n_blocks) * double(nfft);
+    
+    if(cost < best_cost)  { best_cost = cost; best_nfft = nfft; }
+    }
+  
+  if(method == glue_conv::method_auto)
+    {
+    const double direct_cost = double(h_n_elem) * double(x_n_elem);
+    
+    if(best_cost >= direct_cost)  { return uword(0); }
+    }
+  
+  return best_nfft;
+  }
+
+
+
+//! rough cost of a complex FFT of length N, expressed in the number of multiply-add operations
+//! that direct convolution would perform in the same time; direct convolution benefits from vectorisation
+inline
+double
+glue_conv::fft_cost(const double N)
+  {
+  return double(10) * N * std::log2(N);
+  }
+
+
+
+//! smallest length >= N that has only 2, 3 and 5 as factors, which are handled efficiently by fft_engine
+inline
+uword
+glue_conv::fft_size(const uword N)
+  {
+  return fft_helper::good_size(N);
+  }
+
+
+
 // // alternative implementation of 1d convolution
 // template<typename eT>
 // inline
@@ -186,18 +442,19 @@ glue_conv::apply(Mat<typename T1::elem_type>& out, const Glue<T1,T2,glue_conv>&
   
   const bool A_is_col = ((T1::is_col) || (A.n_cols == 1));
   
-  const uword mode = expr.aux_uword;
+  const uword mode   = expr.aux_uword & uword(1);
+  const uword method = expr.aux_uword >> 1;
   
   if(mode == 0)  // full convolution
     {
-    glue_conv::apply(out, A, B, A_is_col);
+    glue_conv::apply(out, A, B, A_is_col, method);
     }
   else
   if(mode == 1)  // same size as A
     {
     Mat<eT> tmp;
     
-    glue_conv::apply(tmp, A, B, A_is_col);
+    glue_conv::apply(tmp, A, B, A_is_col, method);
     
     if( (tmp.is_empty() == false) && (A.is_empty() == false) && (B.is_empty() == false) )
       {
@@ -218,17 +475,63 @@ glue_conv::apply(Mat<typename T1::elem_type>& out, const Glue<T1,T2,glue_conv>&
 
 
 
-// TODO: this implementation of conv2() is rudimentary; replace with faster version
 template<typename eT>
 inline
 void
-glue_conv2::apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B)
+glue_conv2::apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B, const uword method)
   {
   arma_extra_debug_sigprint();
   
   const Mat<eT>& G = (A.n_elem <= B.n_elem) ? A : B;   // unflipped filter coefficients
   const Mat<eT>& W = (A.n_elem <= B.n_elem) ? B : A;   // original 2D image
   
+  if(G.is_empty() || W.is_empty())  { out.zeros(); return; }
+  
+  bool use_fft = false;
+  
+  if( (is_real<eT>::value || is_cx<eT>::value) && (method != glue_conv::method_direct) )
+    {
+    if(method == glue_conv::method_fft)
+      {
+      use_fft = true;
+      }
+    else
+    if(G.n_elem >= glue_conv::fft_threshold)
+      {
+      const uword P = glue_conv::fft_size(W.n_rows + G.n_rows - 1);
+      const uword Q = glue_conv::fft_size(W.n_cols + G.n_cols - 1);
+      
+      const double PQ = double(P) * double(Q);
+      
+      // transforms of real data cost about half as much
+      const double cost_scale = (is_real<eT>::value) ? double(0.5) : double(1);
+      
+      const double    fft_cost = double(3) * cost_scale * glue_conv::fft_cost(PQ) + PQ;
+      const double direct_cost = double(W.n_rows + G.n_rows - 1) * double(W.n_cols + G.n_cols - 1) * double(G.n_elem);
+      
+      use_fft = (fft_cost < direct_cost);
+      }
+    }
+  
+  if(use_fft)
+    {
+    glue_conv2::apply_fft(out, G, W);
+    }
+  else
+    {
+    glue_conv2::apply_direct(out, G, W);
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+glue_conv2::apply_direct(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W)
+  {
+  arma_extra_debug_sigprint();
+  
   const uword out_n_rows = ((W.n_rows + G.n_rows) > 0) ? (W.n_rows + G.n_rows - 1) : uword(0);
   const uword out_n_cols = ((W.n_cols + G.n_cols) > 0) ? (W.n_cols + G.n_cols - 1) : uword(0);
   
@@ -286,6 +589,211 @@ glue_conv2::apply(Mat<eT>& out, const Mat<eT>& A, const Mat<eT>& B)
 
 
 
+//! the columns are transformed via fft_engine_real, so only the non-redundant half of the spectrum is processed
+template<typename eT>
+inline
+void
+glue_conv2::apply_fft(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W, typename arma_real_only<eT>::result* junk)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  typedef std::complex<eT> cx_type;
+  
+  const uword out_n_rows = W.n_rows + G.n_rows - 1;
+  const uword out_n_cols = W.n_cols + G.n_cols - 1;
+  
+  const uword P = 2 * glue_conv::fft_size((out_n_rows + 1) / 2);
+  const uword Q =     glue_conv::fft_size(out_n_cols);
+  
+  const uword n_bins = P/2 + 1;
+  
+  const typename fft_cache< fft_engine_real<cx_type> >::ptr_type worker_ptr = fft_cache< fft_engine_real<cx_type> >::get(P);
+  
+  const fft_engine_real<cx_type>& worker = *worker_ptr;
+  
+  podarray<eT>      buf(P);
+  podarray<cx_type> GG(n_bins*Q);
+  podarray<cx_type> WW(n_bins*Q);
+  
+       eT* buf_mem = buf.memptr();
+  cx_type*  GG_mem =  GG.memptr();
+  cx_type*  WW_mem =  WW.memptr();
+  
+  arrayops::fill_zeros(GG_mem, n_bins*Q);
+  arrayops::fill_zeros(WW_mem, n_bins*Q);
+  
+  arrayops::fill_zeros( &(buf_mem[G.n_rows]), (P - G.n_rows) );
+  
+  for(uword col=0; col < G.n_cols; ++col)
+    {
+    arrayops::copy(buf_mem, G.colptr(col), G.n_rows);
+    
+    worker.r2c( &(GG_mem[col*n_bins]), buf_mem );
+    }
+  
+  arrayops::fill_zeros( &(buf_mem[W.n_rows]), (P - W.n_rows) );
+  
+  for(uword col=0; col < W.n_cols; ++col)
+    {
+    arrayops::copy(buf_mem, W.colptr(col), W.n_rows);
+    
+    worker.r2c( &(WW_mem[col*n_bins]), buf_mem );
+    }
+  
+  glue_conv2::fft_cols_rows<cx_type,false>(GG_mem, n_bins, Q, 0);
+  glue_conv2::fft_cols_rows<cx_type,false>(WW_mem, n_bins, Q, 0);
+  
+  for(uword i=0; i < n_bins*Q; ++i)  { WW_mem[i] *= GG_mem[i]; }
+  
+  glue_conv2::fft_cols_rows<cx_type,true>(WW_mem, n_bins, Q, 0);
+  
+  out.set_size(out_n_rows, out_n_cols);
+  
+  const eT k = eT(1) / eT(Q);
+  
+  for(uword col=0; col < out_n_cols; ++col)
+    {
+    worker.c2r( buf_mem, &(WW_mem[col*n_bins]) );
+    
+    eT* out_colptr = out.colptr(col);
+    
+    for(uword row=0; row < out_n_rows; ++row)  { out_colptr[row] = buf_mem[row] * k; }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+glue_conv2::apply_fft(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W, typename arma_cx_only<eT>::result* junk)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  typedef typename get_pod_type<eT>::result T;
+  typedef std::complex<T>             cx_type;
+  
+  const uword out_n_rows = W.n_rows + G.n_rows - 1;
+  const uword out_n_cols = W.n_cols + G.n_cols - 1;
+  
+  const uword P = glue_conv::fft_size(out_n_rows);
+  const uword Q = glue_conv::fft_size(out_n_cols);
+  
+  podarray<cx_type> GG(P*Q);
+  podarray<cx_type> WW(P*Q);
+  
+  cx_type* GG_mem = GG.memptr();
+  cx_type* WW_mem = WW.memptr();
+  
+  arrayops::fill_zeros(GG_mem, P*Q);
+  arrayops::fill_zeros(WW_mem, P*Q);
+  
+  for(uword col=0; col < G.n_cols; ++col)
+    {
+    const eT*       G_colptr = G.colptr(col);
+          cx_type* GG_colptr = &(GG_mem[col*P]);
+    
+    for(uword row=0; row < G.n_rows; ++row)  { GG_colptr[row] = cx_type(G_colptr[row]); }
+    }
+  
+  for(uword col=0; col < W.n_cols; ++col)
+    {
+    const eT*       W_colptr = W.colptr(col);
+          cx_type* WW_colptr = &(WW_mem[col*P]);
+    
+    for(uword row=0; row < W.n_rows; ++row)  { WW_colptr[row] = cx_type(W_colptr[row]); }
+    }
+  
+  glue_conv2::fft_cols_rows<cx_type,false>(GG_mem, P, Q, G.n_cols);
+  glue_conv2::fft_cols_rows<cx_type,false>(WW_mem, P, Q, W.n_cols);
+  
+  for(uword i=0; i < P*Q; ++i)  { WW_mem[i] *= GG_mem[i]; }
+  
+  glue_conv2::fft_cols_rows<cx_type,true>(WW_mem, P, Q, Q);
+  
+  out.set_size(out_n_rows, out_n_cols);
+  
+  const T k = T(1) / ( T(P) * T(Q) );
+  
+  for(uword col=0; col < out_n_cols; ++col)
+    {
+          eT*      out_colptr = out.colptr(col);
+    const cx_type*  WW_colptr = &(WW_mem[col*P]);
+    
+    for(uword row=0; row < out_n_rows; ++row)  { arrayops::convert_cx_scalar(out_colptr[row], (WW_colptr[row] * k)); }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+glue_conv2::apply_fft(Mat<eT>& out, const Mat<eT>& G, const Mat<eT>& W, typename arma_integral_only<eT>::result* junk)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  // FFT based convolution is not applicable to integer element types
+  
+  glue_conv2::apply_direct(out, G, W);
+  }
+
+
+
+//! in-place unscaled 2D FFT of a P x Q column-major array;
+//! columns at and beyond n_active_cols are assumed to be zero and are not transformed,
+//! hence setting n_active_cols to zero transforms only the rows
+template<typename cx_type, bool inverse>
+inline
+void
+glue_conv2::fft_cols_rows(cx_type* mem, const uword P, const uword Q, const uword n_active_cols)
+  {
+  arma_extra_debug_sigprint();
+  
+  podarray<cx_type> buf_a( (std::max)(P,Q) );
+  podarray<cx_type> buf_b( (std::max)(P,Q) );
+  
+  cx_type* buf_a_mem = buf_a.memptr();
+  cx_type* buf_b_mem = buf_b.memptr();
+  
+  if( (P > 1) && (n_active_cols > 0) )
+    {
+    const typename fft_cache< fft_engine<cx_type,inverse> >::ptr_type worker_ptr = fft_cache< fft_engine<cx_type,inverse> >::get(P);
+    
+    const fft_engine<cx_type,inverse>& worker = *worker_ptr;
+    
+    for(uword col=0; col < n_active_cols; ++col)
+      {
+      cx_type* colptr = &(mem[col*P]);
+      
+      arrayops::copy(buf_a_mem, colptr, P);
+      
+      worker.run(colptr, buf_a_mem);
+      }
+    }
+  
+  if(Q > 1)
+    {
+    const typename fft_cache< fft_engine<cx_type,inverse> >::ptr_type worker_ptr = fft_cache< fft_engine<cx_type,inverse> >::get(Q);
+    
+    const fft_engine<cx_type,inverse>& worker = *worker_ptr;
+    
+    for(uword row=0; row < P; ++row)
+      {
+      for(uword col=0; col < Q; ++col)  { buf_a_mem[col] = mem[row + col*P]; }
+      
+      worker.run(buf_b_mem, buf_a_mem);
+      
+      for(uword col=0; col < Q; ++col)  { mem[row + col*P] = buf_b_mem[col]; }
+      }
+    }
+  }
+
+
+
 template<typename T1, typename T2>
 inline
 void
@@ -301,18 +809,19 @@ glue_conv2::apply(Mat<typename T1::elem_type>& out, const Glue<T1,T2,glue_conv2>
   const Mat<eT>& A = UA.M;
   const Mat<eT>& B = UB.M;
   
-  const uword mode = expr.aux_uword;
+  const uword mode   = expr.aux_uword & uword(1);
+  const uword method = expr.aux_uword >> 1;
   
   if(mode == 0)  // full convolution
     {
-    glue_conv2::apply(out, A, B);
+    glue_conv2::apply(out, A, B, method);
     }
   else
   if(mode == 1)  // same size as A
     {
     Mat<eT> tmp;
     
-    glue_conv2::apply(tmp, A, B);
+    glue_conv2::apply(tmp, A, B, method);
     
     if( (tmp.is_empty() == false) && (A.is_empty() == false) && (B.is_empty() == false) )
       {
@@ -96,11 +96,115 @@ struct glue_times_redirect<3>
   };
 
 
+
+//! \brief
+//! evaluation of a chain of N >= 4 matrix multiplications, in the order with the lowest estimated cost.
+//! the order is found via dynamic programming over all parenthesisations;
+//! the cost model accounts for transposed factors, and for inv() and inv_sympd() factors,
+//! which are never explicitly inverted when they can be replaced by solve()
+
+template<typename eT, uword N>
+class glue_times_chain
+  {
+  public:
+  
+  const Mat<eT>& ref_out;  //!< used for detecting aliasing
+  
+  inline glue_times_chain(const Mat<eT>& in_out);
+  
+  inline void add    (const Mat<eT>& M, const bool do_trans, const eT val, const bool is_alias);
+  inline void add_inv(      Mat<eT>& M, const bool do_inv_sympd);
+  
+  inline void apply(Mat<eT>& out);
+  
+  
+  private:
+  
+  struct factor_type
+    {
+    const Mat<eT>* M;
+          Mat<eT>* inv_M;         //!< non-null for inv() and inv_sympd() factors
+          bool     do_trans;
+          bool     do_inv_sympd;
+    };
+  
+  factor_type factors[N];
+  uword       n_factors;
+  
+  uword dims[N+1];    //!< factor k has dims[k] rows and dims[k+1] columns
+  uword split[N*N];   //!< the product of factors i..j is evaluated as (i..split)*(split+1..j)
+  
+  eT   alpha;
+  bool use_alpha;
+  bool alias;
+  
+  inline static double solve_cost(const double n, const double m, const bool do_inv_sympd);
+  
+  inline void plan();
+  
+  inline void eval(Mat<eT>& out, const uword i, const uword j, const bool top);
+  
+  inline const Mat<eT>& operand(Mat<eT>& tmp, bool& do_trans, const uword i, const uword j);
+  
+  inline static void mul(Mat<eT>& out, const Mat<eT>& A, const bool do_trans_A, const Mat<eT>& B, const bool do_trans_B, const bool do_alpha, const eT val);
+  };
+
+
+
+template<bool do_inv_detect>
+struct glue_times_chain_solve
+  {
+  template<typename eT> inline static bool solve(Mat<eT>& out, Mat<eT>& A, const Mat<eT>& B, const bool do_inv_sympd);
+  template<typename eT> inline static bool inv  (Mat<eT>& out, Mat<eT>& A,                   const bool do_inv_sympd);
+  };
+
+
 template<>
-struct glue_times_redirect<4>
+struct glue_times_chain_solve<false>
+  {
+  template<typename eT> inline static bool solve(Mat<eT>& out, Mat<eT>& A, const Mat<eT>& B, const bool do_inv_sympd);
+  template<typename eT> inline static bool inv  (Mat<eT>& out, Mat<eT>& A,                   const bool do_inv_sympd);
+  };
+
+
+
+//! one factor of a chain; inv() and inv_sympd() factors are detected only when do_inv is true
+template<typename T1, bool do_inv>
+struct glue_times_chain_leaf
   {
-  template<typename T1, typename T2, typename T3, typename T4>
-  arma_hot inline static void apply(Mat<typename T1::elem_type>& out, const Glue< Glue< Glue<T1,T2,glue_times>, T3, glue_times>, T4, glue_times>& X);
+  const partial_unwrap<T1> U;
+  
+  template<typename chain_type> inline glue_times_chain_leaf(const T1& X, chain_type& chain);
+  };
+
+
+template<typename T1>
+struct glue_times_chain_leaf<T1, true>
+  {
+  Mat<typename T1::elem_type> M;
+  
+  template<typename chain_type> inline glue_times_chain_leaf(const T1& X, chain_type& chain);
+  };
+
+
+
+//! adds the factors of Glue<..., glue_times> instances on the left hand side to a chain, in left-to-right order
+template<typename T1, bool do_inv_detect>
+struct glue_times_chain_collect
+  {
+  glue_times_chain_leaf<T1, (do_inv_detect && strip_inv<T1>::do_inv)> leaf;
+  
+  template<typename chain_type> inline glue_times_chain_collect(const T1& X, chain_type& chain) : leaf(X, chain) {}
+  };
+
+
+template<typename T1, typename T2, bool do_inv_detect>
+struct glue_times_chain_collect< Glue<T1,T2,glue_times>, do_inv_detect >
+  {
+  glue_times_chain_collect<T1, do_inv_detect>                          lhs;
+  glue_times_chain_leaf   <T2, (do_inv_detect && strip_inv<T2>::do_inv)> rhs;
+  
+  template<typename chain_type> inline glue_times_chain_collect(const Glue<T1,T2,glue_times>& X, chain_type& chain) : lhs(X.A, chain), rhs(X.B, chain) {}
   };
 
 
@@ -138,9 +242,6 @@ class glue_times
   
   template<typename eT, const bool do_trans_A, const bool do_trans_B, const bool do_trans_C, const bool do_scalar_times, typename TA, typename TB, typename TC>
   arma_hot inline static void apply(Mat<eT>& out, const TA& A, const TB& B, const TC& C, const eT val);
-  
-  template<typename eT, const bool do_trans_A, const bool do_trans_B, const bool do_trans_C, const bool do_trans_D, const bool do_scalar_times, typename TA, typename TB, typename TC, typename TD>
-  arma_hot inline static void apply(Mat<eT>& out, const TA& A, const TB& B, const TC& C, const TD& D, const eT val);
   };
 
 
@@ -380,43 +380,11 @@ glue_times_redirect<N>::apply(Mat<typename T1::elem_type>& out, const Glue<T1,T2
   
   typedef typename T1::elem_type eT;
   
-  const partial_unwrap<T1> tmp1(X.A);
-  const partial_unwrap<T2> tmp2(X.B);
-  
-  const typename partial_unwrap<T1>::stored_type& A = tmp1.M;
-  const typename partial_unwrap<T2>::stored_type& B = tmp2.M;
+  glue_times_chain<eT, N> chain(out);
   
-  const bool use_alpha = partial_unwrap<T1>::do_times || partial_unwrap<T2>::do_times;
-  const eT       alpha = use_alpha ? (tmp1.get_val() * tmp2.get_val()) : eT(0);
+  glue_times_chain_collect< Glue<T1,T2,glue_times>, is_supported_blas_type<eT>::value > factors(X, chain);
   
-  const bool alias = tmp1.is_alias(out) || tmp2.is_alias(out);
-  
-  if(alias == false)
-    {
-    glue_times::apply
-      <
-      eT,
-      partial_unwrap<T1>::do_trans,
-      partial_unwrap<T2>::do_trans,
-      (partial_unwrap<T1>::do_times || partial_unwrap<T2>::do_times)
-      >
-      (out, A, B, alpha);
-    }
-  else
-    {
-    Mat<eT> tmp;
-    
-    glue_times::apply
-      <
-      eT,
-      partial_unwrap<T1>::do_trans,
-      partial_unwrap<T2>::do_trans,
-      (partial_unwrap<T1>::do_times || partial_unwrap<T2>::do_times)
-      >
-      (tmp, A, B, alpha);
-    
-    out.steal_mem(tmp);
-    }
+  chain.apply(out);
   }
 
 
@@ -451,61 +419,103 @@ glue_times_redirect<3>::apply(Mat<typename T1::elem_type>& out, const Glue< Glue
 
 
 
-template<typename T1, typename T2, typename T3, typename T4>
-arma_hot
+template<typename eT, uword N>
+inline
+glue_times_chain<eT,N>::glue_times_chain(const Mat<eT>& in_out)
+  : ref_out  (in_out)
+  , n_factors(0)
+  , alpha    (eT(1))
+  , use_alpha(false)
+  , alias    (false)
+  {
+  arma_extra_debug_sigprint();
+  }
+
+
+
+template<typename eT, uword N>
 inline
 void
-glue_times_redirect<4>::apply(Mat<typename T1::elem_type>& out, const Glue< Glue< Glue<T1,T2,glue_times>, T3, glue_times>, T4, glue_times>& X)
+glue_times_chain<eT,N>::add(const Mat<eT>& M, const bool do_trans, const eT val, const bool is_alias)
   {
   arma_extra_debug_sigprint();
   
-  typedef typename T1::elem_type eT;
+  factor_type& f = factors[n_factors];
   
-  // there is exactly 4 objects
-  // hence we can safely expand X as X.A.A.A, X.A.A.B, X.A.B and X.B
+  f.M            = &M;
+  f.inv_M        = nullptr;
+  f.do_trans     = do_trans;
+  f.do_inv_sympd = false;
   
-  const partial_unwrap<T1> tmp1(X.A.A.A);
-  const partial_unwrap<T2> tmp2(X.A.A.B);
-  const partial_unwrap<T3> tmp3(X.A.B  );
-  const partial_unwrap<T4> tmp4(X.B    );
+  if(val != eT(1))  { alpha *= val; use_alpha = true; }
   
-  const typename partial_unwrap<T1>::stored_type& A = tmp1.M;
-  const typename partial_unwrap<T2>::stored_type& B = tmp2.M;
-  const typename partial_unwrap<T3>::stored_type& C = tmp3.M;
-  const typename partial_unwrap<T4>::stored_type& D = tmp4.M;
+  alias = alias || is_alias;
+  
+  n_factors++;
+  }
+
+
+
+template<typename eT, uword N>
+inline
+void
+glue_times_chain<eT,N>::add_inv(Mat<eT>& M, const bool do_inv_sympd)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (M.is_square() == false), "inv(): given matrix must be square sized" );
   
-  const bool use_alpha = partial_unwrap<T1>::do_times || partial_unwrap<T2>::do_times || partial_unwrap<T3>::do_times || partial_unwrap<T4>::do_times;
-  const eT       alpha = use_alpha ? (tmp1.get_val() * tmp2.get_val() * tmp3.get_val() * tmp4.get_val()) : eT(0);
+  if( do_inv_sympd && (arma_config::debug) && (auxlib::rudimentary_sym_check(M) == false) )
+    {
+    if(is_cx<eT>::no )  { arma_debug_warn("inv_sympd(): given matrix is not symmetric"); }
+    if(is_cx<eT>::yes)  { arma_debug_warn("inv_sympd(): given matrix is not hermitian"); }
+    }
+  
+  factor_type& f = factors[n_factors];
   
-  const bool alias = tmp1.is_alias(out) || tmp2.is_alias(out) || tmp3.is_alias(out) || tmp4.is_alias(out);
+  f.M            = &M;
+  f.inv_M        = &M;
+  f.do_trans     = false;
+  f.do_inv_sympd = do_inv_sympd;
+  
+  n_factors++;
+  }
+
+
+
+template<typename eT, uword N>
+inline
+void
+glue_times_chain<eT,N>::apply(Mat<eT>& out)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (n_factors != N), "glue_times_chain::apply(): internal error: incorrect number of factors" );
+  
+  for(uword k=0; k < N; ++k)
+    {
+    const factor_type& f = factors[k];
+    
+    const uword f_n_rows = (f.do_trans) ? f.M->n_cols : f.M->n_rows;
+    const uword f_n_cols = (f.do_trans) ? f.M->n_rows : f.M->n_cols;
+    
+    if(k > 0)  { arma_debug_assert_mul_size(dims[k-1], dims[k], f_n_rows, f_n_cols, "matrix multiplication"); }
+    
+    dims[k  ] = f_n_rows;
+    dims[k+1] = f_n_cols;
+    }
+  
+  plan();
   
   if(alias == false)
     {
-    glue_times::apply
-      <
-      eT,
-      partial_unwrap<T1>::do_trans,
-      partial_unwrap<T2>::do_trans,
-      partial_unwrap<T3>::do_trans,
-      partial_unwrap<T4>::do_trans,
-      (partial_unwrap<T1>::do_times || partial_unwrap<T2>::do_times || partial_unwrap<T3>::do_times || partial_unwrap<T4>::do_times)
-      >
-      (out, A, B, C, D, alpha);
+    eval(out, 0, N-1, true);
     }
   else
     {
     Mat<eT> tmp;
     
-    glue_times::apply
-      <
-      eT,
-      partial_unwrap<T1>::do_trans,
-      partial_unwrap<T2>::do_trans,
-      partial_unwrap<T3>::do_trans,
-      partial_unwrap<T4>::do_trans,
-      (partial_unwrap<T1>::do_times || partial_unwrap<T2>::do_times || partial_unwrap<T3>::do_times || partial_unwrap<T4>::do_times)
-      >
-      (tmp, A, B, C, D, alpha);
+    eval(tmp, 0, N-1, true);
     
     out.steal_mem(tmp);
     }
@@ -513,6 +523,319 @@ glue_times_redirect<4>::apply(Mat<typename T1::elem_type>& out, const Glue< Glue
 
 
 
+//! approximate number of multiply-add operations for solving a system with an n x n matrix and m right hand sides
+template<typename eT, uword N>
+inline
+double
+glue_times_chain<eT,N>::solve_cost(const double n, const double m, const bool do_inv_sympd)
+  {
+  return ( (do_inv_sympd) ? (n*n*n / 6.0) : (n*n*n / 3.0) ) + n*n*m;
+  }
+
+
+
+template<typename eT, uword N>
+inline
+void
+glue_times_chain<eT,N>::plan()
+  {
+  arma_extra_debug_sigprint();
+  
+  double cost[N*N];
+  
+  for(uword i=0; i < N; ++i)
+    {
+    const factor_type& f = factors[i];
+    
+    // a lone inv() factor must be explicitly inverted; this is only done if both neighbours are inv() factors
+    
+    const double n = double(dims[i]);
+    
+    cost[i*N + i] = (f.inv_M == nullptr) ? 0.0 : ( (f.do_inv_sympd) ? (n*n*n / 2.0) : (n*n*n) );
+    split[i*N + i] = i;
+    }
+  
+  for(uword len=2; len <= N; ++len)
+  for(uword i=0; i <= (N-len); ++i)
+    {
+    const uword j = i + len - 1;
+    
+    double best_cost  = Datum<double>::inf;
+    uword  best_split = i;
+    
+    for(uword k=i; k < j; ++k)
+      {
+      const bool lhs_inv = (k   == i) && (factors[i].inv_M != nullptr);
+      const bool rhs_inv = (k+1 == j) && (factors[j].inv_M != nullptr);
+      
+      double c;
+      
+      if(lhs_inv)
+        {
+        // inv(A)*B  ->  solve(A,B)
+        c = solve_cost(double(dims[i]), double(dims[j+1]), factors[i].do_inv_sympd) + cost[(k+1)*N + j];
+        }
+      else
+      if(rhs_inv)
+        {
+        // A*inv(B)  ->  trans( solve(trans(B), trans(A)) ); the transposes are counted as one operation per element
+        c = cost[i*N + k] + solve_cost(double(dims[j]), double(dims[i]), factors[j].do_inv_sympd) + 2.0 * double(dims[i]) * double(dims[j]);
+        }
+      else
+        {
+        c = cost[i*N + k] + cost[(k+1)*N + j] + double(dims[i]) * double(dims[k+1]) * double(dims[j+1]);
+        }
+      
+      if(c < best_cost)  { best_cost = c; best_split = k; }
+      }
+    
+    cost [i*N + j] = best_cost;
+    split[i*N + j] = best_split;
+    }
+  }
+
+
+
+//! out = product of factors i..j; the product of all scalar multipliers is applied only when top is true
+template<typename eT, uword N>
+inline
+void
+glue_times_chain<eT,N>::eval(Mat<eT>& out, const uword i, const uword j, const bool top)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef glue_times_chain_solve< is_supported_blas_type<eT>::value > solver;
+  
+  bool status = true;
+  
+  if(i == j)
+    {
+    arma_extra_debug_print("glue_times_chain::eval(): explicit inverse");
+    
+    const factor_type& f = factors[i];
+    
+    status = solver::inv(out, *(f.inv_M), f.do_inv_sympd);
+    }
+  else
+    {
+    const uword k = split[i*N + j];
+    
+    Mat<eT> tmp1;
+    Mat<eT> tmp2;
+    
+    const arena_target tmp1_arena(&tmp1);  // tmp1 and tmp2 may use memory from the current arena_scope
+    const arena_target tmp2_arena(&tmp2);
+    
+    if( (k == i) && (factors[i].inv_M != nullptr) )
+      {
+      arma_extra_debug_print("glue_times_chain::eval(): inv(A)*B");
+      
+      const factor_type& f = factors[i];
+      
+      bool B_trans = false;
+      
+      const Mat<eT>& B = operand(tmp1, B_trans, k+1, j);
+      
+      if(B_trans)  { op_htrans::apply_mat_noalias(tmp2, B); }
+      
+      status = solver::solve(out, *(f.inv_M), (B_trans ? tmp2 : B), f.do_inv_sympd);
+      }
+    else
+    if( (k+1 == j) && (factors[j].inv_M != nullptr) )
+      {
+      arma_extra_debug_print("glue_times_chain::eval(): A*inv(B)");
+      
+      const factor_type& f = factors[j];
+      
+      bool A_trans = false;
+      
+      const Mat<eT>& A = operand(tmp1, A_trans, i, k);
+      
+      if(A_trans == false)  { op_htrans::apply_mat_noalias(tmp2, A); }
+      
+      const Mat<eT>& At = (A_trans) ? A : tmp2;
+      
+      Mat<eT> X;
+      
+      if(f.do_inv_sympd)
+        {
+        // transpose of B is avoided as B is explicitly marked as symmetric
+        
+        status = solver::solve(X, *(f.inv_M), At, true);
+        }
+      else
+        {
+        Mat<eT> Bt;
+        
+        op_htrans::apply_mat_noalias(Bt, *(f.inv_M));
+        
+        status = solver::solve(X, Bt, At, false);
+        }
+      
+      if(status)  { op_htrans::apply_mat_noalias(out, X); }
+      }
+    else
+      {
+      bool A_trans = false;
+      bool B_trans = false;
+      
+      const Mat<eT>& A = operand(tmp1, A_trans, i,   k);
+      const Mat<eT>& B = operand(tmp2, B_trans, k+1, j);
+      
+      mul(out, A, A_trans, B, B_trans, (top && use_alpha), alpha);
+      
+      return;
+      }
+    }
+  
+  if(status == false)
+    {
+    out.soft_reset();
+    arma_stop_runtime_error("matrix multiplication: problem with matrix inverse; suggest to use solve() instead");
+    return;
+    }
+  
+  if(top && use_alpha)  { out *= alpha; }
+  }
+
+
+
+//! a single non-inv() factor is used directly, possibly with a pending transpose; other ranges are evaluated into tmp
+template<typename eT, uword N>
+inline
+const Mat<eT>&
+glue_times_chain<eT,N>::operand(Mat<eT>& tmp, bool& do_trans, const uword i, const uword j)
+  {
+  if( (i == j) && (factors[i].inv_M == nullptr) )
+    {
+    do_trans = factors[i].do_trans;
+    
+    return *(factors[i].M);
+    }
+  
+  eval(tmp, i, j, false);
+  
+  do_trans = false;
+  
+  return tmp;
+  }
+
+
+
+template<typename eT, uword N>
+inline
+void
+glue_times_chain<eT,N>::mul(Mat<eT>& out, const Mat<eT>& A, const bool do_trans_A, const Mat<eT>& B, const bool do_trans_B, const bool do_alpha, const eT val)
+  {
+  if(do_alpha)
+    {
+         if( (do_trans_A == false) && (do_trans_B == false) )  { glue_times::apply<eT, false, false, true>(out, A, B, val); }
+    else if( (do_trans_A == false) && (do_trans_B == true ) )  { glue_times::apply<eT, false, true,  true>(out, A, B, val); }
+    else if( (do_trans_A == true ) && (do_trans_B == false) )  { glue_times::apply<eT, true,  false, true>(out, A, B, val); }
+    else                                                       { glue_times::apply<eT, true,  true,  true>(out, A, B, val); }
+    }
+  else
+    {
+         if( (do_trans_A == false) && (do_trans_B == false) )  { glue_times::apply<eT, false, false, false>(out, A, B, eT(0)); }
+    else if( (do_trans_A == false) && (do_trans_B == true ) )  { glue_times::apply<eT, false, true,  false>(out, A, B, eT(0)); }
+    else if( (do_trans_A == true ) && (do_trans_B == false) )  { glue_times::apply<eT, true,  false, false>(out, A, B, eT(0)); }
+    else                                                       { glue_times::apply<eT, true,  true,  false>(out, A, B, eT(0)); }
+    }
+  }
+
+
+
+template<bool do_inv_detect>
+template<typename eT>
+inline
+bool
+glue_times_chain_solve<do_inv_detect>::solve(Mat<eT>& out, Mat<eT>& A, const Mat<eT>& B, const bool do_inv_sympd)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_assert_mul_size(A, B, "matrix multiplication");
+  
+  #if defined(ARMA_OPTIMISE_SYMPD)
+    return (do_inv_sympd) ? auxlib::solve_sympd_fast(out, A, B) : auxlib::solve_square_fast(out, A, B);
+  #else
+    arma_ignore(do_inv_sympd);
+    
+    return auxlib::solve_square_fast(out, A, B);
+  #endif
+  }
+
+
+
+template<bool do_inv_detect>
+template<typename eT>
+inline
+bool
+glue_times_chain_solve<do_inv_detect>::inv(Mat<eT>& out, Mat<eT>& A, const bool do_inv_sympd)
+  {
+  arma_extra_debug_sigprint();
+  
+  return (do_inv_sympd) ? auxlib::inv_sympd(out, A) : auxlib::inv(out, A);
+  }
+
+
+
+template<typename eT>
+inline
+bool
+glue_times_chain_solve<false>::solve(Mat<eT>& out, Mat<eT>& A, const Mat<eT>& B, const bool do_inv_sympd)
+  {
+  arma_ignore(out);
+  arma_ignore(A);
+  arma_ignore(B);
+  arma_ignore(do_inv_sympd);
+  
+  return false;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+glue_times_chain_solve<false>::inv(Mat<eT>& out, Mat<eT>& A, const bool do_inv_sympd)
+  {
+  arma_ignore(out);
+  arma_ignore(A);
+  arma_ignore(do_inv_sympd);
+  
+  return false;
+  }
+
+
+
+template<typename T1, bool do_inv>
+template<typename chain_type>
+inline
+glue_times_chain_leaf<T1, do_inv>::glue_times_chain_leaf(const T1& X, chain_type& chain)
+  : U(X)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename T1::elem_type eT;
+  
+  chain.add(U.M, partial_unwrap<T1>::do_trans, (partial_unwrap<T1>::do_times ? U.get_val() : eT(1)), U.is_alias(chain.ref_out));
+  }
+
+
+
+template<typename T1>
+template<typename chain_type>
+inline
+glue_times_chain_leaf<T1, true>::glue_times_chain_leaf(const T1& X, chain_type& chain)
+  : M( strip_inv<T1>(X).M )
+  {
+  arma_extra_debug_sigprint();
+  
+  chain.add_inv(M, strip_inv<T1>::do_inv_sympd);
+  }
+
+
+
 template<typename T1, typename T2>
 arma_hot
 inline
@@ -558,7 +881,7 @@ glue_times::apply_inplace_plus(Mat<typename T1::elem_type>& out, const Glue<T1,
     {
     // partial workaround for corner cases
     
-    const Mat<eT> tmp(X);
+    const Mat<eT> tmp(X, arena_target(&tmp));
     
     if(sign > sword(0))  { out += tmp; }  else  { out -= tmp; }
     
@@ -801,6 +1124,8 @@ glue_times::apply
   
   Mat<eT> tmp;
   
+  const arena_target tmp_arena(&tmp);  // tmp may use memory from the current arena_scope
+  
   const uword storage_cost_AB = glue_times::mul_storage_cost<eT, do_trans_A, do_trans_B>(A, B);
   const uword storage_cost_BC = glue_times::mul_storage_cost<eT, do_trans_B, do_trans_C>(B, C);
   
@@ -822,59 +1147,6 @@ glue_times::apply
 
 
 
-template
-  <
-  typename   eT,
-  const bool do_trans_A,
-  const bool do_trans_B,
-  const bool do_trans_C,
-  const bool do_trans_D,
-  const bool use_alpha,
-  typename   TA,
-  typename   TB,
-  typename   TC,
-  typename   TD
-  >
-arma_hot
-inline
-void
-glue_times::apply
-  (
-        Mat<eT>& out,
-  const TA&      A,
-  const TB&      B,
-  const TC&      C,
-  const TD&      D,
-  const eT       alpha
-  )
-  {
-  arma_extra_debug_sigprint();
-  
-  Mat<eT> tmp;
-  
-  const uword storage_cost_AC = glue_times::mul_storage_cost<eT, do_trans_A, do_trans_C>(A, C);
-  const uword storage_cost_BD = glue_times::mul_storage_cost<eT, do_trans_B, do_trans_D>(B, D);
-  
-  if(storage_cost_AC <= storage_cost_BD)
-    {
-    // out = (A*B*C)*D
-    
-    glue_times::apply<eT, do_trans_A, do_trans_B, do_trans_C, use_alpha>(tmp, A, B, C, alpha);
-    
-    glue_times::apply<eT, false, do_trans_D, false>(out, tmp, D, eT(0));
-    }
-  else
-    {
-    // out = A*(B*C*D)
-    
-    glue_times::apply<eT, do_trans_B, do_trans_C, do_trans_D, use_alpha>(tmp, B, C, D, alpha);
-    
-    glue_times::apply<eT, do_trans_A, false, false>(out, A, tmp, eT(0));
-    }
-  }
-
-
-
 //
 // glue_times_diag
 
@@ -0,0 +1,271 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup mapped_cube
+//! @{
+
+
+
+template<typename eT>
+inline
+mapped_cube<eT>::mapped_cube()
+  : obj_ptr(new Cube<eT>())
+  , mode(mmap_read_only)
+  , mapped(false)
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+mapped_cube<eT>::~mapped_cube()
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  // the cube must be destroyed before its memory is unmapped
+  delete obj_ptr;
+  }
+
+
+
+template<typename eT>
+inline
+mapped_cube<eT>::mapped_cube(const std::string& name, const mmap_mode in_mode)
+  : obj_ptr(new Cube<eT>())
+  , mode(in_mode)
+  , mapped(false)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  const bool load_okay = load(name, in_mode);
+  
+  if(load_okay == false)  { arma_stop_runtime_error( std::string("mapped_cube::mapped_cube(): couldn't load ") + name ); }
+  }
+
+
+
+template<typename eT>
+inline
+bool
+mapped_cube<eT>::load(const std::string& name, const mmap_mode in_mode)
+  {
+  arma_extra_debug_sigprint();
+  
+  reset();
+  
+  mode = in_mode;
+  
+  std::ifstream f(name.c_str(), std::fstream::binary);
+  
+  if(f.is_open() == false)
+    {
+    arma_debug_warn("mapped_cube::load(): couldn't access ", name);
+    return false;
+    }
+  
+  char magic[6] = {};
+  
+  f.read(magic, 6);
+  
+  if( f.good() && (std::memcmp(magic, "\x93NUMPY", 6) == 0) )
+    {
+    f.close();
+    
+    return load_npy(name);
+    }
+  
+  f.clear();
+  f.seekg(0);
+  
+  std::string f_header;
+  uword       f_n_rows = 0;
+  uword       f_n_cols   = 0;
+  uword       f_n_slices = 0;
+  
+  f >> f_header;
+  f >> f_n_rows;
+  f >> f_n_cols;
+  f >> f_n_slices;
+  
+  if( f.good() && (f_header == diskio::gen_bin_header(*obj_ptr)) )
+    {
+    f.get();
+    
+    const std::streamoff offset = f.tellg();
+    
+    f.close();
+    
+    const size_t n_elem_slice = size_t(f_n_rows) * size_t(f_n_cols);
+    const size_t n_elem       = n_elem_slice * size_t(f_n_slices);
+    const size_t n_bytes      = n_elem * sizeof(eT);
+    
+    const bool size_okay = (n_elem <= (std::numeric_limits<size_t>::max() / sizeof(eT)));
+    
+    const bool dims_okay = ( (f_n_cols   == 0) || ((n_elem_slice / size_t(f_n_cols))   == size_t(f_n_rows)) )
+                        && ( (f_n_slices == 0) || ((n_elem       / size_t(f_n_slices)) == n_elem_slice    ) );
+    
+    if( size_okay && dims_okay && (n_elem > 0) && (offset > 0) && ((offset % std::streamoff(alignof(eT))) == 0) && region.map(name, mode) )
+      {
+      if( (size_t(offset) <= region.n_bytes()) && (n_bytes <= (region.n_bytes() - size_t(offset))) )
+        {
+        delete obj_ptr;
+        
+        obj_ptr = new Cube<eT>( (eT*)(region.memptr() + offset), f_n_rows, f_n_cols, f_n_slices, false, true );
+        
+        mapped = true;
+        
+        return true;
+        }
+      
+      region.unmap();
+      }
+    }
+  else
+    {
+    f.close();
+    }
+  
+  // fallback: ordinary loading, which also handles conversion of u32/s32 cubes into u64/s64 cubes
+  
+  return obj_ptr->load(name, arma_binary);
+  }
+
+
+
+//! NumPy .npy files are mapped if the data is stored in column-major order and has the element type eT
+template<typename eT>
+inline
+bool
+mapped_cube<eT>::load_npy(const std::string& name)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(region.map(name, mode))
+    {
+    diskio::npy_info info;
+    
+    uword f_n_rows   = 0;
+    uword f_n_cols   = 0;
+    uword f_n_slices = 0;
+    
+    const bool header_okay = diskio::parse_npy_header(info, (const char*)(region.memptr()), region.n_bytes()) && diskio::npy_dims(f_n_rows, f_n_cols, f_n_slices, info, 3, false);
+    
+    if( header_okay && info.native_order && diskio::npy_is_colmajor(info) && (info.descr == diskio::gen_npy_descr<eT>()) )
+      {
+      const size_t n_elem = size_t(f_n_rows) * size_t(f_n_cols) * size_t(f_n_slices);
+      
+      if( (n_elem > 0) && (n_elem <= ((region.n_bytes() - info.offset) / sizeof(eT))) )
+        {
+        delete obj_ptr;
+        
+        obj_ptr = new Cube<eT>( (eT*)(region.memptr() + info.offset), f_n_rows, f_n_cols, f_n_slices, false, true );
+        
+        mapped = true;
+        
+        return true;
+        }
+      }
+    
+    region.unmap();
+    }
+  
+  // fallback: ordinary loading, which also handles data stored in C order and conversion of element types
+  
+  return obj_ptr->load(name, npy_binary);
+  }
+
+
+
+template<typename eT>
+inline
+void
+mapped_cube<eT>::reset()
+  {
+  arma_extra_debug_sigprint();
+  
+  if(mapped)
+    {
+    delete obj_ptr;
+    
+    obj_ptr = new Cube<eT>();
+    
+    region.unmap();
+    
+    mapped = false;
+    }
+  else
+    {
+    obj_ptr->reset();
+    }
+  }
+
+
+
+template<typename eT>
+inline
+bool
+mapped_cube<eT>::is_mapped() const
+  {
+  return mapped;
+  }
+
+
+
+template<typename eT>
+inline
+mmap_mode
+mapped_cube<eT>::get_mode() const
+  {
+  return mode;
+  }
+
+
+
+template<typename eT>
+inline
+const Cube<eT>&
+mapped_cube<eT>::get_ref() const
+  {
+  return *obj_ptr;
+  }
+
+
+
+//! writing to the elements is only allowed in copy-on-write mode, as the memory of read-only mappings is protected
+template<typename eT>
+inline
+Cube<eT>&
+mapped_cube<eT>::get_mutable_ref()
+  {
+  arma_debug_check( (mode != mmap_mode::copy_on_write), "mapped_cube::get_mutable_ref(): object was loaded in read-only mode" );
+  
+  return *obj_ptr;
+  }
+
+
+
+template<typename eT>
+inline
+mapped_cube<eT>::operator const Cube<eT>& () const
+  {
+  return *obj_ptr;
+  }
+
+
+
+//! @}
@@ -0,0 +1,65 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup mapped_mat
+//! @{
+
+
+//! Mat whose elements are read directly from a file saved in arma_binary or npy_binary format, via mmap();
+//! the Mat uses the mapped memory as auxiliary memory (strict mode), so the size cannot be changed.
+//! files that cannot be mapped (eg. arma_binary files saved by older versions, whose data is not suitably aligned,
+//! npy_binary files stored in C order or with another element type, or systems without mmap()) are loaded into ordinary memory instead; see is_mapped()
+template<typename eT>
+class mapped_mat
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  inline  mapped_mat();
+  inline ~mapped_mat();
+  
+  inline explicit mapped_mat(const std::string& name, const mmap_mode mode = mmap_read_only);
+  
+  inline bool load(const std::string& name, const mmap_mode mode = mmap_read_only);
+  inline void reset();
+  
+  inline bool      is_mapped() const;
+  inline mmap_mode get_mode()  const;
+  
+  inline const Mat<eT>& get_ref() const;
+  inline       Mat<eT>& get_mutable_ref();
+  
+  inline operator const Mat<eT>& () const;
+  
+  
+  private:
+  
+  inline bool load_npy(const std::string& name);
+  
+  Mat<eT>*     obj_ptr;
+  mmap_region region;
+  mmap_mode   mode;
+  bool        mapped;
+  
+  mapped_mat(const mapped_mat&)            = delete;
+  mapped_mat& operator=(const mapped_mat&) = delete;
+  };
+
+
+
+//! @}
@@ -0,0 +1,98 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup mat_reader
+//! @{
+
+
+//! sequential reader of matrices stored in files, providing blocks of rows with bounded memory use;
+//! supports the csv_ascii, raw_ascii, arma_binary and hdf5_binary formats.
+//! text files are read in parts of a few megabytes; for arma_binary and hdf5_binary files,
+//! only the elements of the requested rows are read
+template<typename eT>
+class mat_reader
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  static constexpr size_t text_read_size = size_t(4) << 20;  //!< minimum number of bytes read from text files at a time
+  
+  inline  mat_reader();
+  inline ~mat_reader();
+  
+  inline explicit mat_reader(const std::string& name, const file_type type);
+  inline explicit mat_reader(const hdf5_name& spec);
+  
+  inline bool open(const std::string& name, const file_type type);
+  inline bool open(const hdf5_name& spec);
+  
+  inline void close();
+  
+  inline bool next(Mat<eT>& block, const uword n_rows_max);
+  
+  inline bool is_open() const;
+  inline bool good()    const;
+  
+  inline uword n_cols()      const;  //!< number of columns in each block
+  inline uword n_rows_read() const;  //!< number of rows provided so far
+  
+  
+  private:
+  
+  file_type   type;
+  std::string name;
+  
+  bool opened;
+  bool failed;
+  bool finished;
+  
+  uword f_n_rows;   //!< number of rows in the file; only known for arma_binary and hdf5_binary
+  uword f_n_cols;
+  uword row_pos;
+  
+  std::ifstream     f;
+  std::streamoff    data_offset;
+  std::vector<char> buf;
+  size_t            buf_pos;
+  bool              at_eof;
+  
+  #if defined(ARMA_USE_HDF5)
+    hid_t h5_file;
+    hid_t h5_dataset;
+    hid_t h5_filespace;
+    int   h5_ndims;
+  #endif
+  
+  inline bool fill_buffer();
+  
+  inline bool open_text();
+  inline bool open_binary();
+  
+  inline bool next_text  (Mat<eT>& block, const uword n_rows_max);
+  inline bool next_binary(Mat<eT>& block, const uword n_rows_max);
+  inline bool next_hdf5  (Mat<eT>& block, const uword n_rows_max);
+  
+  inline void fail(const char* msg);
+  
+  mat_reader(const mat_reader&)            = delete;
+  mat_reader& operator=(const mat_reader&) = delete;
+  };
+
+
+
+//! @}
@@ -0,0 +1,638 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup mat_reader
+//! @{
+
+
+
+template<typename eT>
+inline
+mat_reader<eT>::mat_reader()
+  : type(file_type_unknown)
+  , opened(false)
+  , failed(false)
+  , finished(false)
+  , f_n_rows(0)
+  , f_n_cols(0)
+  , row_pos(0)
+  , data_offset(0)
+  , buf_pos(0)
+  , at_eof(false)
+  #if defined(ARMA_USE_HDF5)
+  , h5_file(-1)
+  , h5_dataset(-1)
+  , h5_filespace(-1)
+  , h5_ndims(0)
+  #endif
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+mat_reader<eT>::~mat_reader()
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  close();
+  }
+
+
+
+template<typename eT>
+inline
+mat_reader<eT>::mat_reader(const std::string& in_name, const file_type in_type)
+  : type(file_type_unknown)
+  , opened(false)
+  , failed(false)
+  , finished(false)
+  , f_n_rows(0)
+  , f_n_cols(0)
+  , row_pos(0)
+  , data_offset(0)
+  , buf_pos(0)
+  , at_eof(false)
+  #if defined(ARMA_USE_HDF5)
+  , h5_file(-1)
+  , h5_dataset(-1)
+  , h5_filespace(-1)
+  , h5_ndims(0)
+  #endif
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  const bool open_okay = open(in_name, in_type);
+  
+  if(open_okay == false)  { arma_stop_runtime_error( std::string("mat_reader::mat_reader(): couldn't open ") + in_name ); }
+  }
+
+
+
+template<typename eT>
+inline
+mat_reader<eT>::mat_reader(const hdf5_name& spec)
+  : type(file_type_unknown)
+  , opened(false)
+  , failed(false)
+  , finished(false)
+  , f_n_rows(0)
+  , f_n_cols(0)
+  , row_pos(0)
+  , data_offset(0)
+  , buf_pos(0)
+  , at_eof(false)
+  #if defined(ARMA_USE_HDF5)
+  , h5_file(-1)
+  , h5_dataset(-1)
+  , h5_filespace(-1)
+  , h5_ndims(0)
+  #endif
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  const bool open_okay = open(spec);
+  
+  if(open_okay == false)  { arma_stop_runtime_error( std::string("mat_reader::mat_reader(): couldn't open ") + spec.filename ); }
+  }
+
+
+
+template<typename eT>
+inline
+bool
+mat_reader<eT>::open(const std::string& in_name, const file_type in_type)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(in_type == hdf5_binary)  { return open( hdf5_name(in_name) ); }
+  
+  close();
+  
+  if( (in_type != csv_ascii) && (in_type != raw_ascii) && (in_type != arma_binary) )
+    {
+    arma_debug_warn("mat_reader::open(): unsupported file type");
+    return false;
+    }
+  
+  type = in_type;
+  name = in_name;
+  
+  f.open(name.c_str(), std::fstream::binary);
+  
+  if(f.is_open() == false)
+    {
+    arma_debug_warn("mat_reader::open(): couldn't access ", name);
+    return false;
+    }
+  
+  const bool open_okay = (type == arma_binary) ? open_binary() : open_text();
+  
+  if(open_okay == false)  { close(); return false; }
+  
+  opened = true;
+  
+  return true;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+mat_reader<eT>::open(const hdf5_name& spec)
+  {
+  arma_extra_debug_sigprint();
+  
+  close();
+  
+  #if defined(ARMA_USE_HDF5)
+    {
+    type = hdf5_binary;
+    name = spec.filename;
+    
+    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
+    
+    h5_file = arma_H5Fopen(name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    
+    if(h5_file < 0)
+      {
+      arma_debug_warn("mat_reader::open(): couldn't access ", name);
+      return false;
+      }
+    
+    // the dataset is found in the same way as in Mat::load()
+    
+    std::vector<std::string> searchNames;
+    
+    const bool exact = (spec.dsname.empty() == false);
+    
+    if(exact)
+      {
+      searchNames.push_back(spec.dsname);
+      }
+    else
+      {
+      searchNames.push_back("dataset");
+      searchNames.push_back("value"  );
+      }
+    
+    h5_dataset = hdf5_misc::search_hdf5_file(searchNames, h5_file, 2, exact);
+    
+    hsize_t dims[2] = { 0, 0 };
+    
+    bool open_okay = (h5_dataset >= 0);
+    
+    if(open_okay)
+      {
+      h5_filespace = arma_H5Dget_space(h5_dataset);
+      h5_ndims     = arma_H5Sget_simple_extent_ndims(h5_filespace);
+      
+      open_okay = (h5_ndims >= 1) && (h5_ndims <= 2) && (arma_H5Sget_simple_extent_dims(h5_filespace, dims, NULL) >= 0);
+      }
+    
+    if(open_okay == false)
+      {
+      arma_debug_warn("mat_reader::open(): unsupported or missing HDF5 data in ", name);
+      close();
+      return false;
+      }
+    
+    // vectors are treated as a matrix with one row, as in Mat::load()
+    if(h5_ndims == 1)  { dims[1] = 1; }
+    
+    f_n_rows = uword(dims[1]);
+    f_n_cols = uword(dims[0]);
+    
+    opened = true;
+    
+    return true;
+    }
+  #else
+    {
+    arma_ignore(spec);
+    
+    arma_stop_logic_error("mat_reader::open(): use of HDF5 must be enabled");
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+template<typename eT>
+inline
+void
+mat_reader<eT>::close()
+  {
+  arma_extra_debug_sigprint();
+  
+  if(f.is_open())  { f.close(); }
+  
+  f.clear();
+  
+  std::vector<char>().swap(buf);
+  
+  #if defined(ARMA_USE_HDF5)
+    {
+    if(h5_filespace >= 0)  { arma_H5Sclose(h5_filespace); }
+    if(h5_dataset   >= 0)  { arma_H5Dclose(h5_dataset);   }
+    if(h5_file      >= 0)  { arma_H5Fclose(h5_file);      }
+    
+    h5_file      = -1;
+    h5_dataset   = -1;
+    h5_filespace = -1;
+    h5_ndims     = 0;
+    }
+  #endif
+  
+  opened   = false;
+  failed   = false;
+  finished = false;
+  
+  f_n_rows = 0;
+  f_n_cols = 0;
+  row_pos  = 0;
+  
+  data_offset = 0;
+  buf_pos     = 0;
+  at_eof      = false;
+  }
+
+
+
+//! read the next block of at most n_rows_max rows;
+//! returns false (and an empty block) if there are no more rows, or if an error occurred (see good())
+template<typename eT>
+inline
+bool
+mat_reader<eT>::next(Mat<eT>& block, const uword n_rows_max)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (n_rows_max == 0), "mat_reader::next(): n_rows_max must be greater than zero" );
+  
+  bool status = false;
+  
+  if( opened && (failed == false) && (finished == false) )
+    {
+    if( (type == csv_ascii) || (type == raw_ascii) )  { status = next_text  (block, n_rows_max); }
+    else
+    if(type == arma_binary)                          { status = next_binary(block, n_rows_max); }
+    else
+    if(type == hdf5_binary)                          { status = next_hdf5  (block, n_rows_max); }
+    }
+  
+  if(status)
+    {
+    row_pos += block.n_rows;
+    }
+  else
+    {
+    block.reset();
+    }
+  
+  return status;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+mat_reader<eT>::is_open() const
+  {
+  return opened;
+  }
+
+
+
+//! false if an error occurred while reading
+template<typename eT>
+inline
+bool
+mat_reader<eT>::good() const
+  {
+  return (failed == false);
+  }
+
+
+
+template<typename eT>
+inline
+uword
+mat_reader<eT>::n_cols() const
+  {
+  return f_n_cols;
+  }
+
+
+
+template<typename eT>
+inline
+uword
+mat_reader<eT>::n_rows_read() const
+  {
+  return row_pos;
+  }
+
+
+
+//! move the unused part of the buffer to the front, and append the next part of the file;
+//! returns false if no more characters are available
+template<typename eT>
+inline
+bool
+mat_reader<eT>::fill_buffer()
+  {
+  arma_extra_debug_sigprint();
+  
+  if(buf_pos > 0)
+    {
+    const size_t n_keep = buf.size() - buf_pos;
+    
+    if(n_keep > 0)  { std::memmove( &(buf[0]), &(buf[buf_pos]), n_keep ); }
+    
+    buf.resize(n_keep);
+    
+    buf_pos = 0;
+    }
+  
+  if(at_eof)  { return false; }
+  
+  const size_t n_old = buf.size();
+  
+  buf.resize(n_old + text_read_size);
+  
+  f.read( &(buf[n_old]), std::streamsize(text_read_size) );
+  
+  const size_t n_new = size_t(f.gcount());
+  
+  buf.resize(n_old + n_new);
+  
+  if(f.good() == false)  { at_eof = true; }
+  
+  if(f.bad())  { fail("couldn't read data from "); return false; }
+  
+  return (n_new > 0);
+  }
+
+
+
+//! the number of columns is taken from the first line
+template<typename eT>
+inline
+bool
+mat_reader<eT>::open_text()
+  {
+  arma_extra_debug_sigprint();
+  
+  const char* line_end = nullptr;
+  
+  while(true)
+    {
+    if(buf.empty() == false)  { line_end = (const char*)( std::memchr(&(buf[0]), '\n', buf.size()) ); }
+    
+    if(line_end != nullptr)  { break; }
+    
+    if(fill_buffer() == false)  { break; }
+    }
+  
+  if(failed)  { return false; }
+  
+  const size_t line_len = (line_end != nullptr) ? size_t(line_end - &(buf[0])) : buf.size();
+  
+  // an empty first line indicates an empty matrix
+  
+  if(line_len == 0)
+    {
+    finished = true;
+    
+    return true;
+    }
+  
+  uword n_min = 0;
+  uword n_max = 0;
+  
+  diskio::count_fields(n_min, n_max, &(buf[0]), line_len, (type == csv_ascii));
+  
+  f_n_cols = n_max;
+  
+  return true;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+mat_reader<eT>::open_binary()
+  {
+  arma_extra_debug_sigprint();
+  
+  std::string f_header;
+  
+  f >> f_header;
+  f >> f_n_rows;
+  f >> f_n_cols;
+  
+  if( (f.good() == false) || (f_header != diskio::gen_bin_header(Mat<eT>())) )
+    {
+    arma_debug_warn("mat_reader::open(): incorrect header in ", name);
+    return false;
+    }
+  
+  f.get();
+  
+  data_offset = std::streamoff(f.tellg());
+  
+  return true;
+  }
+
+
+
+//! the lines in the block are found in the buffer and converted via diskio::parse_text();
+//! an empty line ends the data, as in Mat::load()
+template<typename eT>
+inline
+bool
+mat_reader<eT>::next_text(Mat<eT>& block, const uword n_rows_max)
+  {
+  arma_extra_debug_sigprint();
+  
+  size_t pos     = buf_pos;
+  uword  n_lines = 0;
+  
+  while(n_lines < n_rows_max)
+    {
+    if(pos < buf.size())
+      {
+      if(buf[pos] == '\n')  { finished = true; break; }
+      
+      const char* line_start = &(buf[pos]);
+      const char* line_end   = (const char*)( std::memchr(line_start, '\n', buf.size() - pos) );
+      
+      if(line_end != nullptr)
+        {
+        pos += size_t(line_end - line_start) + 1;
+        
+        ++n_lines;
+        
+        continue;
+        }
+      }
+    
+    // the remaining characters don't form a complete line
+    
+    pos -= buf_pos;
+    
+    if(fill_buffer() == false)
+      {
+      if(failed)  { return false; }
+      
+      if(pos < buf.size())  { pos = buf.size(); ++n_lines; }
+      
+      finished = true;
+      
+      break;
+      }
+    }
+  
+  if(n_lines == 0)  { return false; }
+  
+  const bool is_csv = (type == csv_ascii);
+  
+  std::string err_msg;
+  
+  const bool parse_okay = diskio::parse_text(block, &(buf[buf_pos]), pos - buf_pos, is_csv, err_msg);
+  
+  buf_pos = pos;
+  
+  if(parse_okay == false)  { fail(err_msg.c_str()); return false; }
+  
+  if( (block.n_cols > f_n_cols) || ((block.n_cols < f_n_cols) && (is_csv == false)) )
+    {
+    fail("inconsistent number of columns in ");
+    return false;
+    }
+  
+  // missing elements in CSV files are set to zero
+  if(block.n_cols < f_n_cols)  { block.resize(block.n_rows, f_n_cols); }
+  
+  return true;
+  }
+
+
+
+//! each column of the block is read from a separate part of the file,
+//! as the elements are stored in column-major order
+template<typename eT>
+inline
+bool
+mat_reader<eT>::next_binary(Mat<eT>& block, const uword n_rows_max)
+  {
+  arma_extra_debug_sigprint();
+  
+  if( (row_pos >= f_n_rows) || (f_n_cols == 0) )  { finished = true; return false; }
+  
+  const uword n_rows = (std::min)(n_rows_max, f_n_rows - row_pos);
+  
+  block.set_size(n_rows, f_n_cols);
+  
+  for(uword col=0; col < f_n_cols; ++col)
+    {
+    const std::streamoff offset = data_offset + std::streamoff(sizeof(eT)) * ( std::streamoff(col) * std::streamoff(f_n_rows) + std::streamoff(row_pos) );
+    
+    f.seekg(offset);
+    
+    f.read( reinterpret_cast<char*>(block.colptr(col)), std::streamsize(n_rows * sizeof(eT)) );
+    }
+  
+  if(f.good() == false)  { fail("couldn't read data from "); return false; }
+  
+  return true;
+  }
+
+
+
+//! the rows of the block are selected as a hyperslab of the dataset;
+//! HDF5 stores matrices transposed, so the rows of the matrix are the columns of the dataset
+template<typename eT>
+inline
+bool
+mat_reader<eT>::next_hdf5(Mat<eT>& block, const uword n_rows_max)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_HDF5)
+    {
+    if( (row_pos >= f_n_rows) || (f_n_cols == 0) )  { finished = true; return false; }
+    
+    const uword n_rows = (std::min)(n_rows_max, f_n_rows - row_pos);
+    
+    block.set_size(n_rows, f_n_cols);
+    
+    hdf5_misc::hdf5_suspend_printing_errors hdf5_print_suspender;
+    
+    const hsize_t start[2] = { hsize_t(0),        hsize_t(row_pos) };
+    const hsize_t count[2] = { hsize_t(f_n_cols), hsize_t(n_rows)  };
+    
+    bool read_okay = ( arma_H5Sselect_hyperslab(h5_filespace, H5S_SELECT_SET, start, NULL, count, NULL) >= 0 );
+    
+    if(read_okay)
+      {
+      hid_t mem_space = arma_H5Screate_simple(h5_ndims, count, NULL);
+      hid_t mem_type  = hdf5_misc::get_hdf5_type<eT>();
+      
+      // the HDF5 library converts the elements if the type stored in the file is different
+      read_okay = ( arma_H5Dread(h5_dataset, mem_type, mem_space, h5_filespace, H5P_DEFAULT, void_ptr(block.memptr())) >= 0 );
+      
+      arma_H5Tclose(mem_type);
+      arma_H5Sclose(mem_space);
+      }
+    
+    if(read_okay == false)  { fail("couldn't read data from "); return false; }
+    
+    return true;
+    }
+  #else
+    {
+    arma_ignore(block);
+    arma_ignore(n_rows_max);
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+template<typename eT>
+inline
+void
+mat_reader<eT>::fail(const char* msg)
+  {
+  failed = true;
+  
+  arma_debug_warn("mat_reader::next(): ", msg, name);
+  }
+
+
+
+//! @}
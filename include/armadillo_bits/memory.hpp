@@ -26,6 +26,14 @@ class memory
   
   template<typename eT> arma_inline static void release(eT* mem);
   
+  arma_inline static size_t calc_alignment(const size_t n_bytes);
+  
+  inline static void first_touch(unsigned char* mem, const size_t n_bytes);
+  
+  static constexpr size_t page_size             = memory_pool::page_size;
+  static constexpr size_t page_threshold        = memory_pool::page_threshold;  //!< minimum size of blocks aligned to pages when ARMA_MEM_ALIGN_PAGE is defined
+  static constexpr size_t first_touch_threshold = size_t(2) << 20;    //!< minimum size of blocks touched in parallel when ARMA_OPENMP_FIRST_TOUCH is defined
+  
   template<typename eT> arma_inline static bool      is_aligned(const eT*  mem);
   template<typename eT> arma_inline static void mark_as_aligned(      eT*& mem);
   template<typename eT> arma_inline static void mark_as_aligned(const eT*& mem);
@@ -49,22 +57,26 @@ memory::acquire(const uword n_elem)
   
   eT* out_memptr;
   
-  #if   defined(ARMA_USE_TBB_ALLOC)
+  #if   defined(ARMA_USE_POOL_ALLOC)
+    {
+    out_memptr = (eT *) memory_pool::acquire(sizeof(eT)*size_t(n_elem));
+    }
+  #elif defined(ARMA_USE_TBB_ALLOC)
     {
     out_memptr = (eT *) scalable_malloc(sizeof(eT)*n_elem);
     }
   #elif defined(ARMA_USE_MKL_ALLOC)
     {
-    out_memptr = (eT *) mkl_malloc( sizeof(eT)*n_elem, 32 );
+    out_memptr = (eT *) mkl_malloc( sizeof(eT)*n_elem, int(memory::calc_alignment(sizeof(eT)*size_t(n_elem))) );
     }
   #elif defined(ARMA_HAVE_POSIX_MEMALIGN)
     {
     eT* memptr = nullptr;
     
     const size_t n_bytes   = sizeof(eT)*size_t(n_elem);
-    const size_t alignment = (n_bytes >= size_t(1024)) ? size_t(32) : size_t(16);
+    const size_t alignment = memory::calc_alignment(n_bytes);
     
-    // TODO: investigate apparent memory leak when using alignment >= 64 (as shown on Fedora 28, glibc 2.27)
+    // NOTE: by default alignment >= 64 is not used, due to an apparent memory leak (as shown on Fedora 28, glibc 2.27)
     int status = posix_memalign((void **)&memptr, ( (alignment >= sizeof(void*)) ? alignment : sizeof(void*) ), n_bytes);
     
     out_memptr = (status == 0) ? memptr : nullptr;
@@ -75,7 +87,7 @@ memory::acquire(const uword n_elem)
     //out_memptr = (eT *) _aligned_malloc( sizeof(eT)*n_elem, 16 );  // lives in malloc.h
     
     const size_t n_bytes   = sizeof(eT)*size_t(n_elem);
-    const size_t alignment = (n_bytes >= size_t(1024)) ? size_t(32) : size_t(16);
+    const size_t alignment = memory::calc_alignment(n_bytes);
     
     out_memptr = (eT *) _aligned_malloc( n_bytes, alignment );
     }
@@ -90,11 +102,57 @@ memory::acquire(const uword n_elem)
   
   arma_check_bad_alloc( (out_memptr == nullptr), "arma::memory::acquire(): out of memory" );
   
+  if(arma_config::first_touch && ( (sizeof(eT)*size_t(n_elem)) >= first_touch_threshold ))
+    {
+    memory::first_touch( (unsigned char*)(out_memptr), sizeof(eT)*size_t(n_elem) );
+    }
+  
   return out_memptr;
   }
 
 
 
+//! alignment (in bytes) of a newly allocated block of n_bytes
+arma_inline
+size_t
+memory::calc_alignment(const size_t n_bytes)
+  {
+  if(arma_config::mem_align_page && (n_bytes >= page_threshold))  { return page_size; }
+  
+  return (n_bytes >= size_t(1024)) ? size_t(arma_config::mem_align) : size_t(16);
+  }
+
+
+
+//! write to one byte in each page of a new block, using the same static schedule as the OpenMP loops over elements;
+//! with the first-touch placement policy of NUMA systems, this puts each page on the node of the thread that later processes it
+inline
+void
+memory::first_touch(unsigned char* mem, const size_t n_bytes)
+  {
+  #if defined(ARMA_USE_OPENMP)
+    {
+    if(omp_in_parallel())  { return; }
+    
+    const int n_threads = mp_thread_limit::get();
+    
+    if(n_threads <= 1)  { return; }
+    
+    const size_t n_pages = (n_bytes + page_size - 1) / page_size;
+    
+    #pragma omp parallel for schedule(static) num_threads(n_threads)
+    for(size_t k=0; k < n_pages; ++k)  { mem[k*page_size] = 0; }
+    }
+  #else
+    {
+    arma_ignore(mem);
+    arma_ignore(n_bytes);
+    }
+  #endif
+  }
+
+
+
 template<typename eT>
 arma_inline
 void
@@ -102,7 +160,11 @@ memory::release(eT* mem)
   {
   if(mem == nullptr)  { return; }
   
-  #if   defined(ARMA_USE_TBB_ALLOC)
+  #if   defined(ARMA_USE_POOL_ALLOC)
+    {
+    memory_pool::release( (void *)(mem) );
+    }
+  #elif defined(ARMA_USE_TBB_ALLOC)
     {
     scalable_free( (void *)(mem) );
     }
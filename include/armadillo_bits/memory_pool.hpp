@@ -0,0 +1,323 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup memory_pool
+//! @{
+
+
+//! thread-caching pool allocator, used by memory::acquire() and memory::release() when ARMA_USE_POOL_ALLOC is defined.
+//! requests are rounded up to one of several size classes (4 per power of 2);
+//! released blocks are kept in free lists owned by the releasing thread, and are reused by later requests from that thread.
+//! each block is preceded by a header that records its size class, so blocks can be released by any thread.
+//! when ARMA_MEM_ALIGN_PAGE is defined, blocks in size classes of at least page_threshold bytes are aligned to pages.
+//! requests larger than the largest size class are passed directly to the system allocator.
+class memory_pool
+  {
+  public:
+  
+  struct stats_type
+    {
+    u64 n_hits     = 0;  //!< number of requests served from a free list
+    u64 n_misses   = 0;  //!< number of requests passed to the system allocator
+    u64 n_cached   = 0;  //!< number of released blocks kept in a free list
+    u64 n_returned = 0;  //!< number of released blocks returned to the system allocator
+    
+    size_t n_bytes_cached = 0;  //!< number of bytes currently held in free lists
+    };
+  
+  static constexpr uword  n_classes        = 64;
+  static constexpr size_t header_size      = (arma_config::mem_align > 32) ? size_t(arma_config::mem_align) : size_t(32);  //!< also the default alignment of returned memory
+  static constexpr size_t max_cached_bytes = size_t(64) << 20;    //!< upper limit on the bytes held in the free lists of one thread
+  static constexpr size_t page_size        = 4096;
+  static constexpr size_t page_threshold   = size_t(256) << 10;   //!< minimum size of blocks aligned to pages when ARMA_MEM_ALIGN_PAGE is defined
+  
+  inline arma_malloc static void* acquire(const size_t n_bytes);
+  inline             static void  release(void* mem);
+  
+  inline static stats_type stats();  //!< statistics for the calling thread
+  inline static void       trim();   //!< return all blocks in the free lists of the calling thread to the system allocator
+  
+  inline static uword  calc_class(const size_t n_bytes);
+  inline static size_t class_size(const uword  c);
+  
+  inline static size_t calc_alignment(const uword c);
+  
+  
+  private:
+  
+  struct header_type
+    {
+    uword          c;     //!< size class; n_classes for blocks that are not pooled
+    header_type*   next;  //!< next block in a free list
+    unsigned char* base;  //!< start of the memory obtained from the system allocator
+    };
+  
+  // trivially destructible, so that it remains usable during thread (and program) exit
+  struct cache_type
+    {
+    header_type* lists[n_classes];
+    stats_type   stats;
+    bool         closed;  //!< set after the free lists have been emptied at thread exit
+    };
+  
+  struct cache_guard
+    {
+    cache_type& cache;
+    
+    inline  cache_guard(cache_type& in_cache) : cache(in_cache) {}
+    inline ~cache_guard()  { memory_pool::trim_cache(cache); cache.closed = true; }
+    };
+  
+  inline static cache_type& get_cache();
+  
+  inline static void trim_cache(cache_type& cache);
+  
+  inline arma_malloc static header_type* acquire_system(const size_t n_bytes, const size_t alignment);
+  inline             static void         release_system(header_type* header);
+  };
+
+
+
+inline
+size_t
+memory_pool::class_size(const uword c)
+  {
+  return size_t(4 + (c % 4)) << (c/4 + 4);
+  }
+
+
+
+//! smallest size class that can hold n_bytes; n_classes if n_bytes is too large to be pooled
+inline
+uword
+memory_pool::calc_class(const size_t n_bytes)
+  {
+  if(n_bytes <= class_size(0))  { return 0; }
+  
+  if(n_bytes >  class_size(n_classes-1))  { return n_classes; }
+  
+  const size_t m = n_bytes - 1;
+  
+  uword p = 6;
+  
+  while( (m >> (p+1)) != 0 )  { ++p; }
+  
+  // m lies within [(4+j) << (p-2), (5+j) << (p-2)), so the class following j is the smallest one that fits
+  
+  const uword j = uword( (m >> (p-2)) & 3 );
+  
+  return (p-6)*4 + j + 1;
+  }
+
+
+
+//! alignment of the blocks in size class c; all blocks in a class have the same alignment, so they can be reused for any request in the class
+inline
+size_t
+memory_pool::calc_alignment(const uword c)
+  {
+  if(arma_config::mem_align_page && ( (c >= n_classes) || (class_size(c) >= page_threshold) ))  { return page_size; }
+  
+  return header_size;
+  }
+
+
+
+inline
+memory_pool::cache_type&
+memory_pool::get_cache()
+  {
+  static thread_local cache_type  cache;
+  static thread_local cache_guard guard(cache);
+  
+  return cache;
+  }
+
+
+
+inline
+arma_malloc
+void*
+memory_pool::acquire(const size_t n_bytes)
+  {
+  cache_type& cache = get_cache();
+  
+  const uword c = calc_class(n_bytes);
+  
+  header_type* header = nullptr;
+  
+  if( (c < n_classes) && (cache.lists[c] != nullptr) )
+    {
+    header = cache.lists[c];
+    
+    cache.lists[c] = header->next;
+    
+    cache.stats.n_bytes_cached -= class_size(c);
+    cache.stats.n_hits++;
+    }
+  else
+    {
+    const size_t alignment = calc_alignment(c);
+    
+    if( n_bytes > (std::numeric_limits<size_t>::max() - alignment) )  { return nullptr; }
+    
+    header = acquire_system( ((c < n_classes) ? class_size(c) : n_bytes), alignment );
+    
+    if(header == nullptr)  { return nullptr; }
+    
+    header->c = c;
+    
+    cache.stats.n_misses++;
+    }
+  
+  return (void*)( ((unsigned char*)header) + header_size );
+  }
+
+
+
+inline
+void
+memory_pool::release(void* mem)
+  {
+  if(mem == nullptr)  { return; }
+  
+  header_type* header = (header_type*)( ((unsigned char*)mem) - header_size );
+  
+  const uword c = header->c;
+  
+  cache_type& cache = get_cache();
+  
+  if( (c < n_classes) && (cache.closed == false) && ((cache.stats.n_bytes_cached + class_size(c)) <= max_cached_bytes) )
+    {
+    header->next   = cache.lists[c];
+    cache.lists[c] = header;
+    
+    cache.stats.n_bytes_cached += class_size(c);
+    cache.stats.n_cached++;
+    }
+  else
+    {
+    release_system(header);
+    
+    cache.stats.n_returned++;
+    }
+  }
+
+
+
+inline
+memory_pool::stats_type
+memory_pool::stats()
+  {
+  return get_cache().stats;
+  }
+
+
+
+inline
+void
+memory_pool::trim()
+  {
+  trim_cache( get_cache() );
+  }
+
+
+
+inline
+void
+memory_pool::trim_cache(cache_type& cache)
+  {
+  for(uword c=0; c < n_classes; ++c)
+    {
+    header_type* header = cache.lists[c];
+    
+    while(header != nullptr)
+      {
+      header_type* next = header->next;
+      
+      release_system(header);
+      
+      cache.stats.n_returned++;
+      
+      header = next;
+      }
+    
+    cache.lists[c] = nullptr;
+    }
+  
+  cache.stats.n_bytes_cached = 0;
+  }
+
+
+
+inline
+arma_malloc
+memory_pool::header_type*
+memory_pool::acquire_system(const size_t n_bytes, const size_t alignment)
+  {
+  // the returned memory starts at base + alignment, and the header occupies the bytes just before it
+  
+  const size_t n_total = n_bytes + alignment;
+  
+  unsigned char* base = nullptr;
+  
+  #if defined(ARMA_HAVE_POSIX_MEMALIGN)
+    {
+    void* mem = nullptr;
+    
+    const int status = posix_memalign(&mem, alignment, n_total);
+    
+    base = (status == 0) ? (unsigned char*)(mem) : nullptr;
+    }
+  #elif defined(_MSC_VER)
+    {
+    base = (unsigned char*) _aligned_malloc(n_total, alignment);
+    }
+  #else
+    {
+    base = (unsigned char*) malloc(n_total);
+    }
+  #endif
+  
+  if(base == nullptr)  { return nullptr; }
+  
+  header_type* header = (header_type*)(base + alignment - header_size);
+  
+  header->base = base;
+  
+  return header;
+  }
+
+
+
+inline
+void
+memory_pool::release_system(header_type* header)
+  {
+  #if defined(_MSC_VER) && !defined(ARMA_HAVE_POSIX_MEMALIGN)
+    {
+    _aligned_free( (void*)(header->base) );
+    }
+  #else
+    {
+    free( (void*)(header->base) );
+    }
+  #endif
+  }
+
+
+
+//! @}
@@ -0,0 +1,50 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup mmap_region
+//! @{
+
+
+//! a whole file mapped into memory via mmap(), used by mapped_mat and mapped_cube;
+//! in read-only mode the pages are shared with other processes mapping the same file;
+//! in copy-on-write mode the pages are writable, and modified pages become private copies, leaving the file unchanged.
+//! mapping is only available on systems with ARMA_HAVE_POSIX_MMAP; elsewhere map() always returns false
+class mmap_region
+  {
+  public:
+  
+  inline  mmap_region();
+  inline ~mmap_region();
+  
+  inline bool map(const std::string& name, const mmap_mode mode);
+  inline void unmap();
+  
+  inline unsigned char* memptr()  const { return mem;     }
+  inline size_t         n_bytes() const { return n_total; }
+  
+  
+  private:
+  
+  unsigned char* mem;
+  size_t         n_total;
+  
+  mmap_region(const mmap_region&)            = delete;
+  mmap_region& operator=(const mmap_region&) = delete;
+  };
+
+
+
+//! @}
@@ -0,0 +1,107 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup mmap_region
+//! @{
+
+
+
+inline
+mmap_region::mmap_region()
+  : mem(nullptr)
+  , n_total(0)
+  {
+  arma_extra_debug_sigprint();
+  }
+
+
+
+inline
+mmap_region::~mmap_region()
+  {
+  arma_extra_debug_sigprint();
+  
+  unmap();
+  }
+
+
+
+inline
+bool
+mmap_region::map(const std::string& name, const mmap_mode mode)
+  {
+  arma_extra_debug_sigprint();
+  
+  unmap();
+  
+  #if defined(ARMA_HAVE_POSIX_MMAP)
+    {
+    const int fd = ::open(name.c_str(), O_RDONLY);
+    
+    if(fd < 0)  { return false; }
+    
+    struct stat file_info;
+    
+    if( (::fstat(fd, &file_info) != 0) || (file_info.st_size <= 0) )  { ::close(fd); return false; }
+    
+    const size_t n_file_bytes = size_t(file_info.st_size);
+    
+    const int prot  = (mode == mmap_mode::copy_on_write) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    const int flags = (mode == mmap_mode::copy_on_write) ? MAP_PRIVATE : MAP_SHARED;
+    
+    void* ptr = ::mmap(nullptr, n_file_bytes, prot, flags, fd, 0);
+    
+    // the mapping remains valid after the file descriptor is closed
+    ::close(fd);
+    
+    if(ptr == MAP_FAILED)  { return false; }
+    
+    mem     = (unsigned char*)(ptr);
+    n_total = n_file_bytes;
+    
+    return true;
+    }
+  #else
+    {
+    arma_ignore(name);
+    arma_ignore(mode);
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+inline
+void
+mmap_region::unmap()
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_HAVE_POSIX_MMAP)
+    {
+    if(mem != nullptr)  { ::munmap((void*)(mem), n_total); }
+    }
+  #endif
+  
+  mem     = nullptr;
+  n_total = 0;
+  }
+
+
+
+//! @}
@@ -171,6 +171,223 @@ class gemm_emul_large
   
 
 
+//! \brief
+//! cache-blocked emulation of gemm(), for real and complex matrices.
+//! blocks of A and B are packed into contiguous panels, applying the transposes (hermitian for complex matrices)
+//! and alpha on the way; each pair of panels is then multiplied by the register-blocked micro-kernel in gemm_emul_kernel.
+//! the block sizes are chosen so that a packed panel of B stays in the L1 cache and a packed block of A stays in the L2 cache.
+template<const bool do_trans_A=false, const bool do_trans_B=false, const bool use_alpha=false, const bool use_beta=false>
+class gemm_emul_blocked
+  {
+  public:
+  
+  static constexpr uword kc       = 256;           //!< depth of the packed panels
+  static constexpr uword nc       = 4096;          //!< max number of columns in a packed block of B
+  static constexpr uword mc_bytes = 256 * 1024;    //!< max size of a packed block of A
+  
+  
+  template<typename eT, typename TA, typename TB>
+  arma_hot
+  inline
+  static
+  void
+  apply
+    (
+          Mat<eT>& C,
+    const TA&      A,
+    const TB&      B,
+    const eT       alpha = eT(1),
+    const eT       beta  = eT(0)
+    )
+    {
+    arma_extra_debug_sigprint();
+    
+    typedef gemm_emul_kernel<eT> kernel;
+    
+    const uword mr = kernel::mr;
+    const uword nr = kernel::nr;
+    
+    const uword M = C.n_rows;
+    const uword N = C.n_cols;
+    const uword K = (do_trans_A) ? A.n_rows : A.n_cols;
+    
+    if(use_beta)  { arrayops::inplace_mul(C.memptr(), beta, C.n_elem); }  else  { C.zeros(); }
+    
+    if( (M == 0) || (N == 0) || (K == 0) )  { return; }
+    
+    const uword mc_max = (std::max)( uword(1), uword(mc_bytes / (kc * sizeof(eT) * mr)) ) * mr;
+    const uword nc_max = (nc / nr) * nr;
+    
+    const uword mc_use = (std::min)( mc_max, ((M + mr - 1) / mr) * mr );
+    const uword nc_use = (std::min)( nc_max, ((N + nr - 1) / nr) * nr );
+    const uword kc_use = (std::min)( uword(kc), K );
+    
+    podarray<eT> A_pack(mc_use * kc_use);
+    podarray<eT> B_pack(nc_use * kc_use);
+    
+    eT tile[kernel::mr * kernel::nr];
+    
+    eT* C_mem = C.memptr();
+    
+    for(uword jc=0; jc < N; jc += nc_use)
+      {
+      const uword nb = (std::min)(nc_use, N - jc);
+      
+      for(uword pc=0; pc < K; pc += kc_use)
+        {
+        const uword kb = (std::min)(kc_use, K - pc);
+        
+        pack_B(B_pack.memptr(), B, pc, kb, jc, nb, nr);
+        
+        for(uword ic=0; ic < M; ic += mc_use)
+          {
+          const uword mb = (std::min)(mc_use, M - ic);
+          
+          pack_A(A_pack.memptr(), A, ic, mb, pc, kb, mr, alpha);
+          
+          for(uword jr=0; jr < nb; jr += nr)
+            {
+            const uword nrb = (std::min)(nr, nb - jr);
+            
+            const eT* B_panel = &(B_pack[jr * kb]);
+            
+            for(uword ir=0; ir < mb; ir += mr)
+              {
+              const uword mrb = (std::min)(mr, mb - ir);
+              
+              const eT* A_panel = &(A_pack[ir * kb]);
+              
+              eT* C_block = &(C_mem[(ic + ir) + (jc + jr)*M]);
+              
+              if( (mrb == mr) && (nrb == nr) )
+                {
+                kernel::apply(kb, A_panel, B_panel, C_block, M);
+                }
+              else
+                {
+                arrayops::fill_zeros(tile, mr*nr);
+                
+                kernel::apply(kb, A_panel, B_panel, tile, mr);
+                
+                for(uword j=0; j < nrb; ++j)
+                for(uword i=0; i < mrb; ++i)
+                  {
+                  C_block[i + j*M] += tile[i + j*mr];
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  
+  
+  private:
+  
+  //! pack the block op(A)(ic:ic+mb-1, pc:pc+kb-1) into panels of mr rows, padded with zeros
+  template<typename eT, typename TA>
+  arma_hot
+  inline
+  static
+  void
+  pack_A(eT* out, const TA& A, const uword ic, const uword mb, const uword pc, const uword kb, const uword mr, const eT alpha)
+    {
+    for(uword ir=0; ir < mb; ir += mr)
+      {
+      const uword mrb = (std::min)(mr, mb - ir);
+      
+      if(do_trans_A == false)
+        {
+        for(uword k=0; k < kb; ++k)
+          {
+          const eT* A_colptr = &(A.colptr(pc + k)[ic + ir]);
+          
+          uword i=0;
+          
+          for(; i < mrb; ++i)  { out[i] = (use_alpha) ? eT(alpha * A_colptr[i]) : A_colptr[i]; }
+          for(; i < mr;  ++i)  { out[i] = eT(0); }
+          
+          out += mr;
+          }
+        }
+      else
+        {
+        for(uword i=0; i < mrb; ++i)
+          {
+          const eT* A_colptr = &(A.colptr(ic + ir + i)[pc]);
+          
+          for(uword k=0; k < kb; ++k)
+            {
+            const eT val = access::alt_conj(A_colptr[k]);
+            
+            out[i + k*mr] = (use_alpha) ? eT(alpha * val) : val;
+            }
+          }
+        
+        for(uword i=mrb; i < mr; ++i)
+        for(uword k=0;   k < kb; ++k)
+          {
+          out[i + k*mr] = eT(0);
+          }
+        
+        out += mr*kb;
+        }
+      }
+    }
+  
+  
+  
+  //! pack the block op(B)(pc:pc+kb-1, jc:jc+nb-1) into panels of nr columns, padded with zeros
+  template<typename eT, typename TB>
+  arma_hot
+  inline
+  static
+  void
+  pack_B(eT* out, const TB& B, const uword pc, const uword kb, const uword jc, const uword nb, const uword nr)
+    {
+    for(uword jr=0; jr < nb; jr += nr)
+      {
+      const uword nrb = (std::min)(nr, nb - jr);
+      
+      if(do_trans_B == false)
+        {
+        for(uword j=0; j < nrb; ++j)
+          {
+          const eT* B_colptr = &(B.colptr(jc + jr + j)[pc]);
+          
+          for(uword k=0; k < kb; ++k)  { out[j + k*nr] = B_colptr[k]; }
+          }
+        
+        for(uword j=nrb; j < nr; ++j)
+        for(uword k=0;   k < kb; ++k)
+          {
+          out[j + k*nr] = eT(0);
+          }
+        
+        out += nr*kb;
+        }
+      else
+        {
+        for(uword k=0; k < kb; ++k)
+          {
+          const eT* B_colptr = &(B.colptr(pc + k)[jc + jr]);
+          
+          uword j=0;
+          
+          for(; j < nrb; ++j)  { out[j] = access::alt_conj(B_colptr[j]); }
+          for(; j < nr;  ++j)  { out[j] = eT(0); }
+          
+          out += nr;
+          }
+        }
+      }
+    }
+  
+  };
+
+
+
 template<const bool do_trans_A=false, const bool do_trans_B=false, const bool use_alpha=false, const bool use_beta=false>
 class gemm_emul
   {
@@ -195,7 +412,16 @@ class gemm_emul
     arma_extra_debug_sigprint();
     arma_ignore(junk);
     
-    gemm_emul_large<do_trans_A, do_trans_B, use_alpha, use_beta>::apply(C, A, B, alpha, beta);
+    const uword K = (do_trans_A) ? A.n_rows : A.n_cols;
+    
+    if(use_blocked(C.n_rows, C.n_cols, K))
+      {
+      gemm_emul_blocked<do_trans_A, do_trans_B, use_alpha, use_beta>::apply(C, A, B, alpha, beta);
+      }
+    else
+      {
+      gemm_emul_large<do_trans_A, do_trans_B, use_alpha, use_beta>::apply(C, A, B, alpha, beta);
+      }
     }
   
   
@@ -218,6 +444,15 @@ class gemm_emul
     arma_extra_debug_sigprint();
     arma_ignore(junk);
     
+    const uword K = (do_trans_A) ? A.n_rows : A.n_cols;
+    
+    if(use_blocked(C.n_rows, C.n_cols, K))
+      {
+      gemm_emul_blocked<do_trans_A, do_trans_B, use_alpha, use_beta>::apply(C, A, B, alpha, beta);
+      
+      return;
+      }
+    
     // "better than nothing" handling of hermitian transposes for complex number matrices
     
     Mat<eT> tmp_A;
@@ -231,7 +466,18 @@ class gemm_emul
     
     gemm_emul_large<false, false, use_alpha, use_beta>::apply(C, AA, BB, alpha, beta);
     }
-
+  
+  
+  
+  //! the packing done by gemm_emul_blocked only pays off once each packed element is reused several times
+  arma_inline
+  static
+  bool
+  use_blocked(const uword M, const uword N, const uword K)
+    {
+    return ( (M >= 4) && (N >= 4) && (K >= 4) && ((double(M) * double(N) * double(K)) >= double(4096)) );
+    }
+  
   };
 
 
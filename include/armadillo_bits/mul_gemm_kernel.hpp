@@ -0,0 +1,317 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup gemm
+//! @{
+
+
+
+//! vector operations used by the micro-kernel of the gemm() emulation;
+//! specialisations are provided for element types that are supported by the enabled instruction set
+template<typename eT>
+struct gemm_emul_simd
+  {
+  static constexpr bool supported = false;
+  };
+
+
+
+#if defined(ARMA_HAVE_AVX512)
+
+  template<>
+  struct gemm_emul_simd<float>
+    {
+    static constexpr bool supported = true;
+    
+    typedef __m512 vec_type;
+    
+    static constexpr uword n_lanes = 16;
+    
+    arma_inline static vec_type zeros()                                                        { return _mm512_setzero_ps();        }
+    arma_inline static vec_type load (const float* mem)                                        { return _mm512_loadu_ps(mem);       }
+    arma_inline static vec_type fill (const float* mem)                                        { return _mm512_set1_ps(*mem);       }
+    arma_inline static vec_type fma  (const vec_type& a, const vec_type& b, const vec_type& c) { return _mm512_fmadd_ps(a, b, c);   }
+    arma_inline static vec_type add  (const vec_type& a, const vec_type& b)                    { return _mm512_add_ps(a, b);        }
+    arma_inline static void     store(float* mem, const vec_type& a)                           {        _mm512_storeu_ps(mem, a);   }
+    };
+  
+  
+  template<>
+  struct gemm_emul_simd<double>
+    {
+    static constexpr bool supported = true;
+    
+    typedef __m512d vec_type;
+    
+    static constexpr uword n_lanes = 8;
+    
+    arma_inline static vec_type zeros()                                                        { return _mm512_setzero_pd();        }
+    arma_inline static vec_type load (const double* mem)                                       { return _mm512_loadu_pd(mem);       }
+    arma_inline static vec_type fill (const double* mem)                                       { return _mm512_set1_pd(*mem);       }
+    arma_inline static vec_type fma  (const vec_type& a, const vec_type& b, const vec_type& c) { return _mm512_fmadd_pd(a, b, c);   }
+    arma_inline static vec_type add  (const vec_type& a, const vec_type& b)                    { return _mm512_add_pd(a, b);        }
+    arma_inline static void     store(double* mem, const vec_type& a)                          {        _mm512_storeu_pd(mem, a);   }
+    };
+
+#elif defined(ARMA_HAVE_AVX2)
+
+  template<>
+  struct gemm_emul_simd<float>
+    {
+    static constexpr bool supported = true;
+    
+    typedef __m256 vec_type;
+    
+    static constexpr uword n_lanes = 8;
+    
+    arma_inline static vec_type zeros()                                                        { return _mm256_setzero_ps();        }
+    arma_inline static vec_type load (const float* mem)                                        { return _mm256_loadu_ps(mem);       }
+    arma_inline static vec_type fill (const float* mem)                                        { return _mm256_broadcast_ss(mem);   }
+    arma_inline static vec_type fma  (const vec_type& a, const vec_type& b, const vec_type& c) { return _mm256_fmadd_ps(a, b, c);   }
+    arma_inline static vec_type add  (const vec_type& a, const vec_type& b)                    { return _mm256_add_ps(a, b);        }
+    arma_inline static void     store(float* mem, const vec_type& a)                           {        _mm256_storeu_ps(mem, a);   }
+    };
+  
+  
+  template<>
+  struct gemm_emul_simd<double>
+    {
+    static constexpr bool supported = true;
+    
+    typedef __m256d vec_type;
+    
+    static constexpr uword n_lanes = 4;
+    
+    arma_inline static vec_type zeros()                                                        { return _mm256_setzero_pd();        }
+    arma_inline static vec_type load (const double* mem)                                       { return _mm256_loadu_pd(mem);       }
+    arma_inline static vec_type fill (const double* mem)                                       { return _mm256_broadcast_sd(mem);   }
+    arma_inline static vec_type fma  (const vec_type& a, const vec_type& b, const vec_type& c) { return _mm256_fmadd_pd(a, b, c);   }
+    arma_inline static vec_type add  (const vec_type& a, const vec_type& b)                    { return _mm256_add_pd(a, b);        }
+    arma_inline static void     store(double* mem, const vec_type& a)                          {        _mm256_storeu_pd(mem, a);   }
+    };
+
+#elif defined(ARMA_HAVE_NEON)
+
+  template<>
+  struct gemm_emul_simd<float>
+    {
+    static constexpr bool supported = true;
+    
+    typedef float32x4_t vec_type;
+    
+    static constexpr uword n_lanes = 4;
+    
+    arma_inline static vec_type zeros()                                                        { return vdupq_n_f32(float(0));      }
+    arma_inline static vec_type load (const float* mem)                                        { return vld1q_f32(mem);             }
+    arma_inline static vec_type fill (const float* mem)                                        { return vld1q_dup_f32(mem);         }
+    arma_inline static vec_type fma  (const vec_type& a, const vec_type& b, const vec_type& c) { return vfmaq_f32(c, a, b);         }
+    arma_inline static vec_type add  (const vec_type& a, const vec_type& b)                    { return vaddq_f32(a, b);            }
+    arma_inline static void     store(float* mem, const vec_type& a)                           {        vst1q_f32(mem, a);          }
+    };
+  
+  
+  template<>
+  struct gemm_emul_simd<double>
+    {
+    static constexpr bool supported = true;
+    
+    typedef float64x2_t vec_type;
+    
+    static constexpr uword n_lanes = 2;
+    
+    arma_inline static vec_type zeros()                                                        { return vdupq_n_f64(double(0));     }
+    arma_inline static vec_type load (const double* mem)                                       { return vld1q_f64(mem);             }
+    arma_inline static vec_type fill (const double* mem)                                       { return vld1q_dup_f64(mem);         }
+    arma_inline static vec_type fma  (const vec_type& a, const vec_type& b, const vec_type& c) { return vfmaq_f64(c, a, b);         }
+    arma_inline static vec_type add  (const vec_type& a, const vec_type& b)                    { return vaddq_f64(a, b);            }
+    arma_inline static void     store(double* mem, const vec_type& a)                          {        vst1q_f64(mem, a);          }
+    };
+
+#endif
+
+
+
+//! \brief
+//! micro-kernel of the gemm() emulation: C += A*B, where C is a block of size mr x nr with column stride ldc;
+//! A is a packed panel of size mr x kc, stored column by column (ie. mr consecutive elements for each k);
+//! B is a packed panel of size kc x nr, stored row by row (ie. nr consecutive elements for each k).
+//! the generic version relies on the compiler to vectorise the accumulation over the rows of the block.
+template<typename eT, const bool use_simd = gemm_emul_simd<eT>::supported>
+class gemm_emul_kernel
+  {
+  public:
+  
+  static constexpr uword mr = (sizeof(eT) <= 4) ? 8 : 4;
+  static constexpr uword nr = 4;
+  
+  arma_hot
+  inline
+  static
+  void
+  apply(const uword kc, const eT* A, const eT* B, eT* C, const uword ldc)
+    {
+    eT acc[mr*nr];
+    
+    for(uword i=0; i < mr*nr; ++i)  { acc[i] = eT(0); }
+    
+    for(uword k=0; k < kc; ++k)
+      {
+      for(uword j=0; j < nr; ++j)
+        {
+        const eT B_kj = B[j];
+        
+        for(uword i=0; i < mr; ++i)  { acc[i + j*mr] += A[i] * B_kj; }
+        }
+      
+      A += mr;
+      B += nr;
+      }
+    
+    for(uword j=0; j < nr; ++j)
+      {
+      eT* C_colptr = &(C[j*ldc]);
+      
+      for(uword i=0; i < mr; ++i)  { C_colptr[i] += acc[i + j*mr]; }
+      }
+    }
+  };
+
+
+
+//! complex version, with explicit real and imaginary arithmetic
+//! (which avoids the checks for infinities and NaNs made by operator* of std::complex)
+template<typename T>
+class gemm_emul_kernel< std::complex<T>, false >
+  {
+  public:
+  
+  static constexpr uword mr = 4;
+  static constexpr uword nr = 4;
+  
+  arma_hot
+  inline
+  static
+  void
+  apply(const uword kc, const std::complex<T>* A, const std::complex<T>* B, std::complex<T>* C, const uword ldc)
+    {
+    T acc_real[mr*nr];
+    T acc_imag[mr*nr];
+    
+    for(uword i=0; i < mr*nr; ++i)  { acc_real[i] = T(0); acc_imag[i] = T(0); }
+    
+    for(uword k=0; k < kc; ++k)
+      {
+      T A_real[mr];
+      T A_imag[mr];
+      
+      for(uword i=0; i < mr; ++i)  { A_real[i] = A[i].real(); A_imag[i] = A[i].imag(); }
+      
+      for(uword j=0; j < nr; ++j)
+        {
+        const T c = B[j].real();
+        const T d = B[j].imag();
+        
+        for(uword i=0; i < mr; ++i)
+          {
+          acc_real[i + j*mr] += (A_real[i]*c) - (A_imag[i]*d);
+          acc_imag[i + j*mr] += (A_real[i]*d) + (A_imag[i]*c);
+          }
+        }
+      
+      A += mr;
+      B += nr;
+      }
+    
+    for(uword j=0; j < nr; ++j)
+      {
+      std::complex<T>* C_colptr = &(C[j*ldc]);
+      
+      for(uword i=0; i < mr; ++i)  { C_colptr[i] += std::complex<T>(acc_real[i + j*mr], acc_imag[i + j*mr]); }
+      }
+    }
+  };
+
+
+
+//! version using the vector operations in gemm_emul_simd;
+//! the micro-tile consists of 2 vectors in each of 6 columns, which are held in separate variables
+//! so that they are kept in registers without relying on loop unrolling by the compiler
+template<typename eT>
+class gemm_emul_kernel<eT, true>
+  {
+  public:
+  
+  typedef gemm_emul_simd<eT>              simd;
+  typedef typename simd::vec_type     vec_type;
+  
+  static constexpr uword n_lanes = simd::n_lanes;
+  
+  static constexpr uword mr = 2 * n_lanes;
+  static constexpr uword nr = 6;
+  
+  arma_hot
+  inline
+  static
+  void
+  apply(const uword kc, const eT* A, const eT* B, eT* C, const uword ldc)
+    {
+    vec_type c00 = simd::zeros();  vec_type c10 = simd::zeros();
+    vec_type c01 = simd::zeros();  vec_type c11 = simd::zeros();
+    vec_type c02 = simd::zeros();  vec_type c12 = simd::zeros();
+    vec_type c03 = simd::zeros();  vec_type c13 = simd::zeros();
+    vec_type c04 = simd::zeros();  vec_type c14 = simd::zeros();
+    vec_type c05 = simd::zeros();  vec_type c15 = simd::zeros();
+    
+    for(uword k=0; k < kc; ++k)
+      {
+      const vec_type a0 = simd::load(&(A[0      ]));
+      const vec_type a1 = simd::load(&(A[n_lanes]));
+      
+      vec_type b;
+      
+      b = simd::fill(&(B[0]));  c00 = simd::fma(a0, b, c00);  c10 = simd::fma(a1, b, c10);
+      b = simd::fill(&(B[1]));  c01 = simd::fma(a0, b, c01);  c11 = simd::fma(a1, b, c11);
+      b = simd::fill(&(B[2]));  c02 = simd::fma(a0, b, c02);  c12 = simd::fma(a1, b, c12);
+      b = simd::fill(&(B[3]));  c03 = simd::fma(a0, b, c03);  c13 = simd::fma(a1, b, c13);
+      b = simd::fill(&(B[4]));  c04 = simd::fma(a0, b, c04);  c14 = simd::fma(a1, b, c14);
+      b = simd::fill(&(B[5]));  c05 = simd::fma(a0, b, c05);  c15 = simd::fma(a1, b, c15);
+      
+      A += mr;
+      B += nr;
+      }
+    
+    update(&(C[0*ldc]), c00, c10);
+    update(&(C[1*ldc]), c01, c11);
+    update(&(C[2*ldc]), c02, c12);
+    update(&(C[3*ldc]), c03, c13);
+    update(&(C[4*ldc]), c04, c14);
+    update(&(C[5*ldc]), c05, c15);
+    }
+  
+  
+  arma_inline
+  static
+  void
+  update(eT* C_colptr, const vec_type& c0, const vec_type& c1)
+    {
+    simd::store(&(C_colptr[0      ]), simd::add(simd::load(&(C_colptr[0      ])), c0));
+    simd::store(&(C_colptr[n_lanes]), simd::add(simd::load(&(C_colptr[n_lanes])), c1));
+    }
+  };
+
+
+
+//! @}
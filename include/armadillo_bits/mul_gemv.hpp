@@ -202,6 +202,75 @@ class gemv_emul_helper
     return std::complex<T>(val_real, val_imag);
     }
   
+  
+  
+  //! acc += A*x, processing A column by column (ie. in the order it is stored)
+  template<typename eT, typename TA>
+  arma_hot
+  inline
+  static
+  typename enable_if2< is_cx<eT>::no, void >::result
+  accumulate_cols( eT* acc, const TA& A, const eT* x )
+    {
+    const uword N_rows = A.n_rows;
+    const uword N_cols = A.n_cols;
+    
+    uword col;
+    for(col=0; (col+1) < N_cols; col+=2)
+      {
+      const eT* A_col0 = A.colptr(col  );
+      const eT* A_col1 = A.colptr(col+1);
+      
+      const eT x0 = x[col  ];
+      const eT x1 = x[col+1];
+      
+      for(uword row=0; row < N_rows; ++row)  { acc[row] += (A_col0[row] * x0) + (A_col1[row] * x1); }
+      }
+    
+    if(col < N_cols)
+      {
+      const eT* A_col0 = A.colptr(col);
+      
+      const eT x0 = x[col];
+      
+      for(uword row=0; row < N_rows; ++row)  { acc[row] += A_col0[row] * x0; }
+      }
+    }
+  
+  
+  
+  template<typename eT, typename TA>
+  arma_hot
+  inline
+  static
+  typename enable_if2< is_cx<eT>::yes, void >::result
+  accumulate_cols( eT* acc, const TA& A, const eT* x )
+    {
+    typedef typename get_pod_type<eT>::result T;
+    
+    const uword N_rows = A.n_rows;
+    const uword N_cols = A.n_cols;
+    
+    T* acc_mem = reinterpret_cast<T*>(acc);
+    
+    for(uword col=0; col < N_cols; ++col)
+      {
+      const T* A_col = reinterpret_cast<const T*>(A.colptr(col));
+      
+      const T c = x[col].real();
+      const T d = x[col].imag();
+      
+      for(uword row=0; row < N_rows; ++row)
+        {
+        const T a = A_col[2*row  ];
+        const T b = A_col[2*row+1];
+        
+        acc_mem[2*row  ] += (a*c) - (b*d);
+        acc_mem[2*row+1] += (a*d) + (b*c);
+        }
+      }
+    }
+  
   };
 
 
@@ -239,14 +308,37 @@ class gemv_emul
         else if( (use_alpha == true ) && (use_beta == true ) )  { y[0] = alpha*acc + beta*y[0]; }
         }
       else
-      for(uword row=0; row < A_n_rows; ++row)
+      if(A_n_cols <= 4)
         {
-        const eT acc = gemv_emul_helper::dot_row_col(A, x, row, A_n_cols);
+        for(uword row=0; row < A_n_rows; ++row)
+          {
+          const eT acc = gemv_emul_helper::dot_row_col(A, x, row, A_n_cols);
+          
+               if( (use_alpha == false) && (use_beta == false) )  { y[row] =       acc;               }
+          else if( (use_alpha == true ) && (use_beta == false) )  { y[row] = alpha*acc;               }
+          else if( (use_alpha == false) && (use_beta == true ) )  { y[row] =       acc + beta*y[row]; }
+          else if( (use_alpha == true ) && (use_beta == true ) )  { y[row] = alpha*acc + beta*y[row]; }
+          }
+        }
+      else
+        {
+        // accessing A row by row is cache unfriendly, so accumulate the weighted columns of A instead
         
-             if( (use_alpha == false) && (use_beta == false) )  { y[row] =       acc;               }
-        else if( (use_alpha == true ) && (use_beta == false) )  { y[row] = alpha*acc;               }
-        else if( (use_alpha == false) && (use_beta == true ) )  { y[row] =       acc + beta*y[row]; }
-        else if( (use_alpha == true ) && (use_beta == true ) )  { y[row] = alpha*acc + beta*y[row]; }
+        podarray<eT> tmp(A_n_rows);
+        
+        eT* acc = tmp.memptr();
+        
+        arrayops::fill_zeros(acc, A_n_rows);
+        
+        gemv_emul_helper::accumulate_cols(acc, A, x);
+        
+        for(uword row=0; row < A_n_rows; ++row)
+          {
+               if( (use_alpha == false) && (use_beta == false) )  { y[row] =       acc[row];               }
+          else if( (use_alpha == true ) && (use_beta == false) )  { y[row] = alpha*acc[row];               }
+          else if( (use_alpha == false) && (use_beta == true ) )  { y[row] =       acc[row] + beta*y[row]; }
+          else if( (use_alpha == true ) && (use_beta == true ) )  { y[row] = alpha*acc[row] + beta*y[row]; }
+          }
         }
       }
     else
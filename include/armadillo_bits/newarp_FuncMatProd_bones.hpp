@@ -0,0 +1,67 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+namespace newarp
+{
+
+
+//! Define matrix operations via a user-supplied function object, y = func(x);
+//! func must accept a const Col<eT>& of length n_cols and return a column vector of length n_rows
+template<typename eT, typename func_type>
+class FuncMatProd
+  {
+  private:
+  
+  const func_type& func;
+  
+  
+  public:
+  
+  const uword n_rows;  // number of rows of the implied matrix
+  const uword n_cols;  // number of columns of the implied matrix
+  
+  inline FuncMatProd(const func_type& in_func, const uword in_n_rows, const uword in_n_cols);
+  
+  inline void perform_op(eT* x_in, eT* y_out) const;
+  };
+
+
+
+//! Define the symmetric matrix [0 A; A^T 0] via function objects for y = A*x and y = A^T*x;
+//! used by svds() for operators given as function objects
+template<typename eT, typename func_type, typename func_t_type>
+class FuncAugMatProd
+  {
+  private:
+  
+  const func_type&   func;
+  const func_t_type& func_t;
+  
+  const uword A_n_rows;
+  const uword A_n_cols;
+  
+  
+  public:
+  
+  const uword n_rows;  // A_n_rows + A_n_cols
+  const uword n_cols;  // A_n_rows + A_n_cols
+  
+  inline FuncAugMatProd(const func_type& in_func, const func_t_type& in_func_t, const uword in_A_n_rows, const uword in_A_n_cols);
+  
+  inline void perform_op(eT* x_in, eT* y_out) const;
+  };
+
+}  // namespace newarp
@@ -0,0 +1,96 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+namespace newarp
+{
+
+
+template<typename eT, typename func_type>
+inline
+FuncMatProd<eT,func_type>::FuncMatProd(const func_type& in_func, const uword in_n_rows, const uword in_n_cols)
+  : func(in_func)
+  , n_rows(in_n_rows)
+  , n_cols(in_n_cols)
+  {
+  arma_extra_debug_sigprint();
+  }
+
+
+
+// Perform the matrix-vector multiplication operation \f$y=Ax\f$.
+// y_out = func(x_in)
+template<typename eT, typename func_type>
+inline
+void
+FuncMatProd<eT,func_type>::perform_op(eT* x_in, eT* y_out) const
+  {
+  arma_extra_debug_sigprint();
+  
+  const Col<eT> x(x_in , n_cols, false, true);
+        Col<eT> y(y_out, n_rows, false, true);
+  
+  const Col<eT> tmp = func(x);
+  
+  arma_debug_check( (tmp.n_elem != n_rows), "eigs: function object returned a vector with incorrect size" );
+  
+  y = tmp;
+  }
+
+
+
+
+template<typename eT, typename func_type, typename func_t_type>
+inline
+FuncAugMatProd<eT,func_type,func_t_type>::FuncAugMatProd(const func_type& in_func, const func_t_type& in_func_t, const uword in_A_n_rows, const uword in_A_n_cols)
+  : func(in_func)
+  , func_t(in_func_t)
+  , A_n_rows(in_A_n_rows)
+  , A_n_cols(in_A_n_cols)
+  , n_rows(in_A_n_rows + in_A_n_cols)
+  , n_cols(in_A_n_rows + in_A_n_cols)
+  {
+  arma_extra_debug_sigprint();
+  }
+
+
+
+// y_out = [0 A; A^T 0] * x_in
+template<typename eT, typename func_type, typename func_t_type>
+inline
+void
+FuncAugMatProd<eT,func_type,func_t_type>::perform_op(eT* x_in, eT* y_out) const
+  {
+  arma_extra_debug_sigprint();
+  
+  const Col<eT> x_top(x_in           , A_n_rows, false, true);
+  const Col<eT> x_bot(x_in + A_n_rows, A_n_cols, false, true);
+  
+  Col<eT> y_top(y_out           , A_n_rows, false, true);
+  Col<eT> y_bot(y_out + A_n_rows, A_n_cols, false, true);
+  
+  const Col<eT> tmp_top = func(x_bot);
+  
+  arma_debug_check( (tmp_top.n_elem != A_n_rows), "svds(): function object for A*x returned a vector with incorrect size" );
+  
+  const Col<eT> tmp_bot = func_t(x_top);
+  
+  arma_debug_check( (tmp_bot.n_elem != A_n_cols), "svds(): function object for A.t()*x returned a vector with incorrect size" );
+  
+  y_top = tmp_top;
+  y_bot = tmp_bot;
+  }
+
+}  // namespace newarp
@@ -27,6 +27,44 @@ class op_fft_real
   
   template<typename T1>
   inline static void apply( Mat< std::complex<typename T1::pod_type> >& out, const mtOp<std::complex<typename T1::pod_type>,T1,op_fft_real>& in );
+  
+  template<typename T1>
+  inline static void apply_noalias(Mat< std::complex<typename T1::pod_type> >& out, const Proxy<T1>& P, const uword a, const uword b, const bool full_spectrum);
+  
+  template<typename T1>
+  arma_hot inline static void copy_vec(typename T1::pod_type* dest, const Proxy<T1>& P, const uword N, const uword col);
+  };
+
+
+
+class op_fft_r2c
+  : public traits_op_passthru
+  {
+  public:
+  
+  template<typename T1>
+  inline static void apply( Mat< std::complex<typename T1::pod_type> >& out, const mtOp<std::complex<typename T1::pod_type>,T1,op_fft_r2c>& in );
+  };
+
+
+
+class op_ifft_c2r
+  : public traits_op_passthru
+  {
+  public:
+  
+  template<typename T1>
+  inline static void apply( Mat<typename T1::pod_type>& out, const mtOp<typename T1::pod_type,T1,op_ifft_c2r>& in );
+  };
+
+
+
+class op_fft2_real
+  {
+  public:
+  
+  template<typename eT>
+  inline static void apply( Mat< std::complex<eT> >& out, const Mat<eT>& X );
   };
 
 
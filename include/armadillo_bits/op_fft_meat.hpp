@@ -32,102 +32,273 @@ op_fft_real::apply( Mat< std::complex<typename T1::pod_type> >& out, const mtOp<
   {
   arma_extra_debug_sigprint();
   
+  const Proxy<T1> P(in.m);
+  
+  // no need to worry about aliasing, as we're going from a real object to complex complex, which by definition cannot alias
+  
+  op_fft_real::apply_noalias(out, P, in.aux_uword_a, in.aux_uword_b, true);
+  }
+
+
+
+//! transform of real data, using a half-length complex transform where possible;
+//! if full_spectrum is false, only the N/2+1 non-redundant bins are kept
+template<typename T1>
+inline
+void
+op_fft_real::apply_noalias(Mat< std::complex<typename T1::pod_type> >& out, const Proxy<T1>& P, const uword a, const uword b, const bool full_spectrum)
+  {
+  arma_extra_debug_sigprint();
+  
   typedef typename T1::pod_type         in_eT;
   typedef typename std::complex<in_eT> out_eT;
   
-  const Proxy<T1> P(in.m);
-  
   const uword n_rows = P.get_n_rows();
   const uword n_cols = P.get_n_cols();
   const uword n_elem = P.get_n_elem();
   
   const bool is_vec = ( (n_rows == 1) || (n_cols == 1) );
   
-  const uword N_orig = (is_vec)              ? n_elem         : n_rows;
-  const uword N_user = (in.aux_uword_b == 0) ? in.aux_uword_a : N_orig;
+  const uword N_orig = (is_vec) ? n_elem : n_rows;
+  const uword N_user = (b == 0) ? a      : N_orig;
   
-  fft_engine<out_eT,false> worker(N_user);
-  
-  // no need to worry about aliasing, as we're going from a real object to complex complex, which by definition cannot alias
+  const uword n_bins  = N_user/2 + 1;
+  const uword N_out   = (full_spectrum) ? N_user : ( (N_user > 0) ? n_bins : uword(0) );
   
   if(is_vec)
     {
-    (n_cols == 1) ? out.set_size(N_user, 1) : out.set_size(1, N_user);
+    (n_cols == 1) ? out.set_size(N_out, 1) : out.set_size(1, N_out);
+    }
+  else
+    {
+    out.set_size(N_out, n_cols);
+    }
+  
+  if( (out.n_elem == 0) || (N_orig == 0) )
+    {
+    out.zeros();
+    return;
+    }
+  
+  const typename fft_cache< fft_engine_real<out_eT> >::ptr_type worker_ptr = fft_cache< fft_engine_real<out_eT> >::get(N_user);
+  
+  const fft_engine_real<out_eT>& worker = *worker_ptr;
+  
+  podarray<in_eT> data(N_user);
+  
+  in_eT* data_mem = data.memptr();
+  
+  if(N_user > N_orig)  { arrayops::fill_zeros( &data_mem[N_orig], (N_user - N_orig) ); }
+  
+  const uword N      = (std::min)(N_user, N_orig);
+  const uword n_vecs = (is_vec) ? uword(1) : n_cols;
+  
+  for(uword vec_id=0; vec_id < n_vecs; ++vec_id)
+    {
+    op_fft_real::copy_vec(data_mem, P, N, vec_id);
     
-    if( (out.n_elem == 0) || (N_orig == 0) )
-      {
-      out.zeros();
-      return;
-      }
+    out_eT* out_ptr = (is_vec) ? out.memptr() : out.colptr(vec_id);
     
-    if( (N_user == 1) && (N_orig >= 1) )
+    worker.r2c(out_ptr, data_mem);
+    
+    if(full_spectrum)
       {
-      out[0] = out_eT( P[0] );
-      return;
+      // the remaining bins follow from Hermitian symmetry
+      
+      for(uword k=n_bins; k < N_user; ++k)  { out_ptr[k] = std::conj(out_ptr[N_user - k]); }
       }
-    
-    podarray<out_eT> data(N_user);
-    
-    out_eT* data_mem = data.memptr();
-    
-    if(N_user > N_orig)  { arrayops::fill_zeros( &data_mem[N_orig], (N_user - N_orig) ); }
-    
-    const uword N = (std::min)(N_user, N_orig);
-    
+    }
+  }
+
+
+
+template<typename T1>
+arma_hot
+inline
+void
+op_fft_real::copy_vec(typename T1::pod_type* dest, const Proxy<T1>& P, const uword N, const uword col)
+  {
+  arma_extra_debug_sigprint();
+  
+  const uword n_rows = P.get_n_rows();
+  const uword n_cols = P.get_n_cols();
+  
+  if( (n_rows == 1) || (n_cols == 1) )
+    {
     if(Proxy<T1>::use_at == false)
       {
       typename Proxy<T1>::ea_type X = P.get_ea();
       
-      for(uword i=0; i < N; ++i)  { data_mem[i] = out_eT( X[i], in_eT(0) ); }
+      for(uword i=0; i < N; ++i)  { dest[i] = X[i]; }
       }
     else
       {
       if(n_cols == 1)
         {
-        for(uword i=0; i < N; ++i)  { data_mem[i] = out_eT( P.at(i,0), in_eT(0) ); }
+        for(uword i=0; i < N; ++i)  { dest[i] = P.at(i,0); }
         }
       else
         {
-        for(uword i=0; i < N; ++i)  { data_mem[i] = out_eT( P.at(0,i), in_eT(0) ); }
+        for(uword i=0; i < N; ++i)  { dest[i] = P.at(0,i); }
         }
       }
-    
-    worker.run( out.memptr(), data_mem );
     }
   else
     {
-    // process each column seperately
-    
-    out.set_size(N_user, n_cols);
-    
-    if( (out.n_elem == 0) || (N_orig == 0) )
-      {
-      out.zeros();
-      return;
-      }
+    for(uword i=0; i < N; ++i)  { dest[i] = P.at(i,col); }
+    }
+  }
+
+
+
+//
+// op_fft_r2c
+
+
+
+template<typename T1>
+inline
+void
+op_fft_r2c::apply( Mat< std::complex<typename T1::pod_type> >& out, const mtOp<std::complex<typename T1::pod_type>,T1,op_fft_r2c>& in )
+  {
+  arma_extra_debug_sigprint();
+  
+  const Proxy<T1> P(in.m);
+  
+  op_fft_real::apply_noalias(out, P, in.aux_uword_a, in.aux_uword_b, false);
+  }
+
+
+
+//
+// op_ifft_c2r
+
+
+
+template<typename T1>
+inline
+void
+op_ifft_c2r::apply( Mat<typename T1::pod_type>& out, const mtOp<typename T1::pod_type,T1,op_ifft_c2r>& in )
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename T1::elem_type  in_eT;
+  typedef typename T1::pod_type  out_eT;
+  
+  const quasi_unwrap<T1> U(in.m);
+  const Mat<in_eT>&      X = U.M;
+  
+  // no need to worry about aliasing, as we're going from a complex object to a real object
+  
+  const bool is_vec = ( (X.n_rows == 1) || (X.n_cols == 1) );
+  
+  const uword N_orig = (is_vec) ? X.n_elem : X.n_rows;
+  
+  // by default the length of the real output is inferred from the number of bins, assuming an even length
+  const uword N_user = (in.aux_uword_b == 0) ? in.aux_uword_a : ( (N_orig > 0) ? (2*(N_orig - 1)) : uword(0) );
+  
+  if(is_vec)
+    {
+    (X.n_cols == 1) ? out.set_size(N_user, 1) : out.set_size(1, N_user);
+    }
+  else
+    {
+    out.set_size(N_user, X.n_cols);
+    }
+  
+  if( (out.n_elem == 0) || (N_orig == 0) )
+    {
+    out.zeros();
+    return;
+    }
+  
+  const typename fft_cache< fft_engine_real<in_eT> >::ptr_type worker_ptr = fft_cache< fft_engine_real<in_eT> >::get(N_user);
+  
+  const fft_engine_real<in_eT>& worker = *worker_ptr;
+  
+  const uword n_bins = N_user/2 + 1;
+  const uword N      = (std::min)(n_bins, N_orig);
+  const uword n_vecs = (is_vec) ? uword(1) : X.n_cols;
+  
+  podarray<in_eT> data(n_bins);
+  
+  in_eT* data_mem = data.memptr();
+  
+  if(n_bins > N)  { arrayops::fill_zeros( &data_mem[N], (n_bins - N) ); }
+  
+  for(uword vec_id=0; vec_id < n_vecs; ++vec_id)
+    {
+    const in_eT*  X_ptr = (is_vec) ? X.memptr()   : X.colptr(vec_id);
+          out_eT* out_ptr = (is_vec) ? out.memptr() : out.colptr(vec_id);
     
-    if( (N_user == 1) && (N_orig >= 1) )
-      {
-      for(uword col=0; col < n_cols; ++col)  { out.at(0,col) = out_eT( P.at(0,col) ); }
-      
-      return;
-      }
+    arrayops::copy(data_mem, X_ptr, N);
     
-    podarray<out_eT> data(N_user);
+    worker.c2r(out_ptr, data_mem);
+    }
+  }
+
+
+
+//
+// op_fft2_real
+
+
+
+//! 2D transform of a real matrix: the columns are transformed via fft_engine_real,
+//! the rows are transformed only for the non-redundant half of the spectrum,
+//! and the remaining half is obtained from Hermitian symmetry
+template<typename eT>
+inline
+void
+op_fft2_real::apply( Mat< std::complex<eT> >& out, const Mat<eT>& X )
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef std::complex<eT> cx_type;
+  
+  const uword N1 = X.n_rows;
+  const uword N2 = X.n_cols;
+  
+  out.set_size(N1, N2);
+  
+  if(out.n_elem == 0)  { return; }
+  
+  const uword n_bins = N1/2 + 1;
+  
+  const typename fft_cache< fft_engine_real<cx_type> >::ptr_type worker_col_ptr = fft_cache< fft_engine_real<cx_type> >::get(N1);
+  
+  const fft_engine_real<cx_type>& worker_col = *worker_col_ptr;
+  
+  for(uword col=0; col < N2; ++col)  { worker_col.r2c(out.colptr(col), X.colptr(col)); }
+  
+  if(N2 > 1)
+    {
+    const typename fft_cache< fft_engine<cx_type,false> >::ptr_type worker_row_ptr = fft_cache< fft_engine<cx_type,false> >::get(N2);
     
-    out_eT* data_mem = data.memptr();
+    const fft_engine<cx_type,false>& worker_row = *worker_row_ptr;
     
-    if(N_user > N_orig)  { arrayops::fill_zeros( &data_mem[N_orig], (N_user - N_orig) ); }
+    podarray<cx_type> buf_a(N2);
+    podarray<cx_type> buf_b(N2);
     
-    const uword N = (std::min)(N_user, N_orig);
+    cx_type* buf_a_mem = buf_a.memptr();
+    cx_type* buf_b_mem = buf_b.memptr();
     
-    for(uword col=0; col < n_cols; ++col)
+    for(uword row=0; row < n_bins; ++row)
       {
-      for(uword i=0; i < N; ++i)  { data_mem[i] = P.at(i, col); }
+      for(uword col=0; col < N2; ++col)  { buf_a_mem[col] = out.at(row,col); }
+      
+      worker_row.run(buf_b_mem, buf_a_mem);
       
-      worker.run( out.colptr(col), data_mem );
+      for(uword col=0; col < N2; ++col)  { out.at(row,col) = buf_b_mem[col]; }
       }
     }
+  
+  for(uword col=0; col < N2; ++col)
+    {
+    const uword col_src = (col == 0) ? uword(0) : (N2 - col);
+    
+    for(uword row=n_bins; row < N1; ++row)  { out.at(row,col) = std::conj( out.at(N1 - row, col_src) ); }
+    }
   }
 
 
@@ -181,7 +352,9 @@ op_fft_cx::apply_noalias(Mat<typename T1::elem_type>& out, const Proxy<T1>& P, c
   const uword N_orig = (is_vec) ? n_elem : n_rows;
   const uword N_user = (b == 0) ? a      : N_orig;
   
-  fft_engine<eT,inverse> worker(N_user);
+  const typename fft_cache< fft_engine<eT,inverse> >::ptr_type worker_ptr = fft_cache< fft_engine<eT,inverse> >::get(N_user);
+  
+  const fft_engine<eT,inverse>& worker = *worker_ptr;
   
   if(is_vec)
     {
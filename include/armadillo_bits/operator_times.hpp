@@ -489,4 +489,88 @@ operator*
 
 
 
+//! multiplication of a sparse matrix in CSR format and a dense object
+template<typename eT, typename T1>
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && is_same_type<eT, typename T1::elem_type>::value),
+  Mat<eT>
+  >::result
+operator*
+  (
+  const sp_csr<eT>& X,
+  const T1&         Y
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  const quasi_unwrap<T1> U(Y);
+  
+  Mat<eT> out;
+  
+  X.times(out, U.M);
+  
+  return out;
+  }
+
+
+
+//! multiplication of a sparse matrix in BSR format and a dense object
+template<typename eT, typename T1>
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && is_same_type<eT, typename T1::elem_type>::value),
+  Mat<eT>
+  >::result
+operator*
+  (
+  const sp_bsr<eT>& X,
+  const T1&         Y
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  const quasi_unwrap<T1> U(Y);
+  
+  Mat<eT> out;
+  
+  X.times(out, U.M);
+  
+  return out;
+  }
+
+
+
+//! multiplication of a sparse matrix in SELL-C-sigma format and a dense object
+template<typename eT, typename T1>
+inline
+typename
+enable_if2
+  <
+  (is_arma_type<T1>::value && is_same_type<eT, typename T1::elem_type>::value),
+  Mat<eT>
+  >::result
+operator*
+  (
+  const sp_sell<eT>& X,
+  const T1&          Y
+  )
+  {
+  arma_extra_debug_sigprint();
+  
+  const quasi_unwrap<T1> U(Y);
+  
+  Mat<eT> out;
+  
+  X.times(out, U.M);
+  
+  return out;
+  }
+
+
+
 //! @}
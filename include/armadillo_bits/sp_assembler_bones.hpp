@@ -0,0 +1,74 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_assembler
+//! @{
+
+
+//! assembles a sparse matrix from (row, column, value) triplets added concurrently by several threads;
+//! each OpenMP thread appends to its own buffer, so that no locking is required;
+//! finalize() merges the buffers into compressed sparse column format and sums the values of duplicate locations
+template<typename eT>
+class sp_assembler
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  const uword n_rows;
+  const uword n_cols;
+  const uword n_buffers;
+  
+  static constexpr uword mp_threshold = 65536;  //!< min number of triplets for parallelised merging
+  
+  inline ~sp_assembler();
+  
+  inline explicit sp_assembler(const uword in_n_rows, const uword in_n_cols, const uword in_n_buffers = 0);
+  
+  sp_assembler()                               = delete;
+  sp_assembler(const sp_assembler&)            = delete;
+  sp_assembler& operator=(const sp_assembler&) = delete;
+  
+  inline void reserve(const uword n_per_buffer);
+  
+  arma_inline void add(const uword in_row, const uword in_col, const eT in_val);
+  
+  inline uword n_triplets() const;
+  
+  inline void reset();
+  
+  inline void finalize(SpMat<eT>& out);
+  
+  
+  private:
+  
+  struct buffer_type
+    {
+    std::vector<uword> indices;  //!< linear indices, ie. col*n_rows + row
+    std::vector<eT>    values;
+    
+    char padding[64];  //!< keeps the buffers of different threads in separate cache lines
+    };
+  
+  std::vector<buffer_type> buffers;
+  
+  inline static uword sort_and_sum(uword* rows, eT* vals, const uword N, std::vector< std::pair<uword,eT> >& scratch);
+  };
+
+
+
+//! @}
@@ -0,0 +1,363 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_assembler
+//! @{
+
+
+
+template<typename eT>
+inline
+sp_assembler<eT>::~sp_assembler()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+//! in_n_buffers is the max number of threads which add triplets concurrently;
+//! zero selects the max number of OpenMP threads
+template<typename eT>
+inline
+sp_assembler<eT>::sp_assembler(const uword in_n_rows, const uword in_n_cols, const uword in_n_buffers)
+  : n_rows   (in_n_rows)
+  , n_cols   (in_n_cols)
+  , n_buffers(in_n_buffers)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  arma_debug_check
+    (
+      (
+      ( (n_rows > ARMA_MAX_UHWORD) || (n_cols > ARMA_MAX_UHWORD) )
+        ? ( (double(n_rows) * double(n_cols)) > double(ARMA_MAX_UWORD) )
+        : false
+      ),
+    "sp_assembler(): requested size is too large"
+    );
+  
+  if(n_buffers == 0)
+    {
+    #if defined(ARMA_USE_OPENMP)
+      access::rw(n_buffers) = uword( (std::max)(int(1), int(omp_get_max_threads())) );
+    #else
+      access::rw(n_buffers) = uword(1);
+    #endif
+    }
+  
+  buffers.resize(n_buffers);
+  }
+
+
+
+//! reserve memory for n_per_buffer triplets in each buffer
+template<typename eT>
+inline
+void
+sp_assembler<eT>::reserve(const uword n_per_buffer)
+  {
+  arma_extra_debug_sigprint();
+  
+  for(uword b=0; b < n_buffers; ++b)
+    {
+    buffers[b].indices.reserve(n_per_buffer);
+    buffers[b].values.reserve(n_per_buffer);
+    }
+  }
+
+
+
+//! append a triplet to the buffer of the calling OpenMP thread;
+//! safe to call concurrently from the threads of one parallel region (nested parallel regions are not supported)
+template<typename eT>
+arma_inline
+void
+sp_assembler<eT>::add(const uword in_row, const uword in_col, const eT in_val)
+  {
+  #if defined(ARMA_USE_OPENMP)
+    const uword buffer_id = uword(omp_get_thread_num());
+  #else
+    const uword buffer_id = uword(0);
+  #endif
+  
+  arma_debug_check( ((in_row >= n_rows) || (in_col >= n_cols)), "sp_assembler::add(): index out of bounds" );
+  
+  arma_debug_check( (buffer_id >= n_buffers), "sp_assembler::add(): thread number exceeds number of buffers" );
+  
+  if(in_val == eT(0))  { return; }
+  
+  buffer_type& buffer = buffers[buffer_id];
+  
+  buffer.indices.push_back( (in_col * n_rows) + in_row );
+  buffer.values.push_back(in_val);
+  }
+
+
+
+template<typename eT>
+inline
+uword
+sp_assembler<eT>::n_triplets() const
+  {
+  uword N = 0;
+  
+  for(uword b=0; b < n_buffers; ++b)  { N += uword(buffers[b].indices.size()); }
+  
+  return N;
+  }
+
+
+
+//! remove all triplets
+template<typename eT>
+inline
+void
+sp_assembler<eT>::reset()
+  {
+  arma_extra_debug_sigprint();
+  
+  for(uword b=0; b < n_buffers; ++b)
+    {
+    buffers[b].indices.clear();
+    buffers[b].values.clear();
+    }
+  }
+
+
+
+//! out = sparse matrix with the sums of the triplets at each location; the triplets are removed afterwards.
+//! the triplets are distributed into columns by a counting sort, after which each column is sorted by row and its duplicates are summed;
+//! when OpenMP is enabled, the buffers are distributed over threads for the counting sort, and the columns for sorting.
+//! the order in which duplicates are summed is unspecified.
+template<typename eT>
+inline
+void
+sp_assembler<eT>::finalize(SpMat<eT>& out)
+  {
+  arma_extra_debug_sigprint();
+  
+  const uword N = n_triplets();
+  
+  out.zeros(n_rows, n_cols);
+  
+  if(N == 0)  { return; }
+  
+  out.mem_resize(N);
+  
+  uword* out_col_ptrs    = access::rwp(out.col_ptrs);
+  uword* out_row_indices = access::rwp(out.row_indices);
+  eT*    out_values      = access::rwp(out.values);
+  
+  podarray<uword> col_pos(n_cols);
+  podarray<uword> col_counts(n_cols);
+  
+  uword* col_pos_mem = col_pos.memptr();
+  
+  const bool use_mp = (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && (N >= mp_threshold);
+  
+  if(use_mp)
+    {
+    #if defined(ARMA_USE_OPENMP)
+      {
+      arma_extra_debug_print("sp_assembler::finalize(): parallelised");
+      
+      const int   n_threads  = mp_thread_limit::get();
+      const uword chunk_size = (std::max)( uword(1), n_cols / (uword(n_threads) * uword(16)) );
+      
+      #pragma omp parallel num_threads(n_threads)
+        {
+        #pragma omp for schedule(dynamic)
+        for(uword b=0; b < n_buffers; ++b)
+          {
+          const uword* indices = buffers[b].indices.data();
+          const uword  n_b     = uword(buffers[b].indices.size());
+          
+          for(uword i=0; i < n_b; ++i)
+            {
+            const uword col = indices[i] / n_rows;
+            
+            #pragma omp atomic
+            ++out_col_ptrs[col + 1];
+            }
+          }
+        
+        #pragma omp single
+          {
+          for(uword col=0; col < n_cols; ++col)  { out_col_ptrs[col + 1] += out_col_ptrs[col]; }
+          
+          arrayops::copy(col_pos_mem, out_col_ptrs, n_cols);
+          }
+        
+        #pragma omp for schedule(dynamic)
+        for(uword b=0; b < n_buffers; ++b)
+          {
+          const uword* indices = buffers[b].indices.data();
+          const eT*    values  = buffers[b].values.data();
+          const uword  n_b     = uword(buffers[b].indices.size());
+          
+          for(uword i=0; i < n_b; ++i)
+            {
+            const uword index = indices[i];
+            const uword col   = index / n_rows;
+            
+            uword dest;
+            
+            #pragma omp atomic capture
+            dest = col_pos_mem[col]++;
+            
+            out_row_indices[dest] = index - (col * n_rows);
+            out_values     [dest] = values[i];
+            }
+          }
+        
+        std::vector< std::pair<uword,eT> > scratch;
+        
+        #pragma omp for schedule(dynamic, chunk_size)
+        for(uword col=0; col < n_cols; ++col)
+          {
+          const uword offset = out_col_ptrs[col];
+          
+          col_counts[col] = sp_assembler<eT>::sort_and_sum(&(out_row_indices[offset]), &(out_values[offset]), out_col_ptrs[col + 1] - offset, scratch);
+          }
+        }
+      }
+    #endif
+    }
+  else
+    {
+    arma_extra_debug_print("sp_assembler::finalize()");
+    
+    for(uword b=0; b < n_buffers; ++b)
+      {
+      const uword* indices = buffers[b].indices.data();
+      const uword  n_b     = uword(buffers[b].indices.size());
+      
+      for(uword i=0; i < n_b; ++i)  { ++out_col_ptrs[(indices[i] / n_rows) + 1]; }
+      }
+    
+    for(uword col=0; col < n_cols; ++col)  { out_col_ptrs[col + 1] += out_col_ptrs[col]; }
+    
+    arrayops::copy(col_pos_mem, out_col_ptrs, n_cols);
+    
+    for(uword b=0; b < n_buffers; ++b)
+      {
+      const uword* indices = buffers[b].indices.data();
+      const eT*    values  = buffers[b].values.data();
+      const uword  n_b     = uword(buffers[b].indices.size());
+      
+      for(uword i=0; i < n_b; ++i)
+        {
+        const uword index = indices[i];
+        const uword col   = index / n_rows;
+        const uword dest  = col_pos_mem[col]++;
+        
+        out_row_indices[dest] = index - (col * n_rows);
+        out_values     [dest] = values[i];
+        }
+      }
+    
+    std::vector< std::pair<uword,eT> > scratch;
+    
+    for(uword col=0; col < n_cols; ++col)
+      {
+      const uword offset = out_col_ptrs[col];
+      
+      col_counts[col] = sp_assembler<eT>::sort_and_sum(&(out_row_indices[offset]), &(out_values[offset]), out_col_ptrs[col + 1] - offset, scratch);
+      }
+    }
+  
+  // remove the gaps left by duplicates and by sums which evaluated to zero
+  
+  uword pos = 0;
+  
+  for(uword col=0; col < n_cols; ++col)
+    {
+    const uword offset = out_col_ptrs[col];
+    const uword count  = col_counts[col];
+    
+    if(pos != offset)
+      {
+      for(uword i=0; i < count; ++i)
+        {
+        out_row_indices[pos + i] = out_row_indices[offset + i];
+        out_values     [pos + i] = out_values     [offset + i];
+        }
+      }
+    
+    out_col_ptrs[col] = pos;
+    
+    pos += count;
+    }
+  
+  out_col_ptrs[n_cols] = pos;
+  
+  out.mem_resize(pos);
+  
+  reset();
+  }
+
+
+
+//! sort N (row, value) pairs by row, sum the values of equal rows, and keep the non-zero sums at the start;
+//! returns the number of kept pairs
+template<typename eT>
+inline
+uword
+sp_assembler<eT>::sort_and_sum(uword* rows, eT* vals, const uword N, std::vector< std::pair<uword,eT> >& scratch)
+  {
+  bool is_sorted = true;
+  
+  for(uword i=1; i < N; ++i)  { if(rows[i-1] >= rows[i])  { is_sorted = false; break; } }
+  
+  if(is_sorted == false)
+    {
+    scratch.resize(N);
+    
+    for(uword i=0; i < N; ++i)  { scratch[i] = std::pair<uword,eT>(rows[i], vals[i]); }
+    
+    std::sort( scratch.begin(), scratch.end(), [](const std::pair<uword,eT>& a, const std::pair<uword,eT>& b) { return (a.first < b.first); } );
+    
+    uword count = 0;
+    uword i     = 0;
+    
+    while(i < N)
+      {
+      const uword row = scratch[i].first;
+      
+      eT sum = scratch[i].second;
+      
+      for(++i; (i < N) && (scratch[i].first == row); ++i)  { sum += scratch[i].second; }
+      
+      if(sum != eT(0))
+        {
+        rows[count] = row;
+        vals[count] = sum;
+        
+        ++count;
+        }
+      }
+    
+    return count;
+    }
+  
+  // no duplicates; values added via add() are non-zero
+  
+  return N;
+  }
+
+
+
+//! @}
@@ -39,8 +39,14 @@ class sp_auxlib
   template<typename eT, typename T1>
   inline static bool eigs_sym(Col<eT>& eigval, Mat<eT>& eigvec, const SpBase<eT, T1>& X, const uword n_eigvals, const eT sigma, const eigs_opts& opts);
   
+  template<typename eT, typename func_type>
+  inline static bool eigs_sym_func(Col<eT>& eigval, Mat<eT>& eigvec, const func_type& func, const uword n_rows, const uword n_eigvals, const form_type form_val, const eigs_opts& opts);
+  
   template<typename eT>
   inline static bool eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X, const uword n_eigvals, const form_type form_val, const eigs_opts& opts);
+  
+  template<typename eT, typename op_type>
+  inline static bool eigs_sym_newarp_op(Col<eT>& eigval, Mat<eT>& eigvec, const op_type& op, const uword n_eigvals, const form_type form_val, const eigs_opts& opts);
 
   template<typename eT>
   inline static bool eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X, const uword n_eigvals, const eT sigma, const eigs_opts& opts);
@@ -57,9 +63,15 @@ class sp_auxlib
   template<typename T, typename T1>
   inline static bool eigs_gen(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const SpBase<T, T1>& X, const uword n_eigvals, const std::complex<T> sigma, const eigs_opts& opts);
   
+  template<typename T, typename func_type>
+  inline static bool eigs_gen_func(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const func_type& func, const uword n_rows, const uword n_eigvals, const form_type form_val, const eigs_opts& opts);
+  
   template<typename T>
   inline static bool eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const SpMat<T>& X, const uword n_eigvals, const form_type form_val, const eigs_opts& opts);
   
+  template<typename T, typename op_type>
+  inline static bool eigs_gen_newarp_op(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const op_type& op, const uword n_eigvals, const form_type form_val, const eigs_opts& opts);
+  
   template<typename T, bool use_sigma>
   inline static bool eigs_gen_arpack(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const SpMat<T>& X, const uword n_eigvals, const form_type form_val, const std::complex<T> sigma, const eigs_opts& opts);
   
@@ -182,6 +194,8 @@ class superlu_supermatrix_wrangler
   
   inline superlu::SuperMatrix& get_ref();
   inline superlu::SuperMatrix* get_ptr();
+  
+  inline void reset();  //!< destroy the matrix (if any), so that the wrangler can be reused
   };
 
 
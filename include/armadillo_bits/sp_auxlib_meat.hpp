@@ -144,6 +144,38 @@ sp_auxlib::eigs_sym(Col<eT>& eigval, Mat<eT>& eigvec, const SpBase<eT, T1>& X, c
 
 
 
+//! immediate eigendecomposition of a symmetric real operator given as a function object, y = func(x)
+template<typename eT, typename func_type>
+inline
+bool
+sp_auxlib::eigs_sym_func(Col<eT>& eigval, Mat<eT>& eigvec, const func_type& func, const uword n_rows, const uword n_eigvals, const form_type form_val, const eigs_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_NEWARP)
+    {
+    const newarp::FuncMatProd<eT,func_type> op(func, n_rows, n_rows);
+    
+    return sp_auxlib::eigs_sym_newarp_op(eigval, eigvec, op, n_eigvals, form_val, opts);
+    }
+  #else
+    {
+    arma_ignore(eigval);
+    arma_ignore(eigvec);
+    arma_ignore(func);
+    arma_ignore(n_rows);
+    arma_ignore(n_eigvals);
+    arma_ignore(form_val);
+    arma_ignore(opts);
+    
+    arma_stop_logic_error("eigs_sym(): use of NEWARP must be enabled for operators given as function objects");
+    return false;
+    }
+  #endif
+  }
+
+
+
 template<typename eT>
 inline
 bool
@@ -153,12 +185,40 @@ sp_auxlib::eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X,
   
   #if defined(ARMA_USE_NEWARP)
     {
-    arma_debug_check( (form_val != form_lm) && (form_val != form_sm) && (form_val != form_la) && (form_val != form_sa), "eigs_sym(): unknown form specified" );
-    
     if(X.is_square() == false)  { return false; }
     
     const newarp::SparseGenMatProd<eT> op(X);
     
+    return sp_auxlib::eigs_sym_newarp_op(eigval, eigvec, op, n_eigvals, form_val, opts);
+    }
+  #else
+    {
+    arma_ignore(eigval);
+    arma_ignore(eigvec);
+    arma_ignore(X);
+    arma_ignore(n_eigvals);
+    arma_ignore(form_val);
+    arma_ignore(opts);
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+//! eigendecomposition via newarp, using any operator type that provides n_rows, n_cols and perform_op()
+template<typename eT, typename op_type>
+inline
+bool
+sp_auxlib::eigs_sym_newarp_op(Col<eT>& eigval, Mat<eT>& eigvec, const op_type& op, const uword n_eigvals, const form_type form_val, const eigs_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_NEWARP)
+    {
+    arma_debug_check( (form_val != form_lm) && (form_val != form_sm) && (form_val != form_la) && (form_val != form_sa), "eigs_sym(): unknown form specified" );
+    
     arma_debug_check( (n_eigvals >= op.n_rows), "eigs_sym(): n_eigvals must be less than the number of rows in the matrix" );
     
     // If the matrix is empty, the case is trivial.
@@ -215,7 +275,7 @@ sp_auxlib::eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X,
       {
       if(form_val == form_lm)
         {
-        newarp::SymEigsSolver< eT, newarp::EigsSelect::LARGEST_MAGN, newarp::SparseGenMatProd<eT> > eigs(op, n_eigvals, ncv);
+        newarp::SymEigsSolver< eT, newarp::EigsSelect::LARGEST_MAGN, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -224,7 +284,7 @@ sp_auxlib::eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X,
       else
       if(form_val == form_sm)
         {
-        newarp::SymEigsSolver< eT, newarp::EigsSelect::SMALLEST_MAGN, newarp::SparseGenMatProd<eT> > eigs(op, n_eigvals, ncv);
+        newarp::SymEigsSolver< eT, newarp::EigsSelect::SMALLEST_MAGN, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -233,7 +293,7 @@ sp_auxlib::eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X,
       else
       if(form_val == form_la)
         {
-        newarp::SymEigsSolver< eT, newarp::EigsSelect::LARGEST_ALGE, newarp::SparseGenMatProd<eT> > eigs(op, n_eigvals, ncv);
+        newarp::SymEigsSolver< eT, newarp::EigsSelect::LARGEST_ALGE, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -242,7 +302,7 @@ sp_auxlib::eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X,
       else
       if(form_val == form_sa)
         {
-        newarp::SymEigsSolver< eT, newarp::EigsSelect::SMALLEST_ALGE, newarp::SparseGenMatProd<eT> > eigs(op, n_eigvals, ncv);
+        newarp::SymEigsSolver< eT, newarp::EigsSelect::SMALLEST_ALGE, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -265,7 +325,7 @@ sp_auxlib::eigs_sym_newarp(Col<eT>& eigval, Mat<eT>& eigvec, const SpMat<eT>& X,
     {
     arma_ignore(eigval);
     arma_ignore(eigvec);
-    arma_ignore(X);
+    arma_ignore(op);
     arma_ignore(n_eigvals);
     arma_ignore(form_val);
     arma_ignore(opts);
@@ -583,6 +643,38 @@ sp_auxlib::eigs_gen(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigv
 
 
 
+//! immediate eigendecomposition of a general real operator given as a function object, y = func(x)
+template<typename T, typename func_type>
+inline
+bool
+sp_auxlib::eigs_gen_func(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const func_type& func, const uword n_rows, const uword n_eigvals, const form_type form_val, const eigs_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_NEWARP)
+    {
+    const newarp::FuncMatProd<T,func_type> op(func, n_rows, n_rows);
+    
+    return sp_auxlib::eigs_gen_newarp_op(eigval, eigvec, op, n_eigvals, form_val, opts);
+    }
+  #else
+    {
+    arma_ignore(eigval);
+    arma_ignore(eigvec);
+    arma_ignore(func);
+    arma_ignore(n_rows);
+    arma_ignore(n_eigvals);
+    arma_ignore(form_val);
+    arma_ignore(opts);
+    
+    arma_stop_logic_error("eigs_gen(): use of NEWARP must be enabled for operators given as function objects");
+    return false;
+    }
+  #endif
+  }
+
+
+
 template<typename T>
 inline
 bool
@@ -592,12 +684,40 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
   
   #if defined(ARMA_USE_NEWARP)
     {
-    arma_debug_check( (form_val != form_lm) && (form_val != form_sm) && (form_val != form_lr) && (form_val != form_sr) && (form_val != form_li) && (form_val != form_si), "eigs_gen(): unknown form specified" );
-    
     if(X.is_square() == false)  { return false; }
     
     const newarp::SparseGenMatProd<T> op(X);
     
+    return sp_auxlib::eigs_gen_newarp_op(eigval, eigvec, op, n_eigvals, form_val, opts);
+    }
+  #else
+    {
+    arma_ignore(eigval);
+    arma_ignore(eigvec);
+    arma_ignore(X);
+    arma_ignore(n_eigvals);
+    arma_ignore(form_val);
+    arma_ignore(opts);
+    
+    return false;
+    }
+  #endif
+  }
+
+
+
+//! eigendecomposition via newarp, using any operator type that provides n_rows, n_cols and perform_op()
+template<typename T, typename op_type>
+inline
+bool
+sp_auxlib::eigs_gen_newarp_op(Col< std::complex<T> >& eigval, Mat< std::complex<T> >& eigvec, const op_type& op, const uword n_eigvals, const form_type form_val, const eigs_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_NEWARP)
+    {
+    arma_debug_check( (form_val != form_lm) && (form_val != form_sm) && (form_val != form_lr) && (form_val != form_sr) && (form_val != form_li) && (form_val != form_si), "eigs_gen(): unknown form specified" );
+    
     arma_debug_check( (n_eigvals + 1 >= op.n_rows), "eigs_gen(): n_eigvals + 1 must be less than the number of rows in the matrix" );
     
     // If the matrix is empty, the case is trivial.
@@ -654,7 +774,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
       {
       if(form_val == form_lm)
         {
-        newarp::GenEigsSolver< T, newarp::EigsSelect::LARGEST_MAGN, newarp::SparseGenMatProd<T> > eigs(op, n_eigvals, ncv);
+        newarp::GenEigsSolver< T, newarp::EigsSelect::LARGEST_MAGN, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -663,7 +783,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
       else
       if(form_val == form_sm)
         {
-        newarp::GenEigsSolver< T, newarp::EigsSelect::SMALLEST_MAGN, newarp::SparseGenMatProd<T> > eigs(op, n_eigvals, ncv);
+        newarp::GenEigsSolver< T, newarp::EigsSelect::SMALLEST_MAGN, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -672,7 +792,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
       else
       if(form_val == form_lr)
         {
-        newarp::GenEigsSolver< T, newarp::EigsSelect::LARGEST_REAL, newarp::SparseGenMatProd<T> > eigs(op, n_eigvals, ncv);
+        newarp::GenEigsSolver< T, newarp::EigsSelect::LARGEST_REAL, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -681,7 +801,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
       else
       if(form_val == form_sr)
         {
-        newarp::GenEigsSolver< T, newarp::EigsSelect::SMALLEST_REAL, newarp::SparseGenMatProd<T> > eigs(op, n_eigvals, ncv);
+        newarp::GenEigsSolver< T, newarp::EigsSelect::SMALLEST_REAL, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -690,7 +810,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
       else
       if(form_val == form_li)
         {
-        newarp::GenEigsSolver< T, newarp::EigsSelect::LARGEST_IMAG, newarp::SparseGenMatProd<T> > eigs(op, n_eigvals, ncv);
+        newarp::GenEigsSolver< T, newarp::EigsSelect::LARGEST_IMAG, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -699,7 +819,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
       else
       if(form_val == form_si)
         {
-        newarp::GenEigsSolver< T, newarp::EigsSelect::SMALLEST_IMAG, newarp::SparseGenMatProd<T> > eigs(op, n_eigvals, ncv);
+        newarp::GenEigsSolver< T, newarp::EigsSelect::SMALLEST_IMAG, op_type > eigs(op, n_eigvals, ncv);
         eigs.init();
         nconv  = eigs.compute(maxiter, tol);
         eigval = eigs.eigenvalues();
@@ -722,7 +842,7 @@ sp_auxlib::eigs_gen_newarp(Col< std::complex<T> >& eigval, Mat< std::complex<T>
     {
     arma_ignore(eigval);
     arma_ignore(eigvec);
-    arma_ignore(X);
+    arma_ignore(op);
     arma_ignore(n_eigvals);
     arma_ignore(form_val);
     arma_ignore(opts);
@@ -2461,17 +2581,7 @@ superlu_supermatrix_wrangler::~superlu_supermatrix_wrangler()
   {
   arma_extra_debug_sigprint_this(this);
   
-  if(used == false)  { return; }
-  
-  char* m_char   = reinterpret_cast<char*>(&m);
-  bool  all_zero = true;
-  
-  for(size_t i=0; i < sizeof(superlu::SuperMatrix); ++i)
-    {
-    if(m_char[i] != char(0))  { all_zero = false; break; }
-    }
-  
-  if(all_zero == false)  { sp_auxlib::destroy_supermatrix(m); }
+  reset();
   }
 
 inline
@@ -2500,6 +2610,27 @@ superlu_supermatrix_wrangler::get_ptr()
   return &m;
   }
 
+inline
+void
+superlu_supermatrix_wrangler::reset()
+  {
+  if(used == false)  { return; }
+  
+  char* m_char   = reinterpret_cast<char*>(&m);
+  bool  all_zero = true;
+  
+  for(size_t i=0; i < sizeof(superlu::SuperMatrix); ++i)
+    {
+    if(m_char[i] != char(0))  { all_zero = false; break; }
+    }
+  
+  if(all_zero == false)  { sp_auxlib::destroy_supermatrix(m); }
+  
+  arrayops::fill_zeros(reinterpret_cast<char*>(&m), sizeof(superlu::SuperMatrix));
+  
+  used = false;
+  }
+
 
 //
 
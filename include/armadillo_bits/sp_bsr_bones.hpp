@@ -0,0 +1,76 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_bsr
+//! @{
+
+
+//! block compressed sparse row (BSR) representation of a sparse matrix,
+//! where the non-zero elements are grouped into dense square blocks (eg. 3x3 or 6x6 for finite element matrices);
+//! the blocks are stored row by row, and the elements within each block are stored column by column
+template<typename eT>
+class sp_bsr
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  const uword n_rows;
+  const uword n_cols;
+  const uword block_size;
+  const uword n_block_rows;
+  const uword n_block_cols;
+  const uword n_blocks;      //!< number of stored blocks
+  
+  const uword* block_row_ptrs;     //!< n_block_rows+1 elements; the blocks in block row i are at positions block_row_ptrs[i] to block_row_ptrs[i+1]-1
+  const uword* block_col_indices;  //!< block column index of each block; ascending within each block row
+  const eT*    values;             //!< block b occupies values[b*block_size*block_size] onwards
+  
+  static constexpr uword mp_threshold = 16384;  //!< min number of multiply-adds for parallelised multiplication
+  
+  inline ~sp_bsr();
+  
+  inline sp_bsr(const SpMat<eT>& A, const uword in_block_size);
+  
+  inline sp_bsr(const sp_bsr& x);
+  
+  sp_bsr()                         = delete;
+  sp_bsr& operator=(const sp_bsr&) = delete;
+  
+  inline eT at(const uword in_row, const uword in_col) const;
+  
+  inline void times(Mat<eT>& out, const Mat<eT>& X) const;
+  
+  
+  private:
+  
+  podarray<uword> own_block_row_ptrs;
+  podarray<uword> own_block_col_indices;
+  podarray<eT>    own_values;
+  
+  template<uword fixed_size>
+  inline void times_block_rows(Mat<eT>& out, const Mat<eT>& X, const uword block_row_start, const uword block_row_end) const;
+  
+  template<uword fixed_size, uword n_vec>
+  inline void times_cols(Mat<eT>& out, const Mat<eT>& X, const uword col, const uword block_row_start, const uword block_row_end) const;
+  
+  inline void times_block_rows_dispatch(Mat<eT>& out, const Mat<eT>& X, const uword block_row_start, const uword block_row_end) const;
+  };
+
+
+
+//! @}
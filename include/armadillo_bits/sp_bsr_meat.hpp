@@ -0,0 +1,328 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_bsr
+//! @{
+
+
+
+template<typename eT>
+inline
+sp_bsr<eT>::~sp_bsr()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+//! convert A to BSR format; the number of rows and columns of A must be multiples of the block size;
+//! blocks which are only partly occupied by non-zero elements are stored with explicit zeros
+template<typename eT>
+inline
+sp_bsr<eT>::sp_bsr(const SpMat<eT>& A, const uword in_block_size)
+  : n_rows           (A.n_rows)
+  , n_cols           (A.n_cols)
+  , block_size       (in_block_size)
+  , n_block_rows     (0)
+  , n_block_cols     (0)
+  , n_blocks         (0)
+  , block_row_ptrs   (nullptr)
+  , block_col_indices(nullptr)
+  , values           (nullptr)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  arma_debug_check( (block_size == 0), "sp_bsr::sp_bsr(): block_size must be greater than zero" );
+  
+  arma_debug_check( (((n_rows % block_size) != 0) || ((n_cols % block_size) != 0)), "sp_bsr::sp_bsr(): matrix dimensions must be multiples of block_size" );
+  
+  A.sync();
+  
+  access::rw(n_block_rows) = n_rows / block_size;
+  access::rw(n_block_cols) = n_cols / block_size;
+  
+  const uword block_n_elem = block_size * block_size;
+  
+  // first pass: count the blocks in each block row
+  
+  podarray<uword> marker(n_block_rows);  // block column + 1 which last touched each block row
+  
+  marker.zeros();
+  
+  own_block_row_ptrs.zeros(n_block_rows + 1);
+  
+  uword* out_block_row_ptrs = own_block_row_ptrs.memptr();
+  
+  for(uword block_col=0; block_col < n_block_cols; ++block_col)
+    {
+    const uword index_start = A.col_ptrs[ block_col      * block_size];
+    const uword index_end   = A.col_ptrs[(block_col + 1) * block_size];
+    
+    for(uword i = index_start; i < index_end; ++i)
+      {
+      const uword block_row = A.row_indices[i] / block_size;
+      
+      if(marker[block_row] != (block_col + 1))
+        {
+        marker[block_row] = block_col + 1;
+        
+        ++out_block_row_ptrs[block_row + 1];
+        }
+      }
+    }
+  
+  for(uword block_row=0; block_row < n_block_rows; ++block_row)  { out_block_row_ptrs[block_row + 1] += out_block_row_ptrs[block_row]; }
+  
+  access::rw(n_blocks) = out_block_row_ptrs[n_block_rows];
+  
+  // second pass: assign the blocks in order of block column, and copy the elements
+  
+  own_block_col_indices.set_size(n_blocks);
+  own_values.zeros(n_blocks * block_n_elem);
+  
+  uword* out_block_col_indices = own_block_col_indices.memptr();
+  eT*    out_values            = own_values.memptr();
+  
+  podarray<uword> pos(out_block_row_ptrs, n_block_rows);  // next free block in each block row
+  podarray<uword> slot(n_block_rows);                     // block assigned to each block row for the current block column
+  
+  marker.zeros();
+  
+  for(uword block_col=0; block_col < n_block_cols; ++block_col)
+    {
+    for(uword j=0; j < block_size; ++j)
+      {
+      const uword col = block_col * block_size + j;
+      
+      const uword index_end = A.col_ptrs[col + 1];
+      
+      for(uword i = A.col_ptrs[col]; i < index_end; ++i)
+        {
+        const uword row       = A.row_indices[i];
+        const uword block_row = row / block_size;
+        
+        if(marker[block_row] != (block_col + 1))
+          {
+          marker[block_row] = block_col + 1;
+          
+          slot[block_row] = pos[block_row]++;
+          
+          out_block_col_indices[slot[block_row]] = block_col;
+          }
+        
+        out_values[slot[block_row] * block_n_elem + (row % block_size) + j * block_size] = A.values[i];
+        }
+      }
+    }
+  
+  block_row_ptrs    = out_block_row_ptrs;
+  block_col_indices = out_block_col_indices;
+  values            = out_values;
+  }
+
+
+
+template<typename eT>
+inline
+sp_bsr<eT>::sp_bsr(const sp_bsr<eT>& x)
+  : n_rows               (x.n_rows)
+  , n_cols               (x.n_cols)
+  , block_size           (x.block_size)
+  , n_block_rows         (x.n_block_rows)
+  , n_block_cols         (x.n_block_cols)
+  , n_blocks             (x.n_blocks)
+  , block_row_ptrs       (nullptr)
+  , block_col_indices    (nullptr)
+  , values               (nullptr)
+  , own_block_row_ptrs   (x.own_block_row_ptrs)
+  , own_block_col_indices(x.own_block_col_indices)
+  , own_values           (x.own_values)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  block_row_ptrs    = own_block_row_ptrs.memptr();
+  block_col_indices = own_block_col_indices.memptr();
+  values            = own_values.memptr();
+  }
+
+
+
+template<typename eT>
+inline
+eT
+sp_bsr<eT>::at(const uword in_row, const uword in_col) const
+  {
+  arma_debug_check( ((in_row >= n_rows) || (in_col >= n_cols)), "sp_bsr::at(): index out of bounds" );
+  
+  const uword block_row = in_row / block_size;
+  const uword block_col = in_col / block_size;
+  
+  const uword* start_ptr = &(block_col_indices[block_row_ptrs[block_row    ]]);
+  const uword*   end_ptr = &(block_col_indices[block_row_ptrs[block_row + 1]]);
+  
+  const uword* pos_ptr = std::lower_bound(start_ptr, end_ptr, block_col);
+  
+  if( (pos_ptr == end_ptr) || ((*pos_ptr) != block_col) )  { return eT(0); }
+  
+  const uword block = uword(pos_ptr - block_col_indices);
+  
+  return values[block * block_size * block_size + (in_row % block_size) + (in_col % block_size) * block_size];
+  }
+
+
+
+//! out = A*X, where A is this matrix; the block rows of A are distributed over threads when OpenMP is enabled
+template<typename eT>
+inline
+void
+sp_bsr<eT>::times(Mat<eT>& out, const Mat<eT>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_assert_mul_size(n_rows, n_cols, X.n_rows, X.n_cols, "matrix multiplication");
+  
+  out.set_size(n_rows, X.n_cols);
+  
+  const double n_ops = double(n_blocks) * double(block_size * block_size) * double(X.n_cols);
+  
+  if( (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && (n_ops >= double(mp_threshold)) )
+    {
+    #if defined(ARMA_USE_OPENMP)
+      {
+      const int   n_threads          = mp_thread_limit::get();
+      const uword n_block_rows_chunk = 64;
+      const uword n_chunks           = (n_block_rows + n_block_rows_chunk - 1) / n_block_rows_chunk;
+      
+      #pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+      for(uword chunk=0; chunk < n_chunks; ++chunk)
+        {
+        const uword block_row_start = chunk * n_block_rows_chunk;
+        const uword block_row_end   = (std::min)(block_row_start + n_block_rows_chunk, n_block_rows);
+        
+        times_block_rows_dispatch(out, X, block_row_start, block_row_end);
+        }
+      }
+    #endif
+    }
+  else
+    {
+    times_block_rows_dispatch(out, X, 0, n_block_rows);
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_bsr<eT>::times_block_rows_dispatch(Mat<eT>& out, const Mat<eT>& X, const uword block_row_start, const uword block_row_end) const
+  {
+  switch(block_size)
+    {
+    case 2:  times_block_rows<2>(out, X, block_row_start, block_row_end);  break;
+    case 3:  times_block_rows<3>(out, X, block_row_start, block_row_end);  break;
+    case 4:  times_block_rows<4>(out, X, block_row_start, block_row_end);  break;
+    case 6:  times_block_rows<6>(out, X, block_row_start, block_row_end);  break;
+    default: times_block_rows<0>(out, X, block_row_start, block_row_end);
+    }
+  }
+
+
+
+//! fixed_size is the block size known at compile time, or 0 if it is only known at run time;
+//! the columns of X are processed in groups of 4, so that each block of A is loaded once per group
+template<typename eT>
+template<uword fixed_size>
+inline
+void
+sp_bsr<eT>::times_block_rows(Mat<eT>& out, const Mat<eT>& X, const uword block_row_start, const uword block_row_end) const
+  {
+  const uword X_n_cols = X.n_cols;
+  
+  uword col = 0;
+  
+  for(; (col+4) <= X_n_cols; col += 4)  { times_cols<fixed_size,4>(out, X, col, block_row_start, block_row_end); }
+  for(;  col    <  X_n_cols; col += 1)  { times_cols<fixed_size,1>(out, X, col, block_row_start, block_row_end); }
+  }
+
+
+
+template<typename eT>
+template<uword fixed_size, uword n_vec>
+inline
+void
+sp_bsr<eT>::times_cols(Mat<eT>& out, const Mat<eT>& X, const uword col, const uword block_row_start, const uword block_row_end) const
+  {
+  const uword bs = (fixed_size > 0) ? fixed_size : block_size;
+  
+  const uword block_n_elem = bs * bs;
+  
+  podarray<eT> acc_buffer( (fixed_size > 0) ? uword(0) : (bs * n_vec) );
+  
+  eT  acc_local[ (fixed_size > 0) ? (fixed_size * n_vec) : 1 ];
+  eT* acc = (fixed_size > 0) ? acc_local : acc_buffer.memptr();
+  
+  const eT* X_colptrs[n_vec];
+        eT* out_colptrs[n_vec];
+  
+  for(uword c=0; c < n_vec; ++c)
+    {
+      X_colptrs[c] =   X.colptr(col + c);
+    out_colptrs[c] = out.colptr(col + c);
+    }
+  
+  for(uword block_row = block_row_start; block_row < block_row_end; ++block_row)
+    {
+    for(uword i=0; i < (bs * n_vec); ++i)  { acc[i] = eT(0); }
+    
+    const uword block_end = block_row_ptrs[block_row + 1];
+    
+    for(uword block = block_row_ptrs[block_row]; block < block_end; ++block)
+      {
+      const eT*   block_mem = &(values[block * block_n_elem]);
+      const uword X_offset  = block_col_indices[block] * bs;
+      
+      for(uword j=0; j < bs; ++j)
+        {
+        const eT* block_colptr = &(block_mem[j*bs]);
+        
+        eT X_vals[n_vec];
+        
+        for(uword c=0; c < n_vec; ++c)  { X_vals[c] = X_colptrs[c][X_offset + j]; }
+        
+        for(uword i=0; i < bs; ++i)
+          {
+          const eT A_val = block_colptr[i];
+          
+          eT* acc_i = &(acc[i*n_vec]);
+          
+          for(uword c=0; c < n_vec; ++c)  { acc_i[c] += A_val * X_vals[c]; }
+          }
+        }
+      }
+    
+    for(uword c=0; c < n_vec; ++c)
+      {
+      eT* out_mem = &(out_colptrs[c][block_row * bs]);
+      
+      for(uword i=0; i < bs; ++i)  { out_mem[i] = acc[i*n_vec + c]; }
+      }
+    }
+  }
+
+
+
+//! @}
@@ -0,0 +1,77 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_csr
+//! @{
+
+
+//! compressed sparse row (CSR) representation of a sparse matrix,
+//! for row-oriented access and fast multiplication with dense matrices.
+//! as the CSC arrays of a sparse matrix A are the CSR arrays of its transpose,
+//! constructing from A.st() (or A.t() for real matrices) uses the memory of A directly;
+//! in that case A must not be changed or destroyed while the sp_csr object is in use.
+template<typename eT>
+class sp_csr
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  const uword n_rows;
+  const uword n_cols;
+  const uword n_nonzero;
+  
+  const uword* row_ptrs;     //!< n_rows+1 elements; the elements of row i are at positions row_ptrs[i] to row_ptrs[i+1]-1
+  const uword* col_indices;  //!< column index of each element; ascending within each row
+  const eT*    values;
+  
+  static constexpr uword mp_threshold = 16384;  //!< min number of multiply-adds for parallelised multiplication
+  
+  inline ~sp_csr();
+  
+  inline explicit sp_csr(const SpMat<eT>& A);
+  inline explicit sp_csr(const SpOp<SpMat<eT>, spop_strans>& X);
+  inline explicit sp_csr(const SpOp<SpMat<eT>, spop_htrans>& X);
+  
+  inline sp_csr(const sp_csr& x);
+  
+  sp_csr()                         = delete;
+  sp_csr& operator=(const sp_csr&) = delete;
+  
+  inline bool is_view() const;
+  
+  inline eT at(const uword in_row, const uword in_col) const;
+  
+  inline uword row_n_nonzero(const uword in_row) const;
+  
+  inline void times(Mat<eT>& out, const Mat<eT>& X) const;
+  
+  
+  private:
+  
+  podarray<uword> own_row_ptrs;
+  podarray<uword> own_col_indices;
+  podarray<eT>    own_values;
+  
+  inline void init_view(const SpMat<eT>& A);
+  
+  inline void times_rows(Mat<eT>& out, const Mat<eT>& X, const uword row_start, const uword row_end) const;
+  };
+
+
+
+//! @}
@@ -0,0 +1,330 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_csr
+//! @{
+
+
+
+template<typename eT>
+inline
+sp_csr<eT>::~sp_csr()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+//! convert the CSC representation of A to CSR, via a counting sort of the row indices
+template<typename eT>
+inline
+sp_csr<eT>::sp_csr(const SpMat<eT>& A)
+  : n_rows     (A.n_rows)
+  , n_cols     (A.n_cols)
+  , n_nonzero  (0)
+  , row_ptrs   (nullptr)
+  , col_indices(nullptr)
+  , values     (nullptr)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  A.sync();
+  
+  access::rw(n_nonzero) = A.n_nonzero;
+  
+  own_row_ptrs.zeros(n_rows + 1);
+  own_col_indices.set_size(n_nonzero);
+  own_values.set_size(n_nonzero);
+  
+  uword* out_row_ptrs    = own_row_ptrs.memptr();
+  uword* out_col_indices = own_col_indices.memptr();
+  eT*    out_values      = own_values.memptr();
+  
+  for(uword i=0; i < n_nonzero; ++i)  { ++out_row_ptrs[A.row_indices[i] + 1]; }
+  
+  for(uword row=0; row < n_rows; ++row)  { out_row_ptrs[row + 1] += out_row_ptrs[row]; }
+  
+  podarray<uword> pos(out_row_ptrs, n_rows);
+  
+  for(uword col=0; col < n_cols; ++col)
+    {
+    const uword index_end = A.col_ptrs[col + 1];
+    
+    for(uword i = A.col_ptrs[col]; i < index_end; ++i)
+      {
+      const uword dest = pos[A.row_indices[i]]++;
+      
+      out_col_indices[dest] = col;
+      out_values     [dest] = A.values[i];
+      }
+    }
+  
+  row_ptrs    = out_row_ptrs;
+  col_indices = out_col_indices;
+  values      = out_values;
+  }
+
+
+
+//! CSR representation of A.st(), using the memory of A
+template<typename eT>
+inline
+sp_csr<eT>::sp_csr(const SpOp<SpMat<eT>, spop_strans>& X)
+  : n_rows     (X.m.n_cols)
+  , n_cols     (X.m.n_rows)
+  , n_nonzero  (0)
+  , row_ptrs   (nullptr)
+  , col_indices(nullptr)
+  , values     (nullptr)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  init_view(X.m);
+  }
+
+
+
+//! CSR representation of A.t(), using the memory of A for real matrices;
+//! for complex matrices the conjugated values are stored separately
+template<typename eT>
+inline
+sp_csr<eT>::sp_csr(const SpOp<SpMat<eT>, spop_htrans>& X)
+  : n_rows     (X.m.n_cols)
+  , n_cols     (X.m.n_rows)
+  , n_nonzero  (0)
+  , row_ptrs   (nullptr)
+  , col_indices(nullptr)
+  , values     (nullptr)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  init_view(X.m);
+  
+  if(is_cx<eT>::yes)
+    {
+    own_values.set_size(n_nonzero);
+    
+    eT* out_values = own_values.memptr();
+    
+    for(uword i=0; i < n_nonzero; ++i)  { out_values[i] = access::alt_conj(values[i]); }
+    
+    values = out_values;
+    }
+  }
+
+
+
+template<typename eT>
+inline
+sp_csr<eT>::sp_csr(const sp_csr<eT>& x)
+  : n_rows         (x.n_rows)
+  , n_cols         (x.n_cols)
+  , n_nonzero      (x.n_nonzero)
+  , row_ptrs       (x.row_ptrs)
+  , col_indices    (x.col_indices)
+  , values         (x.values)
+  , own_row_ptrs   (x.own_row_ptrs)
+  , own_col_indices(x.own_col_indices)
+  , own_values     (x.own_values)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  if(x.row_ptrs    == x.own_row_ptrs.memptr()   )  { row_ptrs    = own_row_ptrs.memptr();    }
+  if(x.col_indices == x.own_col_indices.memptr())  { col_indices = own_col_indices.memptr(); }
+  if(x.values      == x.own_values.memptr()     )  { values      = own_values.memptr();      }
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_csr<eT>::init_view(const SpMat<eT>& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  A.sync();
+  
+  access::rw(n_nonzero) = A.n_nonzero;
+  
+  row_ptrs    = A.col_ptrs;
+  col_indices = A.row_indices;
+  values      = A.values;
+  }
+
+
+
+//! true if the row pointers and column indices are those of a SpMat object
+template<typename eT>
+inline
+bool
+sp_csr<eT>::is_view() const
+  {
+  return (row_ptrs != own_row_ptrs.memptr());
+  }
+
+
+
+template<typename eT>
+inline
+uword
+sp_csr<eT>::row_n_nonzero(const uword in_row) const
+  {
+  arma_debug_check( (in_row >= n_rows), "sp_csr::row_n_nonzero(): out of bounds" );
+  
+  return row_ptrs[in_row + 1] - row_ptrs[in_row];
+  }
+
+
+
+template<typename eT>
+inline
+eT
+sp_csr<eT>::at(const uword in_row, const uword in_col) const
+  {
+  arma_debug_check( ((in_row >= n_rows) || (in_col >= n_cols)), "sp_csr::at(): index out of bounds" );
+  
+  const uword* start_ptr = &(col_indices[row_ptrs[in_row    ]]);
+  const uword*   end_ptr = &(col_indices[row_ptrs[in_row + 1]]);
+  
+  const uword* pos_ptr = std::lower_bound(start_ptr, end_ptr, in_col);
+  
+  return ( (pos_ptr != end_ptr) && ((*pos_ptr) == in_col) ) ? values[pos_ptr - col_indices] : eT(0);
+  }
+
+
+
+//! out = A*X, where A is this matrix; the rows of A are distributed over threads when OpenMP is enabled
+template<typename eT>
+inline
+void
+sp_csr<eT>::times(Mat<eT>& out, const Mat<eT>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_assert_mul_size(n_rows, n_cols, X.n_rows, X.n_cols, "matrix multiplication");
+  
+  out.set_size(n_rows, X.n_cols);
+  
+  if( (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && ((double(n_nonzero) * double(X.n_cols)) >= double(mp_threshold)) )
+    {
+    #if defined(ARMA_USE_OPENMP)
+      {
+      const int   n_threads    = mp_thread_limit::get();
+      const uword n_block_rows = 256;
+      const uword n_blocks     = (n_rows + n_block_rows - 1) / n_block_rows;
+      
+      #pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+      for(uword block=0; block < n_blocks; ++block)
+        {
+        const uword row_start = block * n_block_rows;
+        const uword row_end   = (std::min)(row_start + n_block_rows, n_rows);
+        
+        times_rows(out, X, row_start, row_end);
+        }
+      }
+    #endif
+    }
+  else
+    {
+    times_rows(out, X, 0, n_rows);
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_csr<eT>::times_rows(Mat<eT>& out, const Mat<eT>& X, const uword row_start, const uword row_end) const
+  {
+  const uword X_n_cols = X.n_cols;
+  
+  uword col = 0;
+  
+  // blocks of 4 columns of X, so that each element of A is loaded once per block
+  
+  for(; (col+4) <= X_n_cols; col += 4)
+    {
+    const eT* X_col0 = X.colptr(col  );
+    const eT* X_col1 = X.colptr(col+1);
+    const eT* X_col2 = X.colptr(col+2);
+    const eT* X_col3 = X.colptr(col+3);
+    
+    eT* out_col0 = out.colptr(col  );
+    eT* out_col1 = out.colptr(col+1);
+    eT* out_col2 = out.colptr(col+2);
+    eT* out_col3 = out.colptr(col+3);
+    
+    for(uword row = row_start; row < row_end; ++row)
+      {
+      const uword index_end = row_ptrs[row + 1];
+      
+      eT acc0 = eT(0);
+      eT acc1 = eT(0);
+      eT acc2 = eT(0);
+      eT acc3 = eT(0);
+      
+      for(uword i = row_ptrs[row]; i < index_end; ++i)
+        {
+        const eT    val = values[i];
+        const uword k   = col_indices[i];
+        
+        acc0 += val * X_col0[k];
+        acc1 += val * X_col1[k];
+        acc2 += val * X_col2[k];
+        acc3 += val * X_col3[k];
+        }
+      
+      out_col0[row] = acc0;
+      out_col1[row] = acc1;
+      out_col2[row] = acc2;
+      out_col3[row] = acc3;
+      }
+    }
+  
+  // remaining columns; two partial sums shorten the chain of dependent additions
+  
+  for(; col < X_n_cols; ++col)
+    {
+    const eT*   X_colptr = X.colptr(col);
+          eT* out_colptr = out.colptr(col);
+    
+    for(uword row = row_start; row < row_end; ++row)
+      {
+      const uword index_end = row_ptrs[row + 1];
+      
+      eT acc0 = eT(0);
+      eT acc1 = eT(0);
+      
+      uword i = row_ptrs[row];
+      
+      for(; (i+1) < index_end; i += 2)
+        {
+        acc0 += values[i  ] * X_colptr[col_indices[i  ]];
+        acc1 += values[i+1] * X_colptr[col_indices[i+1]];
+        }
+      
+      if(i < index_end)  { acc0 += values[i] * X_colptr[col_indices[i]]; }
+      
+      out_colptr[row] = acc0 + acc1;
+      }
+    }
+  }
+
+
+
+//! @}
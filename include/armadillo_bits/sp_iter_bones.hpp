@@ -0,0 +1,119 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_iter
+//! @{
+
+
+//! information about the progress of pcg(), bicgstab() and gmres()
+struct iter_info
+  {
+  uword        n_iter       = 0;      //!< number of iterations performed
+  double       rel_residual = 0.0;    //!< final relative residual norm, norm(b - A*x) / norm(b)
+  bool         converged    = false;
+  Col<double>  history;               //!< relative residual norm before the first iteration and after each iteration
+  };
+
+
+
+//! the system matrix, as seen by the iterative solvers: apply() computes out = A*in
+
+template<typename eT>
+class sp_iter_op_sparse
+  {
+  public:
+  
+  const SpMat<eT>& A;
+  
+  inline explicit sp_iter_op_sparse(const SpMat<eT>& in_A) : A(in_A) { A.sync(); }
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const;
+  };
+
+
+template<typename eT>
+class sp_iter_op_dense
+  {
+  public:
+  
+  const Mat<eT>& A;
+  
+  inline explicit sp_iter_op_dense(const Mat<eT>& in_A) : A(in_A) {}
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const  { out = A * in; }
+  };
+
+
+//! any callable object (eg. a lambda function) which takes a Col<eT> and returns the product with the system matrix
+template<typename eT, typename func_type>
+class sp_iter_op_func
+  {
+  public:
+  
+  const func_type& func;
+  
+  inline explicit sp_iter_op_func(const func_type& in_func) : func(in_func) {}
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const;
+  };
+
+
+
+class sp_iter
+  {
+  public:
+  
+  static constexpr uword solver_pcg      = 1;
+  static constexpr uword solver_bicgstab = 2;
+  static constexpr uword solver_gmres    = 3;
+  
+  template<typename T1, typename T2>
+  inline static bool apply(const uword solver, Col<typename T2::elem_type>& x, iter_info& info, const T1& A, const Base<typename T2::elem_type,T2>& b_expr, const char* precond, const iter_opts& opts, const char* caller);
+  
+  template<typename eT, typename op_type, typename precond_type>
+  inline static bool pcg(Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts);
+  
+  template<typename eT, typename op_type, typename precond_type>
+  inline static bool bicgstab(Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts);
+  
+  template<typename eT, typename op_type, typename precond_type>
+  inline static bool gmres(Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts);
+  
+  
+  private:
+  
+  template<typename eT, typename T1>
+  inline static typename enable_if2< is_arma_sparse_type<T1>::value, bool >::result
+  dispatch(const uword solver, Col<eT>& x, iter_info& info, const T1& A_expr, const Col<eT>& b, const char* precond, const iter_opts& opts, const char* caller);
+  
+  template<typename eT, typename T1>
+  inline static typename enable_if2< is_arma_type<T1>::value, bool >::result
+  dispatch(const uword solver, Col<eT>& x, iter_info& info, const T1& A_expr, const Col<eT>& b, const char* precond, const iter_opts& opts, const char* caller);
+  
+  template<typename eT, typename T1>
+  inline static typename enable_if2< (is_arma_sparse_type<T1>::value == false) && (is_arma_type<T1>::value == false), bool >::result
+  dispatch(const uword solver, Col<eT>& x, iter_info& info, const T1& A_func, const Col<eT>& b, const char* precond, const iter_opts& opts, const char* caller);
+  
+  template<typename eT, typename op_type, typename precond_type>
+  inline static bool run(const uword solver, Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts, const char* caller);
+  
+  template<typename eT, typename op_type>
+  inline static typename get_pod_type<eT>::result init(Col<eT>& x, Col<eT>& r, const op_type& A, const Col<eT>& b, const iter_opts& opts);
+  };
+
+
+
+//! @}
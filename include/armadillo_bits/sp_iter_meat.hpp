@@ -0,0 +1,590 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_iter
+//! @{
+
+
+
+//! uses the CSC kernels of sparse * dense directly on A, so no second copy of A is kept during the solve
+template<typename eT>
+inline
+void
+sp_iter_op_sparse<eT>::apply(Col<eT>& out, const Col<eT>& in) const
+  {
+  spglue_times_misc::sparse_times_dense(out, A, in);
+  }
+
+
+
+template<typename eT, typename func_type>
+inline
+void
+sp_iter_op_func<eT,func_type>::apply(Col<eT>& out, const Col<eT>& in) const
+  {
+  out = func(in);
+  
+  arma_debug_check( (out.n_elem != in.n_elem), "iterative solver: function for the system matrix returned a vector with incorrect size" );
+  }
+
+
+
+template<typename T1, typename T2>
+inline
+bool
+sp_iter::apply(const uword solver, Col<typename T2::elem_type>& x, iter_info& info, const T1& A, const Base<typename T2::elem_type,T2>& b_expr, const char* precond, const iter_opts& opts, const char* caller)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename T2::elem_type eT;
+  
+  info = iter_info();
+  
+  const quasi_unwrap<T2> UB(b_expr.get_ref());
+  const Mat<eT>& BB    = UB.M;
+  
+  arma_debug_check( ((BB.is_vec() == false) && (BB.is_empty() == false)), caller, ": b must be a vector" );
+  
+  arma_debug_check( (opts.warm_start && (x.n_elem != BB.n_elem)), caller, ": for warm start, the number of elements in x and b must be the same" );
+  
+  if(UB.is_alias(x))
+    {
+    const Col<eT> b(BB.memptr(), BB.n_elem);
+    
+    if(opts.warm_start == false)  { x.zeros(b.n_elem); }
+    
+    return sp_iter::dispatch(solver, x, info, A, b, precond, opts, caller);
+    }
+  
+  const Col<eT> b(const_cast<eT*>(BB.memptr()), BB.n_elem, false, true);
+  
+  if(opts.warm_start == false)  { x.zeros(b.n_elem); }
+  
+  return sp_iter::dispatch(solver, x, info, A, b, precond, opts, caller);
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< is_arma_sparse_type<T1>::value, bool >::result
+sp_iter::dispatch(const uword solver, Col<eT>& x, iter_info& info, const T1& A_expr, const Col<eT>& b, const char* precond, const iter_opts& opts, const char* caller)
+  {
+  arma_extra_debug_sigprint();
+  
+  const unwrap_spmat<T1> U(A_expr);
+  const SpMat<eT>& A   = U.M;
+  
+  arma_debug_check( (A.n_rows != A.n_cols),   caller, ": matrix A must be square sized"                 );
+  arma_debug_check( (A.n_rows != b.n_elem),   caller, ": number of rows in A and b must be the same" );
+  
+  const char sig0 = (precond != nullptr) ? precond[0] : char(0);
+  const char sig1 = (sig0    != char(0)) ? precond[1] : char(0);
+  
+  const bool use_none   = (sig0 == 'n') || (sig0 == char(0));
+  const bool use_jacobi = (sig0 == 'j');
+  const bool use_ilu0   = (sig0 == 'i') && (sig1 == 'l');
+  const bool use_ic0    = (sig0 == 'i') && (sig1 == 'c');
+  
+  arma_debug_check( ((use_none || use_jacobi || use_ilu0 || use_ic0) == false), caller, ": unknown preconditioner" );
+  
+  const sp_iter_op_sparse<eT> op(A);
+  
+  if(use_jacobi)
+    {
+    sp_precond_jacobi<eT> M;
+    
+    if(M.init(A) == false)  { arma_debug_warn(caller, ": jacobi preconditioner: zero element on the diagonal"); x.soft_reset(); return false; }
+    
+    return sp_iter::run(solver, x, info, op, M, b, opts, caller);
+    }
+  
+  if(use_ilu0)
+    {
+    sp_precond_ilu0<eT> M;
+    
+    if(M.init(A) == false)  { arma_debug_warn(caller, ": ilu0 preconditioner: zero pivot or missing diagonal element"); x.soft_reset(); return false; }
+    
+    return sp_iter::run(solver, x, info, op, M, b, opts, caller);
+    }
+  
+  if(use_ic0)
+    {
+    sp_precond_ic0<eT> M;
+    
+    if(M.init(A) == false)  { arma_debug_warn(caller, ": ic0 preconditioner: non-positive pivot or missing diagonal element"); x.soft_reset(); return false; }
+    
+    return sp_iter::run(solver, x, info, op, M, b, opts, caller);
+    }
+  
+  return sp_iter::run(solver, x, info, op, sp_precond_none<eT>(), b, opts, caller);
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< is_arma_type<T1>::value, bool >::result
+sp_iter::dispatch(const uword solver, Col<eT>& x, iter_info& info, const T1& A_expr, const Col<eT>& b, const char* precond, const iter_opts& opts, const char* caller)
+  {
+  arma_extra_debug_sigprint();
+  
+  const quasi_unwrap<T1> U(A_expr);
+  const Mat<eT>& A     = U.M;
+  
+  arma_debug_check( (A.n_rows != A.n_cols), caller, ": matrix A must be square sized"              );
+  arma_debug_check( (A.n_rows != b.n_elem), caller, ": number of rows in A and b must be the same" );
+  
+  arma_debug_check( ((precond != nullptr) && (precond[0] != 'n') && (precond[0] != char(0))), caller, ": preconditioners require a sparse matrix" );
+  
+  const sp_iter_op_dense<eT> op(A);
+  
+  return sp_iter::run(solver, x, info, op, sp_precond_none<eT>(), b, opts, caller);
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< (is_arma_sparse_type<T1>::value == false) && (is_arma_type<T1>::value == false), bool >::result
+sp_iter::dispatch(const uword solver, Col<eT>& x, iter_info& info, const T1& A_func, const Col<eT>& b, const char* precond, const iter_opts& opts, const char* caller)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( ((precond != nullptr) && (precond[0] != 'n') && (precond[0] != char(0))), caller, ": preconditioners require a sparse matrix" );
+  
+  const sp_iter_op_func<eT,T1> op(A_func);
+  
+  return sp_iter::run(solver, x, info, op, sp_precond_none<eT>(), b, opts, caller);
+  }
+
+
+
+template<typename eT, typename op_type, typename precond_type>
+inline
+bool
+sp_iter::run(const uword solver, Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts, const char* caller)
+  {
+  arma_extra_debug_sigprint();
+  
+  bool status = false;
+  
+  if(solver == solver_pcg     )  { status = sp_iter::pcg     (x, info, A, M, b, opts); }
+  if(solver == solver_bicgstab)  { status = sp_iter::bicgstab(x, info, A, M, b, opts); }
+  if(solver == solver_gmres   )  { status = sp_iter::gmres   (x, info, A, M, b, opts); }
+  
+  if(status == false)
+    {
+    std::ostringstream tmp;
+    
+    tmp << caller << ": no convergence after " << info.n_iter << " iterations (relative residual: " << info.rel_residual << ')';
+    
+    arma_debug_warn(tmp.str());
+    }
+  
+  return status;
+  }
+
+
+
+//! r = b - A*x; returns norm(b)
+template<typename eT, typename op_type>
+inline
+typename get_pod_type<eT>::result
+sp_iter::init(Col<eT>& x, Col<eT>& r, const op_type& A, const Col<eT>& b, const iter_opts& opts)
+  {
+  if(opts.warm_start)
+    {
+    A.apply(r, x);
+    
+    r = b - r;
+    }
+  else
+    {
+    r = b;
+    }
+  
+  return norm(b, 2);
+  }
+
+
+
+//! preconditioned conjugate gradient method, for symmetric/hermitian positive definite A
+template<typename eT, typename op_type, typename precond_type>
+inline
+bool
+sp_iter::pcg(Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename get_pod_type<eT>::result T;
+  
+  Col<eT> r;
+  Col<eT> z;
+  Col<eT> p;
+  Col<eT> q;
+  
+  const T b_norm = sp_iter::init(x, r, A, b, opts);
+  
+  if(b_norm == T(0))  { x.zeros(b.n_elem); info.converged = true; info.history.zeros(1); return true; }
+  
+  std::vector<double> history;
+  
+  T res = norm(r, 2) / b_norm;
+  
+  history.push_back(double(res));
+  
+  bool converged = (res <= T(opts.tol));
+  
+  if(converged == false)
+    {
+    M.apply(z, r);
+    
+    p = z;
+    
+    eT rz = cdot(r, z);
+    
+    for(uword iter=1; iter <= uword(opts.max_iter); ++iter)
+      {
+      A.apply(q, p);
+      
+      const eT pq = cdot(p, q);
+      
+      if(pq == eT(0))  { break; }  // breakdown
+      
+      const eT alpha = rz / pq;
+      
+      x += alpha * p;
+      r -= alpha * q;
+      
+      res = norm(r, 2) / b_norm;
+      
+      history.push_back(double(res));
+      
+      info.n_iter = iter;
+      
+      if(res <= T(opts.tol))  { converged = true; break; }
+      
+      M.apply(z, r);
+      
+      const eT rz_new = cdot(r, z);
+      
+      const eT beta = rz_new / rz;
+      
+      p = z + beta * p;
+      
+      rz = rz_new;
+      }
+    }
+  
+  info.converged    = converged;
+  info.rel_residual = double(res);
+  info.history      = Col<double>(history);
+  
+  return converged;
+  }
+
+
+
+//! stabilised bi-conjugate gradient method (right preconditioned), for general square A
+template<typename eT, typename op_type, typename precond_type>
+inline
+bool
+sp_iter::bicgstab(Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename get_pod_type<eT>::result T;
+  
+  Col<eT> r;
+  
+  const T b_norm = sp_iter::init(x, r, A, b, opts);
+  
+  if(b_norm == T(0))  { x.zeros(b.n_elem); info.converged = true; info.history.zeros(1); return true; }
+  
+  std::vector<double> history;
+  
+  T res = norm(r, 2) / b_norm;
+  
+  history.push_back(double(res));
+  
+  bool converged = (res <= T(opts.tol));
+  
+  if(converged == false)
+    {
+    const Col<eT> r_hat(r);
+    
+    Col<eT> p(b.n_elem, fill::zeros);
+    Col<eT> v(b.n_elem, fill::zeros);
+    Col<eT> p_hat;
+    Col<eT> s;
+    Col<eT> s_hat;
+    Col<eT> t;
+    
+    eT rho   = eT(1);
+    eT alpha = eT(1);
+    eT omega = eT(1);
+    
+    for(uword iter=1; iter <= uword(opts.max_iter); ++iter)
+      {
+      const eT rho_new = cdot(r_hat, r);
+      
+      if(rho_new == eT(0))  { break; }  // breakdown
+      
+      const eT beta = (rho_new / rho) * (alpha / omega);
+      
+      p = r + beta * (p - omega * v);
+      
+      M.apply(p_hat, p);
+      A.apply(v, p_hat);
+      
+      const eT r_hat_v = cdot(r_hat, v);
+      
+      if(r_hat_v == eT(0))  { break; }  // breakdown
+      
+      alpha = rho_new / r_hat_v;
+      
+      s = r - alpha * v;
+      
+      info.n_iter = iter;
+      
+      const T s_res = norm(s, 2) / b_norm;
+      
+      if(s_res <= T(opts.tol))
+        {
+        x += alpha * p_hat;
+        
+        r.steal_mem(s);
+        
+        res = s_res;
+        
+        history.push_back(double(res));
+        
+        converged = true;
+        
+        break;
+        }
+      
+      M.apply(s_hat, s);
+      A.apply(t, s_hat);
+      
+      const T t_norm = norm(t, 2);
+      
+      omega = (t_norm > T(0)) ? eT(cdot(t, s) / eT(t_norm * t_norm)) : eT(0);
+      
+      x += alpha * p_hat + omega * s_hat;
+      
+      r = s - omega * t;
+      
+      rho = rho_new;
+      
+      res = norm(r, 2) / b_norm;
+      
+      history.push_back(double(res));
+      
+      if(res <= T(opts.tol))  { converged = true; break; }
+      
+      if(omega == eT(0))  { break; }  // breakdown
+      }
+    }
+  
+  info.converged    = converged;
+  info.rel_residual = double(res);
+  info.history      = Col<double>(history);
+  
+  return converged;
+  }
+
+
+
+//! restarted generalised minimal residual method (right preconditioned), for general square A
+template<typename eT, typename op_type, typename precond_type>
+inline
+bool
+sp_iter::gmres(Col<eT>& x, iter_info& info, const op_type& A, const precond_type& M, const Col<eT>& b, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename get_pod_type<eT>::result T;
+  
+  const uword n = b.n_elem;
+  
+  Col<eT> r;
+  
+  const T b_norm = sp_iter::init(x, r, A, b, opts);
+  
+  if(b_norm == T(0))  { x.zeros(n); info.converged = true; info.history.zeros(1); return true; }
+  
+  std::vector<double> history;
+  
+  T res = norm(r, 2) / b_norm;
+  
+  history.push_back(double(res));
+  
+  bool converged = (res <= T(opts.tol));
+  
+  const uword m = (std::max)( uword(1), (std::min)(uword(opts.restart), n) );
+  
+  Mat<eT> V;
+  Mat<eT> H;
+  Col<T>  cs;
+  Col<eT> sn;
+  Col<eT> g;
+  Col<eT> w;
+  Col<eT> z;
+  
+  if(converged == false)
+    {
+    V.set_size(n, m+1);
+    H.set_size(m+1, m);
+    cs.set_size(m);
+    sn.set_size(m);
+    g.set_size(m+1);
+    }
+  
+  uword iter = 0;
+  
+  while( (converged == false) && (iter < uword(opts.max_iter)) )
+    {
+    const T beta = norm(r, 2);
+    
+    V.col(0) = r / beta;
+    
+    H.zeros();
+    g.zeros();
+    
+    g[0] = eT(beta);
+    
+    uword k = 0;  // number of Arnoldi steps in this cycle
+    
+    for(uword j=0; (j < m) && (iter < uword(opts.max_iter)); ++j)
+      {
+      const Col<eT> v_j(V.colptr(j), n, false, true);
+      
+      M.apply(z, v_j);
+      A.apply(w, z);
+      
+      // modified Gram-Schmidt orthogonalisation
+      
+      for(uword i=0; i <= j; ++i)
+        {
+        const Col<eT> v_i(V.colptr(i), n, false, true);
+        
+        const eT h_ij = cdot(v_i, w);
+        
+        H.at(i,j) = h_ij;
+        
+        w -= h_ij * v_i;
+        }
+      
+      const T h_next = norm(w, 2);
+      
+      H.at(j+1,j) = eT(h_next);
+      
+      if(h_next > T(0))  { V.col(j+1) = w / h_next; }
+      
+      // apply the previous Givens rotations to the new column of H
+      
+      for(uword i=0; i < j; ++i)
+        {
+        const eT h_i  = H.at(i,  j);
+        const eT h_i1 = H.at(i+1,j);
+        
+        H.at(i,  j) =  cs[i] * h_i + sn[i] * h_i1;
+        H.at(i+1,j) = -access::alt_conj(sn[i]) * h_i + cs[i] * h_i1;
+        }
+      
+      // compute a new rotation which eliminates H(j+1,j)
+      
+      const eT h_jj     = H.at(j,j);
+      const T  h_jj_abs = std::abs(h_jj);
+      
+      if(h_jj_abs == T(0))
+        {
+        cs[j] = T(0);
+        sn[j] = eT(1);
+        
+        H.at(j,j) = eT(h_next);
+        }
+      else
+        {
+        const T  denom = std::sqrt(h_jj_abs*h_jj_abs + h_next*h_next);
+        const eT phase = h_jj / h_jj_abs;
+        
+        cs[j] = h_jj_abs / denom;
+        sn[j] = phase * (h_next / denom);
+        
+        H.at(j,j) = phase * denom;
+        }
+      
+      H.at(j+1,j) = eT(0);
+      
+      g[j+1] = -access::alt_conj(sn[j]) * g[j];
+      g[j]   = cs[j] * g[j];
+      
+      ++iter;
+      ++k;
+      
+      res = std::abs(g[j+1]) / b_norm;
+      
+      history.push_back(double(res));
+      
+      if( (res <= T(opts.tol)) || (h_next == T(0)) )  { break; }
+      }
+    
+    // solve the upper triangular system H(0:k-1,0:k-1)*y = g(0:k-1), then update x
+    
+    Col<eT> y(k);
+    
+    for(uword ii=k; ii > 0; --ii)
+      {
+      const uword i = ii-1;
+      
+      eT acc = g[i];
+      
+      for(uword l=i+1; l < k; ++l)  { acc -= H.at(i,l) * y[l]; }
+      
+      y[i] = (H.at(i,i) != eT(0)) ? eT(acc / H.at(i,i)) : eT(0);
+      }
+    
+    const Col<eT> Vy = V.cols(0, k-1) * y;
+    
+    M.apply(z, Vy);
+    
+    x += z;
+    
+    // recompute the residual, rather than relying on the estimate from the rotations
+    
+    A.apply(w, x);
+    
+    r = b - w;
+    
+    res = norm(r, 2) / b_norm;
+    
+    converged = (res <= T(opts.tol));
+    }
+  
+  info.n_iter       = iter;
+  info.converged    = converged;
+  info.rel_residual = double(res);
+  info.history      = Col<double>(history);
+  
+  return converged;
+  }
+
+
+
+//! @}
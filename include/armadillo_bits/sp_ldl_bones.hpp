@@ -0,0 +1,63 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_ldl
+//! @{
+
+
+//! sparse LDL' factorisation of a symmetric (or hermitian) positive definite matrix, P*A*P' = L*D*L',
+//! where L is unit lower triangular and D is diagonal with positive elements.
+//! P is either the identity or a minimum degree ordering (see sp_mindeg), which reduces the fill-in.
+//! the elimination tree of P*A*P' gives the number of elements in each column of L before the numeric phase,
+//! so that L can be stored in compressed columns; row k of L is obtained by a sparse triangular solve
+//! with rows 0 to k-1 (up-looking form), whose pattern is found by walking up the elimination tree.
+//! only the upper triangular part of A is used.
+template<typename eT>
+class sp_ldl
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  inline ~sp_ldl();
+  inline  sp_ldl();
+  
+  inline bool factorise(const SpMat<eT>& A, const bool use_mindeg);  //!< returns false if A is not positive definite
+  
+  inline void solve(Mat<eT>& X) const;  //!< X is used as input (the B matrix) and as output (the solution)
+  
+  inline pod_type rcond() const;  //!< crude estimate of the reciprocal condition number: min(D) / max(D)
+  
+  inline uword n_elem_L() const;  //!< number of elements stored in L, excluding the diagonal
+  
+  
+  private:
+  
+  uword n = 0;
+  
+  podarray<uword>    perm;           //!< perm[k] is the row/column of A placed at position k
+  podarray<uword>    L_col_ptrs;
+  podarray<uword>    L_row_indices;
+  podarray<eT>       L_values;
+  podarray<pod_type> D;
+  
+  inline void reset();
+  };
+
+
+
+//! @}
@@ -0,0 +1,332 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_ldl
+//! @{
+
+
+
+template<typename eT>
+inline
+sp_ldl<eT>::~sp_ldl()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+sp_ldl<eT>::sp_ldl()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_ldl<eT>::reset()
+  {
+  n = 0;
+  
+  perm.reset();
+  L_col_ptrs.reset();
+  L_row_indices.reset();
+  L_values.reset();
+  D.reset();
+  }
+
+
+
+template<typename eT>
+inline
+bool
+sp_ldl<eT>::factorise(const SpMat<eT>& A, const bool use_mindeg)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (A.n_rows != A.n_cols), "sp_ldl::factorise(): matrix must be square sized" );
+  
+  A.sync();
+  
+  reset();
+  
+  const uword N = A.n_rows;
+  
+  perm.set_size(N);
+  
+  if(use_mindeg)
+    {
+    sp_mindeg::apply(perm.memptr(), A);
+    }
+  else
+    {
+    for(uword k=0; k < N; ++k)  { perm[k] = k; }
+    }
+  
+  podarray<uword> pos(N);  // position of each row/column of A in C = P*A*P'
+  
+  for(uword k=0; k < N; ++k)  { pos[perm[k]] = k; }
+  
+  // the strictly upper triangular part of C, stored by columns;
+  // element (i,j) of the upper triangle of A is placed at (pos[i], pos[j]), or conjugated at (pos[j], pos[i]) if that is below the diagonal
+  
+  D.zeros(N);
+  
+  podarray<uword> C_col_ptrs(N+1);
+  
+  C_col_ptrs.zeros();
+  
+  for(uword j=0; j < N; ++j)
+  for(uword p=A.col_ptrs[j]; p < A.col_ptrs[j+1]; ++p)
+    {
+    const uword i = A.row_indices[p];
+    
+    if(i < j)  { C_col_ptrs[ (std::max)(pos[i], pos[j]) + 1 ]++; }
+    }
+  
+  for(uword k=0; k < N; ++k)  { C_col_ptrs[k+1] += C_col_ptrs[k]; }
+  
+  podarray<uword> C_row_indices(C_col_ptrs[N]);
+  podarray<eT>    C_values     (C_col_ptrs[N]);
+  
+  podarray<uword> next(N);  // next free position in each column
+  
+  for(uword k=0; k < N; ++k)  { next[k] = C_col_ptrs[k]; }
+  
+  for(uword j=0; j < N; ++j)
+  for(uword p=A.col_ptrs[j]; p < A.col_ptrs[j+1]; ++p)
+    {
+    const uword i = A.row_indices[p];
+    
+    if(i > j)  { continue; }
+    
+    const eT val = A.values[p];
+    
+    if(i == j)  { D[pos[i]] = access::tmp_real(val); continue; }
+    
+    const uword a = pos[i];
+    const uword b = pos[j];
+    
+    if(a < b)  { C_row_indices[next[b]] = a;  C_values[next[b]] = val;                    ++next[b]; }
+    else       { C_row_indices[next[a]] = b;  C_values[next[a]] = access::alt_conj(val);  ++next[a]; }
+    }
+  
+  // symbolic analysis: the pattern of row k of L is the set of nodes reached by walking up the elimination tree
+  // from each i with C(i,k) != 0, stopping at nodes already visited for row k;
+  // parent[j] is the first row k > j in which column j of L has an element
+  
+  const uword none = (std::numeric_limits<uword>::max)();
+  
+  podarray<uword> parent(N);
+  podarray<uword> visited(N);
+  podarray<uword> L_col_counts(N);
+  
+  L_col_counts.zeros();
+  
+  for(uword k=0; k < N; ++k)
+    {
+    parent[k]  = none;
+    visited[k] = k;
+    
+    for(uword p=C_col_ptrs[k]; p < C_col_ptrs[k+1]; ++p)
+      {
+      for(uword j = C_row_indices[p]; visited[j] != k; j = parent[j])
+        {
+        if(parent[j] == none)  { parent[j] = k; }
+        
+        L_col_counts[j]++;
+        visited[j] = k;
+        }
+      }
+    }
+  
+  L_col_ptrs.set_size(N+1);
+  
+  L_col_ptrs[0] = 0;
+  
+  for(uword k=0; k < N; ++k)
+    {
+    arma_check_bad_alloc( (L_col_counts[k] > (std::numeric_limits<uword>::max() - L_col_ptrs[k])), "sp_ldl::factorise(): factor is too large" );
+    
+    L_col_ptrs[k+1] = L_col_ptrs[k] + L_col_counts[k];
+    }
+  
+  L_row_indices.set_size(L_col_ptrs[N]);
+  L_values.set_size(L_col_ptrs[N]);
+  
+  n = N;
+  
+  // numeric factorisation: row k of L is obtained by solving L(0:k-1,0:k-1) * y = C(0:k-1,k),
+  // with y = D(0:k-1) * conj(L(k,0:k-1))'; the columns of L are filled in one row at a time
+  
+  podarray<eT>    y_mem(N);
+  podarray<uword> pattern(N);  // nodes of row k in topological order, stored in pattern[top] to pattern[N-1]
+  podarray<uword> path(N);
+  
+  y_mem.zeros();
+  
+  eT*       y      = y_mem.memptr();
+  uword*    L_rows = L_row_indices.memptr();
+  eT*       L_vals = L_values.memptr();
+  pod_type* D_mem  = D.memptr();
+  
+  for(uword k=0; k < N; ++k)  { next[k] = L_col_ptrs[k]; visited[k] = none; }
+  
+  for(uword k=0; k < N; ++k)
+    {
+    uword top = N;
+    
+    visited[k] = k;
+    
+    for(uword p=C_col_ptrs[k]; p < C_col_ptrs[k+1]; ++p)
+      {
+      const uword i = C_row_indices[p];
+      
+      y[i] = C_values[p];
+      
+      // each new path is placed before the nodes found so far, keeping descendants ahead of their ancestors
+      
+      uword path_len = 0;
+      
+      for(uword j=i; visited[j] != k; j = parent[j])  { path[path_len++] = j;  visited[j] = k; }
+      
+      while(path_len > 0)  { pattern[--top] = path[--path_len]; }
+      }
+    
+    pod_type d = D_mem[k];
+    
+    for(uword t=top; t < N; ++t)
+      {
+      const uword j   = pattern[t];
+      const eT    y_j = y[j];
+      
+      y[j] = eT(0);
+      
+      const uword p_end = next[j];
+      
+      for(uword p=L_col_ptrs[j]; p < p_end; ++p)  { y[ L_rows[p] ] -= L_vals[p] * y_j; }
+      
+      const eT L_kj = access::alt_conj(y_j) / D_mem[j];
+      
+      d -= access::tmp_real(L_kj * y_j);
+      
+      L_rows[p_end] = k;
+      L_vals[p_end] = L_kj;
+      
+      ++next[j];
+      }
+    
+    // the negated comparison also rejects NaN
+    if( (d > pod_type(0)) == false )  { reset(); return false; }
+    
+    D_mem[k] = d;
+    }
+  
+  return true;
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_ldl<eT>::solve(Mat<eT>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (X.n_rows != n), "sp_ldl::solve(): number of rows in the given matrix must be the same as the size of the factorised matrix" );
+  
+  podarray<eT> y_mem(n);
+  
+  eT* y = y_mem.memptr();
+  
+  const uword*    L_cols   = L_col_ptrs.memptr();
+  const uword*    L_rows   = L_row_indices.memptr();
+  const eT*       L_vals   = L_values.memptr();
+  const pod_type* D_mem    = D.memptr();
+  const uword*    perm_mem = perm.memptr();
+  
+  for(uword c=0; c < X.n_cols; ++c)
+    {
+    eT* x = X.colptr(c);
+    
+    for(uword k=0; k < n; ++k)  { y[k] = x[ perm_mem[k] ]; }
+    
+    // forward substitution with L, one column at a time
+    
+    for(uword j=0; j < n; ++j)
+      {
+      const eT y_j = y[j];
+      
+      for(uword p=L_cols[j]; p < L_cols[j+1]; ++p)  { y[ L_rows[p] ] -= L_vals[p] * y_j; }
+      }
+    
+    for(uword k=0; k < n; ++k)  { y[k] /= D_mem[k]; }
+    
+    // backward substitution with L', using column j of L as row j of L'
+    
+    for(uword jj=n; jj > 0; --jj)
+      {
+      const uword j = jj-1;
+      
+      eT acc = eT(0);
+      
+      for(uword p=L_cols[j]; p < L_cols[j+1]; ++p)  { acc += access::alt_conj(L_vals[p]) * y[ L_rows[p] ]; }
+      
+      y[j] -= acc;
+      }
+    
+    for(uword k=0; k < n; ++k)  { x[ perm_mem[k] ] = y[k]; }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+typename sp_ldl<eT>::pod_type
+sp_ldl<eT>::rcond() const
+  {
+  if(n == 0)  { return pod_type(0); }
+  
+  pod_type min_val = D[0];
+  pod_type max_val = D[0];
+  
+  for(uword k=1; k < n; ++k)
+    {
+    min_val = (std::min)(min_val, D[k]);
+    max_val = (std::max)(max_val, D[k]);
+    }
+  
+  return (max_val > pod_type(0)) ? (min_val / max_val) : pod_type(0);
+  }
+
+
+
+template<typename eT>
+inline
+uword
+sp_ldl<eT>::n_elem_L() const
+  {
+  return (n == 0) ? uword(0) : L_col_ptrs[n];
+  }
+
+
+
+//! @}
@@ -0,0 +1,113 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_lobpcg
+//! @{
+
+
+//! the operator as seen by lobpcg(): apply() computes out = A*in for a block of vectors
+
+template<typename eT>
+class sp_lobpcg_op_sparse
+  {
+  public:
+  
+  const SpMat<eT>& A;
+  
+  inline explicit sp_lobpcg_op_sparse(const SpMat<eT>& in_A) : A(in_A) { A.sync(); }
+  
+  inline void apply(Mat<eT>& out, const Mat<eT>& in) const;
+  };
+
+
+template<typename eT>
+class sp_lobpcg_op_dense
+  {
+  public:
+  
+  const Mat<eT>& A;
+  
+  inline explicit sp_lobpcg_op_dense(const Mat<eT>& in_A) : A(in_A) {}
+  
+  inline void apply(Mat<eT>& out, const Mat<eT>& in) const  { out = A * in; }
+  };
+
+
+//! any callable object (eg. a lambda function) which takes a Mat<eT> and returns the product with the operator,
+//! so that the operator is applied to all vectors of a block in one call
+template<typename eT, typename func_type>
+class sp_lobpcg_op_func
+  {
+  public:
+  
+  const func_type& func;
+  
+  inline explicit sp_lobpcg_op_func(const func_type& in_func) : func(in_func) {}
+  
+  inline void apply(Mat<eT>& out, const Mat<eT>& in) const;
+  };
+
+
+
+//! locally optimal block preconditioned conjugate gradient method (LOBPCG) for extreme eigenpairs of symmetric real operators;
+//! the Rayleigh-Ritz procedure is done on an orthonormal basis of [X, P, W] (current approximations, previous directions
+//! and preconditioned residuals); converged vectors are kept in X, but no longer contribute to P and W (soft locking)
+class sp_lobpcg
+  {
+  public:
+  
+  template<typename eT, typename T1>
+  inline static bool apply(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A, const uword n, const uword k, const char* form, const char* precond, const iter_opts& opts);
+  
+  
+  private:
+  
+  static constexpr uword mp_threshold = 16384;  //!< min number of elements in a block for parallelised preconditioning
+  
+  template<typename eT, typename T1>
+  inline static typename enable_if2< is_arma_sparse_type<T1>::value, bool >::result
+  dispatch(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A_expr, const uword n, const uword k, const bool largest, const char* precond, const iter_opts& opts);
+  
+  template<typename eT, typename T1>
+  inline static typename enable_if2< is_arma_type<T1>::value, bool >::result
+  dispatch(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A_expr, const uword n, const uword k, const bool largest, const char* precond, const iter_opts& opts);
+  
+  template<typename eT, typename T1>
+  inline static typename enable_if2< (is_arma_sparse_type<T1>::value == false) && (is_arma_type<T1>::value == false), bool >::result
+  dispatch(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A_func, const uword n, const uword k, const bool largest, const char* precond, const iter_opts& opts);
+  
+  template<typename eT, typename op_type, typename precond_type>
+  inline static bool run(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const op_type& A, const precond_type& M, const uword n, const uword k, const bool largest, const iter_opts& opts);
+  
+  template<typename eT, typename op_type>
+  inline static bool run_dense(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const op_type& A, const uword n, const uword k, const bool largest);
+  
+  template<typename eT, typename precond_type>
+  inline static void apply_precond(const precond_type& M, Mat<eT>& out, const Mat<eT>& in);
+  
+  template<typename eT>
+  inline static void apply_precond(const sp_precond_none<eT>& M, Mat<eT>& out, const Mat<eT>& in);
+  
+  template<typename eT>
+  inline static void project_out(Mat<eT>& V, Mat<eT>& AV, const Mat<eT>& Q, const Mat<eT>& AQ, const bool use_AV);
+  
+  template<typename eT>
+  inline static bool orthonormalise(Mat<eT>& V, Mat<eT>& AV, const bool use_AV);
+  };
+
+
+
+//! @}
@@ -0,0 +1,559 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_lobpcg
+//! @{
+
+
+
+//! uses the CSC kernels of sparse * dense directly on A, so no second copy of A is kept during the iterations
+template<typename eT>
+inline
+void
+sp_lobpcg_op_sparse<eT>::apply(Mat<eT>& out, const Mat<eT>& in) const
+  {
+  spglue_times_misc::sparse_times_dense(out, A, in);
+  }
+
+
+
+template<typename eT, typename func_type>
+inline
+void
+sp_lobpcg_op_func<eT,func_type>::apply(Mat<eT>& out, const Mat<eT>& in) const
+  {
+  out = func(in);
+  
+  arma_debug_check( ((out.n_rows != in.n_rows) || (out.n_cols != in.n_cols)), "lobpcg(): function for the operator returned a matrix with incorrect size" );
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+bool
+sp_lobpcg::apply(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A, const uword n, const uword k, const char* form, const char* precond, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  info = iter_info();
+  
+  const sp_auxlib::form_type form_val = sp_auxlib::interpret_form_str(form);
+  
+  arma_debug_check( ((form_val != sp_auxlib::form_sa) && (form_val != sp_auxlib::form_la)), "lobpcg(): form must be \"sa\" or \"la\"" );
+  
+  const bool largest = (form_val == sp_auxlib::form_la);
+  
+  arma_debug_check( (largest && (precond != nullptr) && (precond[0] != 'n') && (precond[0] != char(0))), "lobpcg(): preconditioners are only supported for form \"sa\"" );
+  
+  const bool status = sp_lobpcg::dispatch(eigval, eigvec, info, A, n, k, largest, precond, opts);
+  
+  if(status == false)
+    {
+    if(info.n_iter > 0)
+      {
+      std::ostringstream tmp;
+      
+      tmp << "lobpcg(): no convergence after " << info.n_iter << " iterations (relative residual: " << info.rel_residual << ')';
+      
+      arma_debug_warn(tmp.str());
+      }
+    else
+      {
+      arma_debug_warn("lobpcg(): decomposition failed");
+      }
+    }
+  
+  return status;
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< is_arma_sparse_type<T1>::value, bool >::result
+sp_lobpcg::dispatch(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A_expr, const uword n, const uword k, const bool largest, const char* precond, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(n);
+  
+  const unwrap_spmat<T1> U(A_expr);
+  const SpMat<eT>& A   = U.M;
+  
+  arma_debug_check( (A.n_rows != A.n_cols), "lobpcg(): matrix A must be square sized" );
+  
+  const char sig0 = (precond != nullptr) ? precond[0] : char(0);
+  const char sig1 = (sig0    != char(0)) ? precond[1] : char(0);
+  
+  const bool use_none   = (sig0 == 'n') || (sig0 == char(0));
+  const bool use_jacobi = (sig0 == 'j');
+  const bool use_ilu0   = (sig0 == 'i') && (sig1 == 'l');
+  const bool use_ic0    = (sig0 == 'i') && (sig1 == 'c');
+  
+  arma_debug_check( ((use_none || use_jacobi || use_ilu0 || use_ic0) == false), "lobpcg(): unknown preconditioner" );
+  
+  const sp_lobpcg_op_sparse<eT> op(A);
+  
+  if(use_jacobi)
+    {
+    sp_precond_jacobi<eT> M;
+    
+    if(M.init(A) == false)  { arma_debug_warn("lobpcg(): jacobi preconditioner: zero element on the diagonal"); eigval.soft_reset(); eigvec.soft_reset(); return false; }
+    
+    return sp_lobpcg::run(eigval, eigvec, info, op, M, A.n_rows, k, largest, opts);
+    }
+  
+  if(use_ilu0)
+    {
+    sp_precond_ilu0<eT> M;
+    
+    if(M.init(A) == false)  { arma_debug_warn("lobpcg(): ilu0 preconditioner: zero pivot or missing diagonal element"); eigval.soft_reset(); eigvec.soft_reset(); return false; }
+    
+    return sp_lobpcg::run(eigval, eigvec, info, op, M, A.n_rows, k, largest, opts);
+    }
+  
+  if(use_ic0)
+    {
+    sp_precond_ic0<eT> M;
+    
+    if(M.init(A) == false)  { arma_debug_warn("lobpcg(): ic0 preconditioner: non-positive pivot or missing diagonal element"); eigval.soft_reset(); eigvec.soft_reset(); return false; }
+    
+    return sp_lobpcg::run(eigval, eigvec, info, op, M, A.n_rows, k, largest, opts);
+    }
+  
+  return sp_lobpcg::run(eigval, eigvec, info, op, sp_precond_none<eT>(), A.n_rows, k, largest, opts);
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< is_arma_type<T1>::value, bool >::result
+sp_lobpcg::dispatch(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A_expr, const uword n, const uword k, const bool largest, const char* precond, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(n);
+  
+  const quasi_unwrap<T1> U(A_expr);
+  const Mat<eT>& A     = U.M;
+  
+  arma_debug_check( (A.n_rows != A.n_cols), "lobpcg(): matrix A must be square sized" );
+  
+  arma_debug_check( ((precond != nullptr) && (precond[0] != 'n') && (precond[0] != char(0))), "lobpcg(): preconditioners require a sparse matrix" );
+  
+  const sp_lobpcg_op_dense<eT> op(A);
+  
+  return sp_lobpcg::run(eigval, eigvec, info, op, sp_precond_none<eT>(), A.n_rows, k, largest, opts);
+  }
+
+
+
+template<typename eT, typename T1>
+inline
+typename enable_if2< (is_arma_sparse_type<T1>::value == false) && (is_arma_type<T1>::value == false), bool >::result
+sp_lobpcg::dispatch(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const T1& A_func, const uword n, const uword k, const bool largest, const char* precond, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( ((precond != nullptr) && (precond[0] != 'n') && (precond[0] != char(0))), "lobpcg(): preconditioners require a sparse matrix" );
+  
+  const sp_lobpcg_op_func<eT,T1> op(A_func);
+  
+  return sp_lobpcg::run(eigval, eigvec, info, op, sp_precond_none<eT>(), n, k, largest, opts);
+  }
+
+
+
+template<typename eT, typename op_type, typename precond_type>
+inline
+bool
+sp_lobpcg::run(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const op_type& A, const precond_type& M, const uword n, const uword k, const bool largest, const iter_opts& opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (k > n), "lobpcg(): k must not be greater than the number of rows in A" );
+  
+  arma_debug_check( (opts.warm_start && ((eigvec.n_rows != n) || (eigvec.n_cols != k))), "lobpcg(): for warm start, the size of eigvec must be n x k" );
+  
+  if(k == 0)
+    {
+    eigval.reset();
+    eigvec.set_size(n,0);
+    
+    info.converged = true;
+    info.history.zeros(1);
+    
+    return true;
+    }
+  
+  // a few extra vectors in the block improve the convergence of the last wanted eigenpairs
+  
+  const uword m = (std::min)(n, k + (std::min)(k, uword(8)));
+  
+  // the Rayleigh-Ritz procedure works on a subspace with up to 3*m vectors,
+  // so small problems are solved directly
+  
+  if(n <= 5*m)  { return sp_lobpcg::run_dense(eigval, eigvec, info, A, n, k, largest); }
+  
+  const eT sign = (largest) ? eT(-1) : eT(1);  // the largest eigenvalues of A are the smallest of -A
+  const eT eps  = std::numeric_limits<eT>::epsilon();
+  const eT tol  = (std::max)(eT(opts.tol), eps);
+  
+  Mat<eT> X(n, m);
+  
+  if(opts.warm_start)
+    {
+    X.cols(0, k-1) = eigvec;
+    
+    if(m > k)  { X.cols(k, m-1).randu(); X.cols(k, m-1) -= eT(0.5); }
+    }
+  else
+    {
+    X.randu();  X -= eT(0.5);
+    }
+  
+  Mat<eT> AX;
+  
+  A.apply(AX, X);  AX *= sign;
+  
+  if( (sp_lobpcg::orthonormalise(X, AX, true) == false) || (X.n_cols < m) )
+    {
+    arma_debug_warn("lobpcg(): initial vectors are linearly dependent");
+    eigval.soft_reset();
+    eigvec.soft_reset();
+    return false;
+    }
+  
+  Col<eT> lambda;
+  Mat<eT> C;
+  Mat<eT> H;
+  
+  H = X.t() * AX;  H = eT(0.5) * (H + H.t());
+  
+  if(eig_sym(lambda, C, H) == false)  { eigval.soft_reset(); eigvec.soft_reset(); return false; }
+  
+  X  = X  * C;
+  AX = AX * C;
+  
+  eT A_norm = max(abs(lambda));  // estimate of the norm of A, from all Ritz values seen so far
+  
+  Mat<eT> P;
+  Mat<eT> AP;
+  Mat<eT> W;
+  Mat<eT> AW;
+  Mat<eT> R;
+  
+  Col<eT> rel_res(m);
+  
+  std::vector<double> history;
+  
+  bool converged = false;
+  
+  for(uword iter=0; iter <= uword(opts.max_iter); ++iter)
+    {
+    R = AX - X * diagmat(lambda);
+    
+    const eT scale = (A_norm > eT(0)) ? A_norm : eT(1);
+    
+    for(uword i=0; i < m; ++i)  { rel_res[i] = norm(R.col(i), 2) / scale; }
+    
+    const eT res = max(rel_res.head(k));
+    
+    history.push_back(double(res));
+    
+    info.n_iter       = iter;
+    info.rel_residual = double(res);
+    
+    if(res <= tol)  { converged = true; break; }
+    
+    if(iter == uword(opts.max_iter))  { break; }
+    
+    // converged vectors are locked: only the active ones contribute new search directions
+    
+    const uvec active = find(rel_res > tol);
+    
+    sp_lobpcg::apply_precond(M, W, Mat<eT>(R.cols(active)));
+    
+    Mat<eT> Pa;
+    Mat<eT> APa;
+    
+    if(P.n_cols > 0)
+      {
+      Pa  = P.cols(active);
+      APa = AP.cols(active);
+      
+      sp_lobpcg::project_out(Pa, APa, X, AX, true);
+      
+      if(sp_lobpcg::orthonormalise(Pa, APa, true) == false)  { Pa.reset(); APa.reset(); }
+      }
+    
+    // two passes of projection and orthonormalisation give W orthogonal to X and P in floating point
+    
+    for(uword pass=0; pass < 2; ++pass)
+      {
+                           sp_lobpcg::project_out(W, AW, X,  AX,  false);
+      if(Pa.n_cols > 0)  { sp_lobpcg::project_out(W, AW, Pa, APa, false); }
+      
+      if(sp_lobpcg::orthonormalise(W, AW, false) == false)  { break; }
+      }
+    
+    if(W.n_cols == 0)  { break; }  // stagnation
+    
+    A.apply(AW, W);  AW *= sign;
+    
+    const uword nx = X.n_cols;
+    const uword np = Pa.n_cols;
+    const uword nw = W.n_cols;
+    const uword ns = nx + np + nw;
+    
+    // Gram matrix of A on the orthonormal basis [X, P, W]
+    
+    H.set_size(ns, ns);
+    
+    H.submat(0, 0, nx-1, nx-1) = diagmat(lambda);
+    
+    H.submat(0, nx+np, nx-1, ns-1) = X.t() * AW;
+    
+    if(np > 0)
+      {
+      H.submat(0,  nx, nx-1,    nx+np-1) = X.t()  * APa;
+      H.submat(nx, nx, nx+np-1, nx+np-1) = Pa.t() * APa;
+      H.submat(nx, nx+np, nx+np-1, ns-1) = Pa.t() * AW;
+      }
+    
+    H.submat(nx+np, nx+np, ns-1, ns-1) = W.t() * AW;
+    
+    H = symmatu(H);
+    
+    Col<eT> theta;
+    
+    if(eig_sym(theta, C, H) == false)  { break; }
+    
+    A_norm = (std::max)(A_norm, eT(max(abs(theta))));
+    
+    lambda = theta.head(m);
+    
+    const Mat<eT> Cx = C.submat(0,     0, nx-1,       m-1);
+    const Mat<eT> Cw = C.submat(nx+np, 0, ns-1,       m-1);
+    
+    // new directions P = [P, W]*C_pw, and new approximations X = X*C_x + P
+    
+    P  = W  * Cw;
+    AP = AW * Cw;
+    
+    if(np > 0)
+      {
+      const Mat<eT> Cp = C.submat(nx, 0, nx+np-1, m-1);
+      
+      P  += Pa  * Cp;
+      AP += APa * Cp;
+      }
+    
+    X  = X  * Cx;  X  += P;
+    AX = AX * Cx;  AX += AP;
+    
+    // restore orthonormality of X if it has degraded by accumulated rounding errors
+    
+    if( norm(X.t() * X - eye< Mat<eT> >(m,m), "fro") > std::sqrt(eps) )
+      {
+      if( (sp_lobpcg::orthonormalise(X, AX, true) == false) || (X.n_cols < m) )  { break; }
+      
+      H = X.t() * AX;  H = eT(0.5) * (H + H.t());
+      
+      if(eig_sym(lambda, C, H) == false)  { break; }
+      
+      X  = X  * C;
+      AX = AX * C;
+      }
+    }
+  
+  info.converged = converged;
+  info.history   = Col<double>(history);
+  
+  if(largest)
+    {
+    eigval = flipud( -(lambda.head(k)) );
+    eigvec = fliplr( X.cols(0, k-1) );
+    }
+  else
+    {
+    eigval = lambda.head(k);
+    eigvec = X.cols(0, k-1);
+    }
+  
+  return converged;
+  }
+
+
+
+//! direct solution via the dense eigendecomposition, for problems that are too small for the block iteration
+template<typename eT, typename op_type>
+inline
+bool
+sp_lobpcg::run_dense(Col<eT>& eigval, Mat<eT>& eigvec, iter_info& info, const op_type& A, const uword n, const uword k, const bool largest)
+  {
+  arma_extra_debug_sigprint();
+  
+  Mat<eT> AA;
+  
+  A.apply(AA, eye< Mat<eT> >(n,n));
+  
+  AA = eT(0.5) * (AA + AA.t());
+  
+  Col<eT> all_eigval;
+  Mat<eT> all_eigvec;
+  
+  if(eig_sym(all_eigval, all_eigvec, AA) == false)  { eigval.soft_reset(); eigvec.soft_reset(); return false; }
+  
+  const uword start = (largest) ? (n-k) : uword(0);
+  
+  eigval = all_eigval.subvec(start, start+k-1);
+  eigvec = all_eigvec.cols(start, start+k-1);
+  
+  info.converged = true;
+  info.history.zeros(1);
+  
+  return true;
+  }
+
+
+
+template<typename eT, typename precond_type>
+inline
+void
+sp_lobpcg::apply_precond(const precond_type& M, Mat<eT>& out, const Mat<eT>& in)
+  {
+  arma_extra_debug_sigprint();
+  
+  const uword n_rows = in.n_rows;
+  const uword n_cols = in.n_cols;
+  
+  out.set_size(n_rows, n_cols);
+  
+  if( (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && (n_cols > 1) && (in.n_elem >= mp_threshold) )
+    {
+    #if defined(ARMA_USE_OPENMP)
+      {
+      const int n_threads = mp_thread_limit::get();
+      
+      #pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+      for(uword col=0; col < n_cols; ++col)
+        {
+        const Col<eT> in_col(const_cast<eT*>(in.colptr(col)), n_rows, false, true);
+              Col<eT> out_col(out.colptr(col),                n_rows, false, true);
+        
+        M.apply(out_col, in_col);
+        }
+      }
+    #endif
+    }
+  else
+    {
+    for(uword col=0; col < n_cols; ++col)
+      {
+      const Col<eT> in_col(const_cast<eT*>(in.colptr(col)), n_rows, false, true);
+            Col<eT> out_col(out.colptr(col),                n_rows, false, true);
+      
+      M.apply(out_col, in_col);
+      }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_lobpcg::apply_precond(const sp_precond_none<eT>& M, Mat<eT>& out, const Mat<eT>& in)
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(M);
+  
+  out = in;
+  }
+
+
+
+//! V = V - Q*(Q'*V), where Q has orthonormal columns; AV is updated accordingly if use_AV is true
+template<typename eT>
+inline
+void
+sp_lobpcg::project_out(Mat<eT>& V, Mat<eT>& AV, const Mat<eT>& Q, const Mat<eT>& AQ, const bool use_AV)
+  {
+  arma_extra_debug_sigprint();
+  
+  if( (V.n_cols == 0) || (Q.n_cols == 0) )  { return; }
+  
+  const Mat<eT> QtV = Q.t() * V;
+  
+  V -= Q * QtV;
+  
+  if(use_AV)  { AV -= AQ * QtV; }
+  }
+
+
+
+//! orthonormalisation of the columns of V via the eigendecomposition of the scaled Gram matrix (SVQB);
+//! directions that are numerically linearly dependent are dropped, so V may have fewer columns afterwards;
+//! AV is updated accordingly if use_AV is true; returns false if no columns remain
+template<typename eT>
+inline
+bool
+sp_lobpcg::orthonormalise(Mat<eT>& V, Mat<eT>& AV, const bool use_AV)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(V.n_cols == 0)  { return false; }
+  
+  const eT eps = std::numeric_limits<eT>::epsilon();
+  
+  Mat<eT> G = V.t() * V;
+  
+  G = eT(0.5) * (G + G.t());
+  
+  Col<eT> d = G.diag();
+  
+  const eT d_max = max(d);
+  
+  if( (d_max > eT(0)) == false )  { V.reset(); AV.reset(); return false; }
+  
+  for(uword i=0; i < d.n_elem; ++i)  { d[i] = (d[i] > (eps * d_max)) ? eT(1) / std::sqrt(d[i]) : eT(0); }
+  
+  G = diagmat(d) * G * diagmat(d);
+  
+  Col<eT> theta;
+  Mat<eT> Q;
+  
+  if(eig_sym(theta, Q, G) == false)  { V.reset(); AV.reset(); return false; }
+  
+  const eT theta_min = eT(10) * eps * max(theta);
+  
+  const uvec keep = find(theta > theta_min);
+  
+  if(keep.n_elem == 0)  { V.reset(); AV.reset(); return false; }
+  
+  const Mat<eT> T = diagmat(d) * Q.cols(keep) * diagmat( eT(1) / sqrt(theta.elem(keep)) );
+  
+  V = V * T;
+  
+  if(use_AV)  { AV = AV * T; }
+  
+  return true;
+  }
+
+
+
+//! @}
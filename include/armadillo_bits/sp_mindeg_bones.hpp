@@ -0,0 +1,55 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_mindeg
+//! @{
+
+
+//! minimum degree fill-reducing ordering for sparse Cholesky and LDL' factorisations.
+//! the elimination is simulated on the quotient graph (George & Liu, 1980), where each eliminated node becomes
+//! an element that stands for the clique formed by its neighbours; elements adjacent to the pivot are absorbed
+//! into the new element, nodes with the same adjacency are merged into supervariables and eliminated together,
+//! and the exact external degree of each node adjacent to the pivot is recomputed after each step.
+//! the pivots are numbered in a postorder of the tree of absorbed elements; rows with very many elements are placed last.
+class sp_mindeg
+  {
+  public:
+  
+  //! perm[k] is the row/column of A placed at position k; only the pattern of the strictly upper triangular part of A is used
+  template<typename eT>
+  inline static void apply(uword* perm, const SpMat<eT>& A);
+  
+  
+  private:
+  
+  static constexpr uword none = (std::numeric_limits<uword>::max)();
+  
+  static constexpr uword state_variable = 0;  //!< principal variable, not yet eliminated
+  static constexpr uword state_merged   = 1;  //!< variable merged into another supervariable
+  static constexpr uword state_element  = 2;  //!< eliminated; now an element
+  static constexpr uword state_absorbed = 3;  //!< element absorbed into a later element
+  static constexpr uword state_dense    = 4;  //!< kept out of the elimination and placed last
+  
+  struct graph;
+  
+  inline static void eliminate(graph& G, const uword p);
+  inline static void merge_indistinguishable(graph& G, const uword p);
+  inline static uword external_degree(graph& G, const uword i);
+  };
+
+
+
+//! @}
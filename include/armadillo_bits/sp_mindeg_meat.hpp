@@ -0,0 +1,487 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_mindeg
+//! @{
+
+
+
+//! state of the quotient graph during the simulated elimination
+struct sp_mindeg::graph
+  {
+  std::vector< std::vector<uword> > vars_of_var;   //!< variables adjacent to each variable (may hold stale entries)
+  std::vector< std::vector<uword> > elems_of_var;  //!< elements adjacent to each variable
+  std::vector< std::vector<uword> > vars_of_elem;  //!< variables in each element (may hold stale entries)
+  
+  podarray<uword> state;
+  podarray<uword> weight;       //!< number of original nodes in each supervariable
+  podarray<uword> degree;       //!< external degree of each principal variable
+  podarray<uword> member_next;  //!< list of the nodes in each supervariable
+  podarray<uword> member_last;
+  podarray<uword> absorbed_by;  //!< the element that absorbed each element, ie. its parent in the assembly tree
+  
+  podarray<uword> bucket_head;  //!< bucket_head[d] is the first variable with degree d
+  podarray<uword> bucket_next;
+  podarray<uword> bucket_prev;
+  uword           min_degree;
+  
+  podarray<uword> mark;
+  uword           stamp;
+  
+  
+  inline uword new_stamp()
+    {
+    if(stamp == sp_mindeg::none - 1)  { mark.zeros(); stamp = 0; }
+    
+    return ++stamp;
+    }
+  
+  
+  inline void bucket_insert(const uword i, const uword d)
+    {
+    degree[i] = d;
+    
+    const uword first = bucket_head[d];
+    
+    bucket_prev[i] = sp_mindeg::none;
+    bucket_next[i] = first;
+    
+    if(first != sp_mindeg::none)  { bucket_prev[first] = i; }
+    
+    bucket_head[d] = i;
+    
+    if(d < min_degree)  { min_degree = d; }
+    }
+  
+  
+  inline void bucket_remove(const uword i)
+    {
+    const uword prev = bucket_prev[i];
+    const uword next = bucket_next[i];
+    
+    if(prev != sp_mindeg::none)  { bucket_next[prev] = next; }  else  { bucket_head[ degree[i] ] = next; }
+    if(next != sp_mindeg::none)  { bucket_prev[next] = prev; }
+    }
+  };
+
+
+
+template<typename eT>
+inline
+void
+sp_mindeg::apply(uword* perm, const SpMat<eT>& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  A.sync();
+  
+  const uword N = A.n_rows;
+  
+  if(N == 0)  { return; }
+  
+  graph G;
+  
+  G.vars_of_var.resize(N);
+  G.elems_of_var.resize(N);
+  G.vars_of_elem.resize(N);
+  
+  podarray<uword> counts(N);
+  
+  counts.zeros();
+  
+  for(uword j=0; j < N; ++j)
+  for(uword p=A.col_ptrs[j]; p < A.col_ptrs[j+1]; ++p)
+    {
+    const uword i = A.row_indices[p];
+    
+    if(i < j)  { ++counts[i];  ++counts[j]; }
+    }
+  
+  for(uword i=0; i < N; ++i)  { G.vars_of_var[i].reserve(counts[i]); }
+  
+  for(uword j=0; j < N; ++j)
+  for(uword p=A.col_ptrs[j]; p < A.col_ptrs[j+1]; ++p)
+    {
+    const uword i = A.row_indices[p];
+    
+    if(i < j)  { G.vars_of_var[i].push_back(j);  G.vars_of_var[j].push_back(i); }
+    }
+  
+  G.state.zeros(N);
+  G.weight.set_size(N);
+  G.degree.zeros(N);
+  G.member_next.set_size(N);
+  G.member_last.set_size(N);
+  G.absorbed_by.set_size(N);
+  
+  G.bucket_head.set_size(N+1);
+  G.bucket_next.set_size(N);
+  G.bucket_prev.set_size(N);
+  
+  G.mark.zeros(N);
+  G.stamp = 0;
+  
+  for(uword d=0; d <= N; ++d)  { G.bucket_head[d] = none; }
+  
+  G.min_degree = N;
+  
+  // rows with very many elements would be part of nearly every element, making each degree update expensive;
+  // they are kept out of the elimination and placed at the end
+  
+  const uword dense_limit = (std::max)( uword(16), uword(10.0 * std::sqrt(double(N))) );
+  
+  uword n_dense = 0;
+  
+  for(uword i=0; i < N; ++i)
+    {
+    G.weight[i]      = 1;
+    G.member_next[i] = none;
+    G.member_last[i] = i;
+    G.absorbed_by[i] = none;
+    
+    if(G.vars_of_var[i].size() > dense_limit)  { G.state[i] = state_dense; ++n_dense; }
+    }
+  
+  for(uword i=0; i < N; ++i)
+    {
+    if(G.state[i] != state_variable)  { continue; }
+    
+    const std::vector<uword>& vars = G.vars_of_var[i];
+    
+    uword d = 0;
+    
+    for(uword a=0; a < vars.size(); ++a)  { d += (G.state[ vars[a] ] == state_variable) ? uword(1) : uword(0); }
+    
+    G.bucket_insert(i, d);
+    }
+  
+  podarray<uword> pivots(N);
+  
+  uword n_pivots   = 0;
+  uword n_selected = 0;
+  
+  while(n_selected < (N - n_dense))
+    {
+    while(G.bucket_head[G.min_degree] == none)  { ++G.min_degree; }
+    
+    const uword p = G.bucket_head[G.min_degree];
+    
+    G.bucket_remove(p);
+    
+    sp_mindeg::eliminate(G, p);
+    
+    pivots[n_pivots++] = p;
+    
+    n_selected += G.weight[p];
+    }
+  
+  // the pivots are numbered in a postorder of the assembly tree, which gives the same fill-in
+  // and keeps the columns of each subtree of the elimination tree together
+  
+  podarray<uword> child_head(N);
+  podarray<uword> child_next(N);
+  podarray<uword> stack(N);
+  
+  for(uword i=0; i < N; ++i)  { child_head[i] = none; }
+  
+  for(uword t=n_pivots; t > 0; --t)
+    {
+    const uword e      = pivots[t-1];
+    const uword parent = G.absorbed_by[e];
+    
+    if(parent != none)  { child_next[e] = child_head[parent];  child_head[parent] = e; }
+    }
+  
+  uword k = 0;
+  
+  for(uword t=0; t < n_pivots; ++t)
+    {
+    if(G.absorbed_by[ pivots[t] ] != none)  { continue; }
+    
+    uword n_stack = 0;
+    
+    stack[n_stack++] = pivots[t];
+    
+    while(n_stack > 0)
+      {
+      const uword e = stack[n_stack-1];
+      const uword c = child_head[e];
+      
+      if(c != none)
+        {
+        child_head[e] = child_next[c];
+        
+        stack[n_stack++] = c;
+        }
+      else
+        {
+        --n_stack;
+        
+        for(uword m=e; m != none; m = G.member_next[m])  { perm[k++] = m; }
+        }
+      }
+    }
+  
+  for(uword i=0; (i < N) && (n_dense > 0); ++i)
+    {
+    if(G.state[i] == state_dense)  { perm[k++] = i; }
+    }
+  }
+
+
+
+//! turns the principal variable p into an element, and updates the variables adjacent to it
+inline
+void
+sp_mindeg::eliminate(graph& G, const uword p)
+  {
+  const uword s = G.new_stamp();
+  
+  G.mark[p] = s;
+  
+  std::vector<uword>& Lp = G.vars_of_elem[p];
+  
+  Lp.clear();
+  Lp.reserve(G.degree[p]);  // the external degree of p is an upper bound on the number of variables in the new element
+  
+  const std::vector<uword>& p_vars  = G.vars_of_var[p];
+  const std::vector<uword>& p_elems = G.elems_of_var[p];
+  
+  for(uword a=0; a < p_vars.size(); ++a)
+    {
+    const uword v = p_vars[a];
+    
+    if( (G.state[v] == state_variable) && (G.mark[v] != s) )  { G.mark[v] = s; Lp.push_back(v); }
+    }
+  
+  // the elements adjacent to p are absorbed: their variables become part of the new element
+  
+  for(uword b=0; b < p_elems.size(); ++b)
+    {
+    const uword e = p_elems[b];
+    
+    if(G.state[e] != state_element)  { continue; }
+    
+    const std::vector<uword>& e_vars = G.vars_of_elem[e];
+    
+    for(uword a=0; a < e_vars.size(); ++a)
+      {
+      const uword v = e_vars[a];
+      
+      if( (G.state[v] == state_variable) && (G.mark[v] != s) )  { G.mark[v] = s; Lp.push_back(v); }
+      }
+    
+    G.state[e]       = state_absorbed;
+    G.absorbed_by[e] = p;
+    
+    std::vector<uword>().swap(G.vars_of_elem[e]);
+    }
+  
+  G.state[p] = state_element;
+  
+  std::vector<uword>().swap(G.vars_of_var[p]);
+  std::vector<uword>().swap(G.elems_of_var[p]);
+  
+  // variables in the new element are connected through it, so direct links between them are no longer needed
+  
+  const uword Lp_n = uword(Lp.size());
+  
+  for(uword c=0; c < Lp_n; ++c)
+    {
+    const uword i = Lp[c];
+    
+    G.bucket_remove(i);
+    
+    std::vector<uword>& vars  = G.vars_of_var[i];
+    std::vector<uword>& elems = G.elems_of_var[i];
+    
+    uword count = 0;
+    
+    for(uword a=0; a < vars.size(); ++a)
+      {
+      const uword v = vars[a];
+      
+      if( (G.state[v] == state_variable) && (G.mark[v] != s) )  { vars[count++] = v; }
+      }
+    
+    vars.resize(count);
+    
+    count = 0;
+    
+    for(uword b=0; b < elems.size(); ++b)
+      {
+      if(G.state[ elems[b] ] == state_element)  { elems[count++] = elems[b]; }
+      }
+    
+    elems.resize(count);
+    
+    elems.push_back(p);
+    }
+  
+  sp_mindeg::merge_indistinguishable(G, p);
+  
+  // merged variables are removed from the new element before the degrees are computed,
+  // as external_degree() compacts the elements it visits, including this one
+  
+  uword count = 0;
+  
+  for(uword c=0; c < Lp_n; ++c)
+    {
+    if(G.state[ Lp[c] ] == state_variable)  { Lp[count++] = Lp[c]; }
+    }
+  
+  Lp.resize(count);
+  
+  for(uword c=0; c < count; ++c)
+    {
+    const uword i = Lp[c];
+    
+    G.bucket_insert( i, sp_mindeg::external_degree(G, i) );
+    }
+  }
+
+
+
+//! variables of the new element p with the same adjacent variables and elements are merged into one supervariable;
+//! candidates are found by sorting on a hash of the adjacency
+inline
+void
+sp_mindeg::merge_indistinguishable(graph& G, const uword p)
+  {
+  const std::vector<uword>& Lp = G.vars_of_elem[p];
+  
+  std::vector< std::pair<uword,uword> > keys;
+  
+  keys.reserve(Lp.size());
+  
+  for(uword c=0; c < Lp.size(); ++c)
+    {
+    const uword i = Lp[c];
+    
+    const std::vector<uword>& vars  = G.vars_of_var[i];
+    const std::vector<uword>& elems = G.elems_of_var[i];
+    
+    uword h = 0;
+    
+    for(uword a=0; a < vars.size();  ++a)  { h += vars[a];  }
+    for(uword b=0; b < elems.size(); ++b)  { h += elems[b]; }
+    
+    keys.push_back( std::make_pair(h, i) );
+    }
+  
+  std::sort(keys.begin(), keys.end());
+  
+  const uword n_keys = uword(keys.size());
+  
+  uword start = 0;
+  
+  while(start < n_keys)
+    {
+    uword end = start + 1;
+    
+    while( (end < n_keys) && (keys[end].first == keys[start].first) )  { ++end; }
+    
+    if( (end - start) > 1 )
+      {
+      for(uword a=start; a < end; ++a)
+        {
+        const uword i = keys[a].second;
+        
+        std::sort(G.vars_of_var[i].begin(),  G.vars_of_var[i].end() );
+        std::sort(G.elems_of_var[i].begin(), G.elems_of_var[i].end());
+        }
+      
+      for(uword a=start; a < end; ++a)
+        {
+        const uword i = keys[a].second;
+        
+        if(G.state[i] != state_variable)  { continue; }
+        
+        for(uword b=a+1; b < end; ++b)
+          {
+          const uword j = keys[b].second;
+          
+          if(G.state[j] != state_variable)  { continue; }
+          
+          if( (G.vars_of_var[i] != G.vars_of_var[j]) || (G.elems_of_var[i] != G.elems_of_var[j]) )  { continue; }
+          
+          G.weight[i] += G.weight[j];
+          G.weight[j]  = 0;
+          G.state[j]   = state_merged;
+          
+          G.member_next[ G.member_last[i] ] = j;
+          G.member_last[i] = G.member_last[j];
+          
+          std::vector<uword>().swap(G.vars_of_var[j]);
+          std::vector<uword>().swap(G.elems_of_var[j]);
+          }
+        }
+      }
+    
+    start = end;
+    }
+  }
+
+
+
+//! number of original nodes adjacent to variable i, not counting the nodes in i itself;
+//! eliminated and merged variables are removed from the elements of i along the way
+inline
+uword
+sp_mindeg::external_degree(graph& G, const uword i)
+  {
+  const uword s = G.new_stamp();
+  
+  G.mark[i] = s;
+  
+  uword d = 0;
+  
+  const std::vector<uword>& i_vars  = G.vars_of_var[i];
+  const std::vector<uword>& i_elems = G.elems_of_var[i];
+  
+  for(uword a=0; a < i_vars.size(); ++a)
+    {
+    const uword v = i_vars[a];
+    
+    if( (G.state[v] == state_variable) && (G.mark[v] != s) )  { G.mark[v] = s; d += G.weight[v]; }
+    }
+  
+  for(uword b=0; b < i_elems.size(); ++b)
+    {
+    std::vector<uword>& vars = G.vars_of_elem[ i_elems[b] ];
+    
+    uword count = 0;
+    
+    for(uword a=0; a < vars.size(); ++a)
+      {
+      const uword v = vars[a];
+      
+      if(G.state[v] != state_variable)  { continue; }
+      
+      vars[count++] = v;
+      
+      if(G.mark[v] != s)  { G.mark[v] = s; d += G.weight[v]; }
+      }
+    
+    vars.resize(count);
+    }
+  
+  return d;
+  }
+
+
+
+//! @}
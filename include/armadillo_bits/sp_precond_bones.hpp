@@ -0,0 +1,101 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_precond
+//! @{
+
+
+//! preconditioners for the iterative solvers pcg(), bicgstab() and gmres();
+//! apply() computes out = inv(M)*in, where M is an approximation of A
+
+
+template<typename eT>
+class sp_precond_none
+  {
+  public:
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const  { out = in; }
+  };
+
+
+
+//! M = diag(A)
+template<typename eT>
+class sp_precond_jacobi
+  {
+  public:
+  
+  inline bool init(const SpMat<eT>& A);  //!< returns false if the diagonal of A has a zero element
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const;
+  
+  
+  private:
+  
+  Col<eT> diag_inv;
+  };
+
+
+
+//! incomplete LU factorisation without fill-in: M = L*U, where L and U have the sparsity pattern of A;
+//! the factors overwrite a copy of the CSC arrays of A: L is the lower triangular part (including the diagonal)
+//! and U is the strictly upper triangular part (with an implied unit diagonal)
+template<typename eT>
+class sp_precond_ilu0
+  {
+  public:
+  
+  inline bool init(const SpMat<eT>& A);  //!< returns false if a diagonal element is missing or a zero pivot is encountered
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const;
+  
+  
+  private:
+  
+  uword n = 0;
+  
+  podarray<uword> col_ptrs;
+  podarray<uword> row_indices;
+  podarray<uword> diag_pos;     //!< position of the diagonal element of each column
+  podarray<eT>    values;
+  };
+
+
+
+//! incomplete Cholesky factorisation without fill-in: M = L*L', where L has the sparsity pattern of the lower triangular part of A;
+//! A must be symmetric/hermitian positive definite; only the lower triangular part of A is used
+template<typename eT>
+class sp_precond_ic0
+  {
+  public:
+  
+  inline bool init(const SpMat<eT>& A);  //!< returns false if a diagonal element is missing or a non-positive pivot is encountered
+  
+  inline void apply(Col<eT>& out, const Col<eT>& in) const;
+  
+  
+  private:
+  
+  uword n = 0;
+  
+  podarray<uword> col_ptrs;     //!< the first element of each column is the diagonal element
+  podarray<uword> row_indices;
+  podarray<eT>    values;
+  };
+
+
+
+//! @}
@@ -0,0 +1,303 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_precond
+//! @{
+
+
+
+template<typename eT>
+inline
+bool
+sp_precond_jacobi<eT>::init(const SpMat<eT>& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  diag_inv = A.diag();
+  
+  const uword N   = diag_inv.n_elem;
+        eT*   mem = diag_inv.memptr();
+  
+  for(uword i=0; i < N; ++i)
+    {
+    if(mem[i] == eT(0))  { diag_inv.reset(); return false; }
+    
+    mem[i] = eT(1) / mem[i];
+    }
+  
+  return true;
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_precond_jacobi<eT>::apply(Col<eT>& out, const Col<eT>& in) const
+  {
+  out = diag_inv % in;
+  }
+
+
+
+template<typename eT>
+inline
+bool
+sp_precond_ilu0<eT>::init(const SpMat<eT>& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_check( (A.n_rows != A.n_cols), "sp_precond_ilu0::init(): matrix must be square sized" );
+  
+  A.sync();
+  
+  n = A.n_rows;
+  
+  col_ptrs.set_size(n+1);
+  row_indices.set_size(A.n_nonzero);
+  values.set_size(A.n_nonzero);
+  diag_pos.set_size(n);
+  
+  arrayops::copy(col_ptrs.memptr(),    A.col_ptrs,    n+1        );
+  arrayops::copy(row_indices.memptr(), A.row_indices, A.n_nonzero);
+  arrayops::copy(values.memptr(),      A.values,      A.n_nonzero);
+  
+  const uword none = ARMA_MAX_UWORD;
+  
+  for(uword j=0; j < n; ++j)
+    {
+    diag_pos[j] = none;
+    
+    for(uword p=col_ptrs[j]; p < col_ptrs[j+1]; ++p)
+      {
+      if(row_indices[p] == j)  { diag_pos[j] = p; break; }
+      }
+    
+    if(diag_pos[j] == none)  { n = 0; return false; }
+    }
+  
+  // IKJ variant of Gaussian elimination, applied to A' (whose rows are the columns of A),
+  // restricted to the sparsity pattern; this gives A' = L1*U1 and hence A = U1'*L1'
+  
+  podarray<uword> pos(n);
+  
+  pos.fill(none);
+  
+  for(uword i=0; i < n; ++i)
+    {
+    const uword p_start = col_ptrs[i];
+    const uword p_end   = col_ptrs[i+1];
+    
+    for(uword p=p_start; p < p_end; ++p)  { pos[ row_indices[p] ] = p; }
+    
+    for(uword p=p_start; p < diag_pos[i]; ++p)
+      {
+      const uword k = row_indices[p];
+      
+      const eT l_ik = values[p] / values[ diag_pos[k] ];
+      
+      values[p] = l_ik;
+      
+      for(uword q=diag_pos[k]+1; q < col_ptrs[k+1]; ++q)
+        {
+        const uword target = pos[ row_indices[q] ];
+        
+        if(target != none)  { values[target] -= l_ik * values[q]; }
+        }
+      }
+    
+    for(uword p=p_start; p < p_end; ++p)  { pos[ row_indices[p] ] = none; }
+    
+    if(values[ diag_pos[i] ] == eT(0))  { n = 0; return false; }
+    }
+  
+  return true;
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_precond_ilu0<eT>::apply(Col<eT>& out, const Col<eT>& in) const
+  {
+  arma_debug_check( (in.n_elem != n), "sp_precond_ilu0::apply(): size mismatch" );
+  
+  out = in;
+  
+  eT* y = out.memptr();
+  
+  // solve L*y = in, with L stored column-wise in the lower triangular part
+  
+  for(uword i=0; i < n; ++i)
+    {
+    const eT yi = y[i] / values[ diag_pos[i] ];
+    
+    y[i] = yi;
+    
+    for(uword p=diag_pos[i]+1; p < col_ptrs[i+1]; ++p)  { y[ row_indices[p] ] -= values[p] * yi; }
+    }
+  
+  // solve U*out = y, with U stored column-wise in the strictly upper triangular part
+  
+  for(uword ii=n; ii > 0; --ii)
+    {
+    const uword i  = ii-1;
+    const eT    yi = y[i];
+    
+    for(uword p=col_ptrs[i]; p < diag_pos[i]; ++p)  { y[ row_indices[p] ] -= values[p] * yi; }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+bool
+sp_precond_ic0<eT>::init(const SpMat<eT>& A)
+  {
+  arma_extra_debug_sigprint();
+  
+  typedef typename get_pod_type<eT>::result T;
+  
+  arma_debug_check( (A.n_rows != A.n_cols), "sp_precond_ic0::init(): matrix must be square sized" );
+  
+  A.sync();
+  
+  n = A.n_rows;
+  
+  // extract the lower triangular part; row indices in each column are sorted, so the diagonal comes first
+  
+  col_ptrs.set_size(n+1);
+  
+  col_ptrs[0] = 0;
+  
+  for(uword j=0; j < n; ++j)
+    {
+    uword count = 0;
+    
+    for(uword p=A.col_ptrs[j]; p < A.col_ptrs[j+1]; ++p)  { count += (A.row_indices[p] >= j) ? uword(1) : uword(0); }
+    
+    col_ptrs[j+1] = col_ptrs[j] + count;
+    }
+  
+  row_indices.set_size(col_ptrs[n]);
+  values.set_size(col_ptrs[n]);
+  
+  for(uword j=0; j < n; ++j)
+    {
+    uword q = col_ptrs[j];
+    
+    for(uword p=A.col_ptrs[j]; p < A.col_ptrs[j+1]; ++p)
+      {
+      const uword i = A.row_indices[p];
+      
+      if(i >= j)  { row_indices[q] = i; values[q] = A.values[p]; ++q; }
+      }
+    
+    if( (col_ptrs[j] == col_ptrs[j+1]) || (row_indices[ col_ptrs[j] ] != j) )  { n = 0; return false; }
+    }
+  
+  // right-looking factorisation restricted to the sparsity pattern
+  
+  const uword none = ARMA_MAX_UWORD;
+  
+  podarray<uword> pos(n);
+  
+  pos.fill(none);
+  
+  for(uword k=0; k < n; ++k)
+    {
+    const uword p_diag = col_ptrs[k];
+    const uword p_end  = col_ptrs[k+1];
+    
+    const T d = access::tmp_real(values[p_diag]);
+    
+    if( (d <= T(0)) || arma_isnan(d) )  { n = 0; return false; }
+    
+    const T l_kk = std::sqrt(d);
+    
+    values[p_diag] = eT(l_kk);
+    
+    for(uword p=p_diag+1; p < p_end; ++p)  { values[p] /= l_kk; }
+    
+    // update the columns j > k which have an element in row j of column k
+    
+    for(uword p=p_diag+1; p < p_end; ++p)
+      {
+      const uword j    = row_indices[p];
+      const eT    l_jk = access::alt_conj(values[p]);
+      
+      for(uword q=col_ptrs[j]; q < col_ptrs[j+1]; ++q)  { pos[ row_indices[q] ] = q; }
+      
+      for(uword pp=p; pp < p_end; ++pp)
+        {
+        const uword target = pos[ row_indices[pp] ];
+        
+        if(target != none)  { values[target] -= values[pp] * l_jk; }
+        }
+      
+      for(uword q=col_ptrs[j]; q < col_ptrs[j+1]; ++q)  { pos[ row_indices[q] ] = none; }
+      }
+    }
+  
+  return true;
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_precond_ic0<eT>::apply(Col<eT>& out, const Col<eT>& in) const
+  {
+  arma_debug_check( (in.n_elem != n), "sp_precond_ic0::apply(): size mismatch" );
+  
+  out = in;
+  
+  eT* y = out.memptr();
+  
+  // solve L*y = in
+  
+  for(uword k=0; k < n; ++k)
+    {
+    const uword p_diag = col_ptrs[k];
+    
+    const eT yk = y[k] / values[p_diag];
+    
+    y[k] = yk;
+    
+    for(uword p=p_diag+1; p < col_ptrs[k+1]; ++p)  { y[ row_indices[p] ] -= values[p] * yk; }
+    }
+  
+  // solve L'*out = y
+  
+  for(uword kk=n; kk > 0; --kk)
+    {
+    const uword k      = kk-1;
+    const uword p_diag = col_ptrs[k];
+    
+    eT acc = y[k];
+    
+    for(uword p=p_diag+1; p < col_ptrs[k+1]; ++p)  { acc -= access::alt_conj(values[p]) * y[ row_indices[p] ]; }
+    
+    y[k] = acc / values[p_diag];
+    }
+  }
+
+
+
+//! @}
@@ -0,0 +1,79 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_sell
+//! @{
+
+
+//! SELL-C-sigma representation of a sparse matrix:
+//! the rows are grouped into chunks of chunk_size consecutive rows (after sorting),
+//! and each chunk is stored column by column, padded with zeros to the length of its longest row,
+//! so that the rows within a chunk can be processed together by SIMD instructions;
+//! to reduce the padding, the rows within each window of sigma rows are sorted by decreasing number of non-zero elements
+template<typename eT>
+class sp_sell
+  {
+  public:
+  
+  typedef eT                                elem_type;
+  typedef typename get_pod_type<eT>::result pod_type;
+  
+  const uword n_rows;
+  const uword n_cols;
+  const uword n_nonzero;    //!< number of non-zero elements, excluding padding
+  const uword chunk_size;
+  const uword sigma;
+  const uword n_chunks;
+  const uword n_elem_padded;  //!< number of stored elements, including padding
+  
+  const uword* row_perm;     //!< n_chunks*chunk_size elements; original row of each slot, or n_rows for padding slots
+  const uword* row_lens;     //!< n_chunks*chunk_size elements; number of non-zero elements in each slot
+  const uword* chunk_ptrs;   //!< n_chunks+1 elements; chunk c occupies positions chunk_ptrs[c] to chunk_ptrs[c+1]-1
+  const uword* col_indices;  //!< element j of slot r in chunk c is at position chunk_ptrs[c] + j*chunk_size + r
+  const eT*    values;
+  
+  static constexpr uword max_chunk_size = 64;
+  static constexpr uword mp_threshold   = 16384;  //!< min number of multiply-adds for parallelised multiplication
+  
+  inline ~sp_sell();
+  
+  inline explicit sp_sell(const SpMat<eT>& A, const uword in_chunk_size = 8, const uword in_sigma = 256);
+  
+  inline sp_sell(const sp_sell& x);
+  
+  sp_sell()                          = delete;
+  sp_sell& operator=(const sp_sell&) = delete;
+  
+  inline void times(Mat<eT>& out, const Mat<eT>& X) const;
+  
+  
+  private:
+  
+  podarray<uword> own_row_perm;
+  podarray<uword> own_row_lens;
+  podarray<uword> own_chunk_ptrs;
+  podarray<uword> own_col_indices;
+  podarray<eT>    own_values;
+  
+  template<uword fixed_size>
+  inline void times_chunks(Mat<eT>& out, const Mat<eT>& X, const uword chunk_start, const uword chunk_end) const;
+  
+  inline void times_chunks_dispatch(Mat<eT>& out, const Mat<eT>& X, const uword chunk_start, const uword chunk_end) const;
+  };
+
+
+
+//! @}
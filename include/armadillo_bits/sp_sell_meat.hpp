@@ -0,0 +1,306 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup sp_sell
+//! @{
+
+
+
+template<typename eT>
+inline
+sp_sell<eT>::~sp_sell()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+sp_sell<eT>::sp_sell(const SpMat<eT>& A, const uword in_chunk_size, const uword in_sigma)
+  : n_rows       (A.n_rows)
+  , n_cols       (A.n_cols)
+  , n_nonzero    (0)
+  , chunk_size   (in_chunk_size)
+  , sigma        (in_sigma)
+  , n_chunks     (0)
+  , n_elem_padded(0)
+  , row_perm     (nullptr)
+  , row_lens     (nullptr)
+  , chunk_ptrs   (nullptr)
+  , col_indices  (nullptr)
+  , values       (nullptr)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  arma_debug_check( ((chunk_size == 0) || (chunk_size > max_chunk_size)), "sp_sell::sp_sell(): chunk_size must be in the range [1,64]" );
+  
+  arma_debug_check( (sigma == 0), "sp_sell::sp_sell(): sigma must be greater than zero" );
+  
+  const sp_csr<eT> B(A);
+  
+  access::rw(n_nonzero) = B.n_nonzero;
+  access::rw(n_chunks)  = (n_rows + chunk_size - 1) / chunk_size;
+  
+  const uword n_slots = n_chunks * chunk_size;
+  
+  // sort the rows within each window of sigma rows by decreasing length;
+  // stable sorting keeps the original order of rows with equal length
+  
+  own_row_perm.set_size(n_slots);
+  
+  uword* out_row_perm = own_row_perm.memptr();
+  
+  for(uword row=0;       row  < n_rows;  ++row )  { out_row_perm[row ] = row;    }
+  for(uword slot=n_rows; slot < n_slots; ++slot)  { out_row_perm[slot] = n_rows; }
+  
+  if(sigma > 1)
+    {
+    const uword* B_row_ptrs = B.row_ptrs;
+    
+    for(uword window_start=0; window_start < n_rows; window_start += sigma)
+      {
+      const uword window_end = (std::min)(window_start + sigma, n_rows);
+      
+      std::stable_sort( out_row_perm + window_start, out_row_perm + window_end, [B_row_ptrs](const uword a, const uword b) { return (B_row_ptrs[a+1] - B_row_ptrs[a]) > (B_row_ptrs[b+1] - B_row_ptrs[b]); } );
+      }
+    }
+  
+  own_row_lens.set_size(n_slots);
+  
+  uword* out_row_lens = own_row_lens.memptr();
+  
+  for(uword slot=0; slot < n_slots; ++slot)
+    {
+    const uword row = out_row_perm[slot];
+    
+    out_row_lens[slot] = (row < n_rows) ? B.row_n_nonzero(row) : uword(0);
+    }
+  
+  // each chunk is padded to the length of its longest row
+  
+  own_chunk_ptrs.set_size(n_chunks + 1);
+  
+  uword* out_chunk_ptrs = own_chunk_ptrs.memptr();
+  
+  out_chunk_ptrs[0] = 0;
+  
+  for(uword chunk=0; chunk < n_chunks; ++chunk)
+    {
+    uword chunk_len = 0;
+    
+    for(uword r=0; r < chunk_size; ++r)  { chunk_len = (std::max)(chunk_len, out_row_lens[chunk * chunk_size + r]); }
+    
+    out_chunk_ptrs[chunk + 1] = out_chunk_ptrs[chunk] + chunk_len * chunk_size;
+    }
+  
+  access::rw(n_elem_padded) = out_chunk_ptrs[n_chunks];
+  
+  // padding elements have a value of zero and refer to column 0, so that they can be loaded like other elements;
+  // their products are discarded in times_chunks(), as 0 times a non-finite element of X is not zero
+  
+  own_col_indices.zeros(n_elem_padded);
+  own_values.zeros(n_elem_padded);
+  
+  uword* out_col_indices = own_col_indices.memptr();
+  eT*    out_values      = own_values.memptr();
+  
+  for(uword chunk=0; chunk < n_chunks; ++chunk)
+    {
+    const uword chunk_offset = out_chunk_ptrs[chunk];
+    
+    for(uword r=0; r < chunk_size; ++r)
+      {
+      const uword row = out_row_perm[chunk * chunk_size + r];
+      
+      if(row >= n_rows)  { continue; }
+      
+      const uword index_start = B.row_ptrs[row];
+      const uword row_len     = B.row_ptrs[row + 1] - index_start;
+      
+      for(uword j=0; j < row_len; ++j)
+        {
+        const uword dest = chunk_offset + j * chunk_size + r;
+        
+        out_col_indices[dest] = B.col_indices[index_start + j];
+        out_values     [dest] = B.values     [index_start + j];
+        }
+      }
+    }
+  
+  row_perm    = out_row_perm;
+  row_lens    = out_row_lens;
+  chunk_ptrs  = out_chunk_ptrs;
+  col_indices = out_col_indices;
+  values      = out_values;
+  }
+
+
+
+template<typename eT>
+inline
+sp_sell<eT>::sp_sell(const sp_sell<eT>& x)
+  : n_rows         (x.n_rows)
+  , n_cols         (x.n_cols)
+  , n_nonzero      (x.n_nonzero)
+  , chunk_size     (x.chunk_size)
+  , sigma          (x.sigma)
+  , n_chunks       (x.n_chunks)
+  , n_elem_padded  (x.n_elem_padded)
+  , row_perm       (nullptr)
+  , row_lens       (nullptr)
+  , chunk_ptrs     (nullptr)
+  , col_indices    (nullptr)
+  , values         (nullptr)
+  , own_row_perm   (x.own_row_perm)
+  , own_row_lens   (x.own_row_lens)
+  , own_chunk_ptrs (x.own_chunk_ptrs)
+  , own_col_indices(x.own_col_indices)
+  , own_values     (x.own_values)
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  row_perm    = own_row_perm.memptr();
+  row_lens    = own_row_lens.memptr();
+  chunk_ptrs  = own_chunk_ptrs.memptr();
+  col_indices = own_col_indices.memptr();
+  values      = own_values.memptr();
+  }
+
+
+
+//! out = A*X, where A is this matrix; the chunks of A are distributed over threads when OpenMP is enabled
+template<typename eT>
+inline
+void
+sp_sell<eT>::times(Mat<eT>& out, const Mat<eT>& X) const
+  {
+  arma_extra_debug_sigprint();
+  
+  arma_debug_assert_mul_size(n_rows, n_cols, X.n_rows, X.n_cols, "matrix multiplication");
+  
+  out.set_size(n_rows, X.n_cols);
+  
+  if( (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && ((double(n_elem_padded) * double(X.n_cols)) >= double(mp_threshold)) )
+    {
+    #if defined(ARMA_USE_OPENMP)
+      {
+      const int   n_threads      = mp_thread_limit::get();
+      const uword n_chunks_group = (std::max)(uword(1), uword(256) / chunk_size);
+      const uword n_groups       = (n_chunks + n_chunks_group - 1) / n_chunks_group;
+      
+      #pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+      for(uword group=0; group < n_groups; ++group)
+        {
+        const uword chunk_start = group * n_chunks_group;
+        const uword chunk_end   = (std::min)(chunk_start + n_chunks_group, n_chunks);
+        
+        times_chunks_dispatch(out, X, chunk_start, chunk_end);
+        }
+      }
+    #endif
+    }
+  else
+    {
+    times_chunks_dispatch(out, X, 0, n_chunks);
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+sp_sell<eT>::times_chunks_dispatch(Mat<eT>& out, const Mat<eT>& X, const uword chunk_start, const uword chunk_end) const
+  {
+  switch(chunk_size)
+    {
+    case 4:  times_chunks< 4>(out, X, chunk_start, chunk_end);  break;
+    case 8:  times_chunks< 8>(out, X, chunk_start, chunk_end);  break;
+    case 16: times_chunks<16>(out, X, chunk_start, chunk_end);  break;
+    case 32: times_chunks<32>(out, X, chunk_start, chunk_end);  break;
+    default: times_chunks< 0>(out, X, chunk_start, chunk_end);
+    }
+  }
+
+
+
+//! fixed_size is the chunk size known at compile time, or 0 if it is only known at run time;
+//! with a fixed chunk size the accumulators are held in registers and the loops over the rows of a chunk are vectorised
+template<typename eT>
+template<uword fixed_size>
+inline
+void
+sp_sell<eT>::times_chunks(Mat<eT>& out, const Mat<eT>& X, const uword chunk_start, const uword chunk_end) const
+  {
+  const uword C        = (fixed_size > 0) ? fixed_size : chunk_size;
+  const uword X_n_cols = X.n_cols;
+  
+  eT acc[ (fixed_size > 0) ? fixed_size : max_chunk_size ];
+  
+  for(uword col=0; col < X_n_cols; ++col)
+    {
+    const eT*   X_colptr = X.colptr(col);
+          eT* out_colptr = out.colptr(col);
+    
+    for(uword chunk = chunk_start; chunk < chunk_end; ++chunk)
+      {
+      for(uword r=0; r < C; ++r)  { acc[r] = eT(0); }
+      
+      const uword index_start = chunk_ptrs[chunk    ];
+      const uword index_end   = chunk_ptrs[chunk + 1];
+      
+      const uword* chunk_row_lens = &(row_lens[chunk * C]);
+      
+      uword min_len = chunk_row_lens[0];
+      
+      for(uword r=1; r < C; ++r)  { min_len = (std::min)(min_len, chunk_row_lens[r]); }
+      
+      // the first min_len elements of each slot contain no padding
+      
+      const uword index_mid = index_start + min_len * C;
+      
+      for(uword index = index_start; index < index_mid; index += C)
+        {
+        const uword* chunk_col_indices = &(col_indices[index]);
+        const eT*    chunk_values      = &(values[index]);
+        
+        for(uword r=0; r < C; ++r)  { acc[r] += chunk_values[r] * X_colptr[chunk_col_indices[r]]; }
+        }
+      
+      for(uword index = index_mid, j = min_len; index < index_end; index += C, ++j)
+        {
+        const uword* chunk_col_indices = &(col_indices[index]);
+        const eT*    chunk_values      = &(values[index]);
+        
+        for(uword r=0; r < C; ++r)  { acc[r] += (j < chunk_row_lens[r]) ? (chunk_values[r] * X_colptr[chunk_col_indices[r]]) : eT(0); }
+        }
+      
+      const uword* chunk_row_perm = &(row_perm[chunk * C]);
+      
+      for(uword r=0; r < C; ++r)
+        {
+        const uword row = chunk_row_perm[r];
+        
+        if(row < n_rows)  { out_colptr[row] = acc[r]; }
+        }
+      }
+    }
+  }
+
+
+
+//! @}
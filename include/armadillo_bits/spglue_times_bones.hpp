@@ -39,6 +39,14 @@ class spglue_times
   
   template<typename eT>
   arma_hot inline static void apply_noalias(SpMat<eT>& c, const SpMat<eT>& x, const SpMat<eT>& y);
+  
+  template<typename eT>
+  arma_hot inline static uword symbolic_col(const SpMat<eT>& x, const SpMat<eT>& y, const uword col, uword* marker);
+  
+  template<typename eT>
+  arma_hot inline static uword numeric_col(uword* out_row_indices, eT* out_values, const SpMat<eT>& x, const SpMat<eT>& y, const uword col, uword* marker, eT* sums, uword* rows);
+  
+  static constexpr uword mp_threshold = 8192;  //!< min number of non-zeros in x and y for parallelised apply_noalias()
   };
 
 
@@ -60,6 +68,15 @@ class spglue_times_misc
   
   template<typename T1, typename T2>
   inline static void dense_times_sparse(Mat<typename T1::elem_type>& out, const T1& x, const T2& y);
+  
+  template<typename eT>
+  arma_hot inline static void sparse_times_dense_mp(Mat<eT>& out, const SpMat<eT>& A, const Mat<eT>& B, const int n_threads);
+  
+  template<typename eT>
+  arma_hot inline static void sparse_times_dense_cols(eT* out_mem, const SpMat<eT>& A, const Mat<eT>& B, const uword A_col_start, const uword A_col_end, const uword B_col_start, const uword B_col_end);
+  
+  static constexpr uword n_block_cols = 4;      //!< number of columns of B processed per pass over A by one thread
+  static constexpr uword mp_threshold = 16384;  //!< min number of multiply-adds for parallelised sparse_times_dense()
   };
 
 
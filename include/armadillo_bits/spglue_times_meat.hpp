@@ -93,192 +93,269 @@ spglue_times::apply_noalias(SpMat<eT>& c, const SpMat<eT>& x, const SpMat<eT>& y
   const uword x_n_cols = x.n_cols;
   const uword y_n_rows = y.n_rows;
   const uword y_n_cols = y.n_cols;
-
+  
   arma_debug_assert_mul_size(x_n_rows, x_n_cols, y_n_rows, y_n_cols, "matrix multiplication");
-
-  // First we must determine the structure of the new matrix (column pointers).
-  // This follows the algorithm described in 'Sparse Matrix Multiplication
-  // Package (SMMP)' (R.E. Bank and C.C. Douglas, 2001).  Their description of
-  // "SYMBMM" does not include anything about memory allocation.  In addition it
-  // does not consider that there may be elements which space may be allocated
-  // for but which evaluate to zero anyway.  So we have to modify the algorithm
-  // to work that way.  For the "SYMBMM" implementation we will not determine
-  // the row indices but instead just the column pointers.
   
-  //SpMat<typename T1::elem_type> c(x_n_rows, y_n_cols); // Initializes col_ptrs to 0.
   c.zeros(x_n_rows, y_n_cols);
   
-  //if( (x.n_elem == 0) || (y.n_elem == 0) )  { return; }
   if( (x.n_nonzero == 0) || (y.n_nonzero == 0) )  { return; }
   
-  // Auxiliary storage which denotes when items have been found.
-  podarray<uword> index(x_n_rows);
-  index.fill(x_n_rows); // Fill with invalid links.
+  // Gustavson's algorithm: column j of c is the sum of the columns of x
+  // selected by the non-zero elements in column j of y, gathered in a dense accumulator.
+  // The symbolic pass counts the distinct rows in each column of c, which gives the exact amount of memory required;
+  // the numeric pass then fills each column of c in its own slot.
+  // As each column of c is handled independently, the columns are distributed over threads when OpenMP is enabled;
+  // each thread has its own accumulator.
   
-  typename SpMat<eT>::const_iterator y_it  = y.begin();
-  typename SpMat<eT>::const_iterator y_end = y.end();
-
-  // SYMBMM: calculate column pointers for resultant matrix to obtain a good
-  // upper bound on the number of nonzero elements.
-  uword cur_col_length = 0;
-  uword last_ind = x_n_rows + 1;
-  do
+  uword* c_col_ptrs = access::rwp(c.col_ptrs);
+  
+  podarray<uword> c_col_counts(y_n_cols);
+  
+  const bool use_mp = (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && ((x.n_nonzero + y.n_nonzero) >= mp_threshold);
+  
+  if(use_mp)
     {
-    const uword y_it_row = y_it.row();
+    #if defined(ARMA_USE_OPENMP)
+      {
+      arma_extra_debug_print("spglue_times::apply_noalias(): symbolic pass (parallelised)");
+      
+      const int   n_threads  = mp_thread_limit::get();
+      const uword chunk_size = (std::max)( uword(1), y_n_cols / (uword(n_threads) * uword(16)) );
+      
+      #pragma omp parallel num_threads(n_threads)
+        {
+        podarray<uword> marker(x_n_rows);
+        
+        marker.zeros();
+        
+        #pragma omp for schedule(dynamic, chunk_size)
+        for(uword col=0; col < y_n_cols; ++col)
+          {
+          c_col_ptrs[col + 1] = spglue_times::symbolic_col(x, y, col, marker.memptr());
+          }
+        }
+      }
+    #endif
+    }
+  else
+    {
+    arma_extra_debug_print("spglue_times::apply_noalias(): symbolic pass");
+    
+    podarray<uword> marker(x_n_rows);
     
-    // Look through the column that this point (*y_it) could affect.
-    typename SpMat<eT>::const_iterator x_it = x.begin_col_no_sync(y_it_row);
+    marker.zeros();
     
-    while(x_it.col() == y_it_row)
+    for(uword col=0; col < y_n_cols; ++col)
+      {
+      c_col_ptrs[col + 1] = spglue_times::symbolic_col(x, y, col, marker.memptr());
+      }
+    }
+  
+  for(uword col=0; col < y_n_cols; ++col)  { c_col_ptrs[col + 1] += c_col_ptrs[col]; }
+  
+  c.mem_resize(c_col_ptrs[y_n_cols]);
+  
+  uword* c_row_indices = access::rwp(c.row_indices);
+  eT*    c_values      = access::rwp(c.values);
+  
+  if(use_mp)
+    {
+    #if defined(ARMA_USE_OPENMP)
       {
-      const uword x_it_row = x_it.row();
+      arma_extra_debug_print("spglue_times::apply_noalias(): numeric pass (parallelised)");
       
-      // A point at x(i, j) and y(j, k) implies a point at c(i, k).
-      if(index[x_it_row] == x_n_rows)
+      const int   n_threads  = mp_thread_limit::get();
+      const uword chunk_size = (std::max)( uword(1), y_n_cols / (uword(n_threads) * uword(16)) );
+      
+      #pragma omp parallel num_threads(n_threads)
         {
-        index[x_it_row] = last_ind;
-        last_ind = x_it_row;
-        ++cur_col_length;
+        podarray<uword> marker(x_n_rows);
+        podarray<eT>    sums(x_n_rows);
+        podarray<uword> rows(x_n_rows);
+        
+        marker.zeros();
+        
+        #pragma omp for schedule(dynamic, chunk_size)
+        for(uword col=0; col < y_n_cols; ++col)
+          {
+          const uword offset = c_col_ptrs[col];
+          
+          c_col_counts[col] = spglue_times::numeric_col(&(c_row_indices[offset]), &(c_values[offset]), x, y, col, marker.memptr(), sums.memptr(), rows.memptr());
+          }
         }
-
-      ++x_it;
       }
-
-    const uword old_col = y_it.col();
-    ++y_it;
-
-    // See if column incremented.
-    if(old_col != y_it.col())
+    #endif
+    }
+  else
+    {
+    arma_extra_debug_print("spglue_times::apply_noalias(): numeric pass");
+    
+    podarray<uword> marker(x_n_rows);
+    podarray<eT>    sums(x_n_rows);
+    podarray<uword> rows(x_n_rows);
+    
+    marker.zeros();
+    
+    for(uword col=0; col < y_n_cols; ++col)
       {
-      // Set column pointer (this is not a cumulative count; that is done later).
-      access::rw(c.col_ptrs[old_col + 1]) = cur_col_length;
-      cur_col_length = 0;
-
-      // Return index markers to zero.  Use last_ind for traversal.
-      while(last_ind != x_n_rows + 1)
+      const uword offset = c_col_ptrs[col];
+      
+      c_col_counts[col] = spglue_times::numeric_col(&(c_row_indices[offset]), &(c_values[offset]), x, y, col, marker.memptr(), sums.memptr(), rows.memptr());
+      }
+    }
+  
+  // remove the gaps left by sums which evaluated to zero
+  
+  uword c_n_nonzero = 0;
+  
+  for(uword col=0; col < y_n_cols; ++col)  { c_n_nonzero += c_col_counts[col]; }
+  
+  if(c_n_nonzero != c.n_nonzero)
+    {
+    uword pos = 0;
+    
+    for(uword col=0; col < y_n_cols; ++col)
+      {
+      const uword offset = c_col_ptrs[col];
+      const uword count  = c_col_counts[col];
+      
+      if(pos != offset)
         {
-        const uword tmp = index[last_ind];
-        index[last_ind] = x_n_rows;
-        last_ind = tmp;
+        for(uword i=0; i < count; ++i)
+          {
+          c_row_indices[pos + i] = c_row_indices[offset + i];
+          c_values     [pos + i] = c_values     [offset + i];
+          }
         }
+      
+      c_col_ptrs[col] = pos;
+      
+      pos += count;
       }
+    
+    c_col_ptrs[y_n_cols] = pos;
+    
+    c.mem_resize(pos);
     }
-  while(y_it != y_end);
+  }
 
-  // Accumulate column pointers.
-  for(uword i = 0; i < c.n_cols; ++i)
-    {
-    access::rw(c.col_ptrs[i + 1]) += c.col_ptrs[i];
-    }
 
-  // Now that we know a decent bound on the number of nonzero elements, allocate
-  // the memory and fill it.
-  c.mem_resize(c.col_ptrs[c.n_cols]);
 
-  // Now the implementation of the NUMBMM algorithm.
-  uword cur_pos = 0; // Current position in c matrix.
-  podarray<eT> sums(x_n_rows); // Partial sums.
-  sums.zeros();
+//! number of distinct rows in column 'col' of x*y;
+//! marker must not contain the value col+1 for any row, and is updated so that no later column is affected
+template<typename eT>
+arma_hot
+inline
+uword
+spglue_times::symbolic_col(const SpMat<eT>& x, const SpMat<eT>& y, const uword col, uword* marker)
+  {
+  const uword* x_col_ptrs    = x.col_ptrs;
+  const uword* x_row_indices = x.row_indices;
   
-  podarray<uword> sorted_indices(x_n_rows);  // upper bound
+  const uword y_index_start = y.col_ptrs[col    ];
+  const uword y_index_end   = y.col_ptrs[col + 1];
   
-  // last_ind is already set to x_n_rows, and cur_col_length is already set to 0.
-  // We will loop through all columns as necessary.
-  uword cur_col = 0;
-  while(cur_col < c.n_cols)
+  const uword stamp = col + 1;
+  
+  uword count = 0;
+  
+  for(uword y_index = y_index_start; y_index < y_index_end; ++y_index)
     {
-    // Skip to next column with elements in it.
-    while((cur_col < c.n_cols) && (c.col_ptrs[cur_col] == c.col_ptrs[cur_col + 1]))
+    const uword k = y.row_indices[y_index];
+    
+    const uword x_index_end = x_col_ptrs[k + 1];
+    
+    for(uword x_index = x_col_ptrs[k]; x_index < x_index_end; ++x_index)
       {
-      // Update current column pointer to actual number of nonzero elements up
-      // to this point.
-      access::rw(c.col_ptrs[cur_col]) = cur_pos;
-      ++cur_col;
+      const uword row = x_row_indices[x_index];
+      
+      if(marker[row] != stamp)  { marker[row] = stamp; ++count; }
       }
+    }
+  
+  return count;
+  }
 
-    if(cur_col == c.n_cols)
-      {
-      break;
-      }
 
-    // Update current column pointer.
-    access::rw(c.col_ptrs[cur_col]) = cur_pos;
 
-    // Check all elements in this column.
-    typename SpMat<eT>::const_iterator y_col_it = y.begin_col_no_sync(cur_col);
+//! computes column 'col' of x*y, writing the non-zero elements in ascending row order and returning their number;
+//! sums and rows are workspaces with x.n_rows elements
+template<typename eT>
+arma_hot
+inline
+uword
+spglue_times::numeric_col(uword* out_row_indices, eT* out_values, const SpMat<eT>& x, const SpMat<eT>& y, const uword col, uword* marker, eT* sums, uword* rows)
+  {
+  const uword  x_n_rows      = x.n_rows;
+  const uword* x_col_ptrs    = x.col_ptrs;
+  const uword* x_row_indices = x.row_indices;
+  const eT*    x_values      = x.values;
+  
+  const uword y_index_start = y.col_ptrs[col    ];
+  const uword y_index_end   = y.col_ptrs[col + 1];
+  
+  const uword stamp = col + 1;
+  
+  uword n_rows_used = 0;
+  
+  for(uword y_index = y_index_start; y_index < y_index_end; ++y_index)
+    {
+    const uword k     = y.row_indices[y_index];
+    const eT    y_val = y.values[y_index];
+    
+    const uword x_index_end = x_col_ptrs[k + 1];
     
-    while(y_col_it.col() == cur_col)
+    for(uword x_index = x_col_ptrs[k]; x_index < x_index_end; ++x_index)
       {
-      const uword y_col_it_row = y_col_it.row();
+      const uword row = x_row_indices[x_index];
       
-      // Check all elements in the column of the other matrix corresponding to
-      // the row of this column.
-      typename SpMat<eT>::const_iterator x_col_it = x.begin_col_no_sync(y_col_it_row);
-
-      const eT y_value = (*y_col_it);
-
-      while(x_col_it.col() == y_col_it_row)
+      if(marker[row] != stamp)
         {
-        const uword x_col_it_row = x_col_it.row();
+        marker[row] = stamp;
+        sums[row]   = x_values[x_index] * y_val;
         
-        // A point at x(i, j) and y(j, k) implies a point at c(i, k).
-        // Add to partial sum.
-        const eT x_value = (*x_col_it);
-        sums[x_col_it_row] += (x_value * y_value);
-
-        // Add point if it hasn't already been marked.
-        if(index[x_col_it_row] == x_n_rows)
-          {
-          index[x_col_it_row] = last_ind;
-          last_ind = x_col_it_row;
-          }
-
-        ++x_col_it;
+        rows[n_rows_used] = row;
+        ++n_rows_used;
         }
-
-      ++y_col_it;
-      }
-
-    // Now sort the indices that were used in this column.
-    uword cur_index = 0;
-    while(last_ind != x_n_rows + 1)
-      {
-      const uword tmp = last_ind;
-
-      // Check that it wasn't a "fake" nonzero element.
-      if(sums[tmp] != eT(0))
+      else
         {
-        // Assign to next open position.
-        sorted_indices[cur_index] = tmp;
-        ++cur_index;
+        sums[row] += x_values[x_index] * y_val;
         }
-
-      last_ind = index[tmp];
-      index[tmp] = x_n_rows;
       }
-
-    // Now sort the indices.
-    if(cur_index != 0)
+    }
+  
+  // for columns with many elements it's quicker to scan the marker than to sort the row indices
+  
+  if( (n_rows_used * uword(16)) >= x_n_rows )
+    {
+    n_rows_used = 0;
+    
+    for(uword row=0; row < x_n_rows; ++row)
       {
-      op_sort::direct_sort_ascending(sorted_indices.memptr(), cur_index);
-
-      for(uword k = 0; k < cur_index; ++k)
-        {
-        const uword row = sorted_indices[k];
-        access::rw(c.row_indices[cur_pos]) = row;
-        access::rw(c.values[cur_pos]) = sums[row];
-        sums[row] = eT(0);
-        ++cur_pos;
-        }
+      if(marker[row] == stamp)  { rows[n_rows_used] = row; ++n_rows_used; }
       }
-
-    // Move to next column.
-    ++cur_col;
     }
-
-  // Update last column pointer and resize to actual memory size.
-  access::rw(c.col_ptrs[c.n_cols]) = cur_pos;
-  c.mem_resize(cur_pos);
+  else
+    {
+    op_sort::direct_sort_ascending(rows, n_rows_used);
+    }
+  
+  uword count = 0;
+  
+  for(uword i=0; i < n_rows_used; ++i)
+    {
+    const uword row = rows[i];
+    const eT    val = sums[row];
+    
+    if(val != eT(0))
+      {
+      out_row_indices[count] = row;
+      out_values     [count] = val;
+      ++count;
+      }
+    }
+  
+  return count;
   }
 
 
@@ -329,49 +406,177 @@ spglue_times_misc::sparse_times_dense(Mat<typename T1::elem_type>& out, const T1
     
     arma_debug_assert_mul_size(A_n_rows, A_n_cols, B_n_rows, B_n_cols, "matrix multiplication");
     
-    if(B_n_cols >= (B_n_rows / uword(100)))
+    out.zeros(A_n_rows, B_n_cols);
+    
+    if( (A.n_nonzero == 0) || (B.n_elem == 0) )  { return; }
+    
+    if( (arma_config::openmp) && (mp_thread_limit::in_parallel() == false) && ((double(A.n_nonzero) * double(B_n_cols)) >= double(mp_threshold)) )
+      {
+      #if defined(ARMA_USE_OPENMP)
+        {
+        spglue_times_misc::sparse_times_dense_mp(out, A, B, mp_thread_limit::get());
+        }
+      #endif
+      }
+    else
       {
-      arma_extra_debug_print("using transpose-based multiplication");
+      arma_extra_debug_print("using standard multiplication");
       
-      const SpMat<eT> At = A.st();
-      const   Mat<eT> Bt = B.st();
+      spglue_times_misc::sparse_times_dense_cols(out.memptr(), A, B, 0, A_n_cols, 0, B_n_cols);
+      }
+    }
+  }
+
+
+
+template<typename eT>
+inline
+void
+spglue_times_misc::sparse_times_dense_mp(Mat<eT>& out, const SpMat<eT>& A, const Mat<eT>& B, const int n_threads)
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_OPENMP)
+    {
+    const uword A_n_cols = A.n_cols;
+    const uword B_n_cols = B.n_cols;
+    
+    const uword n_blocks = (B_n_cols + n_block_cols - 1) / n_block_cols;
+    
+    if(n_blocks >= uword(n_threads))
+      {
+      arma_extra_debug_print("using parallelised multiplication over the columns of B");
       
-      if(A_n_rows == B_n_cols)
+      #pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+      for(uword block=0; block < n_blocks; ++block)
         {
-        spglue_times_misc::dense_times_sparse(out, Bt, At);
+        const uword B_col_start = block * n_block_cols;
+        const uword B_col_end   = (std::min)(B_col_start + n_block_cols, B_n_cols);
         
-        op_strans::apply_mat(out, out);  // since 'out' is square-sized, this will do an inplace transpose
+        spglue_times_misc::sparse_times_dense_cols(out.colptr(B_col_start), A, B, 0, A_n_cols, B_col_start, B_col_end);
         }
-      else
+      }
+    else
+      {
+      arma_extra_debug_print("using parallelised multiplication over the columns of A");
+      
+      // each thread handles a range of columns of A with roughly the same number of non-zeros,
+      // and accumulates into its own copy of the result; the copies are summed afterwards
+      
+      Mat<eT> partial(out.n_elem, uword(n_threads - 1), fill::zeros);
+      
+      const uword* A_col_ptrs = A.col_ptrs;
+      
+      #pragma omp parallel for schedule(static) num_threads(n_threads)
+      for(int t=0; t < n_threads; ++t)
         {
-        Mat<eT> tmp;
+        const uword nnz_start = uword( (double(A.n_nonzero) * double(t  )) / double(n_threads) );
+        const uword nnz_end   = uword( (double(A.n_nonzero) * double(t+1)) / double(n_threads) );
+        
+        const uword A_col_start =                    uword(std::lower_bound(A_col_ptrs, A_col_ptrs + A_n_cols, nnz_start) - A_col_ptrs);
+        const uword A_col_end   = (t+1 == n_threads) ? A_n_cols : uword(std::lower_bound(A_col_ptrs, A_col_ptrs + A_n_cols, nnz_end) - A_col_ptrs);
         
-        spglue_times_misc::dense_times_sparse(tmp, Bt, At);
+        eT* out_mem = (t == 0) ? out.memptr() : partial.colptr(uword(t-1));
         
-        op_strans::apply_mat(out, tmp);
+        spglue_times_misc::sparse_times_dense_cols(out_mem, A, B, A_col_start, A_col_end, 0, B_n_cols);
+        }
+      
+      const uword out_n_elem     = out.n_elem;
+      const uword partial_n_cols = partial.n_cols;
+      
+      eT* out_mem = out.memptr();
+      
+      #pragma omp parallel for schedule(static) num_threads(n_threads)
+      for(uword i=0; i < out_n_elem; ++i)
+        {
+        eT acc = eT(0);
+        
+        for(uword t=0; t < partial_n_cols; ++t)  { acc += partial.at(i,t); }
+        
+        out_mem[i] += acc;
         }
       }
-    else
+    }
+  #else
+    {
+    arma_ignore(out);
+    arma_ignore(A);
+    arma_ignore(B);
+    arma_ignore(n_threads);
+    }
+  #endif
+  }
+
+
+
+//! adds A.cols(A_col_start, A_col_end-1) * B.submat(A_col_start, B_col_start, A_col_end-1, B_col_end-1) to out_mem,
+//! which holds columns B_col_start to B_col_end-1 of the result (stored column by column, with A.n_rows rows);
+//! the columns of B are processed in blocks, so that each non-zero element of A is loaded once per block
+template<typename eT>
+inline
+void
+spglue_times_misc::sparse_times_dense_cols(eT* out_mem, const SpMat<eT>& A, const Mat<eT>& B, const uword A_col_start, const uword A_col_end, const uword B_col_start, const uword B_col_end)
+  {
+  const uword  out_n_rows    = A.n_rows;
+  const uword* A_col_ptrs    = A.col_ptrs;
+  const uword* A_row_indices = A.row_indices;
+  const eT*    A_values      = A.values;
+  
+  uword j = B_col_start;
+  
+  for(; (j + 4) <= B_col_end; j += 4)
+    {
+    eT* out_col0 = &(out_mem[(j - B_col_start) * out_n_rows]);
+    eT* out_col1 = out_col0 + out_n_rows;
+    eT* out_col2 = out_col1 + out_n_rows;
+    eT* out_col3 = out_col2 + out_n_rows;
+    
+    const eT* B_col0 = B.colptr(j  );
+    const eT* B_col1 = B.colptr(j+1);
+    const eT* B_col2 = B.colptr(j+2);
+    const eT* B_col3 = B.colptr(j+3);
+    
+    for(uword col = A_col_start; col < A_col_end; ++col)
       {
-      arma_extra_debug_print("using standard multiplication");
+      const uword index_start = A_col_ptrs[col    ];
+      const uword index_end   = A_col_ptrs[col + 1];
       
-      out.zeros(A_n_rows, B_n_cols);
+      if(index_start == index_end)  { continue; }
       
-      typename SpMat<eT>::const_iterator A_it     = A.begin();
-      typename SpMat<eT>::const_iterator A_it_end = A.end();
+      const eT B_val0 = B_col0[col];
+      const eT B_val1 = B_col1[col];
+      const eT B_val2 = B_col2[col];
+      const eT B_val3 = B_col3[col];
       
-      while(A_it != A_it_end)
+      for(uword i = index_start; i < index_end; ++i)
         {
-        const eT    A_it_val = (*A_it);
-        const uword A_it_row = A_it.row();
-        const uword A_it_col = A_it.col();
-        
-        for(uword col = 0; col < B_n_cols; ++col)
-          {
-          out.at(A_it_row, col) += A_it_val * B.at(A_it_col, col);
-          }
+        const uword row   = A_row_indices[i];
+        const eT    A_val = A_values[i];
         
-        ++A_it;
+        out_col0[row] += A_val * B_val0;
+        out_col1[row] += A_val * B_val1;
+        out_col2[row] += A_val * B_val2;
+        out_col3[row] += A_val * B_val3;
+        }
+      }
+    }
+  
+  for(; j < B_col_end; ++j)
+    {
+    eT* out_col = &(out_mem[(j - B_col_start) * out_n_rows]);
+    
+    const eT* B_col = B.colptr(j);
+    
+    for(uword col = A_col_start; col < A_col_end; ++col)
+      {
+      const uword index_start = A_col_ptrs[col    ];
+      const uword index_end   = A_col_ptrs[col + 1];
+      
+      const eT B_val = B_col[col];
+      
+      for(uword i = index_start; i < index_end; ++i)
+        {
+        out_col[A_row_indices[i]] += A_values[i] * B_val;
         }
       }
     }
@@ -0,0 +1,105 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup spsolve_factoriser
+//! @{
+
+
+#if defined(ARMA_USE_SUPERLU)
+
+//! LU factorisation of a square sparse matrix via SuperLU, kept for repeated solves;
+//! the column permutation is reused when a matrix with the same sparsity pattern is factorised again
+template<typename eT>
+class superlu_worker
+  {
+  public:
+  
+  typedef typename get_pod_type<eT>::result T;
+  
+  inline ~superlu_worker();
+  inline  superlu_worker(const uword in_n);
+  
+  inline bool factorise(T& out_rcond, const SpMat<eT>& A, const superlu_opts& user_opts);
+  
+  inline bool solve(Mat<eT>& X);
+  
+  inline superlu_worker(const superlu_worker&) = delete;
+  inline void operator= (const superlu_worker&) = delete;
+  
+  
+  private:
+  
+  uword n               = 0;
+  bool  factorised      = false;
+  bool  have_perm_c     = false;  //!< perm_c holds the column permutation for the pattern stored in pattern_col_ptrs and pattern_row_indices
+  
+  podarray<uword> pattern_col_ptrs;
+  podarray<uword> pattern_row_indices;
+  
+  superlu_supermatrix_wrangler l;
+  superlu_supermatrix_wrangler u;
+  
+  superlu_array_wrangler<int> perm_c;
+  superlu_array_wrangler<int> perm_r;
+  superlu_array_wrangler<int> etree;
+  
+  superlu_stat_wrangler stat;
+  
+  inline bool same_pattern(const SpMat<eT>& A) const;
+  };
+
+#endif
+
+
+
+//! factorises a sparse matrix once, and then solves A*X = B for any number of B matrices;
+//! refactorising a matrix with the same sparsity pattern reuses the symbolic analysis (column permutation)
+class spsolve_factoriser
+  {
+  public:
+  
+  inline ~spsolve_factoriser();
+  inline  spsolve_factoriser();
+  
+  template<typename T1>
+  inline bool factorise(const SpBase<typename T1::elem_type,T1>& A_expr, const spsolve_opts_base& settings = spsolve_opts_none(), const typename arma_blas_type_only<typename T1::elem_type>::result* junk = nullptr);
+  
+  template<typename T1>
+  inline bool solve(Mat<typename T1::elem_type>& X, const Base<typename T1::elem_type,T1>& B_expr, const typename arma_blas_type_only<typename T1::elem_type>::result* junk = nullptr);
+  
+  inline double rcond() const;  //!< reciprocal condition number estimate from the last factorisation
+  
+  inline void reset();
+  
+  inline spsolve_factoriser(const spsolve_factoriser&) = delete;
+  inline void operator=    (const spsolve_factoriser&) = delete;
+  
+  
+  private:
+  
+  void*  worker_ptr          = nullptr;
+  uword  elem_type_indicator = 0;  //!< 1: float, 2: double, 3: cx_float, 4: cx_double
+  uword  n                   = 0;
+  double rcond_value         = 0.0;
+  
+  template<typename eT> inline static uword get_elem_type_indicator();
+  
+  template<typename eT> inline void delete_worker();
+  };
+
+
+
+//! @}
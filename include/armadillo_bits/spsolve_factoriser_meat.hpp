@@ -0,0 +1,421 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+//! \addtogroup spsolve_factoriser
+//! @{
+
+
+#if defined(ARMA_USE_SUPERLU)
+
+template<typename eT>
+inline
+superlu_worker<eT>::~superlu_worker()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+superlu_worker<eT>::superlu_worker(const uword in_n)
+  : n     (in_n    )
+  , perm_c(in_n + 1)  // paranoia: increase array length by 1
+  , perm_r(in_n + 1)
+  , etree (in_n + 1)
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+bool
+superlu_worker<eT>::same_pattern(const SpMat<eT>& A) const
+  {
+  if( (A.n_rows != n) || (A.n_cols != n) || (A.n_nonzero != pattern_row_indices.n_elem) )  { return false; }
+  
+  return ( (std::memcmp(A.col_ptrs,    pattern_col_ptrs.memptr(),    (n+1)       * sizeof(uword)) == 0)
+        && (std::memcmp(A.row_indices, pattern_row_indices.memptr(), A.n_nonzero * sizeof(uword)) == 0) );
+  }
+
+
+
+template<typename eT>
+inline
+bool
+superlu_worker<eT>::factorise(T& out_rcond, const SpMat<eT>& A, const superlu_opts& user_opts)
+  {
+  arma_extra_debug_sigprint();
+  
+  out_rcond = T(0);
+  
+  // gstrf() allocates new storage for L and U, so the previous factorisation is released first
+  
+  factorised = false;
+  
+  l.reset();
+  u.reset();
+  
+  superlu::superlu_options_t options;
+  sp_auxlib::set_superlu_opts(options, user_opts);
+  
+  const bool reuse_perm_c = (have_perm_c) && (same_pattern(A));
+  
+  superlu_supermatrix_wrangler a;
+  superlu_supermatrix_wrangler ac;
+  
+  if(sp_auxlib::copy_to_supermatrix(a.get_ref(), A) == false)  { return false; }
+  
+  if(reuse_perm_c)
+    {
+    options.Fact = superlu::SamePattern;
+    }
+  else
+    {
+    options.Fact = superlu::DOFACT;
+    
+    have_perm_c = false;
+    
+    arma_extra_debug_print("superlu::get_permutation_c()");
+    superlu::get_permutation_c(options.ColPerm, a.get_ptr(), perm_c.get_ptr());
+    }
+  
+  superlu::GlobalLU_t glu;
+  arrayops::fill_zeros(reinterpret_cast<char*>(&glu), sizeof(superlu::GlobalLU_t));
+  
+  int panel_size = superlu::sp_ispec_environ(1);
+  int relax      = superlu::sp_ispec_environ(2);
+  int lwork      = 0;
+  int info       = 0;
+  
+  arma_extra_debug_print("superlu::gstrf()");
+  superlu::sp_preorder_mat(&options, a.get_ptr(), perm_c.get_ptr(), etree.get_ptr(), ac.get_ptr());
+  superlu::gstrf<eT>(&options, ac.get_ptr(), relax, panel_size, etree.get_ptr(), NULL, lwork, perm_c.get_ptr(), perm_r.get_ptr(), l.get_ptr(), u.get_ptr(), &glu, stat.get_ptr(), &info);
+  
+  if(reuse_perm_c == false)
+    {
+    pattern_col_ptrs.set_size(n+1);
+    pattern_row_indices.set_size(A.n_nonzero);
+    
+    arrayops::copy(pattern_col_ptrs.memptr(),    A.col_ptrs,    n+1        );
+    arrayops::copy(pattern_row_indices.memptr(), A.row_indices, A.n_nonzero);
+    
+    have_perm_c = true;
+    }
+  
+  if(info != 0)
+    {
+    if(info > int(n))  { arma_debug_warn("spsolve_factoriser::factorise(): memory allocation failure: could not allocate ", (info - int(n)), " bytes"); }
+    
+    l.reset();
+    u.reset();
+    
+    return false;
+    }
+  
+  out_rcond = sp_auxlib::lu_rcond<eT>(l.get_ptr(), u.get_ptr(), sp_auxlib::norm1<eT>(a.get_ptr()));
+  
+  if( ((out_rcond < std::numeric_limits<T>::epsilon()) || arma_isnan(out_rcond)) && (user_opts.allow_ugly == false) )
+    {
+    l.reset();
+    u.reset();
+    
+    return false;
+    }
+  
+  factorised = true;
+  
+  return true;
+  }
+
+
+
+//! X is used as input (the B matrix) and as output (the solution)
+template<typename eT>
+inline
+bool
+superlu_worker<eT>::solve(Mat<eT>& X)
+  {
+  arma_extra_debug_sigprint();
+  
+  if(factorised == false)  { return false; }
+  
+  if(X.is_empty())  { return true; }
+  
+  superlu_supermatrix_wrangler x;
+  
+  if(sp_auxlib::wrap_to_supermatrix(x.get_ref(), X) == false)  { return false; }
+  
+  int info = 0;
+  
+  arma_extra_debug_print("superlu::gstrs()");
+  superlu::gstrs<eT>(superlu::NOTRANS, l.get_ptr(), u.get_ptr(), perm_c.get_ptr(), perm_r.get_ptr(), x.get_ptr(), stat.get_ptr(), &info);
+  
+  return (info == 0);
+  }
+
+#endif
+
+
+
+// 
+
+
+
+inline
+spsolve_factoriser::~spsolve_factoriser()
+  {
+  arma_extra_debug_sigprint_this(this);
+  
+  reset();
+  }
+
+
+
+inline
+spsolve_factoriser::spsolve_factoriser()
+  {
+  arma_extra_debug_sigprint_this(this);
+  }
+
+
+
+template<typename eT>
+inline
+uword
+spsolve_factoriser::get_elem_type_indicator()
+  {
+  if(is_float     <eT>::value)  { return 1; }
+  if(is_double    <eT>::value)  { return 2; }
+  if(is_cx_float  <eT>::value)  { return 3; }
+  if(is_cx_double <eT>::value)  { return 4; }
+  
+  return 0;
+  }
+
+
+
+template<typename eT>
+inline
+void
+spsolve_factoriser::delete_worker()
+  {
+  arma_extra_debug_sigprint();
+  
+  #if defined(ARMA_USE_SUPERLU)
+    {
+    delete reinterpret_cast< superlu_worker<eT>* >(worker_ptr);
+    }
+  #endif
+  
+  worker_ptr = nullptr;
+  }
+
+
+
+inline
+void
+spsolve_factoriser::reset()
+  {
+  arma_extra_debug_sigprint();
+  
+  if(worker_ptr != nullptr)
+    {
+         if(elem_type_indicator == 1)  { delete_worker< float     >(); }
+    else if(elem_type_indicator == 2)  { delete_worker< double    >(); }
+    else if(elem_type_indicator == 3)  { delete_worker< cx_float  >(); }
+    else if(elem_type_indicator == 4)  { delete_worker< cx_double >(); }
+    }
+  
+  worker_ptr          = nullptr;
+  elem_type_indicator = 0;
+  n                   = 0;
+  rcond_value         = 0.0;
+  }
+
+
+
+inline
+double
+spsolve_factoriser::rcond() const
+  {
+  return rcond_value;
+  }
+
+
+
+template<typename T1>
+inline
+bool
+spsolve_factoriser::factorise
+  (
+  const SpBase<typename T1::elem_type,T1>& A_expr,
+  const spsolve_opts_base&                settings,
+  const typename arma_blas_type_only<typename T1::elem_type>::result* junk
+  )
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  #if defined(ARMA_USE_SUPERLU)
+    {
+    typedef typename T1::pod_type   T;
+    typedef typename T1::elem_type eT;
+    
+    superlu_opts superlu_opts_default;
+    
+    const superlu_opts& opts = (settings.id == 1) ? static_cast<const superlu_opts&>(settings) : superlu_opts_default;
+    
+    arma_debug_check( ( (opts.pivot_thresh < double(0)) || (opts.pivot_thresh > double(1)) ), "spsolve_factoriser::factorise(): pivot_thresh out of bounds" );
+    
+    if( (opts.equilibrate == true) || (opts.refine != superlu_opts::REF_NONE) )
+      {
+      arma_debug_warn("spsolve_factoriser::factorise(): equilibration and iterative refinement are not supported; ignoring");
+      }
+    
+    const unwrap_spmat<T1> U(A_expr.get_ref());
+    const SpMat<eT>& A   = U.M;
+    
+    arma_debug_check( (A.n_rows != A.n_cols), "spsolve_factoriser::factorise(): matrix A must be square sized" );
+    
+    if(arma_config::debug)
+      {
+      const bool overflow = (A.n_nonzero > INT_MAX) || (A.n_rows > INT_MAX);
+      
+      if(overflow)
+        {
+        arma_stop_runtime_error("spsolve_factoriser::factorise(): integer overflow: matrix dimensions are too large for integer type used by SuperLU");
+        return false;
+        }
+      }
+    
+    if( (worker_ptr != nullptr) && ( (elem_type_indicator != get_elem_type_indicator<eT>()) || (n != A.n_rows) ) )  { reset(); }
+    
+    rcond_value = 0.0;
+    
+    if(A.n_nonzero == uword(0))
+      {
+      reset();
+      
+      arma_debug_warn("spsolve_factoriser::factorise(): system is singular");
+      
+      return false;
+      }
+    
+    if(worker_ptr == nullptr)
+      {
+      worker_ptr          = (void*)(new superlu_worker<eT>(A.n_rows));
+      elem_type_indicator = get_elem_type_indicator<eT>();
+      n                   = A.n_rows;
+      }
+    
+    superlu_worker<eT>& worker = *(reinterpret_cast< superlu_worker<eT>* >(worker_ptr));
+    
+    T rcond = T(0);
+    
+    const bool status = worker.factorise(rcond, A, opts);
+    
+    rcond_value = double(rcond);
+    
+    if(status == false)
+      {
+      if(rcond > T(0))  { arma_debug_warn("spsolve_factoriser::factorise(): system seems singular (rcond: ", rcond, ")"); }
+      else              { arma_debug_warn("spsolve_factoriser::factorise(): system seems singular");                      }
+      }
+    else
+    if(rcond < std::numeric_limits<T>::epsilon())
+      {
+      arma_debug_warn("spsolve_factoriser::factorise(): factorisation computed, but system seems singular to working precision (rcond: ", rcond, ")");
+      }
+    
+    return status;
+    }
+  #else
+    {
+    arma_ignore(A_expr);
+    arma_ignore(settings);
+    arma_stop_logic_error("spsolve_factoriser::factorise(): use of SuperLU must be enabled");
+    return false;
+    }
+  #endif
+  }
+
+
+
+template<typename T1>
+inline
+bool
+spsolve_factoriser::solve
+  (
+         Mat<typename T1::elem_type>&     X,
+  const Base<typename T1::elem_type,T1>&  B_expr,
+  const typename arma_blas_type_only<typename T1::elem_type>::result* junk
+  )
+  {
+  arma_extra_debug_sigprint();
+  arma_ignore(junk);
+  
+  #if defined(ARMA_USE_SUPERLU)
+    {
+    typedef typename T1::elem_type eT;
+    
+    if( (worker_ptr == nullptr) || (elem_type_indicator != get_elem_type_indicator<eT>()) )
+      {
+      arma_debug_warn("spsolve_factoriser::solve(): no factorisation available for this element type");
+      X.soft_reset();
+      return false;
+      }
+    
+    X = B_expr.get_ref();   // superlu::gstrs() uses X as input (the B matrix) and as output (the solution)
+    
+    arma_debug_check( (X.n_rows != n), "spsolve_factoriser::solve(): number of rows in the given objects must be the same" );
+    
+    if(arma_config::debug)
+      {
+      if(X.n_cols > INT_MAX)
+        {
+        arma_stop_runtime_error("spsolve_factoriser::solve(): integer overflow: matrix dimensions are too large for integer type used by SuperLU");
+        return false;
+        }
+      }
+    
+    superlu_worker<eT>& worker = *(reinterpret_cast< superlu_worker<eT>* >(worker_ptr));
+    
+    const bool status = worker.solve(X);
+    
+    if(status == false)
+      {
+      arma_debug_warn("spsolve_factoriser::solve(): solution not found");
+      X.soft_reset();
+      }
+    
+    return status;
+    }
+  #else
+    {
+    arma_ignore(X);
+    arma_ignore(B_expr);
+    arma_stop_logic_error("spsolve_factoriser::solve(): use of SuperLU must be enabled");
+    return false;
+    }
+  #endif
+  }
+
+
+
+//! @}
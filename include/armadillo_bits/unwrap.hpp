@@ -30,7 +30,7 @@ struct unwrap_default
   
   inline
   unwrap_default(const T1& A)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -137,7 +137,7 @@ struct unwrap< mtGlue<out_eT, T1, T2, glue_type> >
   
   inline
   unwrap(const mtGlue<out_eT, T1, T2, glue_type>& A)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -154,7 +154,7 @@ struct unwrap< mtOp<out_eT, T1, op_type> >
   
   inline
   unwrap(const mtOp<out_eT, T1, op_type>& A)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -787,14 +787,14 @@ struct unwrap_check_default
   
   inline
   unwrap_check_default(const T1& A, const Mat<eT>&)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
   
   inline
   unwrap_check_default(const T1& A, const bool)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -1137,7 +1137,7 @@ struct partial_unwrap_default
   
   inline
   partial_unwrap_default(const T1& A)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -1363,7 +1363,7 @@ struct partial_unwrap_htrans_default
   
   inline
   partial_unwrap_htrans_default(const Op<T1, op_htrans>& A)
-    : M(A.m)
+    : M(A.m, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -1562,7 +1562,7 @@ struct partial_unwrap_htrans2_default
   inline
   partial_unwrap_htrans2_default(const Op<T1, op_htrans2>& A)
     : val(A.aux)
-    , M  (A.m)
+    , M  (A.m, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -1775,7 +1775,7 @@ struct partial_unwrap_scalar_times_default
   inline
   partial_unwrap_scalar_times_default(const eOp<T1, eop_scalar_times>& A)
     : val(A.aux)
-    , M  (A.P.Q)
+    , M  (A.P.Q, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -1992,7 +1992,7 @@ struct partial_unwrap_neg_default
   
   inline
   partial_unwrap_neg_default(const eOp<T1, eop_neg>& A)
-    : M(A.P.Q)
+    : M(A.P.Q, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -2199,7 +2199,7 @@ struct partial_unwrap_check_default
   
   inline
   partial_unwrap_check_default(const T1& A, const Mat<eT>&)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -2402,7 +2402,7 @@ struct partial_unwrap_check_htrans_default
   
   inline
   partial_unwrap_check_htrans_default(const Op<T1, op_htrans>& A, const Mat<eT>&)
-    : M(A.m)
+    : M(A.m, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -2604,7 +2604,7 @@ struct partial_unwrap_check_htrans2_default
   inline
   partial_unwrap_check_htrans2_default(const Op<T1, op_htrans2>& A, const Mat<eT>&)
     : val(A.aux)
-    , M  (A.m)
+    , M  (A.m, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -2818,7 +2818,7 @@ struct partial_unwrap_check_scalar_times_default
   inline
   partial_unwrap_check_scalar_times_default(const eOp<T1, eop_scalar_times>& A, const Mat<eT>&)
     : val(A.aux)
-    , M  (A.P.Q)
+    , M  (A.P.Q, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -3028,7 +3028,7 @@ struct partial_unwrap_check_neg_default
   
   inline
   partial_unwrap_check_neg_default(const eOp<T1, eop_neg>& A, const Mat<eT>&)
-    : M(A.P.Q)
+    : M(A.P.Q, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -26,7 +26,7 @@ struct unwrap_cube
   
   inline
   unwrap_cube(const T1& A)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     }
@@ -70,7 +70,7 @@ struct unwrap_cube_check
   
   inline
   unwrap_cube_check(const T1& A, const Cube<eT>&)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     
@@ -79,7 +79,7 @@ struct unwrap_cube_check
   
   inline
   unwrap_cube_check(const T1& A, const bool)
-    : M(A)
+    : M(A, arena_target(&M))
     {
     arma_extra_debug_sigprint();
     
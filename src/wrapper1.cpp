@@ -1819,6 +1819,11 @@ extern "C"
       return H5Screate_simple(rank, current_dims, maximum_dims);
       }
     
+    herr_t arma_H5Sselect_hyperslab(hid_t space_id, H5S_seloper_t op, const hsize_t* start, const hsize_t* stride, const hsize_t* count, const hsize_t* block)
+      {
+      return H5Sselect_hyperslab(space_id, op, start, stride, count, block);
+      }
+    
     herr_t arma_H5Ovisit(hid_t object_id, H5_index_t index_type, H5_iter_order_t order, H5O_iterate_t op, void* op_data)
       {
       return H5Ovisit(object_id, index_type, order, op, op_data);
@@ -0,0 +1,96 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("arena_scope_1")
+  {
+  mat A = reshape(linspace<vec>(1,  2, 400), 20, 20);
+  mat B = reshape(linspace<vec>(-1, 1, 400), 20, 20);
+  mat C = reshape(linspace<vec>(0,  3, 400), 20, 20);
+  vec x = linspace<vec>(0, 1, 20);
+  
+  mat X1 = (A+B) * C.t() * (B-C);
+  mat X2 = trans(A*B) * exp(C) + A;
+  vec y1 = (A+B) * x + 2*x;
+  
+  mat Z1;
+  mat Z2;
+  vec z1;
+  
+    {
+    arena_scope scope(1 << 16);
+    
+    Z1 = (A+B) * C.t() * (B-C);
+    Z2 = trans(A*B) * exp(C) + A;
+    z1 = (A+B) * x + 2*x;
+    
+    REQUIRE( scope.n_bytes_used() >  0                     );
+    REQUIRE( scope.n_bytes_used() <= scope.n_bytes_total() );
+    
+      {
+      arena_scope inner(16);  // too small, so temporaries fall back to memory::acquire()
+      
+      mat W = (A+B) * C.t() * (B-C);
+      
+      REQUIRE( accu(abs(W - X1)) == Approx(0.0).margin(1e-10) );
+      }
+    }
+  
+  // overwrite the released buffer with unrelated temporaries
+  
+    {
+    arena_scope scope(1 << 16);
+    
+    mat T = (B+C) * (A-B) * (C-A);
+    
+    REQUIRE( T.n_elem == 400 );
+    }
+  
+  REQUIRE( accu(abs(Z1 - X1)) == Approx(0.0).margin(1e-10) );
+  REQUIRE( accu(abs(Z2 - X2)) == Approx(0.0).margin(1e-10) );
+  REQUIRE( accu(abs(z1 - y1)) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("arena_scope_2")
+  {
+  cube Q(10, 10, 3);
+  
+  Q.slice(0) = reshape(linspace<vec>(1, 2, 100), 10, 10);
+  Q.slice(1) = 2 * Q.slice(0);
+  Q.slice(2) = 3 * Q.slice(0);
+  
+  cube R1 = (Q+Q) % Q;
+  cube R2;
+  
+    {
+    arena_scope scope(1 << 16);
+    
+    R2 = (Q+Q) % Q;
+    
+    R2.resize(10, 10, 4);
+    }
+  
+  REQUIRE( R2.n_slices == 4 );
+  REQUIRE( accu(abs(R2.head_slices(3) - R1)) == Approx(0.0).margin(1e-10) );
+  }
@@ -0,0 +1,121 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("fn_batch_mul_1")
+  {
+  const char* trans_specs[] = { "nn", "nt", "tn", "tt" };
+  
+  for(uword n : { 1, 3, 4, 7, 8, 16, 33 })
+  for(const char* spec : trans_specs)
+    {
+    const bool trans_A = (spec[0] == 't');
+    const bool trans_B = (spec[1] == 't');
+    
+    const uword M = n;
+    const uword K = n + 2;
+    const uword N = (n > 1) ? (n - 1) : n;
+    
+    cube A = randu<cube>( (trans_A ? K : M), (trans_A ? M : K), 5 );
+    cube B = randu<cube>( (trans_B ? N : K), (trans_B ? K : N), 5 );
+    
+    cube C;
+    
+    batch_mul(C, A, B, spec);
+    
+    REQUIRE( C.n_rows   == M );
+    REQUIRE( C.n_cols   == N );
+    REQUIRE( C.n_slices == 5 );
+    
+    for(uword s=0; s < C.n_slices; ++s)
+      {
+      const mat AA = (trans_A) ? mat(A.slice(s).t()) : A.slice(s);
+      const mat BB = (trans_B) ? mat(B.slice(s).t()) : B.slice(s);
+      
+      REQUIRE( accu(abs( C.slice(s) - AA*BB )) == Approx(0.0).margin(1e-10) );
+      }
+    }
+  }
+
+
+
+TEST_CASE("fn_batch_mul_2")
+  {
+  cx_cube A = randu<cx_cube>(6, 6, 4);
+  cx_cube B = randu<cx_cube>(5, 6, 1);  // used for all slices of A
+  
+  cx_cube C;
+  
+  batch_mul(C, A, B, "tt");
+  
+  REQUIRE( C.n_slices == 4 );
+  
+  for(uword s=0; s < C.n_slices; ++s)
+    {
+    REQUIRE( accu(abs( C.slice(s) - A.slice(s).t() * B.slice(0).t() )) == Approx(0.0).margin(1e-10) );
+    }
+  
+  // aliasing
+  
+  cube X = randu<cube>(8, 8, 3);
+  cube Y = X;
+  
+  batch_mul(X, X, X);
+  
+  for(uword s=0; s < X.n_slices; ++s)
+    {
+    REQUIRE( accu(abs( X.slice(s) - Y.slice(s) * Y.slice(s) )) == Approx(0.0).margin(1e-10) );
+    }
+  
+  cube Z;
+  
+  REQUIRE_THROWS( batch_mul(Z, randu<cube>(3,4,2), randu<cube>(3,4,2)) );
+  REQUIRE_THROWS( batch_mul(Z, randu<cube>(3,3,2), randu<cube>(3,3,3)) );
+  REQUIRE_THROWS( batch_mul(Z, randu<cube>(3,3,2), randu<cube>(3,3,2), "xn") );
+  }
+
+
+
+TEST_CASE("fn_batch_mul_3")
+  {
+  // a cube with no slices gives an empty result, including when the other cube has one slice
+  
+  cube C;
+  
+  batch_mul(C, randu<cube>(3,4,1), randu<cube>(4,5,0));
+  
+  REQUIRE( C.n_rows   == 3 );
+  REQUIRE( C.n_cols   == 5 );
+  REQUIRE( C.n_slices == 0 );
+  
+  batch_mul(C, randu<cube>(3,4,0), randu<cube>(4,5,1), "nn");
+  
+  REQUIRE( C.n_rows   == 3 );
+  REQUIRE( C.n_cols   == 5 );
+  REQUIRE( C.n_slices == 0 );
+  
+  batch_mul(C, randu<cube>(40,40,1), randu<cube>(40,40,0));  // larger than the kernel size
+  
+  REQUIRE( C.n_slices == 0 );
+  
+  batch_mul(C, randu<cube>(3,4,0), randu<cube>(4,5,0));
+  
+  REQUIRE( C.n_slices == 0 );
+  }
@@ -0,0 +1,65 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("fn_bicgstab_1")
+  {
+  sp_mat A;
+  A.sprandu(200, 200, 0.02);
+  A.diag() += 3.0;
+
+  vec b(200, fill::randu);
+
+  iter_opts opts;
+  opts.tol = 1e-10;
+
+  const char* precond[] = { "none", "jacobi", "ilu0" };
+
+  for(uword i=0; i < 3; ++i)
+    {
+    vec x;
+    iter_info info;
+
+    REQUIRE( bicgstab(x, info, A, b, precond[i], opts) );
+    REQUIRE( info.converged );
+
+    REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-9) );
+    }
+  }
+
+
+
+TEST_CASE("fn_bicgstab_2")
+  {
+  sp_cx_mat A;
+  A.sprandu(100, 100, 0.05);
+  A.diag() += cx_double(3.0, 1.0);
+
+  cx_vec b(100, fill::randu);
+  cx_vec x;
+
+  iter_opts opts;
+  opts.tol = 1e-10;
+
+  REQUIRE( bicgstab(x, A, b, "ilu0", opts) );
+
+  REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-9) );
+  }
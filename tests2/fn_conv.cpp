@@ -44,3 +44,63 @@ TEST_CASE("fn_conv_1")
   
   REQUIRE( accu(abs(c - d)) == Approx(0.0) );
   }
+
+
+
+TEST_CASE("fn_conv_2")
+  {
+  vec a = linspace<vec>(-1,2,1000);
+  vec b = cos(linspace<vec>(0,10,300));
+  
+  vec c1 = conv(a, b, "full", "direct");
+  vec c2 = conv(a, b, "full", "fft");
+  vec c3 = conv(a, b);
+  
+  REQUIRE( c1.n_elem == (a.n_elem + b.n_elem - 1) );
+  REQUIRE( c2.n_elem == c1.n_elem );
+  
+  REQUIRE( accu(abs(c1 - c2)) == Approx(0.0).margin(1e-8) );
+  REQUIRE( accu(abs(c1 - c3)) == Approx(0.0).margin(1e-8) );
+  
+  vec d1 = conv(a, b, "same", "direct");
+  vec d2 = conv(a, b, "same", "fft");
+  
+  REQUIRE( d2.n_elem == a.n_elem );
+  REQUIRE( accu(abs(d1 - d2)) == Approx(0.0).margin(1e-8) );
+  }
+
+
+
+TEST_CASE("fn_conv_3")
+  {
+  cx_rowvec a = cx_rowvec( linspace<rowvec>(1,5,500), linspace<rowvec>(2,-1,500) );
+  cx_rowvec b = cx_rowvec( sin(linspace<rowvec>(0,5,130)), cos(linspace<rowvec>(0,5,130)) );
+  
+  cx_rowvec c1 = conv(a, b, "full", "direct");
+  cx_rowvec c2 = conv(a, b, "full", "fft");
+  
+  REQUIRE( c2.n_elem == (a.n_elem + b.n_elem - 1) );
+  REQUIRE( accu(abs(c1 - c2)) == Approx(0.0).margin(1e-8) );
+  }
+
+
+
+TEST_CASE("fn_conv2_1")
+  {
+  mat A = reshape( linspace<vec>(1,10,40*30), 40, 30 );
+  mat B = reshape( cos(linspace<vec>(0,10,9*11)), 9, 11 );
+  
+  mat C1 = conv2(A, B, "full", "direct");
+  mat C2 = conv2(A, B, "full", "fft");
+  
+  REQUIRE( C2.n_rows == (A.n_rows + B.n_rows - 1) );
+  REQUIRE( C2.n_cols == (A.n_cols + B.n_cols - 1) );
+  
+  REQUIRE( accu(abs(C1 - C2)) == Approx(0.0).margin(1e-8) );
+  
+  mat D1 = conv2(A, B, "same", "direct");
+  mat D2 = conv2(A, B, "same", "fft");
+  
+  REQUIRE( size(D2) == size(A) );
+  REQUIRE( accu(abs(D1 - D2)) == Approx(0.0).margin(1e-8) );
+  }
@@ -2275,3 +2275,48 @@ TEST_CASE("fn_eigs_gen_even_complex_sm_opts_test")
   
   REQUIRE(count > 0);
   }
+
+
+
+TEST_CASE("fn_eigs_gen_func_test")
+  {
+  const uword n_rows   = 100;
+  const uword n_eigval = 5;
+  
+  sp_mat m;
+  m.sprandu(n_rows, n_rows, 0.1);
+  m.diag() += linspace<vec>(1, 10, n_rows);
+  
+  auto op = [&](const vec& x) -> vec { return m*x; };
+  
+  cx_vec eigval;
+  cx_mat eigvec;
+  
+  const bool status = eigs_gen(eigval, eigvec, op, n_rows, n_eigval);
+  
+  REQUIRE( status == true );
+  REQUIRE( eigval.n_elem == n_eigval );
+  REQUIRE( eigvec.n_rows == n_rows   );
+  REQUIRE( eigvec.n_cols == n_eigval );
+  
+  const cx_mat d = conv_to<cx_mat>::from(mat(m));
+  
+  for(uword i=0; i < n_eigval; ++i)
+    {
+    REQUIRE( norm(d * eigvec.col(i) - eigval(i) * eigvec.col(i)) < 1e-6 * std::max(1.0, std::abs(eigval(i))) );
+    }
+  
+  cx_vec eigval_sp;
+  
+  const bool status_sp = eigs_gen(eigval_sp, m, n_eigval);
+  
+  REQUIRE( status_sp == true );
+  
+  const vec abs_func = sort(abs(eigval));
+  const vec abs_sp   = sort(abs(eigval_sp));
+  
+  for(uword i=0; i < n_eigval; ++i)
+    {
+    REQUIRE( abs_func(i) == Approx(abs_sp(i)).epsilon(1e-6) );
+    }
+  }
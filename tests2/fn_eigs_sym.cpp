@@ -183,3 +183,71 @@ TEST_CASE("fn_eigs_sigma_test")
   
   REQUIRE( count > 0 );
   }
+
+
+
+TEST_CASE("fn_eigs_func_test")
+  {
+  // 1D Laplacian with Dirichlet boundaries, applied without forming the matrix;
+  // the eigenvalues are 2 - 2*cos(k*pi/(n+1)) for k = 1,...,n
+  const uword n = 200;
+  
+  auto laplacian = [](const vec& x) -> vec
+    {
+    const uword N = x.n_elem;
+    
+    vec y = 2.0 * x;
+    
+    y.tail(N-1) -= x.head(N-1);
+    y.head(N-1) -= x.tail(N-1);
+    
+    return y;
+    };
+  
+  vec eigval;
+  mat eigvec;
+  
+  const bool status = eigs_sym(eigval, eigvec, laplacian, n, 5, "la");
+  
+  REQUIRE( status == true );
+  REQUIRE( eigval.n_elem == 5 );
+  REQUIRE( eigvec.n_rows == n );
+  REQUIRE( eigvec.n_cols == 5 );
+  
+  const double pi = datum::pi;
+  
+  for(uword i=0; i < 5; ++i)
+    {
+    const double expected = 2.0 - 2.0 * std::cos( double(n-4+i) * pi / double(n+1) );
+    
+    REQUIRE( eigval(i) == Approx(expected).epsilon(1e-6) );
+    
+    REQUIRE( norm(laplacian(eigvec.col(i)) - eigval(i) * eigvec.col(i)) < 1e-5 );
+    }
+  
+  // compare against the same operator given as a sparse matrix
+  
+  sp_mat L(n, n);
+  
+  for(uword i=0; i < n; ++i)
+    {
+    L(i,i) = 2.0;
+    
+    if(i > 0    )  { L(i,i-1) = -1.0; }
+    if(i < (n-1))  { L(i,i+1) = -1.0; }
+    }
+  
+  vec eigval_func;
+  vec eigval_sp;
+  
+  const bool status_func = eigs_sym(eigval_func, [&](const vec& x) -> vec { return L*x; }, n, 5, "sa");
+  const bool status_sp   = eigs_sym(eigval_sp, L, 5, "sa");
+  
+  REQUIRE( status_func == true );
+  REQUIRE( status_sp   == true );
+  
+  for(uword i=0; i < 5; ++i)
+    {
+    REQUIRE( eigval_func(i) == Approx(eigval_sp(i)).epsilon(1e-6) );
+    }
+  }
@@ -0,0 +1,168 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("fn_fft_1")
+  {
+  vec X = linspace<vec>(1,5,8);
+  
+  cx_vec Y = fft(X);
+  
+  REQUIRE( Y.n_elem == 8 );
+  REQUIRE( Y(0).real() == Approx(accu(X)) );
+  REQUIRE( Y(0).imag() == Approx(0.0).margin(1e-12) );
+  
+  cx_vec Z = ifft(Y);
+  
+  REQUIRE( accu(abs(real(Z) - X)) == Approx(0.0).margin(1e-12) );
+  REQUIRE( accu(abs(imag(Z)))     == Approx(0.0).margin(1e-12) );
+  }
+
+
+
+TEST_CASE("fft_plan_1")
+  {
+  cx_vec X = cx_vec( linspace<vec>(-1,1,100), cos(linspace<vec>(0,10,100)) );
+  
+  fft_plan<cx_double> P(100);
+  
+  cx_vec Y1 = P.fft(X);
+  cx_vec Y2 = fft(X);
+  
+  REQUIRE( Y1.n_elem == 100 );
+  REQUIRE( accu(abs(Y1 - Y2)) == Approx(0.0).margin(1e-10) );
+  
+  cx_vec Z;
+  
+  P.ifft(Z, Y1);
+  
+  REQUIRE( accu(abs(Z - X)) == Approx(0.0).margin(1e-10) );
+  
+  fft_plan<cx_double> Q(128);
+  
+  cx_mat A = repmat(X, 1, 3);
+  
+  cx_mat B1 = Q.fft(A);
+  cx_mat B2 = fft(A, 128);
+  
+  REQUIRE( B1.n_rows == 128 );
+  REQUIRE( B1.n_cols ==   3 );
+  REQUIRE( accu(abs(B1 - B2)) == Approx(0.0).margin(1e-10) );
+  
+  vec R = real(X);
+  
+  REQUIRE( accu(abs(P.fft(R) - fft(R))) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("fn_fft_r2c_1")
+  {
+  vec X = cos(linspace<vec>(0,10,101)) + linspace<vec>(-1,1,101);
+  
+  for(uword N = 1; N <= 130; N += 3)
+    {
+    cx_vec Y1 = fft_r2c(X, N);
+    cx_vec Y2 = fft(X, N);
+    
+    REQUIRE( Y1.n_elem == (N/2 + 1) );
+    REQUIRE( accu(abs(Y1 - Y2.head(N/2 + 1))) == Approx(0.0).margin(1e-10) );
+    
+    vec Z1 = ifft_c2r(Y1, N);
+    vec Z2 = real(ifft(Y2));
+    
+    REQUIRE( Z1.n_elem == N );
+    REQUIRE( accu(abs(Z1 - Z2)) == Approx(0.0).margin(1e-10) );
+    }
+  
+  cx_vec Y = fft_r2c(X);
+  
+  REQUIRE( Y.n_elem == 51 );
+  vec Z = ifft_c2r(Y);
+  
+  REQUIRE( Z.n_elem == 100 );
+  
+  mat A = reshape(X.head(100), 20, 5);
+  
+  cx_mat B1 = fft_r2c(A);
+  cx_mat B2 = fft(A);
+  
+  REQUIRE( B1.n_rows == 11 );
+  REQUIRE( B1.n_cols ==  5 );
+  REQUIRE( accu(abs(B1 - B2.head_rows(11))) == Approx(0.0).margin(1e-10) );
+  REQUIRE( accu(abs(ifft_c2r(B1) - A))      == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("fn_fft2_1")
+  {
+  mat A = reshape(cos(linspace<vec>(0,20,7*12)), 7, 12);
+  mat B = reshape(linspace<vec>(-1,1,8*9), 8, 9);
+  
+  cx_mat A1 = fft2(A);
+  cx_mat A2 = fft2( cx_mat(A, zeros<mat>(size(A))) );
+  
+  REQUIRE( accu(abs(A1 - A2)) == Approx(0.0).margin(1e-10) );
+  
+  cx_mat B1 = fft2(B);
+  cx_mat B2 = fft2( cx_mat(B, zeros<mat>(size(B))) );
+  
+  REQUIRE( accu(abs(B1 - B2)) == Approx(0.0).margin(1e-10) );
+  REQUIRE( accu(abs(real(ifft2(B1)) - B)) == Approx(0.0).margin(1e-10) );
+  
+  vec C = B.col(0);
+  
+  REQUIRE( accu(abs(fft2(C) - fft2( cx_vec(C, zeros<vec>(size(C))) ))) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("fn_fft_prime_1")
+  {
+  // lengths with large prime factors are evaluated via Bluestein's algorithm
+  
+  const uword lengths[] = { 13, 61, 97, 2*101, 1009 };
+  
+  for(uword i=0; i < 5; ++i)
+    {
+    const uword N = lengths[i];
+    
+    cx_vec X = cx_vec( cos(linspace<vec>(0,10,N)), linspace<vec>(-1,1,N) );
+    
+    cx_vec Y1 = fft(X);
+    cx_vec Y2(N, fill::zeros);
+    
+    for(uword k=0; k < N; ++k)
+    for(uword n=0; n < N; ++n)
+      {
+      Y2(k) += X(n) * std::polar(1.0, -2.0 * datum::pi * double((n*k) % N) / double(N));
+      }
+    
+    REQUIRE( norm(Y1 - Y2) / norm(Y2) == Approx(0.0).margin(1e-12) );
+    REQUIRE( norm(ifft(Y1) - X)       == Approx(0.0).margin(1e-10) );
+    
+    vec R = real(X);
+    
+    REQUIRE( norm(fft(R) - fft(cx_vec(R, zeros<vec>(N)))) == Approx(0.0).margin(1e-10) );
+    }
+  }
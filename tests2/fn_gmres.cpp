@@ -0,0 +1,74 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("fn_gmres_1")
+  {
+  sp_mat A;
+  A.sprandu(200, 200, 0.02);
+  A.diag() += 3.0;
+
+  vec b(200, fill::randu);
+
+  iter_opts opts;
+  opts.tol     = 1e-10;
+  opts.restart = 10;
+
+  const char* precond[] = { "none", "jacobi", "ilu0" };
+
+  for(uword i=0; i < 3; ++i)
+    {
+    vec x;
+    iter_info info;
+
+    REQUIRE( gmres(x, info, A, b, precond[i], opts) );
+    REQUIRE( info.converged );
+
+    REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-9) );
+    }
+  }
+
+
+
+TEST_CASE("fn_gmres_2")
+  {
+  mat A(50, 50, fill::randu);
+  A.diag() += 25.0;
+
+  vec b(50, fill::randu);
+  vec x;
+
+  REQUIRE( gmres(x, A, b) );
+
+  REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-5) );
+
+  cx_mat C(50, 50, fill::randu);
+  C.diag() += cx_double(25.0, 5.0);
+
+  cx_vec d(50, fill::randu);
+  cx_vec y;
+
+  auto C_func = [&](const cx_vec& v) -> cx_vec { return C*v; };
+
+  REQUIRE( gmres(y, C_func, d) );
+
+  REQUIRE( norm(C*y - d) / norm(d) == Approx(0.0).margin(1e-5) );
+  }
@@ -0,0 +1,200 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+
+#include "catch.hpp"
+
+using namespace arma;
+
+
+static
+sp_mat
+fn_lobpcg_laplacian(const uword m)
+  {
+  const uword n = m*m;
+
+  sp_mat A(n, n);
+
+  for(uword i=0; i < m; ++i)
+  for(uword j=0; j < m; ++j)
+    {
+    const uword k = i*m + j;
+
+    A(k,k) = 4.0;
+
+    if(i > 0  )  { A(k, k-m) = -1.0; }
+    if(i+1 < m)  { A(k, k+m) = -1.0; }
+    if(j > 0  )  { A(k, k-1) = -1.0; }
+    if(j+1 < m)  { A(k, k+1) = -1.0; }
+    }
+
+  return A;
+  }
+
+
+
+// all eigenvalues of the 2D Laplacian, in ascending order
+static
+vec
+fn_lobpcg_laplacian_eigval(const uword m)
+  {
+  vec t(m);
+
+  for(uword i=0; i < m; ++i)  { t(i) = 2.0 - 2.0 * std::cos( double(i+1) * datum::pi / double(m+1) ); }
+
+  vec out(m*m);
+
+  for(uword i=0; i < m; ++i)
+  for(uword j=0; j < m; ++j)
+    {
+    out(i*m + j) = t(i) + t(j);
+    }
+
+  return sort(out);
+  }
+
+
+
+TEST_CASE("fn_lobpcg_1")
+  {
+  const uword m = 30;
+  const uword k = 6;
+
+  const sp_mat A = fn_lobpcg_laplacian(m);
+
+  const vec expected = fn_lobpcg_laplacian_eigval(m);
+
+  const char* precond[] = { "none", "jacobi", "ic0" };
+
+  uword n_iter_none = 0;
+
+  for(uword p=0; p < 3; ++p)
+    {
+    vec eigval;
+    mat eigvec;
+
+    iter_info info;
+
+    const bool status = lobpcg(eigval, eigvec, info, A, k, "sa", precond[p]);
+
+    REQUIRE( status == true );
+    REQUIRE( info.converged == true );
+    REQUIRE( info.rel_residual <= 1e-6 );
+
+    REQUIRE( eigval.n_elem == k );
+    REQUIRE( eigvec.n_rows == A.n_rows );
+    REQUIRE( eigvec.n_cols == k );
+
+    REQUIRE( approx_equal(eigval, vec(expected.head(k)), "absdiff", 1e-6) );
+
+    REQUIRE( norm(eigvec.t() * eigvec - eye(k,k), "fro") < 1e-8 );
+
+    REQUIRE( norm(A * eigvec - eigvec * diagmat(eigval), "fro") < 1e-4 );
+
+    if(p == 0)  { n_iter_none = info.n_iter; }
+    if(p == 2)  { REQUIRE( info.n_iter < n_iter_none ); }
+    }
+  }
+
+
+
+TEST_CASE("fn_lobpcg_2")
+  {
+  // largest eigenvalues; dense matrix
+
+  const uword m = 25;
+  const uword k = 4;
+
+  const mat A(fn_lobpcg_laplacian(m));
+
+  const vec expected = fn_lobpcg_laplacian_eigval(m);
+
+  vec eigval;
+  mat eigvec;
+
+  const bool status = lobpcg(eigval, eigvec, A, k, "la");
+
+  REQUIRE( status == true );
+
+  REQUIRE( approx_equal(eigval, vec(expected.tail(k)), "absdiff", 1e-6) );
+
+  REQUIRE( norm(A * eigvec - eigvec * diagmat(eigval), "fro") < 1e-4 );
+  }
+
+
+
+TEST_CASE("fn_lobpcg_3")
+  {
+  // operator given as a function applied to blocks of vectors
+
+  const uword m = 30;
+  const uword n = m*m;
+  const uword k = 5;
+
+  const sp_mat A = fn_lobpcg_laplacian(m);
+
+  const vec expected = fn_lobpcg_laplacian_eigval(m);
+
+  uword n_calls = 0;
+
+  auto op = [&](const mat& X) -> mat { ++n_calls; return A*X; };
+
+  vec eigval;
+  mat eigvec;
+
+  iter_info info;
+
+  const bool status = lobpcg(eigval, eigvec, info, op, n, k);
+
+  REQUIRE( status == true );
+
+  REQUIRE( approx_equal(eigval, vec(expected.head(k)), "absdiff", 1e-6) );
+
+  // one application of the operator for the initial block and one per iteration
+  REQUIRE( n_calls == (info.n_iter + 1) );
+
+  // warm start from the solution converges immediately
+
+  iter_opts opts;
+  opts.warm_start = true;
+
+  const bool status2 = lobpcg(eigval, eigvec, info, op, n, k, "sa", opts);
+
+  REQUIRE( status2 == true );
+  REQUIRE( info.n_iter <= 2 );
+  }
+
+
+
+TEST_CASE("fn_lobpcg_4")
+  {
+  // small problems are solved directly
+
+  const sp_mat A = fn_lobpcg_laplacian(4);
+
+  const vec expected = fn_lobpcg_laplacian_eigval(4);
+
+  vec eigval;
+  mat eigvec;
+
+  REQUIRE( lobpcg(eigval, eigvec, A, 3) == true );
+
+  REQUIRE( approx_equal(eigval, vec(expected.head(3)), "absdiff", 1e-10) );
+
+  REQUIRE( lobpcg(eigval, eigvec, A, 0) == true );
+
+  REQUIRE( eigval.n_elem == 0 );
+  }
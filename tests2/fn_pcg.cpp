@@ -0,0 +1,128 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+
+#include "catch.hpp"
+
+using namespace arma;
+
+
+static
+sp_mat
+fn_pcg_laplacian(const uword m)
+  {
+  const uword n = m*m;
+
+  sp_mat A(n, n);
+
+  for(uword i=0; i < m; ++i)
+  for(uword j=0; j < m; ++j)
+    {
+    const uword k = i*m + j;
+
+    A(k,k) = 4.0;
+
+    if(i > 0  )  { A(k, k-m) = -1.0; }
+    if(i+1 < m)  { A(k, k+m) = -1.0; }
+    if(j > 0  )  { A(k, k-1) = -1.0; }
+    if(j+1 < m)  { A(k, k+1) = -1.0; }
+    }
+
+  return A;
+  }
+
+
+
+TEST_CASE("fn_pcg_1")
+  {
+  const sp_mat A = fn_pcg_laplacian(20);
+
+  vec b(A.n_rows, fill::randu);
+
+  iter_opts opts;
+  opts.tol = 1e-10;
+
+  const char* precond[] = { "none", "jacobi", "ilu0", "ic0" };
+
+  uword n_iter_none = 0;
+
+  for(uword i=0; i < 4; ++i)
+    {
+    vec x;
+    iter_info info;
+
+    REQUIRE( pcg(x, info, A, b, precond[i], opts) );
+
+    REQUIRE( info.converged );
+    REQUIRE( info.history.n_elem == (info.n_iter + 1) );
+    REQUIRE( info.rel_residual <= 1e-10 );
+
+    REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-9) );
+
+    if(i == 0)  { n_iter_none = info.n_iter; }
+
+    if(i >= 2)  { REQUIRE( info.n_iter < n_iter_none ); }
+    }
+  }
+
+
+
+TEST_CASE("fn_pcg_2")
+  {
+  const sp_mat A = fn_pcg_laplacian(10);
+
+  vec b(A.n_rows, fill::randu);
+
+  auto A_func = [&](const vec& v) -> vec { return A*v; };
+
+  vec x;
+  iter_info info;
+
+  REQUIRE( pcg(x, info, A_func, b) );
+
+  REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-5) );
+
+  // warm start from the solution
+
+  iter_opts opts;
+  opts.warm_start = true;
+
+  REQUIRE( pcg(x, info, A_func, b, "none", opts) );
+  REQUIRE( info.n_iter == 0 );
+  }
+
+
+
+TEST_CASE("fn_pcg_3")
+  {
+  sp_cx_mat A(fn_pcg_laplacian(10), sp_mat(100, 100));
+
+  for(uword i=1; i < A.n_rows; i += 7)
+    {
+    A(i, i-1) = cx_double(0.0,  0.3);
+    A(i-1, i) = cx_double(0.0, -0.3);
+    }
+
+  cx_vec b(A.n_rows, fill::randu);
+  cx_vec x;
+
+  iter_opts opts;
+  opts.tol = 1e-10;
+
+  REQUIRE( pcg(x, A, b, "ic0", opts) );
+
+  REQUIRE( norm(A*x - b) / norm(b) == Approx(0.0).margin(1e-9) );
+  }
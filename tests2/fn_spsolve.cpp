@@ -879,4 +879,206 @@ TEST_CASE("fn_spsolve_cx_float_function_test")
     }
   }
 
+
+
+TEST_CASE("fn_spsolve_factoriser_test")
+  {
+  sp_mat A;
+  A.sprandu(60, 60, 0.1);
+  A.diag() += 2.0;
+
+  mat B1(60, 4, fill::randu);
+  mat B2(60, 1, fill::randu);
+
+  spsolve_factoriser SF;
+
+  REQUIRE( SF.factorise(A) );
+  REQUIRE( SF.rcond() > 0.0 );
+
+  mat X1;
+  mat X2;
+
+  REQUIRE( SF.solve(X1, B1) );
+  REQUIRE( SF.solve(X2, B2) );
+
+  REQUIRE( norm(A*X1 - B1) == Approx(0.0).margin(1e-8) );
+  REQUIRE( norm(A*X2 - B2) == Approx(0.0).margin(1e-8) );
+
+  // new values, same sparsity pattern
+
+  A *= 3.0;
+  A.diag() += 1.0;
+
+  REQUIRE( SF.factorise(A) );
+  REQUIRE( SF.solve(X1, B1) );
+
+  mat Y1;
+  REQUIRE( spsolve(Y1, A, B1) );
+
+  REQUIRE( norm(X1 - Y1) == Approx(0.0).margin(1e-8) );
+
+  // different sparsity pattern
+
+  A(0, 59) = 1.5;
+
+  REQUIRE( SF.factorise(A) );
+  REQUIRE( SF.solve(X1, B1) );
+
+  REQUIRE( norm(A*X1 - B1) == Approx(0.0).margin(1e-8) );
+  }
+
 #endif
+
+
+
+TEST_CASE("fn_spsolve_cholesky_test")
+  {
+  for (size_t t = 0; t < 5; ++t)
+    {
+    const uword size = 20 * (t + 1);
+
+    sp_mat R;
+    R.sprandu(size, size, 0.05);
+
+    sp_mat A = R * R.t();
+    A.diag() += 1.0;
+
+    mat B(size, 3, fill::randu);
+
+    mat X;
+    REQUIRE( spsolve(X, A, B, "cholesky") );
+
+    mat Y = solve(mat(A), B);
+
+    REQUIRE( norm(X - Y) == Approx(0.0).margin(1e-10) );
+
+    spchol_opts opts;
+    opts.permutation = spchol_opts::NATURAL;
+
+    REQUIRE( spsolve(X, A, B, "cholesky", opts) );
+
+    REQUIRE( norm(X - Y) == Approx(0.0).margin(1e-10) );
+    }
+  }
+
+
+
+TEST_CASE("fn_spsolve_cx_cholesky_test")
+  {
+  sp_cx_mat R;
+  R.sprandu(50, 50, 0.1);
+
+  sp_cx_mat A = R * R.t();
+  A.diag() += cx_double(1.0, 0.0);
+
+  cx_mat B(50, 2, fill::randu);
+
+  cx_mat X = spsolve(A, B, "cholesky");
+  cx_mat Y = solve(cx_mat(A), B);
+
+  REQUIRE( norm(X - Y) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("fn_spsolve_cholesky_singular_test")
+  {
+  sp_mat A(10, 10);
+  A.diag().ones();
+  A(4, 4) = 0.0;
+
+  vec b(10, fill::ones);
+  vec x;
+
+  REQUIRE( spsolve(x, A, b, "cholesky") == false );
+  REQUIRE( x.n_elem == 0 );
+  }
+
+
+
+TEST_CASE("fn_spsolve_cholesky_indefinite_test")
+  {
+  // symmetric but indefinite: rejected, although an LDL' factorisation exists
+
+  sp_mat A(10, 10);
+  A.diag().ones();
+  A(4, 4) = -1.0;
+  A(3, 4) = 0.5;
+  A(4, 3) = 0.5;
+
+  vec b(10, fill::ones);
+  vec x;
+
+  REQUIRE( spsolve(x, A, b, "cholesky") == false );
+  REQUIRE( x.n_elem == 0 );
+
+  // positive definite, but not symmetric
+
+  sp_mat C(10, 10);
+  C.diag().fill(4.0);
+  C(2, 7) = 1.0;
+
+  REQUIRE( spsolve(x, C, b, "cholesky") == false );
+  REQUIRE( x.n_elem == 0 );
+  }
+
+
+
+TEST_CASE("fn_spsolve_cholesky_mindeg_test")
+  {
+  // 2D Laplacian on a 30x30 grid, with the unknowns in a random order,
+  // plus a row coupled to all grid points and a disconnected block
+
+  const uword m = 30;
+  const uword n = m * m;
+
+  sp_mat L(n + 6, n + 6);
+
+  for(uword i = 0; i < m; ++i)
+  for(uword j = 0; j < m; ++j)
+    {
+    const uword k = i + j*m;
+
+    L(k, k) = 4.0;
+
+    if(i + 1 < m) { L(k, k + 1) = -1.0; L(k + 1, k) = -1.0; }
+    if(j + 1 < m) { L(k, k + m) = -1.0; L(k + m, k) = -1.0; }
+
+    L(k, n) = -0.01;
+    L(n, k) = -0.01;
+    }
+
+  L(n, n) = 1000.0;
+
+  for(uword k = n + 1; k < n + 6; ++k)  { L(k, k) = 2.0; }
+
+  const uvec q = randperm(n + 6);
+
+  sp_mat A = L.cols(q).t();
+  A = A.cols(q);
+
+  mat B(n + 6, 2, fill::randu);
+
+  mat X1;
+  mat X2;
+
+  spchol_opts opts;
+  opts.permutation = spchol_opts::NATURAL;
+
+  REQUIRE( spsolve(X1, A, B, "cholesky") );
+  REQUIRE( spsolve(X2, A, B, "cholesky", opts) );
+
+  REQUIRE( norm(A * X1 - B) == Approx(0.0).margin(1e-10) );
+  REQUIRE( norm(A * X2 - B) == Approx(0.0).margin(1e-10) );
+
+  sp_ldl<double> F1;
+  sp_ldl<double> F2;
+
+  REQUIRE( F1.factorise(A, true ) );
+  REQUIRE( F2.factorise(A, false) );
+
+  // the fill-in of a 2D grid under a minimum degree ordering grows as about n*log(n)
+
+  REQUIRE( F1.n_elem_L() <= 16 * n );
+  REQUIRE( F1.n_elem_L() <  F2.n_elem_L() / 4 );
+  }
@@ -0,0 +1,62 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("fn_svds_func_test")
+  {
+  const uword n_rows = 60;
+  const uword n_cols = 40;
+  const uword k      = 5;
+  
+  mat A(n_rows, n_cols, fill::randu);
+  
+  auto func   = [&](const vec& x) -> vec { return A * x;     };
+  auto func_t = [&](const vec& x) -> vec { return A.t() * x; };
+  
+  mat U;
+  vec S;
+  mat V;
+  
+  const bool status = svds(U, S, V, func, func_t, n_rows, n_cols, k);
+  
+  REQUIRE( status == true );
+  REQUIRE( S.n_elem == k );
+  REQUIRE( U.n_rows == n_rows );
+  REQUIRE( U.n_cols == k );
+  REQUIRE( V.n_rows == n_cols );
+  REQUIRE( V.n_cols == k );
+  
+  const vec S_dense = svd(A);
+  
+  for(uword i=0; i < k; ++i)
+    {
+    REQUIRE( S(i) == Approx(S_dense(i)).epsilon(1e-6) );
+    
+    REQUIRE( norm(A * V.col(i) - S(i) * U.col(i)) < 1e-6 * S(0) );
+    }
+  
+  vec S2;
+  
+  const bool status2 = svds(S2, func, func_t, n_rows, n_cols, k);
+  
+  REQUIRE( status2 == true );
+  REQUIRE( approx_equal(S, S2, "reldiff", 1e-6) );
+  }
@@ -0,0 +1,151 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("load_text_csv_1")
+  {
+  mat A = randn<mat>(57, 6);
+
+  A(0,0) = 1e300;
+  A(1,1) = -4.9e-324;
+  A(2,2) = 123456789.0;
+  A(3,3) = datum::inf;
+  A(4,4) = -datum::inf;
+
+  A.save("file_text.csv", csv_ascii);
+
+  mat B;
+
+  REQUIRE( B.load("file_text.csv", csv_ascii) == true );
+
+  REQUIRE( B.n_rows == A.n_rows );
+  REQUIRE( B.n_cols == A.n_cols );
+
+  // numbers saved with full precision are recovered exactly
+
+  A(3,3) = 0.0;  B(3,3) = 0.0;
+  A(4,4) = 0.0;  B(4,4) = 0.0;
+
+  REQUIRE( accu(A != B) == 0 );
+
+  // loading via a stream gives the same result
+
+  mat C;
+
+    {
+    std::ifstream f("file_text.csv");
+
+    REQUIRE( C.load(f, csv_ascii) == true );
+    }
+
+  C(3,3) = 0.0;
+  C(4,4) = 0.0;
+
+  REQUIRE( accu(A != C) == 0 );
+
+  std::remove("file_text.csv");
+  }
+
+
+
+TEST_CASE("load_text_csv_2")
+  {
+  std::stringstream ss;
+
+  ss << "1,2.5,-3e2" << '\n';
+  ss << " 4 ,,nan,7"  << '\n';
+  ss << "+8,0x10"     << '\r' << '\n';
+  ss << '\n';
+  ss << "9,9,9,9"     << '\n';
+
+  mat A;
+
+  REQUIRE( A.load(ss, csv_ascii) == true );
+
+  // missing elements are set to zero; lines after an empty line are ignored
+
+  REQUIRE( A.n_rows == 3 );
+  REQUIRE( A.n_cols == 4 );
+
+  REQUIRE( A(0,0) == Approx(1.0)    );
+  REQUIRE( A(0,1) == Approx(2.5)    );
+  REQUIRE( A(0,2) == Approx(-300.0) );
+  REQUIRE( A(0,3) == Approx(0.0)    );
+
+  REQUIRE( A(1,0) == Approx(4.0) );
+  REQUIRE( A(1,1) == Approx(0.0) );
+  REQUIRE( std::isnan(A(1,2))    );
+  REQUIRE( A(1,3) == Approx(7.0) );
+
+  REQUIRE( A(2,0) == Approx(8.0)  );
+  REQUIRE( A(2,1) == Approx(16.0) );
+
+  ss.clear();
+  ss.seekg(0);
+
+  imat B;
+
+  REQUIRE( B.load(ss, csv_ascii) == true );
+
+  REQUIRE( B(0,1) ==  2 );
+  REQUIRE( B(0,2) == -3 );
+  REQUIRE( B(2,0) ==  8 );
+  }
+
+
+
+TEST_CASE("load_text_raw_1")
+  {
+  mat A = randu<mat>(40, 5);
+
+  A.save("file_text.txt", raw_ascii);
+
+  mat B;
+
+  REQUIRE( B.load("file_text.txt", raw_ascii) == true );
+
+  REQUIRE( B.n_rows == A.n_rows );
+  REQUIRE( B.n_cols == A.n_cols );
+
+  REQUIRE( accu(abs(A - B)) == Approx(0.0).margin(1e-10) );
+
+  fmat C;
+
+  REQUIRE( C.load("file_text.txt", raw_ascii) == true );
+
+  REQUIRE( accu(abs(conv_to<mat>::from(C) - A)) == Approx(0.0).margin(1e-4) );
+
+  std::remove("file_text.txt");
+
+  std::stringstream ss1("1 2 3\n4 5\n");
+  std::stringstream ss2("1 2 3\n4 5 x\n");
+  std::stringstream ss3("");
+
+  mat D;
+
+  REQUIRE( D.load(ss1, raw_ascii) == false );
+  REQUIRE( D.load(ss2, raw_ascii) == false );
+
+  D.ones(2,2);
+
+  REQUIRE( D.load(ss3, raw_ascii) == true );
+  REQUIRE( D.n_elem == 0 );
+  }
@@ -0,0 +1,180 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("mapped_mat_1")
+  {
+  mat A = reshape(linspace<vec>(1, 2, 37*23), 37, 23);
+
+  A.save("file_mapped.bin", arma_binary);
+
+    {
+    mapped_mat<double> M("file_mapped.bin");
+
+    const mat& X = M;
+
+    REQUIRE( X.n_rows == 37 );
+    REQUIRE( X.n_cols == 23 );
+
+    REQUIRE( accu(abs(X - A)) == Approx(0.0).margin(1e-10) );
+
+    #if defined(ARMA_HAVE_POSIX_MMAP)
+      {
+      REQUIRE( M.is_mapped() == true );
+      REQUIRE( (uintptr_t(X.memptr()) % alignof(double)) == 0 );
+      }
+    #endif
+
+    // the memory of read-only mappings can't be written to
+    REQUIRE_THROWS( M.get_mutable_ref() );
+    }
+
+  // loaded data is also available after the mapping is released
+
+  mapped_mat<double> M;
+
+  REQUIRE( M.load("file_mapped.bin") == true );
+
+  mat B = M.get_ref();
+
+  M.reset();
+
+  REQUIRE( M.get_ref().n_elem == 0 );
+  REQUIRE( M.is_mapped()      == false );
+
+  REQUIRE( accu(abs(B - A)) == Approx(0.0).margin(1e-10) );
+
+  std::remove("file_mapped.bin");
+  }
+
+
+
+TEST_CASE("mapped_mat_2")
+  {
+  fmat A = reshape(linspace<fvec>(-1, 1, 100), 10, 10);
+
+  A.save("file_mapped.bin", arma_binary);
+
+    {
+    mapped_mat<float> M("file_mapped.bin", mmap_copy_on_write);
+
+    fmat& X = M.get_mutable_ref();
+
+    X *= 2.0f;
+    X(0,0) = 123.0f;
+
+    REQUIRE( X(0,0) == Approx(123.0) );
+    REQUIRE( X(1,0) == Approx(2.0f * A(1,0)) );
+    
+    // the data is used in place, so the size can't be changed
+    if(M.is_mapped())  { REQUIRE_THROWS( X.set_size(2,2) ); }
+    }
+
+  // modifications in copy-on-write mode don't change the file
+
+  fmat B;
+
+  REQUIRE( B.load("file_mapped.bin", arma_binary) == true );
+
+  REQUIRE( accu(abs(B - A)) == Approx(0.0).margin(1e-6) );
+
+  std::remove("file_mapped.bin");
+  }
+
+
+
+TEST_CASE("mapped_mat_3")
+  {
+  // files in the older layout, where the data directly follows the header, are loaded into ordinary memory
+
+  mat A = reshape(linspace<vec>(1, 2, 15), 3, 5);
+
+    {
+    std::ofstream f("file_mapped.bin", std::fstream::binary);
+
+    f << "ARMA_MAT_BIN_FN008" << '\n';
+    f << "3 5" << '\n';
+    f.write( reinterpret_cast<const char*>(A.memptr()), std::streamsize(A.n_elem*sizeof(double)) );
+    }
+
+  mapped_mat<double> M("file_mapped.bin");
+
+  REQUIRE( M.is_mapped() == false );
+
+  REQUIRE( accu(abs(M.get_ref() - A)) == Approx(0.0).margin(1e-10) );
+
+  // matrices saved with a different element type can't be loaded
+
+  mapped_mat<float> N;
+
+  REQUIRE( N.load("file_mapped.bin") == false );
+
+  REQUIRE_THROWS( mapped_mat<float>("file_mapped.bin") );
+
+  std::remove("file_mapped.bin");
+  }
+
+
+
+TEST_CASE("mapped_cube_1")
+  {
+  cube A(4, 5, 6);
+
+  for(uword i=0; i < A.n_elem; ++i)  { A[i] = double(i) / 7.0; }
+
+  A.save("file_mapped.bin", arma_binary);
+
+    {
+    mapped_cube<double> M("file_mapped.bin");
+
+    const cube& X = M;
+
+    REQUIRE( X.n_rows   == 4 );
+    REQUIRE( X.n_cols   == 5 );
+    REQUIRE( X.n_slices == 6 );
+
+    REQUIRE( accu(abs(X - A)) == Approx(0.0).margin(1e-10) );
+
+    REQUIRE( accu(abs(X.slice(3) - A.slice(3))) == Approx(0.0).margin(1e-10) );
+
+    #if defined(ARMA_HAVE_POSIX_MMAP)
+      {
+      REQUIRE( M.is_mapped() == true );
+      }
+    #endif
+    }
+
+    {
+    mapped_cube<double> M("file_mapped.bin", mmap_copy_on_write);
+
+    M.get_mutable_ref().slice(2).fill(-1.0);
+
+    REQUIRE( accu(M.get_ref().slice(2)) == Approx(-20.0) );
+    }
+
+  cube B;
+
+  REQUIRE( B.load("file_mapped.bin", arma_binary) == true );
+
+  REQUIRE( accu(abs(B - A)) == Approx(0.0).margin(1e-10) );
+
+  std::remove("file_mapped.bin");
+  }
@@ -289,3 +289,44 @@ TEST_CASE("mat_mul_cx_1")
 
 
 
+TEST_CASE("mat_mul_cx_2")
+  {
+  // emulation of gemm(), as used when a BLAS library is not available;
+  // transposed operands are conjugated
+  
+  const uword sizes[][3] = { {5,7,3}, {17,40,9}, {40,17,301}, {301,13,40} };
+  
+  for(const auto& s : sizes)
+    {
+    const uword m = s[0];
+    const uword n = s[1];
+    const uword k = s[2];
+    
+    const cx_mat A = reshape( cx_vec( linspace<vec>(-1,2, m*k) % cos(linspace<vec>(0,20, m*k)), sin(linspace<vec>(0,25, m*k)) ), m, k );
+    const cx_mat B = reshape( cx_vec( linspace<vec>(-2,1, k*n) % sin(linspace<vec>(0,30, k*n)), cos(linspace<vec>(0,15, k*n)) ), k, n );
+    
+    const cx_mat At = A.t();
+    const cx_mat Bt = B.t();
+    
+    const cx_mat D = A*B;
+    
+    const cx_double alpha(2.0, -1.0);
+    const cx_double beta (0.5,  3.0);
+    
+    cx_mat C(m, n);
+    
+    gemm_emul<false,false>::apply(C, A,  B );  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    gemm_emul<true, false>::apply(C, At, B );  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    gemm_emul<false,true >::apply(C, A,  Bt);  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    gemm_emul<true, true >::apply(C, At, Bt);  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    
+    C.ones();
+    
+    gemm_emul<true,true,true,true>::apply(C, At, Bt, alpha, beta);
+    
+    REQUIRE( approx_equal(C, alpha*D + beta, "absdiff", 1e-10) );
+    }
+  }
+
+
+
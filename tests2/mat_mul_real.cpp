@@ -925,3 +925,106 @@ TEST_CASE("mat_mul_real_6")
 
 
 
+
+
+
+TEST_CASE("mat_mul_real_7")
+  {
+  // chains of 4 or more factors, with widely varying shapes
+  
+  mat A = linspace<mat>(1,2, 6*3); A.reshape(6,3);
+  mat B = linspace<mat>(2,3, 3*7); B.reshape(3,7);
+  mat C = linspace<mat>(3,4, 7*2); C.reshape(7,2);
+  mat D = linspace<mat>(4,5, 2*5); D.reshape(2,5);
+  vec x = linspace<vec>(5,6, 5);
+  
+  mat P = 0.1 * B * B.t() + 5.0 * eye<mat>(3,3);
+  
+  const mat AB   = A*B;
+  const mat ABC  = AB*C;
+  const mat ABCD = ABC*D;
+  
+  const mat ABCDx = ABCD*x;
+  
+  REQUIRE( accu(abs( A*B*C*D   - ABCD  )) == Approx(0.0).margin(1e-8) );
+  REQUIRE( accu(abs( A*B*C*D*x - ABCDx )) == Approx(0.0).margin(1e-6) );
+  
+  REQUIRE( accu(abs( 2*A*B.t().t()*(C*3)*D*x - 6*ABCDx )) == Approx(0.0).margin(1e-5) );
+  REQUIRE( accu(abs( (x.t()*D.t()*C.t()*B.t()*A.t()).t() - ABCDx )) == Approx(0.0).margin(1e-6) );
+  
+  const mat Pi = inv(P);
+  
+  const mat A_Pi_B_C_D = A*Pi*B*C*D;
+  
+  REQUIRE( accu(abs( A*inv(P)*B*C*D       - A_Pi_B_C_D )) == Approx(0.0).margin(1e-8) );
+  REQUIRE( accu(abs( A*inv_sympd(P)*B*C*D - A_Pi_B_C_D )) == Approx(0.0).margin(1e-8) );
+  
+  const mat Bt_Pi_Pi_B_C = B.t()*Pi*Pi*B*C;
+  
+  REQUIRE( accu(abs( B.t()*inv(P)*inv(P)*B*C - Bt_Pi_Pi_B_C )) == Approx(0.0).margin(1e-8) );
+  
+  mat E = A.head_cols(3) * P;
+  mat F = E;
+  
+  E = E*P*P*E.t()*E;  // aliasing
+  
+  REQUIRE( accu(abs( E - F*P*P*F.t()*F )) == Approx(0.0).margin(1e-6) );
+  
+  mat Y;
+  
+  REQUIRE_THROWS( Y = A*B*D*C*x );
+  }
+
+
+
+TEST_CASE("mat_mul_real_8")
+  {
+  // emulation of gemm(), as used when a BLAS library is not available;
+  // the sizes include partial micro-tiles and more than one packed panel along each dimension
+  
+  const uword sizes[][3] = { {5,7,3}, {17,40,9}, {40,17,301}, {301,13,40}, {64,64,64} };
+  
+  for(const auto& s : sizes)
+    {
+    const uword m = s[0];
+    const uword n = s[1];
+    const uword k = s[2];
+    
+    const mat AA = reshape( linspace<vec>(-1,2, m*k) % cos(linspace<vec>(0,20, m*k)), m, k );
+    const mat BB = reshape( linspace<vec>(-2,1, k*n) % sin(linspace<vec>(0,30, k*n)), k, n );
+    
+    const mat At = AA.t();
+    const mat Bt = BB.t();
+    
+    const mat D = AA*BB;
+    
+    mat C(m, n);
+    
+    gemm_emul<false,false>::apply(C, AA, BB);  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    gemm_emul<true, false>::apply(C, At, BB);  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    gemm_emul<false,true >::apply(C, AA, Bt);  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    gemm_emul<true, true >::apply(C, At, Bt);  REQUIRE( approx_equal(C, D, "absdiff", 1e-10) );
+    
+    C.ones();
+    
+    gemm_emul<false,false,true,true>::apply(C, AA, BB, 2.0, 3.0);
+    
+    REQUIRE( approx_equal(C, 2.0*D + 3.0, "absdiff", 1e-10) );
+    
+    const fmat fA = conv_to<fmat>::from(AA);
+    const fmat fB = conv_to<fmat>::from(BB);
+    
+    fmat fC(m, n);
+    
+    gemm_emul<false,false>::apply(fC, fA, fB);
+    
+    REQUIRE( approx_equal(conv_to<mat>::from(fC), D, "absdiff", 1e-3) );
+    
+    const imat iA = conv_to<imat>::from(round(10.0*AA));
+    const imat iB = conv_to<imat>::from(round(10.0*BB));
+    
+    const imat iD = conv_to<imat>::from( conv_to<mat>::from(iA) * conv_to<mat>::from(iB) );
+    
+    REQUIRE( all(vectorise(iA*iB == iD)) );
+    }
+  }
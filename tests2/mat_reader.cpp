@@ -0,0 +1,155 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("mat_reader_1")
+  {
+  mat A = reshape(linspace<vec>(-1, 1, 1003*7), 1003, 7);
+
+  A.save("file_reader.csv", csv_ascii  );
+  A.save("file_reader.txt", raw_ascii  );
+  A.save("file_reader.bin", arma_binary);
+
+  const char*     names[] = { "file_reader.csv", "file_reader.txt", "file_reader.bin" };
+  const file_type types[] = {  csv_ascii,         raw_ascii,         arma_binary      };
+
+  for(uword i=0; i < 3; ++i)
+    {
+    mat_reader<double> reader(names[i], types[i]);
+
+    REQUIRE( reader.is_open() == true );
+    REQUIRE( reader.n_cols()  == 7    );
+
+    mat   block;
+    uword n_blocks = 0;
+    uword row      = 0;
+
+    while(reader.next(block, 100))
+      {
+      REQUIRE( block.n_rows <= 100 );
+      REQUIRE( block.n_cols == 7   );
+
+      REQUIRE( accu(abs(block - A.rows(row, row + block.n_rows - 1))) == Approx(0.0).margin(1e-10) );
+
+      row += block.n_rows;
+
+      ++n_blocks;
+      }
+
+    REQUIRE( n_blocks == 11 );
+    REQUIRE( row      == A.n_rows );
+
+    REQUIRE( reader.n_rows_read() == A.n_rows );
+    REQUIRE( reader.good()        == true     );
+    REQUIRE( block.n_elem         == 0        );
+    }
+
+  std::remove("file_reader.csv");
+  std::remove("file_reader.txt");
+  std::remove("file_reader.bin");
+  }
+
+
+
+TEST_CASE("mat_reader_2")
+  {
+    {
+    std::ofstream f("file_reader.csv");
+
+    f << "1,2,3" << '\n';
+    f << "4"     << '\n';
+    f << "5,6"   << '\n';
+    f << '\n';
+    f << "7,8,9" << '\n';
+    }
+
+  mat_reader<double> reader("file_reader.csv", csv_ascii);
+
+  mat block;
+
+  // missing elements are set to zero; lines after an empty line are ignored
+
+  REQUIRE( reader.next(block, 2) == true );
+
+  REQUIRE( block.n_rows == 2 );
+  REQUIRE( block.n_cols == 3 );
+  REQUIRE( block(1,0) == Approx(4.0) );
+  REQUIRE( block(1,2) == Approx(0.0) );
+
+  REQUIRE( reader.next(block, 2) == true );
+
+  REQUIRE( block.n_rows == 1 );
+  REQUIRE( block(0,1) == Approx(6.0) );
+
+  REQUIRE( reader.next(block, 2) == false );
+  REQUIRE( reader.good()         == true  );
+
+  // lines with more fields than the first line are an error
+
+    {
+    std::ofstream f("file_reader.csv");
+
+    f << "1,2"   << '\n';
+    f << "3,4,5" << '\n';
+    }
+
+  REQUIRE( reader.open("file_reader.csv", csv_ascii) == true  );
+  REQUIRE( reader.next(block, 10)                    == false );
+  REQUIRE( reader.good()                             == false );
+
+  std::remove("file_reader.csv");
+
+  REQUIRE( reader.open("file_reader.csv", csv_ascii) == false );
+
+  REQUIRE_THROWS( mat_reader<double>("file_reader.csv", csv_ascii) );
+  }
+
+
+
+#if defined(ARMA_USE_HDF5)
+
+TEST_CASE("mat_reader_hdf5")
+  {
+  imat A = reshape(regspace<ivec>(1, 300), 60, 5);
+
+  A.save("file_reader.h5", hdf5_binary);
+
+  mat_reader<double> reader("file_reader.h5", hdf5_binary);
+
+  REQUIRE( reader.n_cols() == 5 );
+
+  mat   block;
+  uword row = 0;
+
+  while(reader.next(block, 25))
+    {
+    REQUIRE( accu(abs(block - conv_to<mat>::from(A.rows(row, row + block.n_rows - 1)))) == Approx(0.0).margin(1e-10) );
+
+    row += block.n_rows;
+    }
+
+  REQUIRE( row           == 60   );
+  REQUIRE( reader.good() == true );
+
+  std::remove("file_reader.h5");
+  }
+
+#endif
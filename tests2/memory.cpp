@@ -0,0 +1,57 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("memory_1")
+  {
+  REQUIRE( memory::calc_alignment(100)  == size_t(16) );
+  REQUIRE( memory::calc_alignment(1024) == size_t(arma_config::mem_align) );
+  
+  if(arma_config::mem_align_page)
+    {
+    REQUIRE( memory::calc_alignment(size_t(memory::page_threshold)) == size_t(memory::page_size) );
+    }
+  
+  mat A(100, 100, fill::zeros);
+  
+  #if !defined(ARMA_USE_TBB_ALLOC)
+    {
+    REQUIRE( (size_t(A.memptr()) % size_t(arma_config::mem_align)) == 0 );
+    }
+  #endif
+  
+  mat B(1000, 1000, fill::ones);  // large enough to be first touched when ARMA_OPENMP_FIRST_TOUCH is defined
+  
+  REQUIRE( accu(B) == Approx(1000000.0) );
+  
+  mat C(200, 200, fill::ones);  // above page_threshold, but small enough to be pooled when ARMA_USE_POOL_ALLOC is defined
+  
+  #if !defined(ARMA_USE_TBB_ALLOC)
+    {
+    if(arma_config::mem_align_page)
+      {
+      REQUIRE( (uintptr_t(B.memptr()) % uintptr_t(memory::page_size)) == 0 );
+      REQUIRE( (uintptr_t(C.memptr()) % uintptr_t(memory::page_size)) == 0 );
+      }
+    }
+  #endif
+  
+  REQUIRE( accu(C) == Approx(40000.0) );
+  }
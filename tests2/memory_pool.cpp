@@ -0,0 +1,119 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("memory_pool_1")
+  {
+  for(size_t n = 1; n < 100000; n += 7)
+    {
+    const uword c = memory_pool::calc_class(n);
+    
+    REQUIRE( c < uword(memory_pool::n_classes) );
+    REQUIRE( memory_pool::class_size(c) >= n );
+    
+    if(c > 0)  { REQUIRE( memory_pool::class_size(c-1) < n ); }
+    }
+  
+  REQUIRE( memory_pool::calc_class(memory_pool::class_size(memory_pool::n_classes-1) + 1) == uword(memory_pool::n_classes) );
+  }
+
+
+
+TEST_CASE("memory_pool_2")
+  {
+  memory_pool::trim();
+  
+  const memory_pool::stats_type s0 = memory_pool::stats();
+  
+  double* A = (double*) memory_pool::acquire(sizeof(double) * 1000);
+  
+  REQUIRE( A != nullptr );
+  REQUIRE( (size_t(A) % size_t(memory_pool::header_size)) == 0 );
+  
+  A[0] = 1.0;  A[999] = 2.0;
+  
+  memory_pool::release(A);
+  
+  double* B = (double*) memory_pool::acquire(sizeof(double) * 990);
+  
+  REQUIRE( B == A );
+  
+  memory_pool::release(B);
+  
+  double* C = (double*) memory_pool::acquire(sizeof(double) * 10000000);  // too large to be pooled
+  
+  REQUIRE( C != nullptr );
+  REQUIRE( (uintptr_t(C) % uintptr_t(memory_pool::calc_alignment(memory_pool::n_classes))) == 0 );
+  
+  memory_pool::release(C);
+  
+  const memory_pool::stats_type s1 = memory_pool::stats();
+  
+  REQUIRE( (s1.n_hits     - s0.n_hits    ) == 1 );
+  REQUIRE( (s1.n_misses   - s0.n_misses  ) == 2 );
+  REQUIRE( (s1.n_cached   - s0.n_cached  ) == 2 );
+  REQUIRE( (s1.n_returned - s0.n_returned) == 1 );
+  REQUIRE( s1.n_bytes_cached > 0 );
+  
+  memory_pool::trim();
+  
+  REQUIRE( memory_pool::stats().n_bytes_cached == 0 );
+  }
+
+
+
+TEST_CASE("memory_pool_3")
+  {
+  // blocks of at least page_threshold bytes are aligned to pages when ARMA_MEM_ALIGN_PAGE is defined
+  
+  const size_t n_bytes = memory_pool::page_threshold + 1000;
+  
+  const uword c = memory_pool::calc_class(n_bytes);
+  
+  REQUIRE( c < uword(memory_pool::n_classes) );
+  
+  if(arma_config::mem_align_page)
+    {
+    REQUIRE( memory_pool::calc_alignment(c)                     == size_t(memory_pool::page_size) );
+    REQUIRE( memory_pool::calc_alignment(memory_pool::n_classes) == size_t(memory_pool::page_size) );
+    }
+  
+  for(uword i=0; i < 2; ++i)  // the second request is served from the free list
+    {
+    unsigned char* A = (unsigned char*) memory_pool::acquire(n_bytes);
+    
+    REQUIRE( A != nullptr );
+    REQUIRE( (uintptr_t(A) % uintptr_t(memory_pool::calc_alignment(c))) == 0 );
+    
+    A[0] = 1;  A[n_bytes-1] = 2;
+    
+    memory_pool::release(A);
+    }
+  
+  unsigned char* B = (unsigned char*) memory_pool::acquire(memory_pool::header_size);
+  
+  REQUIRE( (uintptr_t(B) % uintptr_t(memory_pool::header_size)) == 0 );
+  
+  memory_pool::release(B);
+  
+  memory_pool::trim();
+  }
@@ -0,0 +1,182 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("npy_binary_1")
+  {
+  mat A = randn<mat>(13, 7);
+
+  A.save("file_npy.npy", npy_binary);
+
+  mat B;
+
+  REQUIRE( B.load("file_npy.npy", npy_binary) == true );
+
+  REQUIRE( B.n_rows == A.n_rows );
+  REQUIRE( B.n_cols == A.n_cols );
+
+  REQUIRE( accu(A != B) == 0 );
+
+  // automatic detection of the file type; conversion of the element type
+
+  fmat C;
+
+  REQUIRE( C.load("file_npy.npy") == true );
+
+  REQUIRE( accu(abs(conv_to<mat>::from(C) - A)) == Approx(0.0).margin(1e-4) );
+
+  // complex data can't be loaded into a real matrix
+
+  cx_mat X = randn<cx_mat>(3, 4);
+
+  X.save("file_npy.npy", npy_binary);
+
+  REQUIRE( B.quiet_load("file_npy.npy", npy_binary) == false );
+
+  cx_mat Y;
+
+  REQUIRE( Y.load("file_npy.npy", npy_binary) == true );
+
+  REQUIRE( accu(X != Y) == 0 );
+
+  std::remove("file_npy.npy");
+  }
+
+
+
+TEST_CASE("npy_binary_2")
+  {
+  // array stored in C order (row-major), as saved by numpy.save() by default
+
+  const std::string dict = "{'descr': '<i4', 'fortran_order': False, 'shape': (2, 3), }";
+
+  std::string header = dict + std::string(128 - 10 - dict.length() - 1, ' ') + '\n';
+
+  std::stringstream ss;
+
+  ss.write("\x93NUMPY\x01\x00", 8);
+  ss.put( char(header.length() & 0xFF) );
+  ss.put( char(header.length() >> 8)   );
+  ss << header;
+
+  const s32 vals[] = { 1, 2, 3, 4, 5, 6 };
+
+  ss.write( reinterpret_cast<const char*>(vals), sizeof(vals) );
+
+  // the test data is written in little endian byte order
+
+  const u16 endian_test = 1;
+
+  if( *(reinterpret_cast<const unsigned char*>(&endian_test)) == 1 )
+    {
+    imat A;
+
+    REQUIRE( A.load(ss, npy_binary) == true );
+
+    REQUIRE( A.n_rows == 2 );
+    REQUIRE( A.n_cols == 3 );
+
+    REQUIRE( A(0,0) == 1 );
+    REQUIRE( A(0,1) == 2 );
+    REQUIRE( A(0,2) == 3 );
+    REQUIRE( A(1,0) == 4 );
+    REQUIRE( A(1,1) == 5 );
+    REQUIRE( A(1,2) == 6 );
+    }
+
+  // cubes are stored with shape (n_rows, n_cols, n_slices)
+
+  cube Q = randu<cube>(4, 3, 2);
+
+  std::stringstream ss2;
+
+  REQUIRE( Q.save(ss2, npy_binary) == true );
+
+  cube R;
+
+  REQUIRE( R.load(ss2, npy_binary) == true );
+
+  REQUIRE( R.n_rows   == 4 );
+  REQUIRE( R.n_cols   == 3 );
+  REQUIRE( R.n_slices == 2 );
+
+  REQUIRE( accu(Q != R) == 0 );
+  }
+
+
+
+TEST_CASE("npy_binary_3")
+  {
+  // fields are stored as .npz archives
+
+  field<mat> F(3);
+
+  F(0) = randu<mat>(5, 6);
+  F(1) = randu<mat>(1, 9);
+  F(2).reset();
+
+  F.save("file_npy.npz", npy_binary);
+
+  field<mat> G;
+
+  REQUIRE( G.load("file_npy.npz", npy_binary) == true );
+
+  REQUIRE( G.n_elem == 3 );
+
+  REQUIRE( accu(G(0) != F(0)) == 0 );
+  REQUIRE( accu(G(1) != F(1)) == 0 );
+
+  REQUIRE( G(1).n_rows == 1 );
+  REQUIRE( G(2).n_elem == 0 );
+
+  std::remove("file_npy.npz");
+
+  // matrices are mapped into memory directly
+
+  mat A = randn<mat>(20, 30);
+
+  A.save("file_npy.npy", npy_binary);
+
+    {
+    mapped_mat<double> M("file_npy.npy");
+
+    const mat& X = M;
+
+    REQUIRE( X.n_rows == 20 );
+    REQUIRE( X.n_cols == 30 );
+
+    REQUIRE( accu(X != A) == 0 );
+
+    #if defined(ARMA_HAVE_POSIX_MMAP)
+      {
+      REQUIRE( M.is_mapped() == true );
+      }
+    #endif
+    }
+
+  mapped_mat<float> N("file_npy.npy");
+
+  REQUIRE( N.is_mapped() == false );
+
+  REQUIRE( accu(abs(conv_to<mat>::from(N.get_ref()) - A)) == Approx(0.0).margin(1e-4) );
+
+  std::remove("file_npy.npy");
+  }
@@ -0,0 +1,174 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+#include <clocale>
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("save_text_1")
+  {
+  mat A = randn<mat>(300, 7);
+
+  A(0,0) = 0.1;
+  A(1,1) = -4.9e-324;
+  A(2,2) = 1e300;
+  A(3,3) = datum::inf;
+  A(4,4) = -datum::inf;
+  A(5,5) = datum::nan;
+
+  // numbers are saved with enough digits to be recovered exactly
+
+  std::stringstream ss1;
+  std::stringstream ss2;
+
+  REQUIRE( A.save(ss1, csv_ascii) == true );
+  REQUIRE( A.save(ss2, raw_ascii) == true );
+
+  mat B;
+  mat C;
+
+  REQUIRE( B.load(ss1, csv_ascii) == true );
+  REQUIRE( C.load(ss2, raw_ascii) == true );
+
+  REQUIRE( B.n_rows == A.n_rows );
+  REQUIRE( B.n_cols == A.n_cols );
+  REQUIRE( C.n_rows == A.n_rows );
+  REQUIRE( C.n_cols == A.n_cols );
+
+  REQUIRE( std::isinf(B(3,3)) );  REQUIRE( B(3,3) > 0.0 );
+  REQUIRE( std::isinf(C(4,4)) );  REQUIRE( C(4,4) < 0.0 );
+  REQUIRE( std::isnan(B(5,5)) );
+  REQUIRE( std::isnan(C(5,5)) );
+
+  A.replace(datum::nan, 0.0);
+  B.replace(datum::nan, 0.0);
+  C.replace(datum::nan, 0.0);
+
+  REQUIRE( accu(A != B) == 0 );
+  REQUIRE( accu(A != C) == 0 );
+
+  // single precision data can be loaded as double precision without introducing errors
+
+  fmat D = randn<fmat>(20, 3);
+
+  std::stringstream ss3;
+
+  REQUIRE( D.save(ss3, raw_ascii) == true );
+
+  REQUIRE( B.load(ss3, raw_ascii) == true );
+
+  REQUIRE( accu(conv_to<mat>::from(D) != B) == 0 );
+
+  // integers are saved exactly, without exponents
+
+  imat E = { { -7, 0, std::numeric_limits<sword>::max() }, { 12, -300, std::numeric_limits<sword>::min() } };
+
+  std::stringstream ss4;
+
+  REQUIRE( E.save(ss4, csv_ascii) == true );
+
+  REQUIRE( ss4.str().find('e') == std::string::npos );
+
+  imat F;
+
+  REQUIRE( F.load(ss4, csv_ascii) == true );
+
+  REQUIRE( accu(E != F) == 0 );
+  }
+
+
+
+TEST_CASE("save_text_2")
+  {
+  // wide matrices are formatted in several parts per line
+
+  mat A = randu<mat>(2, 20000);
+
+  A.save("file_text.csv", csv_ascii);
+
+  mat B;
+
+  REQUIRE( B.load("file_text.csv", csv_ascii) == true );
+
+  REQUIRE( B.n_rows == A.n_rows );
+  REQUIRE( B.n_cols == A.n_cols );
+
+  REQUIRE( accu(A != B) == 0 );
+
+  std::remove("file_text.csv");
+
+  cube C = randn<cube>(3, 4, 2);
+
+  C.save("file_text.txt", raw_ascii);
+
+  mat D;
+
+  REQUIRE( D.load("file_text.txt", raw_ascii) == true );
+
+  REQUIRE( D.n_rows == 6 );
+  REQUIRE( D.n_cols == 4 );
+
+  REQUIRE( accu(D.rows(0,2) != C.slice(0)) == 0 );
+  REQUIRE( accu(D.rows(3,5) != C.slice(1)) == 0 );
+
+  std::remove("file_text.txt");
+
+  cx_mat X = randn<cx_mat>(4, 3);
+
+  std::stringstream ss;
+
+  REQUIRE( X.save(ss, raw_ascii) == true );
+
+  cx_mat Y;
+
+  REQUIRE( Y.load(ss, raw_ascii) == true );
+
+  REQUIRE( accu(X != Y) == 0 );
+  }
+
+
+
+TEST_CASE("save_text_3")
+  {
+  // the saved text must not depend on the radix character of the current locale
+
+  mat A = { { 1.5, -2.25 }, { 1e-300, 3.0 } };
+
+  std::stringstream ss1;
+
+  REQUIRE( A.save(ss1, csv_ascii) == true );
+
+  const char* names[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8" };
+
+  bool found = false;
+
+  for(const char* name : names)  { if(std::setlocale(LC_NUMERIC, name) != nullptr)  { found = true; break; } }
+
+  if(found == false)  { return; }
+
+  std::stringstream ss2;
+
+  const bool status = A.save(ss2, csv_ascii);
+
+  std::setlocale(LC_NUMERIC, "C");
+
+  REQUIRE( status == true );
+
+  REQUIRE( ss1.str() == ss2.str() );
+  }
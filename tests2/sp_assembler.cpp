@@ -0,0 +1,113 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("sp_assembler_1")
+  {
+  arma_rng::set_seed(7);
+  
+  const uword n_rows = 500;
+  const uword n_cols = 400;
+  const uword N      = 100000;
+  
+  umat locs(2, N);
+  locs.row(0) = randi<urowvec>(N, distr_param(0, int(n_rows-1)));
+  locs.row(1) = randi<urowvec>(N, distr_param(0, int(n_cols-1)));
+  
+  vec vals = round(randu<vec>(N) * 10.0) - 5.0;  // integers, so that the sums are exact
+  
+  sp_mat ref(true, locs, vals, n_rows, n_cols);
+  
+  sp_assembler<double> asmb(n_rows, n_cols);
+  
+  asmb.reserve(N / asmb.n_buffers);
+  
+  #if defined(ARMA_USE_OPENMP)
+  #pragma omp parallel for
+  #endif
+  for(uword i=0; i < N; ++i)
+    {
+    asmb.add(locs(0,i), locs(1,i), vals(i));
+    }
+  
+  REQUIRE( asmb.n_triplets() == uword(accu(vals != 0.0)) );
+  
+  sp_mat A;
+  
+  asmb.finalize(A);
+  
+  REQUIRE( asmb.n_triplets() == 0 );
+  
+  REQUIRE( A.n_rows    == n_rows                 );
+  REQUIRE( A.n_cols    == n_cols                 );
+  REQUIRE( A.n_nonzero == uword(accu(mat(ref) != 0.0)) );
+  
+  REQUIRE( accu(abs(A - ref)) == Approx(0.0).margin(1e-12) );
+  
+  for(uword j=0; j < n_cols; ++j)
+  for(uword i = A.col_ptrs[j] + 1; i < A.col_ptrs[j+1]; ++i)
+    {
+    REQUIRE( A.row_indices[i-1] < A.row_indices[i] );
+    }
+  
+  // reuse, with cancellation
+  
+  asmb.add(1, 2,  3.0);
+  asmb.add(4, 2,  1.0);
+  asmb.add(1, 2, -3.0);
+  asmb.add(0, 0,  0.0);
+  
+  asmb.finalize(A);
+  
+  REQUIRE( A.n_nonzero == 1 );
+  REQUIRE( A(4,2) == Approx(1.0) );
+  
+  asmb.finalize(A);
+  
+  REQUIRE( A.n_nonzero == 0      );
+  REQUIRE( A.n_rows    == n_rows );
+  
+  REQUIRE_THROWS( asmb.add(n_rows, 0, 1.0) );
+  }
+
+
+
+TEST_CASE("sp_assembler_2")
+  {
+  sp_assembler<cx_double> asmb(3, 4, 2);
+  
+  REQUIRE( asmb.n_buffers == 2 );
+  
+  asmb.add(2, 3, cx_double(1.0, 2.0));
+  asmb.add(0, 1, cx_double(0.5, 0.0));
+  asmb.add(2, 3, cx_double(1.0, -1.0));
+  
+  sp_cx_mat A;
+  
+  asmb.finalize(A);
+  
+  REQUIRE( A.n_nonzero == 2 );
+  
+  REQUIRE( std::real(cx_double(A(2,3))) == Approx(2.0) );
+  REQUIRE( std::imag(cx_double(A(2,3))) == Approx(1.0) );
+  REQUIRE( std::real(cx_double(A(0,1))) == Approx(0.5) );
+  }
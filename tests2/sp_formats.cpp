@@ -0,0 +1,218 @@
+// Copyright 2008-2016 Conrad Sanderson (http://conradsanderson.id.au)
+// Copyright 2008-2016 National ICT Australia (NICTA)
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ------------------------------------------------------------------------
+
+
+
+#include <armadillo>
+#include "catch.hpp"
+
+using namespace arma;
+
+
+TEST_CASE("sp_csr_1")
+  {
+  sp_mat A = sprandu<sp_mat>(300, 200, 0.05);
+  A(0,0) = 1.5;
+  A.row(7).zeros();
+  
+  mat X = randu<mat>(200, 6);
+  
+  mat Z = mat(A) * X;
+  
+  const sp_csr<double> B(A);
+  
+  REQUIRE( B.n_rows    == 300         );
+  REQUIRE( B.n_cols    == 200         );
+  REQUIRE( B.n_nonzero == A.n_nonzero );
+  REQUIRE( B.is_view() == false       );
+  
+  REQUIRE( B.at(0,0)          == Approx(1.5) );
+  REQUIRE( B.row_n_nonzero(7) == 0           );
+  
+  REQUIRE( accu(abs((B * X) - Z))               == Approx(0.0).margin(1e-10) );
+  REQUIRE( accu(abs((B * X.col(1)) - Z.col(1))) == Approx(0.0).margin(1e-10) );
+  
+  const sp_csr<double> C(A.st());
+  
+  REQUIRE( C.is_view() == true        );
+  REQUIRE( C.n_rows    == 200         );
+  REQUIRE( C.row_ptrs  == A.col_ptrs  );
+  REQUIRE( C.at(0,0)   == Approx(1.5) );
+  
+  mat Y = randu<mat>(300, 3);
+  
+  REQUIRE( accu(abs((C * Y) - (mat(A).t() * Y))) == Approx(0.0).margin(1e-10) );
+  
+  const sp_csr<double> D(B);
+  
+  REQUIRE( accu(abs((D * X) - Z)) == Approx(0.0).margin(1e-10) );
+  
+  mat W(10,10);
+  
+  REQUIRE_THROWS( B * W );
+  }
+
+
+
+TEST_CASE("sp_csr_2")
+  {
+  sp_cx_mat A = sprandu<sp_cx_mat>(100, 80, 0.1);
+  
+  cx_mat X = randu<cx_mat>(100, 4);
+  
+  const sp_csr<cx_double> B(A.t());
+  
+  REQUIRE( B.is_view() == true );
+  
+  REQUIRE( accu(abs((B * X) - (cx_mat(A).t() * X))) == Approx(0.0).margin(1e-10) );
+  
+  cx_mat Y = randu<cx_mat>(80, 4);
+  
+  const sp_csr<cx_double> C(A);
+  
+  REQUIRE( accu(abs((C * Y) - (cx_mat(A) * Y))) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("sp_bsr_1")
+  {
+  // matrix with 3x3 block structure, as arising from finite element discretisations
+  
+  sp_mat P = sprandu<sp_mat>(40, 40, 0.1);
+  sp_mat A = kron(P, sp_mat(ones<mat>(3,3)));
+  
+  A(5,5) = 0.0;  // partly filled block
+  
+  mat X = randu<mat>(120, 7);
+  
+  mat Z = mat(A) * X;
+  
+  for(uword bs : { uword(1), uword(2), uword(3), uword(4), uword(6) })
+    {
+    const sp_bsr<double> B(A, bs);
+    
+    REQUIRE( B.n_block_rows == (120 / bs) );
+    REQUIRE( B.at(5,5)      == 0.0        );
+    
+    REQUIRE( accu(abs((B * X) - Z)) == Approx(0.0).margin(1e-10) );
+    }
+  
+  const sp_bsr<double> B(A, 3);
+  
+  REQUIRE( B.n_blocks == P.n_nonzero );
+  
+  const sp_bsr<double> C(B);
+  
+  REQUIRE( accu(abs((C * X) - Z)) == Approx(0.0).margin(1e-10) );
+  
+  REQUIRE_THROWS( sp_bsr<double>(A, 7) );
+  
+  sp_cx_mat D = sprandu<sp_cx_mat>(30, 30, 0.2);
+  
+  cx_mat Y = randu<cx_mat>(30, 2);
+  
+  const sp_bsr<cx_double> E(D, 5);
+  
+  REQUIRE( accu(abs((E * Y) - (cx_mat(D) * Y))) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("sp_sell_1")
+  {
+  sp_mat A = sprandu<sp_mat>(503, 400, 0.02);
+  A.row(10).ones();  // one long row
+  A.row(11).zeros();
+  
+  mat X = randu<mat>(400, 6);
+  
+  mat Z = mat(A) * X;
+  
+  const sp_sell<double> B(A);
+  
+  REQUIRE( B.n_nonzero     == A.n_nonzero );
+  REQUIRE( B.n_chunks      == 63          );
+  REQUIRE( B.n_elem_padded >= A.n_nonzero );
+  
+  REQUIRE( accu(abs((B * X) - Z)) == Approx(0.0).margin(1e-10) );
+  
+  const sp_sell<double> C(A, 4, 1);
+  
+  REQUIRE( accu(abs((C * X) - Z)) == Approx(0.0).margin(1e-10) );
+  
+  const sp_sell<double> D(A, 32, 1024);
+  
+  REQUIRE( accu(abs((D * X) - Z)) == Approx(0.0).margin(1e-10) );
+  
+  // sorting within windows reduces padding
+  REQUIRE( D.n_elem_padded <= sp_sell<double>(A, 32, 1).n_elem_padded );
+  
+  const sp_sell<double> E(D);
+  
+  REQUIRE( accu(abs((E * X.col(0)) - Z.col(0))) == Approx(0.0).margin(1e-10) );
+  
+  REQUIRE_THROWS( sp_sell<double>(A, 65) );
+  
+  sp_cx_mat F = sprandu<sp_cx_mat>(50, 40, 0.1);
+  
+  cx_mat Y = randu<cx_mat>(40, 3);
+  
+  const sp_sell<cx_double> G(F, 8, 16);
+  
+  REQUIRE( accu(abs((G * Y) - (cx_mat(F) * Y))) == Approx(0.0).margin(1e-10) );
+  }
+
+
+
+TEST_CASE("sp_sell_2")
+  {
+  // padding elements must not propagate non-finite elements of X
+  
+  sp_mat A = sprandu<sp_mat>(100, 50, 0.05);
+  A.row(3).ones();
+  A.row(4).zeros();
+  A.col(0).zeros();
+  A(5,0) = 2.0;
+  
+  mat X = randu<mat>(50, 4);
+  X(0,0) = datum::nan;
+  X(0,1) = datum::inf;
+  X(0,2) = -datum::inf;
+  
+  const sp_mat B = A.cols(1, A.n_cols-1);
+  
+  const mat Z = mat(B) * X.rows(1, X.n_rows-1);
+  
+  const uword chunk_sizes[] = { 3, 4, 8, 16, 32 };
+  
+  for(const uword chunk_size : chunk_sizes)
+    {
+    const sp_sell<double> C(A, chunk_size, 1);
+    
+    const mat Y = C * X;
+    
+    for(uword row=0; row < A.n_rows; ++row)
+      {
+      if(row == 5)  { continue; }
+      
+      REQUIRE( Y.row(row).is_finite() );
+      REQUIRE( accu(abs(Y.row(row) - Z.row(row))) == Approx(0.0).margin(1e-10) );
+      }
+    
+    REQUIRE( std::isnan(Y(5,0)) );
+    REQUIRE( Y(5,1) == datum::inf );
+    }
+  }
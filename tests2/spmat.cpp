@@ -3188,3 +3188,150 @@ TEST_CASE("spmat_vectorise_dimension_alias")
     REQUIRE(m(i) == Approx(n(i)));
     }
   }
+
+
+
+// Test sparse * dense for a range of shapes, including sizes that use the parallelised code paths.
+TEST_CASE("spmat_sparse_times_dense")
+  {
+  const uword n_cols_list[] = { 1, 3, 4, 6, 9, 70 };
+
+  for (const uword n : n_cols_list)
+    {
+    sp_mat a;
+    a.sprandu(500, 300, 0.05);
+    mat d(a);
+    mat b;
+    b.randu(300, n);
+
+    mat y = a * b;
+    mat z = d * b;
+
+    REQUIRE( approx_equal(y, z, "absdiff", 1e-10) );
+
+    mat c;
+    c.randu(500, n);
+
+    y = a.t() * c;
+    z = d.t() * c;
+
+    REQUIRE( y.n_rows == 300 );
+    REQUIRE( y.n_cols == n );
+    REQUIRE( approx_equal(y, z, "absdiff", 1e-10) );
+
+    sp_cx_mat ca(a, 2.0 * a);
+    cx_mat cd(ca);
+    cx_mat cb(b, -b);
+
+    cx_mat cy = ca * cb;
+    cx_mat cz = cd * cb;
+
+    REQUIRE( approx_equal(cy, cz, "absdiff", 1e-10) );
+    }
+  }
+
+
+
+// Test sparse * sparse, including sizes that use the parallelised code path, and sums which evaluate to zero.
+TEST_CASE("spmat_sparse_times_sparse")
+  {
+  sp_mat a;
+  a.sprandu(400, 300, 0.05);
+  sp_mat b;
+  b.sprandu(300, 200, 0.05);
+
+  mat da(a);
+  mat db(b);
+
+  sp_mat c = a * b;
+  mat dc = da * db;
+
+  REQUIRE( approx_equal(mat(c), dc, "absdiff", 1e-10) );
+  REQUIRE( c.n_nonzero == uword(accu(dc != 0.0)) );
+
+  // column j of c has the same row indices as column j of the dense product
+  for (uword j = 0; j < c.n_cols; ++j)
+    {
+    REQUIRE( c.col(j).n_nonzero == uword(accu(dc.col(j) != 0.0)) );
+    }
+
+  sp_mat ia = round(10.0 * a);
+  sp_mat ib = round(10.0 * b);
+
+  sp_mat x = join_rows(ia, ia);
+  sp_mat y = join_cols(ib, sp_mat(-ib));
+
+  sp_mat z = x * y;
+
+  REQUIRE( z.n_rows == 400 );
+  REQUIRE( z.n_cols == 200 );
+  REQUIRE( z.n_nonzero == 0 );
+
+  y = join_cols(ib, sp_mat(-2.0 * ib));
+  z = x * y;
+
+  REQUIRE( approx_equal(mat(z), -(mat(ia) * mat(ib)), "absdiff", 1e-10) );
+  REQUIRE( z.n_nonzero == uword(accu(mat(ia) * mat(ib) != 0.0)) );
+  }
+
+
+
+TEST_CASE("spmat_element_assembly")
+  {
+  // element-wise assembly in random order, with cancellations and explicit erasures
+
+  arma_rng::set_seed(123);
+
+  const uword n = 300;
+
+  umat loc = randi<umat>(2, 20000, distr_param(0, int(n-1)));
+
+  sp_mat a(n, n);
+  mat   da(n, n, fill::zeros);
+
+  for (uword k = 0; k < loc.n_cols; ++k)
+    {
+    const uword r = loc(0,k);
+    const uword c = loc(1,k);
+
+    const double v = double(k % 7) - 3.0;
+
+    if ((k % 11) == 0)
+      {
+      a(r,c)  = 0.0;
+      da(r,c) = 0.0;
+      }
+    else
+      {
+      a(r,c)  += v;
+      da(r,c) += v;
+      }
+    }
+
+  REQUIRE( a.n_nonzero == uword(accu(da != 0.0)) );
+  REQUIRE( approx_equal(mat(a), da, "absdiff", 1e-12) );
+
+  // row indices must be sorted within each column after conversion
+  a.sync();
+  for (uword j = 0; j < n; ++j)
+    {
+    for (uword i = a.col_ptrs[j] + 1; i < a.col_ptrs[j+1]; ++i)
+      {
+      REQUIRE( a.row_indices[i-1] < a.row_indices[i] );
+      }
+    }
+
+  // very tall matrix with few elements
+  sp_vec b(1000000);
+  b(999999) = 1.0;
+  b(3)      = 2.0;
+  b(500000) = 3.0;
+  b(3)     *= 2.0;
+  b.sync();
+
+  REQUIRE( b.n_nonzero == 3 );
+  REQUIRE( b.row_indices[0] == 3      );
+  REQUIRE( b.row_indices[1] == 500000 );
+  REQUIRE( b.row_indices[2] == 999999 );
+  REQUIRE( b(3) == Approx(4.0) );
+  }